@@ -44,6 +44,7 @@
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_mask_kernels_priv.h"
 #include "gdal_priv.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
@@ -345,17 +346,9 @@ template<class T> static CPLErr GDALWarpNoDataMaskerT( const double *padfNoData,
         return CE_None;
     }
 
-    const int nNoData = static_cast<int>(floor(padfNoData[0] + 0.000001));
-    int bAllValid = TRUE;
-    for( size_t iOffset = 0; iOffset < nPixels; ++iOffset )
-    {
-        if( pData[iOffset] == nNoData )
-        {
-            bAllValid = FALSE;
-            CPLMaskClear(panValidityMask, iOffset);
-        }
-    }
-    *pbOutAllValid = bAllValid;
+    const T nNoData = static_cast<T>(floor(padfNoData[0] + 0.000001));
+    *pbOutAllValid =
+        GDALMaskClearNoData(panValidityMask, pData, nPixels, nNoData);
 
     return CE_None;
 }
@@ -415,7 +408,6 @@ GDALWarpNoDataMasker( void *pMaskFuncArg, int nBandCount, GDALDataType eType,
       {
           const float fNoData = static_cast<float>(padfNoData[0]);
           const float *pafData = reinterpret_cast<float *>(*ppImageData);
-          const bool bIsNoDataNan = CPL_TO_BOOL(CPLIsNan(fNoData));
 
           // Nothing to do if value is out of range.
           if( padfNoData[1] != 0.0 )
@@ -424,18 +416,8 @@ GDALWarpNoDataMasker( void *pMaskFuncArg, int nBandCount, GDALDataType eType,
               return CE_None;
           }
 
-          int bAllValid = TRUE;
-          for( size_t iOffset = 0; iOffset < nPixels; ++iOffset )
-          {
-              float fVal = pafData[iOffset];
-              if( (bIsNoDataNan && CPLIsNan(fVal)) ||
-                  (!bIsNoDataNan && ARE_REAL_EQUAL(fVal, fNoData)) )
-              {
-                  bAllValid = FALSE;
-                  CPLMaskClear(panValidityMask, iOffset);
-              }
-          }
-          *pbOutAllValid = bAllValid;
+          *pbOutAllValid =
+              GDALMaskClearNoData(panValidityMask, pafData, nPixels, fNoData);
       }
       break;
 
@@ -444,7 +426,6 @@ GDALWarpNoDataMasker( void *pMaskFuncArg, int nBandCount, GDALDataType eType,
           const double dfNoData = padfNoData[0];
           const double *padfData =
               reinterpret_cast<double *>(*ppImageData);
-          const bool bIsNoDataNan = CPL_TO_BOOL(CPLIsNan(dfNoData));
 
           // Nothing to do if value is out of range.
           if( padfNoData[1] != 0.0 )
@@ -453,18 +434,8 @@ GDALWarpNoDataMasker( void *pMaskFuncArg, int nBandCount, GDALDataType eType,
               return CE_None;
           }
 
-          int bAllValid = TRUE;
-          for( size_t iOffset = 0; iOffset < nPixels; ++iOffset )
-          {
-              double dfVal = padfData[iOffset];
-              if( (bIsNoDataNan && CPLIsNan(dfVal)) ||
-                  (!bIsNoDataNan && ARE_REAL_EQUAL(dfVal, dfNoData)) )
-              {
-                  bAllValid = FALSE;
-                  CPLMaskClear(panValidityMask, iOffset);
-              }
-          }
-          *pbOutAllValid = bAllValid;
+          *pbOutAllValid =
+              GDALMaskClearNoData(panValidityMask, padfData, nPixels, dfNoData);
       }
       break;
 
@@ -787,11 +758,7 @@ GDALWarpSrcMaskMasker( void *pMaskFuncArg,
 /*      Pack into 1 bit per pixel for validity.                         */
 /* -------------------------------------------------------------------- */
     const size_t nPixels = static_cast<size_t>(nXSize) * nYSize;
-    for( size_t iPixel = 0; iPixel < nPixels; iPixel++ )
-    {
-        if( pabySrcMask[iPixel] == 0 )
-            CPLMaskClear(panMask, iPixel);
-    }
+    CPLMaskClearFromBytes(panMask, pabySrcMask, nPixels);
 
     CPLFree( pabySrcMask );
 
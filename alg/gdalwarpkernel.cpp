@@ -5995,6 +5995,9 @@ static void GWKAverageOrModeThread( void* pData)
     int *panVals = nullptr;
     int nBins = 0;
     int nBinsOffset = 0;
+    // Indices of the non-zero bins of panVals, so that only them need to
+    // be reset between target pixels.
+    int *panUsedBins = nullptr;
 
     // Only used with nAlgo = 2.
     float* pafRealVals = nullptr;
@@ -6020,6 +6023,7 @@ static void GWKAverageOrModeThread( void* pData)
     {
         // TODO check color table count > 256.
         if( poWK->eWorkingDataType == GDT_Byte ||
+            poWK->eWorkingDataType == GDT_Int8 ||
             poWK->eWorkingDataType == GDT_UInt16 ||
             poWK->eWorkingDataType == GDT_Int16 )
         {
@@ -6049,9 +6053,15 @@ static void GWKAverageOrModeThread( void* pData)
                 nBins = 65536;
             }
             panVals =
+                static_cast<int *>(VSI_CALLOC_VERBOSE(nBins, sizeof(int)));
+            panUsedBins =
                 static_cast<int *>(VSI_MALLOC_VERBOSE(nBins * sizeof(int)));
-            if( panVals == nullptr )
+            if( panVals == nullptr || panUsedBins == nullptr )
+            {
+                VSIFree(panVals);
+                VSIFree(panUsedBins);
                 return;
+            }
         }
         else
         {
@@ -6562,9 +6572,8 @@ static void GWKAverageOrModeThread( void* pData)
                     else // byte or int16.
                     {
                         int nMaxVal = 0;
-                        int iMaxInd = -1;
-
-                        memset(panVals, 0, nBins*sizeof(int));
+                        int iMaxInd = 0;
+                        int nUsedBins = 0;
 
                         for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
                         {
@@ -6586,18 +6595,32 @@ static void GWKAverageOrModeThread( void* pData)
                                 {
                                     const int nVal =
                                         static_cast<int>(dfValueRealTmp);
-                                    if( ++panVals[nVal+nBinsOffset] > nMaxVal )
+                                    const int iBin = nVal + nBinsOffset;
+                                    if( panVals[iBin] == 0 )
+                                        panUsedBins[nUsedBins++] = iBin;
+                                    if( ++panVals[iBin] > nMaxVal )
                                     {
                                         // Sum the density.
                                         // Is it the most common value so far?
                                         iMaxInd = nVal;
-                                        nMaxVal = panVals[nVal+nBinsOffset];
+                                        nMaxVal = panVals[iBin];
                                     }
                                 }
                             }
                         }
 
-                        if( iMaxInd != -1 )
+                        // Reset the histogram for the next target pixel.
+                        if( nUsedBins > nBins / 16 )
+                        {
+                            memset(panVals, 0, nBins*sizeof(int));
+                        }
+                        else
+                        {
+                            for( int i = 0; i < nUsedBins; ++i )
+                                panVals[panUsedBins[i]] = 0;
+                        }
+
+                        if( nMaxVal != 0 )
                         {
                             dfValueReal = iMaxInd;
 
@@ -6825,6 +6848,7 @@ static void GWKAverageOrModeThread( void* pData)
     CPLFree( pabSuccess );
     CPLFree( pabSuccess2 );
     VSIFree( panVals );
+    VSIFree( panUsedBins );
     VSIFree(pafRealVals);
     VSIFree(panRealSums);
     if (bIsComplex)
@@ -125,6 +125,9 @@ struct GDALInfoOptions
     /*! display the file list or the first file of the file list */
     int bShowFileList;
 
+    /*! report block cache statistics of the dataset */
+    int bShowBlockCacheStats;
+
     /*! report metadata for the specified domains. "all" can be used to report
         metadata in all domains.
         */
@@ -1691,6 +1694,43 @@ char *GDALInfo( GDALDatasetH hDataset, const GDALInfoOptions *psOptions )
         }
     }
 
+    if( psOptions->bShowBlockCacheStats )
+    {
+        GDALBlockCacheStatistics sStats;
+        GDALDatasetGetBlockCacheStatistics(hDataset, &sStats);
+        if( bJson )
+        {
+            json_object *poCacheStats = json_object_new_object();
+            json_object_object_add(poCacheStats, "hits",
+                                   json_object_new_int64(sStats.nHits));
+            json_object_object_add(poCacheStats, "misses",
+                                   json_object_new_int64(sStats.nMisses));
+            json_object_object_add(poCacheStats, "evictions",
+                                   json_object_new_int64(sStats.nEvictions));
+            json_object_object_add(poCacheStats, "dirtyBlockFlushes",
+                json_object_new_int64(sStats.nDirtyBlockFlushes));
+            json_object_object_add(poCacheStats, "residentBytes",
+                json_object_new_int64(sStats.nResidentBytes));
+            json_object_object_add(poCacheStats, "secondTierRecalls",
+                json_object_new_int64(sStats.nSecondTierRecalls));
+            json_object_object_add(poJsonObject, "blockCacheStatistics",
+                                   poCacheStats);
+        }
+        else
+        {
+            Concat(osStr, psOptions->bStdoutOutput,
+                   "Block Cache Statistics:\n"
+                   "  Hits=" CPL_FRMT_GIB ", Misses=" CPL_FRMT_GIB
+                   ", Evictions=" CPL_FRMT_GIB
+                   ", Dirty Block Flushes=" CPL_FRMT_GIB
+                   ", Resident Bytes=" CPL_FRMT_GIB
+                   ", Second Tier Recalls=" CPL_FRMT_GIB "\n",
+                   sStats.nHits, sStats.nMisses, sStats.nEvictions,
+                   sStats.nDirtyBlockFlushes, sStats.nResidentBytes,
+                   sStats.nSecondTierRecalls);
+        }
+    }
+
     if(bJson)
     {
         json_object_object_add(poJsonObject, "bands", poBands);
@@ -2120,6 +2160,7 @@ GDALInfoOptions *GDALInfoOptionsNew(
     psOptions->bShowColorTable = TRUE;
     psOptions->bListMDD = FALSE;
     psOptions->bShowFileList = TRUE;
+    psOptions->bShowBlockCacheStats = FALSE;
     psOptions->pszWKTFormat = CPLStrdup("WKT2");
 
 /* -------------------------------------------------------------------- */
@@ -2178,6 +2219,8 @@ GDALInfoOptions *GDALInfoOptionsNew(
         }
         else if( EQUAL(papszArgv[i], "-nofl") )
             psOptions->bShowFileList = FALSE;
+        else if( EQUAL(papszArgv[i], "-cachestats") )
+            psOptions->bShowBlockCacheStats = TRUE;
         else if( EQUAL(papszArgv[i], "-sd") && papszArgv[i+1] != nullptr )
         {
             i++;
@@ -1904,6 +1904,24 @@ def test_warp_mode_ties():
     assert out_ds.GetRasterBand(1).ReadAsArray()[0, 0] == 5
 
 
+###############################################################################
+# Test mode resampling on 8 and 16 bit integer data types, with negative values
+
+
+@pytest.mark.parametrize("dt", [gdal.GDT_Int8, gdal.GDT_Int16, gdal.GDT_UInt16])
+def test_warp_mode_histogram(dt):
+    numpy = pytest.importorskip("numpy")
+
+    val = 7 if dt == gdal.GDT_UInt16 else -1
+    src_ds = gdal.GetDriverByName("MEM").Create("", 4, 4, 1, dt)
+    src_ds.SetGeoTransform([1, 1, 0, 1, 0, 1])
+    src_ds.GetRasterBand(1).WriteArray(
+        numpy.array([[val, val, 3, 3], [val, 2, 3, 4], [0, 0, 3, 3], [1, 0, 4, 5]])
+    )
+    out_ds = gdal.Warp("", src_ds, format="MEM", resampleAlg="mode", xRes=2, yRes=2)
+    assert out_ds.GetRasterBand(1).ReadAsArray().tolist() == [[val, 3], [0, 3]]
+
+
 ###############################################################################
 # Test bugfix for #6526
 
@@ -4082,6 +4082,44 @@ namespace
         VSIFree(m2);
     }
 
+    // Test CPLMask byte mask conversions and intersection
+    TEST_F(test_cpl, CPLMaskBytes)
+    {
+        // Large enough to go through the 32-bit word fast paths, with a tail
+        constexpr std::size_t sz = 71;
+        std::vector<GByte> abyMask(sz, 1);
+        abyMask[0] = 0;
+        abyMask[31] = 0;
+        abyMask[32] = 0;
+        abyMask[70] = 0;
+
+        auto m = CPLMaskCreate(sz, true);
+        EXPECT_FALSE(CPLMaskClearFromBytes(m, abyMask.data(), sz));
+        for (std::size_t i = 0; i < sz; i++) {
+            EXPECT_EQ(CPLMaskGet(m, i), abyMask[i] != 0) << "bit " << i;
+        }
+
+        std::vector<GByte> abyExpanded(sz, 1);
+        CPLMaskExpandToBytes(m, abyExpanded.data(), sz);
+        for (std::size_t i = 0; i < sz; i++) {
+            EXPECT_EQ(abyExpanded[i], abyMask[i] ? 255 : 0) << "byte " << i;
+        }
+
+        auto m2 = CPLMaskCreate(sz, true);
+        EXPECT_TRUE(CPLMaskClearFromBytes(m2, abyExpanded.data() + 1, 30));
+
+        CPLMaskClear(m2, 5);
+        CPLMaskClear(m2, 64);
+        CPLMaskIntersect(m2, m, sz);
+        for (std::size_t i = 0; i < sz; i++) {
+            EXPECT_EQ(CPLMaskGet(m2, i),
+                      abyMask[i] != 0 && i != 5 && i != 64) << "bit " << i;
+        }
+
+        VSIFree(m);
+        VSIFree(m2);
+    }
+
     // Test cpl::ThreadSafeQueue
     TEST_F(test_cpl, ThreadSafeQueue)
     {
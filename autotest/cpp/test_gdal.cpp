@@ -36,6 +36,8 @@
 
 #include <limits>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "test_data.h"
 
@@ -2465,4 +2467,228 @@ namespace
         EXPECT_STREQ(CPLGetLastErrorMsg(), "foo: bar");
     }
 
+    // Test GDAL_OF_THREAD_SAFE
+    TEST_F(test_gdal, GDAL_OF_THREAD_SAFE)
+    {
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        EXPECT_EQ(GDALOpenEx(GCORE_DATA_DIR "rgbsmall.tif",
+                             GDAL_OF_RASTER | GDAL_OF_UPDATE |
+                                GDAL_OF_THREAD_SAFE,
+                             nullptr, nullptr, nullptr), nullptr);
+        EXPECT_EQ(GDALOpenEx(GCORE_DATA_DIR "rgbsmall.tif",
+                             GDAL_OF_VECTOR | GDAL_OF_THREAD_SAFE,
+                             nullptr, nullptr, nullptr), nullptr);
+        CPLPopErrorHandler();
+
+        int anRefChecksums[3] = { 0, 0, 0 };
+        {
+            GDALDatasetUniquePtr poRefDS(
+                GDALDataset::Open(GCORE_DATA_DIR "rgbsmall.tif"));
+            ASSERT_TRUE(poRefDS != nullptr);
+            for( int i = 0; i < 3; ++i )
+            {
+                anRefChecksums[i] = GDALChecksumImage(
+                    poRefDS->GetRasterBand(i + 1), 0, 0,
+                    poRefDS->GetRasterXSize(), poRefDS->GetRasterYSize());
+            }
+        }
+
+        GDALDatasetUniquePtr poDS(
+            GDALDataset::Open(GCORE_DATA_DIR "rgbsmall.tif",
+                              GDAL_OF_RASTER | GDAL_OF_THREAD_SAFE));
+        ASSERT_TRUE(poDS != nullptr);
+        ASSERT_EQ(poDS->GetRasterCount(), 3);
+        EXPECT_EQ(poDS->GetAccess(), GA_ReadOnly);
+        EXPECT_STREQ(poDS->GetDriver()->GetDescription(), "GTiff");
+        EXPECT_EQ(poDS->GetRasterBand(1)->GetMaskBand()->GetXSize(),
+                  poDS->GetRasterXSize());
+
+        std::vector<std::thread> aoThreads;
+        std::vector<int> anErrors(8);
+        for( int iThread = 0; iThread < 8; ++iThread )
+        {
+            aoThreads.emplace_back([&poDS, &anRefChecksums, &anErrors, iThread]()
+            {
+                for( int iIter = 0; iIter < 10; ++iIter )
+                {
+                    for( int i = 0; i < 3; ++i )
+                    {
+                        if( GDALChecksumImage(
+                                poDS->GetRasterBand(i + 1), 0, 0,
+                                poDS->GetRasterXSize(),
+                                poDS->GetRasterYSize()) != anRefChecksums[i] )
+                        {
+                            anErrors[iThread]++;
+                        }
+                    }
+                }
+            });
+        }
+        for( auto& oThread : aoThreads )
+            oThread.join();
+        for( int nErrors : anErrors )
+            EXPECT_EQ(nErrors, 0);
+
+        // Threads share the block cache of the bands: each block has been
+        // decoded once, and then found in the cache.
+        for( int i = 0; i < 3; ++i )
+        {
+            GDALRasterBand* poBand = poDS->GetRasterBand(i + 1);
+            int nBlockXSize = 0;
+            int nBlockYSize = 0;
+            poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+            const int nBlocks =
+                ((poBand->GetXSize() + nBlockXSize - 1) / nBlockXSize) *
+                ((poBand->GetYSize() + nBlockYSize - 1) / nBlockYSize);
+            GDALBlockCacheStatistics sStats;
+            poBand->GetBlockCacheStatistics(&sStats);
+            EXPECT_EQ(sStats.nMisses, nBlocks);
+            EXPECT_GT(sStats.nHits, 0);
+        }
+
+        // Mutating methods are rejected
+        double adfGT[6] = { 0, 1, 0, 0, 0, -1 };
+        GByte abyBuffer[1] = { 0 };
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        CPLErrorReset();
+        EXPECT_EQ(poDS->SetGeoTransform(adfGT), CE_Failure);
+        EXPECT_EQ(CPLGetLastErrorNo(), CPLE_NotSupported);
+        EXPECT_EQ(poDS->SetMetadataItem("FOO", "BAR"), CE_Failure);
+        EXPECT_EQ(poDS->GetRasterBand(1)->SetNoDataValue(0), CE_Failure);
+        EXPECT_EQ(poDS->GetRasterBand(1)->SetMetadata(nullptr), CE_Failure);
+        EXPECT_EQ(poDS->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, 1, 1,
+                                                   abyBuffer, 1, 1, GDT_Byte,
+                                                   0, 0, nullptr), CE_Failure);
+        CPLPopErrorHandler();
+        EXPECT_EQ(poDS->GetMetadataItem("FOO"), nullptr);
+    }
+
+    // Test GDALRasterBand::ComputeQuantiles()
+    TEST_F(test_gdal, ComputeQuantiles)
+    {
+        GDALDriver* poMEMDrv = GetGDALDriverManager()->GetDriverByName("MEM");
+        if( poMEMDrv == nullptr )
+        {
+            GTEST_SKIP() << "MEM driver missing";
+        }
+        const double adfProbabilities[] = { 0.0, 0.02, 0.5, 0.98, 1.0 };
+        double adfQuantiles[5] = { 0, 0, 0, 0, 0 };
+
+        // Exact quantiles of 1..100 (0 being nodata), using several
+        // threads and blocks.
+        {
+            GDALDatasetUniquePtr poDS(
+                poMEMDrv->Create("", 10, 11, 1, GDT_Byte, nullptr));
+            auto poBand = poDS->GetRasterBand(1);
+            std::vector<GByte> abyValues(10 * 11);
+            for( int i = 0; i < 100; ++i )
+                abyValues[i] = static_cast<GByte>(100 - i);
+            EXPECT_EQ(poBand->RasterIO(GF_Write, 0, 0, 10, 11,
+                                       abyValues.data(), 10, 11, GDT_Byte,
+                                       0, 0, nullptr), CE_None);
+            poBand->SetNoDataValue(0);
+            CPLSetConfigOption("GDAL_NUM_THREADS", "4");
+            EXPECT_EQ(poBand->ComputeQuantiles(FALSE, 5, adfProbabilities,
+                                               adfQuantiles,
+                                               nullptr, nullptr), CE_None);
+            CPLSetConfigOption("GDAL_NUM_THREADS", nullptr);
+            EXPECT_EQ(adfQuantiles[0], 1);
+            EXPECT_EQ(adfQuantiles[1], 2);
+            EXPECT_EQ(adfQuantiles[2], 50);
+            EXPECT_EQ(adfQuantiles[3], 98);
+            EXPECT_EQ(adfQuantiles[4], 100);
+            EXPECT_STREQ(poBand->GetMetadataItem("STATISTICS_QUANTILE_0.5"),
+                         "50");
+            EXPECT_EQ(poBand->GetMetadataItem(
+                "STATISTICS_QUANTILES_APPROXIMATE"), nullptr);
+        }
+
+        // Approximate quantiles of Float32 values, identical whatever the
+        // number of threads.
+        {
+            constexpr int nSize = 500;
+            GDALDatasetUniquePtr poDS(
+                poMEMDrv->Create("", nSize, nSize, 1, GDT_Float32, nullptr));
+            auto poBand = poDS->GetRasterBand(1);
+            std::vector<float> afValues(nSize * nSize);
+            for( int i = 0; i < nSize * nSize; ++i )
+                afValues[i] = static_cast<float>((i * 7919) % (nSize * nSize));
+            EXPECT_EQ(poBand->RasterIO(GF_Write, 0, 0, nSize, nSize,
+                                       afValues.data(), nSize, nSize,
+                                       GDT_Float32, 0, 0, nullptr), CE_None);
+            EXPECT_EQ(poBand->ComputeQuantiles(FALSE, 5, adfProbabilities,
+                                               adfQuantiles,
+                                               nullptr, nullptr), CE_None);
+            EXPECT_EQ(adfQuantiles[0], 0);
+            EXPECT_NEAR(adfQuantiles[1], 0.02 * nSize * nSize, 50);
+            EXPECT_NEAR(adfQuantiles[2], 0.5 * nSize * nSize, 500);
+            EXPECT_NEAR(adfQuantiles[3], 0.98 * nSize * nSize, 50);
+            EXPECT_EQ(adfQuantiles[4], nSize * nSize - 1);
+            EXPECT_STREQ(poBand->GetMetadataItem(
+                "STATISTICS_QUANTILES_APPROXIMATE"), "YES");
+
+            double adfQuantilesMT[5] = { 0, 0, 0, 0, 0 };
+            CPLSetConfigOption("GDAL_NUM_THREADS", "4");
+            EXPECT_EQ(poBand->ComputeQuantiles(FALSE, 5, adfProbabilities,
+                                               adfQuantilesMT,
+                                               nullptr, nullptr), CE_None);
+            CPLSetConfigOption("GDAL_NUM_THREADS", nullptr);
+            for( int i = 0; i < 5; ++i )
+                EXPECT_EQ(adfQuantiles[i], adfQuantilesMT[i]);
+        }
+    }
+
+    // Test the pipelined GDALDatasetCopyWholeRaster() with a data type
+    // conversion done by worker threads
+    TEST_F(test_gdal, GDALDatasetCopyWholeRaster_pipelined_conversion)
+    {
+        GDALDriver* poMEMDrv = GetGDALDriverManager()->GetDriverByName("MEM");
+        if( poMEMDrv == nullptr )
+        {
+            GTEST_SKIP() << "MEM driver missing";
+        }
+        constexpr int nXSize = 500;
+        constexpr int nYSize = 400;
+        constexpr int nBands = 3;
+        GDALDatasetUniquePtr poSrcDS(
+            poMEMDrv->Create("", nXSize, nYSize, nBands, GDT_Byte, nullptr));
+        std::vector<GByte> abySrc(nXSize * nYSize * nBands);
+        for( size_t i = 0; i < abySrc.size(); ++i )
+            abySrc[i] = static_cast<GByte>((i * 37) % 251);
+        ASSERT_EQ(poSrcDS->RasterIO(GF_Write, 0, 0, nXSize, nYSize,
+                                    abySrc.data(), nXSize, nYSize, GDT_Byte,
+                                    nBands, nullptr, 0, 0, 0, nullptr),
+                  CE_None);
+        std::vector<float> afExpected(abySrc.size());
+        ASSERT_EQ(poSrcDS->RasterIO(GF_Read, 0, 0, nXSize, nYSize,
+                                    afExpected.data(), nXSize, nYSize,
+                                    GDT_Float32, nBands, nullptr,
+                                    0, 0, 0, nullptr), CE_None);
+
+        for( const char* pszInterleave: { "BAND", "PIXEL" } )
+        {
+            GDALDatasetUniquePtr poDstDS(
+                poMEMDrv->Create("", nXSize, nYSize, nBands, GDT_Float32,
+                                 nullptr));
+            const char* const apszOptions[] = {
+                pszInterleave[0] == 'P' ? "INTERLEAVE=PIXEL" : "INTERLEAVE=BAND",
+                nullptr };
+            CPLSetConfigOption("GDAL_NUM_THREADS", "4");
+            CPLSetConfigOption("GDAL_SWATH_SIZE", "10000");
+            EXPECT_EQ(GDALDatasetCopyWholeRaster(
+                          GDALDataset::ToHandle(poSrcDS.get()),
+                          GDALDataset::ToHandle(poDstDS.get()),
+                          apszOptions, nullptr, nullptr), CE_None);
+            CPLSetConfigOption("GDAL_SWATH_SIZE", nullptr);
+            CPLSetConfigOption("GDAL_NUM_THREADS", nullptr);
+
+            std::vector<float> afGot(abySrc.size());
+            ASSERT_EQ(poDstDS->RasterIO(GF_Read, 0, 0, nXSize, nYSize,
+                                        afGot.data(), nXSize, nYSize,
+                                        GDT_Float32, nBands, nullptr,
+                                        0, 0, 0, nullptr), CE_None);
+            EXPECT_TRUE(afGot == afExpected) << pszInterleave;
+        }
+    }
+
 } // namespace
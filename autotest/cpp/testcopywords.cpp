@@ -30,7 +30,10 @@
 #include "cpl_conv.h"
 #include "gdal.h"
 
+#include <climits>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #include "gtest_include.h"
 
@@ -710,6 +713,84 @@ template<> void CheckPacked<GUInt16,GInt16>(GDALDataType eIn, GDALDataType eOut)
     }
 }
 
+// Check that packed conversions of values requiring rounding, clamping or
+// NaN handling give the same results as word-per-word conversions.
+template<class Tin, class Tout>
+void CheckPackedAgainstUnpacked(GDALDataType eIn, GDALDataType eOut,
+                                const std::vector<double>& adfValues)
+{
+    const int N = 64+7;
+    Tin arrayIn[N];
+    Tout arrayOut[N];
+    for(int i=0;i<N;i++)
+    {
+        arrayIn[i] = static_cast<Tin>(adfValues[i % adfValues.size()]);
+        arrayOut[i] = 0;
+    }
+    GDALCopyWords(arrayIn, eIn, GDALGetDataTypeSizeBytes(eIn),
+                  arrayOut, eOut, GDALGetDataTypeSizeBytes(eOut),
+                  N);
+    for(int i=0;i<N;i++)
+    {
+        Tout expected = 0;
+        GDALCopyWords(&arrayIn[i], eIn, 0, &expected, eOut, 0, 1);
+        if( expected != expected )
+            EXPECT_TRUE( arrayOut[i] != arrayOut[i] ) << i;
+        else
+            EXPECT_EQ( arrayOut[i], expected ) << i << " " << arrayIn[i];
+    }
+}
+
+static std::vector<double> GetRealValuesToRound()
+{
+    return { std::numeric_limits<double>::quiet_NaN(), -0.5, 0.5, 1.5, -1.5,
+             0.49, -0.49, 254.5, 255.5, 256, -32768.5, -32767.5, 32766.5,
+             32767.5, 65534.5, 65535.5, 1e10, -1e10,
+             std::numeric_limits<double>::infinity(),
+             -std::numeric_limits<double>::infinity() };
+}
+
+template<> void CheckPacked<float,GByte>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<float,GByte>(eIn, eOut);
+    CheckPackedAgainstUnpacked<float,GByte>(eIn, eOut, GetRealValuesToRound());
+}
+
+template<> void CheckPacked<float,GInt16>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<float,GInt16>(eIn, eOut);
+    CheckPackedAgainstUnpacked<float,GInt16>(eIn, eOut, GetRealValuesToRound());
+}
+
+template<> void CheckPacked<float,GUInt16>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<float,GUInt16>(eIn, eOut);
+    CheckPackedAgainstUnpacked<float,GUInt16>(eIn, eOut, GetRealValuesToRound());
+}
+
+template<> void CheckPacked<double,GInt16>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<double,GInt16>(eIn, eOut);
+    CheckPackedAgainstUnpacked<double,GInt16>(eIn, eOut, GetRealValuesToRound());
+}
+
+template<> void CheckPacked<double,float>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<double,float>(eIn, eOut);
+    std::vector<double> adfValues(GetRealValuesToRound());
+    adfValues.push_back(std::numeric_limits<float>::max());
+    adfValues.push_back(-static_cast<double>(std::numeric_limits<float>::max()) * 1.0000001);
+    adfValues.push_back(1e300);
+    CheckPackedAgainstUnpacked<double,float>(eIn, eOut, adfValues);
+}
+
+template<> void CheckPacked<GInt32,GUInt16>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<GInt32,GUInt16>(eIn, eOut);
+    CheckPackedAgainstUnpacked<GInt32,GUInt16>(eIn, eOut,
+        { -100000, -1, 0, 1, 65535, 65536, 100000, INT_MIN, INT_MAX });
+}
+
 template<class Tin>
 void CheckPacked(GDALDataType eIn, GDALDataType eOut)
 {
@@ -788,6 +869,123 @@ INSTANTIATE_TEST_SUITE_P(
         }
 );
 
+// Float64 to integer conversions of values requiring rounding, clamping or
+// NaN handling, with their expected results as Byte, UInt16 and Int32.
+struct Float64ToIntCase
+{
+    double dfValue;
+    int    nByte;
+    int    nUInt16;
+    int    nInt32;
+};
+
+static const Float64ToIntCase asFloat64ToIntCases[] =
+{
+    { std::numeric_limits<double>::quiet_NaN(), 0, 0, 0 },
+    { std::numeric_limits<double>::infinity(), 255, 65535, INT_MAX },
+    { -std::numeric_limits<double>::infinity(), 0, 0, INT_MIN },
+    { -0.0, 0, 0, 0 },
+    { 0.0, 0, 0, 0 },
+    { 0.5, 1, 1, 1 },
+    { -0.5, 0, 0, -1 },
+    { 1.5, 2, 2, 2 },
+    { -1.5, 0, 0, -2 },
+    { 2.5, 3, 3, 3 },
+    { -2.5, 0, 0, -3 },
+    // Largest double below 0.5: adding 0.5 rounds to 1.
+    { 0.49999999999999994, 1, 1, 1 },
+    { 254.5, 255, 255, 255 },
+    { 255.5, 255, 256, 256 },
+    { 65534.5, 255, 65535, 65535 },
+    { 65535.5, 255, 65535, 65536 },
+    { 2147483646.5, 255, 65535, INT_MAX },
+    { 2147483647.5, 255, 65535, INT_MAX },
+    { -2147483647.5, 0, 0, INT_MIN },
+    { -2147483648.5, 0, 0, INT_MIN },
+    { 1e300, 255, 65535, INT_MAX },
+    { -1e300, 0, 0, INT_MIN },
+    { 1e-300, 0, 0, 0 },
+    { -1e-300, 0, 0, 0 },
+};
+
+static int GetExpected(const Float64ToIntCase& sCase, GDALDataType eOut)
+{
+    switch( eOut )
+    {
+        case GDT_Byte: return sCase.nByte;
+        case GDT_UInt16: return sCase.nUInt16;
+        default: return sCase.nInt32;
+    }
+}
+
+// Check packed conversions, which go through the AVX2 kernels when available,
+// against the expected values, against packed conversions with
+// GDAL_USE_AVX2=NO (only honoured in DEBUG builds) and against word-per-word
+// conversions, which are never vectorized. Each value is put at every position
+// of the vectors and of the scalar tail.
+template<class Tout>
+void CheckFloat64ToIntEdgeValues(GDALDataType eOut)
+{
+    const int N = 64+7;
+    const int nCases = static_cast<int>(CPL_ARRAYSIZE(asFloat64ToIntCases));
+    for( int iShift = 0; iShift < nCases; iShift++ )
+    {
+        double adfIn[N];
+        for( int i = 0; i < N; i++ )
+            adfIn[i] = asFloat64ToIntCases[(i + iShift) % nCases].dfValue;
+
+        Tout arrayOut[N] = {};
+        GDALCopyWords(adfIn, GDT_Float64, sizeof(double),
+                      arrayOut, eOut, sizeof(Tout), N);
+
+        Tout arrayOutNoAVX2[N] = {};
+        CPLSetConfigOption("GDAL_USE_AVX2", "NO");
+        GDALCopyWords(adfIn, GDT_Float64, sizeof(double),
+                      arrayOutNoAVX2, eOut, sizeof(Tout), N);
+        CPLSetConfigOption("GDAL_USE_AVX2", nullptr);
+
+        for( int i = 0; i < N; i++ )
+        {
+            const auto& sCase = asFloat64ToIntCases[(i + iShift) % nCases];
+            Tout nWordPerWord = 0;
+            GDALCopyWords(&adfIn[i], GDT_Float64, 0,
+                          &nWordPerWord, eOut, 0, 1);
+            EXPECT_EQ( static_cast<int>(arrayOut[i]),
+                       GetExpected(sCase, eOut) ) << i << " " << adfIn[i];
+            EXPECT_EQ( arrayOut[i], arrayOutNoAVX2[i] ) << i << " " << adfIn[i];
+            EXPECT_EQ( arrayOut[i], nWordPerWord ) << i << " " << adfIn[i];
+        }
+    }
+}
+
+class TestCopyWordsFloat64ToIntFixture :
+        public TestCopyWords,
+        public ::testing::WithParamInterface<GDALDataType>
+{
+};
+
+TEST_P(TestCopyWordsFloat64ToIntFixture, EdgeValues)
+{
+    const GDALDataType eOut = GetParam();
+    switch( eOut )
+    {
+        case GDT_Byte: CheckFloat64ToIntEdgeValues<GByte>(eOut); break;
+        case GDT_UInt16: CheckFloat64ToIntEdgeValues<GUInt16>(eOut); break;
+        case GDT_Int32: CheckFloat64ToIntEdgeValues<GInt32>(eOut); break;
+        default:
+            CPLAssert(false);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        TestCopyWords,
+        TestCopyWordsFloat64ToIntFixture,
+        ::testing::Values(GDT_Byte, GDT_UInt16, GDT_Int32),
+        [](const ::testing::TestParamInfo<TestCopyWordsFloat64ToIntFixture::ParamType>& l_info) {
+            return std::string("Float64_") + GDALGetDataTypeName(l_info.param);
+        }
+);
+
 TEST_F(TestCopyWords, ByteToByte)
 {
     for(int k=0;k<2;k++)
@@ -29,16 +29,20 @@
 ###############################################################################
 
 
+import gdaltest
+
 from osgeo import gdal
 
 ###############################################################################
-# Test AsyncReader interface on the default (synchronous) implementation
+# Test AsyncReader interface on the default synchronous implementation
 
 
 def test_asyncreader_1():
 
     ds = gdal.Open("data/rgbsmall.tif")
-    asyncreader = ds.BeginAsyncReader(0, 0, ds.RasterXSize, ds.RasterYSize)
+    asyncreader = ds.BeginAsyncReader(
+        0, 0, ds.RasterXSize, ds.RasterYSize, options=["ASYNC=NO"]
+    )
     buf = asyncreader.GetBuffer()
     result = asyncreader.GetNextUpdatedRegion(0)
     assert result == [
@@ -67,3 +71,100 @@ def test_asyncreader_1():
         assert csum == expected_cs[i], "did not get expected checksum for band %d" % (
             i + 1
         )
+
+
+###############################################################################
+# Test AsyncReader interface on a regular read-only dataset, where the default
+# implementation runs requests in the global thread pool on private handles
+
+
+def test_asyncreader_private_handle():
+
+    ds = gdal.Open("data/rgbsmall.tif")
+
+    expected = ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+
+    asyncreaders = [
+        ds.BeginAsyncReader(0, 0, ds.RasterXSize, ds.RasterYSize) for i in range(8)
+    ]
+    # The caller can keep using its handle while the requests run
+    assert ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize) == expected
+    for asyncreader in asyncreaders:
+        result = asyncreader.GetNextUpdatedRegion(-1)
+        assert result == [
+            gdal.GARIO_COMPLETE,
+            0,
+            0,
+            ds.RasterXSize,
+            ds.RasterYSize,
+        ], "wrong return values for GetNextUpdatedRegion()"
+        assert bytes(asyncreader.GetBuffer()) == expected
+        ds.EndAsyncReader(asyncreader)
+    asyncreaders = None
+
+
+###############################################################################
+# Test AsyncReader interface on a dataset that cannot be re-opened, where
+# the request is run synchronously by GetNextUpdatedRegion()
+
+
+def test_asyncreader_no_private_handle():
+
+    src_ds = gdal.Open("data/rgbsmall.tif")
+    ds = gdal.GetDriverByName("MEM").CreateCopy("", src_ds)
+    expected = src_ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+
+    asyncreader = ds.BeginAsyncReader(0, 0, ds.RasterXSize, ds.RasterYSize)
+    result = asyncreader.GetNextUpdatedRegion(-1)
+    assert result[0] == gdal.GARIO_COMPLETE
+    assert bytes(asyncreader.GetBuffer()) == expected
+    ds.EndAsyncReader(asyncreader)
+
+
+###############################################################################
+# Test AsyncReader interface on a dataset opened with GDAL_OF_THREAD_SAFE,
+# where the default implementation runs requests in the global thread pool
+
+
+def test_asyncreader_thread_safe():
+
+    ds = gdal.OpenEx("data/rgbsmall.tif", gdal.OF_RASTER | gdal.OF_THREAD_SAFE)
+    assert ds is not None
+
+    expected = ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+
+    asyncreaders = [
+        ds.BeginAsyncReader(0, 0, ds.RasterXSize, ds.RasterYSize) for i in range(8)
+    ]
+    for asyncreader in asyncreaders:
+        result = asyncreader.GetNextUpdatedRegion(-1)
+        assert result == [
+            gdal.GARIO_COMPLETE,
+            0,
+            0,
+            ds.RasterXSize,
+            ds.RasterYSize,
+        ], "wrong return values for GetNextUpdatedRegion()"
+        assert bytes(asyncreader.GetBuffer()) == expected
+        ds.EndAsyncReader(asyncreader)
+    asyncreaders = None
+
+
+###############################################################################
+# Test that errors emitted by a request run in the global thread pool are
+# re-emitted in the thread of the caller
+
+
+def test_asyncreader_thread_safe_error():
+
+    ds = gdal.OpenEx("data/byte_truncated.tif", gdal.OF_RASTER | gdal.OF_THREAD_SAFE)
+    assert ds is not None
+
+    asyncreader = ds.BeginAsyncReader(0, 0, ds.RasterXSize, ds.RasterYSize)
+    gdal.ErrorReset()
+    with gdaltest.error_handler():
+        result = asyncreader.GetNextUpdatedRegion(-1)
+    assert result[0] == gdal.GARIO_ERROR
+    assert gdal.GetLastErrorType() == gdal.CE_Failure
+    assert gdal.GetLastErrorMsg() != ""
+    ds.EndAsyncReader(asyncreader)
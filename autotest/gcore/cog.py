@@ -29,6 +29,7 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import os
 import struct
 import sys
 
@@ -383,6 +384,127 @@ def test_cog_creation_of_overviews_with_mask():
     gdal.Unlink(directory)
 
 
+###############################################################################
+# Test that temporary overview files are created in memory when they fit
+# within COG_TMP_MAX_MEMORY
+
+
+@pytest.mark.parametrize("max_memory,expect_tmp_on_disk", [(None, False), ("0", True)])
+def test_cog_tmp_overview_files_in_memory(tmp_path, max_memory, expect_tmp_on_disk):
+
+    filename = str(tmp_path / "cog.tif")
+    src_ds = gdal.Translate("", "data/byte.tif", options="-of MEM -outsize 2048 2048")
+    src_ds.CreateMaskBand(gdal.GMF_PER_DATASET)
+    src_ds.GetRasterBand(1).GetMaskBand().Fill(255)
+
+    seen_tmp_files = set()
+
+    def my_cbk(pct, _, arg):
+        for ext in (".ovr.tmp", ".msk.ovr.tmp"):
+            if gdal.VSIStatL(filename + ext) is not None:
+                seen_tmp_files.add(ext)
+        return 1
+
+    with gdaltest.config_option("COG_TMP_MAX_MEMORY", max_memory):
+        ds = gdal.GetDriverByName("COG").CreateCopy(filename, src_ds, callback=my_cbk)
+    assert ds
+    assert ds.GetRasterBand(1).GetOverviewCount() == 2
+    ds = None
+    assert bool(seen_tmp_files) == expect_tmp_on_disk
+    assert len(os.listdir(tmp_path)) == 1  # check that temp files have gone away
+
+    ds = gdal.Open(filename)
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+    ds = None
+    _check_cog(filename)
+
+
+###############################################################################
+# Test writing to a file system that only supports sequential writing
+
+
+def test_cog_sequential_write_output():
+
+    filename = "/vsigzip//vsimem/test_cog_sequential_write_output.tif.gz"
+    src_ds = gdal.Translate("", "data/byte.tif", options="-of MEM -outsize 2048 2048")
+
+    tab = [0]
+
+    def my_cbk(pct, _, arg):
+        assert pct >= tab[0]
+        tab[0] = pct
+        return 1
+
+    ds = gdal.GetDriverByName("COG").CreateCopy(
+        filename, src_ds, callback=my_cbk, callback_data=tab
+    )
+    assert tab[0] == 1.0
+    assert ds
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+    assert ds.GetRasterBand(1).GetOverviewCount() == 2
+    assert ds.GetRasterBand(1).GetBlockSize() == [512, 512]
+    ds = None
+
+    gdal.Unlink("/vsimem/test_cog_sequential_write_output.tif.gz")
+
+
+###############################################################################
+# Test writing to a file system that cannot be read back
+
+
+def test_cog_write_only_output():
+
+    filename = "/vsimem/test_cog_write_only_output.tif"
+    src_ds = gdal.Translate("", "data/byte.tif", options="-of MEM -outsize 1024 1024")
+
+    ds = gdal.GetDriverByName("COG").CreateCopy(
+        "/vsistdout_redirect/" + filename, src_ds
+    )
+    assert ds
+    assert ds.GetDescription() == "/vsistdout_redirect/" + filename
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+    assert ds.GetRasterBand(1).GetOverviewCount() == 1
+    ds = None
+
+    ds = gdal.Open(filename)
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+    ds = None
+    _check_cog(filename)
+
+    gdal.Unlink(filename)
+
+
+###############################################################################
+# Test writing to a file system that cannot be read back, with temporary
+# files that do not fit in memory
+
+
+def test_cog_write_only_output_tmp_files_on_disk():
+
+    dirname = "/vsimem/test_cog_write_only_output_tmp_files_on_disk"
+    filename = dirname + "/out.tif"
+    src_ds = gdal.Translate("", "data/byte.tif", options="-of MEM -outsize 1024 1024")
+
+    with gdaltest.config_option("COG_TMP_MAX_MEMORY", "0"):
+        ds = gdal.GetDriverByName("COG").CreateCopy(
+            "/vsistdout_redirect/" + filename, src_ds
+        )
+    assert ds
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+    ds = None
+
+    # Temporary files are not created next to the destination
+    assert gdal.ReadDir(dirname) == ["out.tif"]
+
+    ds = gdal.Open(filename)
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+    assert ds.GetRasterBand(1).GetOverviewCount() == 1
+    ds = None
+    _check_cog(filename)
+
+    gdal.Unlink(filename)
+
+
 ###############################################################################
 # Test full world reprojection to WebMercator
 
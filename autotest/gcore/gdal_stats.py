@@ -905,3 +905,194 @@ def test_stats_computeminmax(datatype, minval, maxval, nodata):
         buf_ysize=1,
     )
     assert ds.GetRasterBand(1).ComputeRasterMinMax(0) == (expected_minval, maxval)
+
+
+###############################################################################
+# Test the optimized statistics and min/max computation code paths, in
+# single and multi-threaded mode, against a Python computation
+
+
+@pytest.mark.parametrize(
+    "datatype,struct_frmt",
+    [
+        (gdal.GDT_Int16, "h"),
+        (gdal.GDT_Int32, "i"),
+        (gdal.GDT_Float32, "f"),
+        (gdal.GDT_Float64, "d"),
+    ],
+)
+@pytest.mark.parametrize("nodata", [None, 8])
+@pytest.mark.parametrize("num_threads", [None, "4"])
+def test_stats_optimized_types(datatype, struct_frmt, nodata, num_threads):
+
+    width = 123
+    height = 45
+    values = [((i * 37) % 1001) - 500 for i in range(width * height)]
+    if struct_frmt in ("f", "d"):
+        values = [
+            float("nan") if (v % 3) == 0 else v + 0.25 if (v % 3) == 1 else v
+            for v in values
+        ]
+
+    filename = "/vsimem/test_stats_optimized_types.tif"
+    ds = gdal.GetDriverByName("GTiff").Create(
+        filename,
+        width,
+        height,
+        1,
+        datatype,
+        options=["TILED=YES", "BLOCKXSIZE=32", "BLOCKYSIZE=16"],
+    )
+    if nodata is not None:
+        ds.GetRasterBand(1).SetNoDataValue(nodata)
+    ds.GetRasterBand(1).WriteRaster(
+        0, 0, width, height, struct.pack(struct_frmt * len(values), *values)
+    )
+    ds = None
+
+    valid = [v for v in values if not math.isnan(v) and v != nodata]
+    expected_mean = sum(valid) / len(valid)
+    expected_stddev = math.sqrt(
+        sum((v - expected_mean) ** 2 for v in valid) / len(valid)
+    )
+
+    try:
+        with gdaltest.config_option("GDAL_NUM_THREADS", num_threads):
+            ds = gdal.Open(filename)
+            stats = ds.GetRasterBand(1).ComputeStatistics(False)
+            minmax = ds.GetRasterBand(1).ComputeRasterMinMax(False)
+            ds = None
+    finally:
+        gdal.GetDriverByName("GTiff").Delete(filename)
+
+    assert stats[0] == min(valid)
+    assert stats[1] == max(valid)
+    assert stats[2] == pytest.approx(expected_mean, rel=1e-12)
+    assert stats[3] == pytest.approx(expected_stddev, rel=1e-12)
+    assert minmax == (min(valid), max(valid))
+
+
+###############################################################################
+# Test GDAL_STATISTICS_ON_WRITE=YES
+
+
+@pytest.mark.parametrize(
+    "datatype,struct_frmt,nodata",
+    [
+        (gdal.GDT_Byte, "B", None),
+        (gdal.GDT_Int16, "h", 8),
+        (gdal.GDT_Float32, "f", None),
+    ],
+)
+def test_stats_on_write(datatype, struct_frmt, nodata):
+
+    width = 123
+    height = 45
+    nbands = 3
+    filename = "/vsimem/test_stats_on_write.tif"
+    try:
+        with gdaltest.config_option("GDAL_STATISTICS_ON_WRITE", "YES"):
+            ds = gdal.GetDriverByName("GTiff").Create(
+                filename,
+                width,
+                height,
+                nbands,
+                datatype,
+                options=["TILED=YES", "BLOCKXSIZE=32", "BLOCKYSIZE=16"],
+            )
+            for i in range(nbands):
+                band = ds.GetRasterBand(i + 1)
+                if nodata is not None:
+                    band.SetNoDataValue(nodata)
+                values = [(j * (37 + i)) % 251 for j in range(width * height)]
+                band.WriteRaster(
+                    0, 0, width, height, struct.pack(struct_frmt * len(values), *values)
+                )
+            ds = None
+
+        ds = gdal.Open(filename)
+        for i in range(nbands):
+            band = ds.GetRasterBand(i + 1)
+            md = band.GetMetadata()
+            assert "STATISTICS_MEAN" in md
+            assert "STATISTICS_APPROXIMATE" not in md
+            stats = [
+                float(md["STATISTICS_MINIMUM"]),
+                float(md["STATISTICS_MAXIMUM"]),
+                float(md["STATISTICS_MEAN"]),
+                float(md["STATISTICS_STDDEV"]),
+            ]
+            expected_stats = band.ComputeStatistics(False)
+            assert stats == pytest.approx(expected_stats, rel=1e-10)
+            if datatype == gdal.GDT_Byte:
+                hist = band.GetDefaultHistogram(force=False)
+                assert hist is not None
+                assert hist[3] == band.GetHistogram(-0.5, 255.5, 256, False, False)
+        ds = None
+    finally:
+        gdal.GetDriverByName("GTiff").Delete(filename)
+
+
+def test_stats_on_write_partial():
+
+    filename = "/vsimem/test_stats_on_write_partial.tif"
+    try:
+        with gdaltest.config_option("GDAL_STATISTICS_ON_WRITE", "YES"):
+            ds = gdal.GetDriverByName("GTiff").Create(
+                filename,
+                64,
+                64,
+                1,
+                options=["TILED=YES", "BLOCKXSIZE=32", "BLOCKYSIZE=32"],
+            )
+            ds.GetRasterBand(1).WriteRaster(0, 0, 32, 32, b"\x01" * (32 * 32))
+            ds = None
+
+        ds = gdal.Open(filename)
+        assert ds.GetRasterBand(1).GetMetadataItem("STATISTICS_MEAN") is None
+        ds = None
+    finally:
+        gdal.GetDriverByName("GTiff").Delete(filename)
+
+
+def test_stats_on_write_nodata_changed_after_write():
+
+    filename = "/vsimem/test_stats_on_write_nodata_changed_after_write.tif"
+    try:
+        with gdaltest.config_option("GDAL_STATISTICS_ON_WRITE", "YES"):
+            ds = gdal.GetDriverByName("GTiff").Create(filename, 16, 16, 1)
+            ds.GetRasterBand(1).WriteRaster(0, 0, 16, 16, b"\x01" * (16 * 16))
+            ds.GetRasterBand(1).SetNoDataValue(1)
+            ds = None
+
+        ds = gdal.Open(filename)
+        assert ds.GetRasterBand(1).GetMetadataItem("STATISTICS_MEAN") is None
+        ds = None
+    finally:
+        gdal.GetDriverByName("GTiff").Delete(filename)
+
+
+###############################################################################
+# Test ComputeQuantiles()
+
+
+@pytest.mark.parametrize("num_threads", ["1", "ALL_CPUS"])
+def test_stats_compute_quantiles(num_threads):
+
+    ds = gdal.GetDriverByName("MEM").Create("", 100, 100, 1, gdal.GDT_UInt16)
+    values = [j % 1000 for j in range(100 * 100)]
+    ds.GetRasterBand(1).WriteRaster(
+        0, 0, 100, 100, struct.pack("H" * len(values), *values)
+    )
+    band = ds.GetRasterBand(1)
+    with gdaltest.config_option("GDAL_NUM_THREADS", num_threads):
+        assert band.ComputeQuantiles(False, [0.02, 0.5, 0.98]) == [19, 499, 979]
+    assert band.GetMetadataItem("STATISTICS_QUANTILE_0.5") == "499"
+    assert band.GetMetadataItem("STATISTICS_QUANTILES_APPROXIMATE") is None
+
+    # Quantiles already computed are reused
+    band.SetMetadataItem("STATISTICS_QUANTILE_0.5", "500")
+    assert band.ComputeQuantiles(False, [0.5]) == [500]
+
+    with gdaltest.error_handler():
+        assert band.ComputeQuantiles(False, [1.5]) is None
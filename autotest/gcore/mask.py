@@ -1027,3 +1027,39 @@ def test_mask_setting_nodata(dt):
     assert ds.GetRasterBand(1).GetMaskBand().ReadRaster() == struct.pack("B", 0)
     ds.GetRasterBand(1).DeleteNoDataValue()
     assert ds.GetRasterBand(1).GetMaskBand().ReadRaster() == struct.pack("B", 255)
+
+
+###############################################################################
+# Test nodata masks over widths that are not a multiple of the 32-pixel
+# words of the packed mask kernels, with a pixel spacing != 1 too.
+
+
+@pytest.mark.parametrize(
+    "dt,fmt,nodata",
+    [
+        (gdal.GDT_Byte, "B", 7),
+        (gdal.GDT_Int16, "h", -7),
+        (gdal.GDT_UInt16, "H", 65535),
+        (gdal.GDT_Int32, "i", -7),
+        (gdal.GDT_Float32, "f", 1.5),
+        (gdal.GDT_Float32, "f", float("nan")),
+        (gdal.GDT_Float64, "d", float("nan")),
+    ],
+)
+def test_mask_nodata_packed_kernels(dt, fmt, nodata):
+
+    width = 71
+    ds = gdal.GetDriverByName("MEM").Create("", width, 2, 1, dt)
+    values = [nodata if (i % 3 == 0 or i == 63) else 2 for i in range(width * 2)]
+    ds.GetRasterBand(1).WriteRaster(
+        0, 0, width, 2, struct.pack(fmt * (width * 2), *values)
+    )
+    ds.GetRasterBand(1).SetNoDataValue(nodata)
+
+    expected = [0 if (i % 3 == 0 or i == 63) else 255 for i in range(width * 2)]
+    msk = ds.GetRasterBand(1).GetMaskBand()
+    assert struct.unpack("B" * (width * 2), msk.ReadRaster()) == tuple(expected)
+
+    # Non-contiguous Byte buffer
+    got = msk.ReadRaster(buf_type=gdal.GDT_Byte, buf_pixel_space=2)
+    assert struct.unpack("B" * (width * 4), got)[::2] == tuple(expected)
@@ -29,8 +29,11 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import json
 import math
+import os
 import struct
+import subprocess
 import sys
 
 import gdaltest
@@ -2998,3 +3001,354 @@ def test_rasterio_readraster_in_existing_buffer_alignment_issues(datatype):
             band.ReadBlock(0, 0, buf_obj=memoryview(bytearray([0] * (2 * 8 + 1)))[1:])
             is None
         )
+
+
+###############################################################################
+# Test that sequential reads with GDAL_BLOCK_PREFETCH return the same data
+
+
+def test_rasterio_block_prefetch():
+
+    src_ds = gdal.Open("data/byte.tif")
+    filename = "/vsimem/test_rasterio_block_prefetch.tif"
+    gdal.Translate(
+        filename,
+        src_ds,
+        options="-outsize 256 256 -co TILED=YES -co BLOCKXSIZE=16 -co BLOCKYSIZE=16",
+    )
+
+    ds = gdal.Open(filename)
+    expected = [ds.ReadRaster(0, y, 256, 1) for y in range(256)]
+    ds = None
+
+    with gdaltest.config_option("GDAL_BLOCK_PREFETCH", "8"):
+        ds = gdal.Open(filename)
+        band = ds.GetRasterBand(1)
+        for y in range(256):
+            assert band.ReadRaster(0, y, 256, 1) == expected[y], y
+
+        # Non sequential access
+        assert band.ReadBlock(3, 2) == band.ReadBlock(3, 2)
+
+        # Check that blocks have been served by the prefetcher
+        debug_msgs = []
+
+        def handler(eErrClass, err_no, msg):
+            if eErrClass == gdal.CE_Debug:
+                debug_msgs.append(msg)
+
+        gdal.PushErrorHandler(handler)
+        gdal.SetCurrentErrorHandlerCatchDebug(True)
+        with gdaltest.config_option("CPL_DEBUG", "ON"):
+            band.FlushCache()
+        gdal.PopErrorHandler()
+        assert [
+            msg for msg in debug_msgs if "blocks read from prefetched buffers" in msg
+        ], debug_msgs
+
+        for y in range(255, -1, -1):
+            assert band.ReadRaster(0, y, 256, 1) == expected[y], y
+        ds = None
+
+    gdal.Unlink(filename)
+
+
+###############################################################################
+# Test the default AdviseRead() implementation that reads blocks in the
+# background when GDAL_NUM_THREADS is set
+
+
+def test_rasterio_advise_read_warm_cache():
+
+    src_ds = gdal.Open("data/byte.tif")
+    filename = "/vsimem/test_rasterio_advise_read_warm_cache.tif"
+    ds = gdal.Translate(
+        filename,
+        src_ds,
+        options="-outsize 256 256 -co TILED=YES -co BLOCKXSIZE=16 -co BLOCKYSIZE=16",
+    )
+    ds.BuildOverviews("AVERAGE", [2])
+    ds = None
+
+    ds = gdal.Open(filename)
+    expected = ds.ReadRaster(16, 32, 200, 100)
+    expected_ovr = ds.ReadRaster(16, 32, 200, 100, 100, 50)
+    expected_full = ds.ReadRaster()
+    ds = None
+
+    debug_msgs = []
+
+    def handler(eErrClass, err_no, msg):
+        if eErrClass == gdal.CE_Debug:
+            debug_msgs.append(msg)
+
+    def flush_and_get_recalled_blocks(band):
+        del debug_msgs[:]
+        gdal.PushErrorHandler(handler)
+        gdal.SetCurrentErrorHandlerCatchDebug(True)
+        with gdaltest.config_option("CPL_DEBUG", "ON"):
+            band.FlushCache()
+        gdal.PopErrorHandler()
+        for msg in debug_msgs:
+            if "blocks read from prefetched buffers" in msg:
+                return int(msg.split(": ")[-1].split(" ")[0])
+        return 0
+
+    with gdaltest.config_option("GDAL_NUM_THREADS", "4"):
+        ds = gdal.Open(filename)
+        assert ds.AdviseRead(16, 32, 200, 100) == gdal.CE_None
+        assert ds.ReadRaster(16, 32, 200, 100) == expected
+        # Blocks (1, 2) to (13, 8) have been read in the background
+        assert flush_and_get_recalled_blocks(ds.GetRasterBand(1)) == 13 * 7
+
+        assert ds.AdviseRead(16, 32, 200, 100, 100, 50) == gdal.CE_None
+        assert ds.ReadRaster(16, 32, 200, 100, 100, 50) == expected_ovr
+        # Blocks (0, 1) to (6, 4) of the overview
+        assert (
+            flush_and_get_recalled_blocks(ds.GetRasterBand(1).GetOverview(0))
+            == 7 * 4
+        )
+
+        # Advised blocks that are not read
+        assert ds.AdviseRead(0, 0, 256, 256) == gdal.CE_None
+        ds = None
+
+    # Buffers of advised blocks are limited to half of the block cache:
+    # 10000 bytes, that is 39 blocks of 16x16 bytes
+    oldval = gdal.GetCacheMax()
+    gdal.SetCacheMax(20000)
+    try:
+        with gdaltest.config_option("GDAL_NUM_THREADS", "4"):
+            ds = gdal.Open(filename)
+            assert ds.AdviseRead(0, 0, 256, 32) == gdal.CE_None
+            # Discards the oldest blocks of the first window
+            assert ds.AdviseRead(0, 32, 256, 32) == gdal.CE_None
+            assert ds.ReadRaster(0, 0, 256, 64) == expected_full[0 : 256 * 64]
+            assert flush_and_get_recalled_blocks(ds.GetRasterBand(1)) <= 39
+            ds = None
+    finally:
+        gdal.SetCacheMax(oldval)
+
+    gdal.Unlink(filename)
+
+
+###############################################################################
+# Test that resampled RasterIO() gives the same results when the chunks are
+# resampled by worker threads
+
+
+@pytest.mark.parametrize(
+    "resample_alg",
+    [gdal.GRIORA_Bilinear, gdal.GRIORA_Cubic, gdal.GRIORA_Average, gdal.GRIORA_Mode],
+)
+@pytest.mark.parametrize("nodata", [None, 10])
+def test_rasterio_resampled_multithreaded(resample_alg, nodata):
+
+    src_ds = gdal.Open("data/byte.tif")
+    options = "-of MEM -outsize 2500 2000 -ot UInt16 -b 1 -b 1"
+    if nodata is not None:
+        options += " -a_nodata %d" % nodata
+    ds = gdal.Translate("", src_ds, options=options)
+
+    def read():
+        band = ds.GetRasterBand(1)
+        return [
+            band.ReadRaster(
+                3, 5, 2490, 1990, 331, 217, resample_alg=resample_alg
+            ),
+            band.ReadRaster(
+                3,
+                5,
+                2490,
+                1990,
+                331,
+                217,
+                buf_type=gdal.GDT_Float32,
+                resample_alg=resample_alg,
+            ),
+            ds.ReadRaster(0, 0, 2500, 2000, 250, 200, resample_alg=resample_alg),
+        ]
+
+    expected = read()
+    with gdaltest.config_option("GDAL_NUM_THREADS", "4"):
+        got = read()
+    assert got == expected
+
+    # Check progress and interruption
+    tab = [0]
+
+    def callback(pct, msg, user_data):
+        assert pct >= tab[0]
+        tab[0] = pct
+        return pct < 0.5
+
+    with gdaltest.config_option("GDAL_NUM_THREADS", "4"):
+        with gdaltest.error_handler():
+            assert (
+                ds.GetRasterBand(1).ReadRaster(
+                    0,
+                    0,
+                    2500,
+                    2000,
+                    100,
+                    100,
+                    resample_alg=resample_alg,
+                    callback=callback,
+                )
+                is None
+            )
+
+
+###############################################################################
+# Test that the pipelined GDALDatasetCopyWholeRaster(), used by the default
+# CreateCopy() implementation when GDAL_NUM_THREADS is set, gives the same
+# result as the sequential one
+
+
+@pytest.mark.parametrize("interleave", ["BSQ", "BIP"])
+def test_rasterio_copy_whole_raster_pipelined(interleave):
+
+    src_ds = gdal.Translate(
+        "", "data/rgbsmall.tif", options="-of MEM -outsize 500 400 -r bilinear"
+    )
+    drv = gdal.GetDriverByName("ENVI")
+
+    def copy(filename):
+        tab = [0]
+
+        def callback(pct, msg, user_data):
+            assert pct >= tab[0]
+            tab[0] = pct
+            return 1
+
+        with gdaltest.config_option("GDAL_SWATH_SIZE", "10000"):
+            ds = drv.CreateCopy(
+                filename,
+                src_ds,
+                options=["INTERLEAVE=" + interleave],
+                callback=callback,
+            )
+        assert tab[0] == 1.0
+        data = ds.ReadRaster()
+        ds = None
+        drv.Delete(filename)
+        return data
+
+    expected = copy("/vsimem/test_rasterio_copy_whole_raster_sequential.bin")
+    with gdaltest.config_option("GDAL_NUM_THREADS", "4"):
+        got = copy("/vsimem/test_rasterio_copy_whole_raster_pipelined.bin")
+    assert got == expected
+    assert expected == src_ds.ReadRaster()
+
+
+###############################################################################
+# Test reading without going through the block cache
+# (GDAL_RASTERIO_BYPASS_CACHE=YES)
+
+
+def test_rasterio_bypass_block_cache():
+
+    filename = "/vsimem/test_rasterio_bypass_block_cache.tif"
+    src_ds = gdal.Open("data/byte.tif")
+    gdal.Translate(
+        filename,
+        src_ds,
+        options="-outsize 100 80 -co TILED=YES -co BLOCKXSIZE=16 -co BLOCKYSIZE=16",
+    )
+
+    def read(ds):
+        band = ds.GetRasterBand(1)
+        return [
+            band.ReadRaster(),
+            band.ReadRaster(16, 32, 16, 16),
+            band.ReadRaster(3, 5, 90, 70),
+            band.ReadRaster(3, 5, 90, 70, buf_type=gdal.GDT_Float32),
+            band.ReadRaster(0, 0, 100, 80, buf_pixel_space=2, buf_line_space=250),
+        ]
+
+    ds = gdal.Open(filename)
+    expected = read(ds)
+    ds = None
+
+    ds = gdal.Open(filename)
+    with gdaltest.config_option("GDAL_RASTERIO_BYPASS_CACHE", "YES"):
+        cache_used = gdal.GetCacheUsed()
+        assert read(ds) == expected
+        # Blocks have not been inserted in the cache
+        assert gdal.GetCacheUsed() == cache_used
+    ds = None
+
+    # By default, reads larger than the block cache bypass it for drivers
+    # that have opted in, such as GTiff
+    old_cache_max = gdal.GetCacheMax()
+    gdal.SetCacheMax(4096)
+    try:
+        ds = gdal.Open(filename)
+        cache_used = gdal.GetCacheUsed()
+        assert ds.GetRasterBand(1).ReadRaster() == expected[0]
+        assert gdal.GetCacheUsed() == cache_used
+        ds = None
+    finally:
+        gdal.SetCacheMax(old_cache_max)
+
+    # Blocks modified in the cache are taken into account
+    ds = gdal.Open(filename, gdal.GA_Update)
+    ds.GetRasterBand(1).WriteRaster(20, 20, 2, 2, b"\x01\x02\x03\x04")
+    expected_line = bytearray(expected[0][20 * 100 + 19 : 20 * 100 + 23])
+    expected_line[1:3] = b"\x01\x02"
+    with gdaltest.config_option("GDAL_RASTERIO_BYPASS_CACHE", "YES"):
+        assert ds.GetRasterBand(1).ReadRaster(19, 20, 4, 1) == expected_line
+    ds = None
+
+    gdal.Unlink(filename)
+
+
+###############################################################################
+# Test the compressed second tier of the block cache, when blocks are read
+# a second time after having been evicted. The second tier is configured once
+# per process, hence the use of a subprocess.
+
+
+def test_rasterio_block_cache_second_tier():
+
+    filename = "tmp/test_rasterio_block_cache_second_tier.tif"
+    gdal.Translate(
+        filename,
+        "data/byte.tif",
+        options="-outsize 2000 2000 -co TILED=YES -co COMPRESS=DEFLATE",
+    )
+
+    script = (
+        "import json, sys\n"
+        "from osgeo import gdal\n"
+        "ds = gdal.Open(sys.argv[1])\n"
+        "checksums = [ds.GetRasterBand(1).Checksum() for i in range(2)]\n"
+        "info = gdal.Info(ds, format='json', blockCacheStats=True)\n"
+        "print(json.dumps({'checksums': checksums,\n"
+        "                  'stats': info['blockCacheStatistics']}))\n"
+    )
+
+    def run(second_tier_max):
+        env = os.environ.copy()
+        env["GDAL_CACHEMAX"] = "1"
+        env["GDAL_PAM_ENABLED"] = "NO"
+        env["GDAL_BLOCK_CACHE_SECOND_TIER_MAX"] = second_tier_max
+        out = subprocess.check_output(
+            [sys.executable, "-c", script, filename], env=env
+        ).decode("utf-8")
+        return json.loads(out)
+
+    try:
+        ref = run("0")
+        got = run("16")
+    finally:
+        gdal.GetDriverByName("GTiff").Delete(filename)
+
+    # The second pass of Checksum() reads blocks evicted by the first one
+    assert ref["stats"]["evictions"] > 0
+    assert ref["stats"]["secondTierRecalls"] == 0
+    assert got["stats"]["evictions"] > 0
+    assert got["stats"]["secondTierRecalls"] > 0
+    assert got["stats"]["secondTierRecalls"] <= got["stats"]["misses"]
+    assert got["checksums"] == ref["checksums"]
+    assert got["checksums"][0] == got["checksums"][1]
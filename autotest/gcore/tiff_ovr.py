@@ -727,6 +727,35 @@ def test_tiff_ovr_mode_multiband(multiband, read_only):
     gdal.GetDriverByName("GTiff").Delete("/vsimem/test.tif")
 
 
+###############################################################################
+# Check mode resampling on 8 and 16 bit integer data types, including
+# negative values and nodata
+
+
+@pytest.mark.parametrize(
+    "dt,fmt,values",
+    [
+        (gdal.GDT_Int8, "b", [-1, -128, 127, 5]),
+        (gdal.GDT_UInt16, "H", [0, 65535, 1000, 3]),
+        (gdal.GDT_Int16, "h", [-1, -32768, 32767, 5]),
+    ],
+)
+def test_tiff_ovr_mode_histogram(dt, fmt, values):
+
+    a, b, c, nodata = values
+    # Three 2x2 windows, whose modes are a, nodata (no valid value) and c
+    data = [a, a, nodata, nodata, c, c] + [nodata, b, nodata, nodata, b, c]
+    filename = "/vsimem/test_tiff_ovr_mode_histogram.tif"
+    ds = gdal.GetDriverByName("GTiff").Create(filename, 6, 2, 1, dt)
+    ds.GetRasterBand(1).SetNoDataValue(nodata)
+    ds.GetRasterBand(1).WriteRaster(0, 0, 6, 2, struct.pack(fmt * 12, *data))
+    ds.BuildOverviews("MODE", [2])
+    ovr = ds.GetRasterBand(1).GetOverview(0)
+    assert struct.unpack(fmt * 3, ovr.ReadRaster()) == (a, nodata, c)
+    ds = None
+    gdal.Unlink(filename)
+
+
 ###############################################################################
 # Check that we can create overviews on a newly create file (#2621)
 
@@ -2318,6 +2347,144 @@ def test_tiff_ovr_multithreading_multiband():
     gdal.Unlink("/vsimem/test.tif")
 
 
+###############################################################################
+# Test that multithreaded computation of several overview levels, where each
+# level is computed from the previous one, gives the same result as serial mode
+
+
+@pytest.mark.parametrize("compress", ["LZW", "JPEG"])
+def test_tiff_ovr_multithreading_multiband_several_levels(compress):
+
+    if compress == "JPEG" and "<Value>JPEG</Value>" not in gdal.GetDriverByName(
+        "GTIFF"
+    ).GetMetadataItem("DMD_CREATIONOPTIONLIST"):
+        pytest.skip("JPEG support missing")
+
+    def get_checksums(num_threads):
+        filename = "/vsimem/test_%s.tif" % num_threads
+        ds = gdal.Translate(
+            filename,
+            "data/stefan_full_rgba.tif",
+            creationOptions=[
+                "COMPRESS=" + compress,
+                "TILED=YES",
+                "BLOCKXSIZE=16",
+                "BLOCKYSIZE=16",
+            ],
+            bandList=[1, 2, 3],
+        )
+        with gdaltest.config_options(
+            {
+                "GDAL_NUM_THREADS": num_threads,
+                "GDAL_OVR_CHUNK_MAX_SIZE": "100",
+                "COMPRESS_OVERVIEW": compress,
+            }
+        ):
+            ds.BuildOverviews("CUBIC", [2, 4, 8, 16])
+        ds = None
+        ds = gdal.Open(filename)
+        cs = [
+            ds.GetRasterBand(i + 1).GetOverview(j).Checksum()
+            for i in range(3)
+            for j in range(4)
+        ]
+        ds = None
+        gdal.Unlink(filename)
+        return cs
+
+    assert get_checksums("8") == get_checksums("1")
+
+
+###############################################################################
+# Test that overview levels are not pipelined when values written to the
+# overviews are not read back unchanged (Float32 stored on 16 bits)
+
+
+def test_tiff_ovr_multithreading_several_levels_nbits():
+    def get_overview_data(num_threads):
+        filename = "/vsimem/test_%s.tif" % num_threads
+        ds = gdal.Translate(
+            filename,
+            "data/stefan_full_rgba.tif",
+            outputType=gdal.GDT_Float32,
+            scaleParams=[[0, 255, 0, 1]],
+            creationOptions=[
+                "NBITS=16",
+                "COMPRESS=LZW",
+                "TILED=YES",
+                "BLOCKXSIZE=16",
+                "BLOCKYSIZE=16",
+            ],
+            bandList=[1, 2, 3],
+        )
+        with gdaltest.config_options(
+            {"GDAL_NUM_THREADS": num_threads, "GDAL_OVR_CHUNK_MAX_SIZE": "100"}
+        ):
+            ds.BuildOverviews("CUBIC", [2, 4, 8, 16])
+        ds = None
+        ds = gdal.Open(filename)
+        assert (
+            ds.GetRasterBand(1).GetOverview(0).GetMetadataItem(
+                "NBITS", "IMAGE_STRUCTURE"
+            )
+            == "16"
+        )
+        data = [
+            ds.GetRasterBand(i + 1).GetOverview(j).ReadRaster()
+            for i in range(3)
+            for j in range(4)
+        ]
+        ds = None
+        gdal.Unlink(filename)
+        return data
+
+    assert get_overview_data("8") == get_overview_data("1")
+
+
+###############################################################################
+# Test that multithreaded computation of several overview levels on a
+# INTERLEAVE=BAND file, where bands are resampled concurrently, gives the same
+# result as serial mode
+
+
+def test_tiff_ovr_multithreading_band_interleaved():
+    def get_checksums(num_threads):
+        filename = "/vsimem/test_%s.tif" % num_threads
+        ds = gdal.Translate(
+            filename,
+            "data/stefan_full_rgba.tif",
+            creationOptions=[
+                "COMPRESS=LZW",
+                "INTERLEAVE=BAND",
+                "TILED=YES",
+                "BLOCKXSIZE=16",
+                "BLOCKYSIZE=16",
+            ],
+            bandList=[1, 2, 3],
+        )
+        with gdaltest.config_options(
+            {
+                "GDAL_NUM_THREADS": num_threads,
+                "GDAL_OVR_CHUNK_MAX_SIZE": "100",
+                "COMPRESS_OVERVIEW": "LZW",
+            }
+        ):
+            assert ds.BuildOverviews("AVERAGE", [2, 4, 8]) == gdal.CE_None
+        ds = None
+        ds = gdal.Open(filename)
+        assert ds.GetMetadataItem("INTERLEAVE", "IMAGE_STRUCTURE") == "BAND"
+        cs = [
+            ds.GetRasterBand(i + 1).GetOverview(j).Checksum()
+            for i in range(3)
+            for j in range(3)
+        ]
+        ds = None
+        gdal.Unlink(filename)
+        return cs
+
+    assert get_checksums("8") == get_checksums("1")
+
+
 ###############################################################################
 
 
@@ -2753,6 +2920,119 @@ def test_tiff_ovr_internal_overview_different_planar_config_to_band():
     gdal.GetDriverByName("GTiff").Delete(temp_path)
 
 
+###############################################################################
+# Test that the AVX2 convolution kernels used for Float32 give the same
+# results as the generic code
+
+
+@pytest.mark.parametrize("resampling", ["BILINEAR", "CUBIC", "LANCZOS"])
+@pytest.mark.parametrize("nodata", [None, -9999])
+def test_tiff_ovr_convolution_float32_avx2(resampling, nodata):
+
+    # GDAL_USE_AVX2 is only honoured in DEBUG builds. Otherwise both runs
+    # would use the same code path.
+    if "DEBUG=YES" not in gdal.VersionInfo("BUILD_INFO"):
+        pytest.skip("requires a DEBUG build")
+
+    width = 67
+    height = 53
+    values = []
+    for j in range(height):
+        for i in range(width):
+            if nodata is not None and (i * 7 + j * 3) % 11 == 0:
+                values.append(nodata)
+            else:
+                values.append(((i * 13 + j * 29) % 97) * 1.5 - 20)
+
+    def get_values(use_avx2):
+        filename = "/vsimem/test_tiff_ovr_convolution_float32_avx2.tif"
+        ds = gdal.GetDriverByName("GTiff").Create(
+            filename, width, height, 1, gdal.GDT_Float32
+        )
+        if nodata is not None:
+            ds.GetRasterBand(1).SetNoDataValue(nodata)
+        ds.GetRasterBand(1).WriteRaster(
+            0, 0, width, height, struct.pack("f" * len(values), *values)
+        )
+        with gdaltest.config_option("GDAL_USE_AVX2", use_avx2):
+            ds.BuildOverviews(resampling, [2, 3])
+            downsampled = ds.GetRasterBand(1).ReadRaster(
+                buf_xsize=23,
+                buf_ysize=19,
+                resample_alg=getattr(gdal, "GRIORA_" + resampling.capitalize()),
+            )
+        ret = []
+        for k in range(2):
+            ovr = ds.GetRasterBand(1).GetOverview(k)
+            ret += struct.unpack(
+                "f" * (ovr.XSize * ovr.YSize),
+                ovr.ReadRaster(buf_type=gdal.GDT_Float32),
+            )
+        ret += struct.unpack("f" * (23 * 19), downsampled)
+        ds = None
+        gdal.Unlink(filename)
+        return ret
+
+    ref = get_values("NO")
+    got = get_values("YES")
+    assert len(got) == len(ref)
+    for a, b in zip(got, ref):
+        assert a == pytest.approx(b, rel=1e-5, abs=1e-5)
+
+
+###############################################################################
+# Test in-memory overviews computed on demand (GDAL_IN_MEMORY_OVERVIEWS=YES)
+
+
+@pytest.mark.parametrize("nodata", [None, 0])
+def test_tiff_ovr_in_memory_overviews(nodata):
+
+    filename = "/vsimem/test_tiff_ovr_in_memory_overviews.tif"
+    src_ds = gdal.Open("data/byte.tif")
+    options = "-outsize 1000 600 -b 1 -b 1 -co TILED=YES"
+    if nodata is not None:
+        options += " -a_nodata %d" % nodata
+    gdal.Translate(filename, src_ds, options=options)
+
+    ds = gdal.Open(filename)
+    assert ds.GetRasterBand(1).GetOverviewCount() == 0
+    expected = ds.GetRasterBand(1).ReadRaster(
+        0, 0, 1000, 600, 500, 300, resample_alg=gdal.GRIORA_Average
+    )
+    expected_ds = ds.ReadRaster(
+        0, 0, 1000, 600, 250, 150, resample_alg=gdal.GRIORA_Average
+    )
+    ds = None
+
+    with gdaltest.config_option("GDAL_IN_MEMORY_OVERVIEWS", "YES"):
+        ds = gdal.Open(filename)
+    band = ds.GetRasterBand(1)
+    assert band.GetOverviewCount() == 2
+    assert (band.GetOverview(0).XSize, band.GetOverview(0).YSize) == (500, 300)
+    assert (band.GetOverview(1).XSize, band.GetOverview(1).YSize) == (250, 150)
+    assert band.GetOverview(2) is None
+    assert band.GetOverview(0).GetNoDataValue() == nodata
+
+    assert band.GetOverview(0).ReadRaster() == expected
+    assert band.ReadRaster(0, 0, 1000, 600, 500, 300) == expected
+    # The second level is computed from the first one, so values may only
+    # differ by rounding.
+    got_ds = ds.ReadRaster(
+        0, 0, 1000, 600, 250, 150, resample_alg=gdal.GRIORA_Average
+    )
+    assert len(got_ds) == len(expected_ds)
+    assert max(abs(a - b) for a, b in zip(got_ds, expected_ds)) <= 1
+    ds = None
+
+    # Not exposed in update mode
+    with gdaltest.config_option("GDAL_IN_MEMORY_OVERVIEWS", "YES"):
+        ds = gdal.Open(filename, gdal.GA_Update)
+    assert ds.GetRasterBand(1).GetOverviewCount() == 0
+    ds = None
+
+    gdal.Unlink(filename)
+
+
 ###############################################################################
 # Cleanup
 
@@ -4927,6 +4927,102 @@ def test_tiff_read_multi_threaded_vsicurl(use_dataset_readraster):
         gdal.VSICurlClearCache()
 
 
+###############################################################################
+# Test that blocks read one at a time are decoded ahead in worker threads,
+# and that the result is identical to single-threaded decoding
+
+
+@pytest.mark.parametrize(
+    "nbands,interleave,tiled",
+    [
+        (1, "BAND", True),
+        (1, "BAND", False),
+        (3, "PIXEL", True),
+        (3, "PIXEL", False),
+        (2, "BAND", True),
+    ],
+)
+def test_tiff_read_multi_threaded_read_block(nbands, interleave, tiled):
+
+    if not check_libtiff_internal_or_at_least(4, 0, 11):
+        pytest.skip()
+
+    tmpfile = "/vsimem/test_tiff_read_multi_threaded_read_block.tif"
+    options = ["COMPRESS=DEFLATE", "INTERLEAVE=" + interleave]
+    if tiled:
+        options += ["TILED=YES", "BLOCKXSIZE=32", "BLOCKYSIZE=16"]
+    else:
+        options += ["BLOCKYSIZE=7"]
+    ds = gdal.GetDriverByName("GTiff").Create(
+        tmpfile, 100, 50, nbands, gdal.GDT_Byte, options=options
+    )
+    for band in range(nbands):
+        ds.GetRasterBand(band + 1).WriteRaster(
+            0,
+            0,
+            100,
+            50,
+            array.array("B", [(band * 10 + i * 7) % 251 for i in range(100 * 50)]),
+        )
+    ds = None
+
+    def read_blocks(ds, use_cache):
+        blocks = []
+        blockxsize, blockysize = ds.GetRasterBand(1).GetBlockSize()
+        for y in range((ds.RasterYSize + blockysize - 1) // blockysize):
+            for x in range((ds.RasterXSize + blockxsize - 1) // blockxsize):
+                for band in range(ds.RasterCount):
+                    if use_cache:
+                        blocks.append(
+                            ds.GetRasterBand(band + 1).ReadRaster(
+                                x * blockxsize,
+                                y * blockysize,
+                                min(blockxsize, ds.RasterXSize - x * blockxsize),
+                                min(blockysize, ds.RasterYSize - y * blockysize),
+                            )
+                        )
+                    else:
+                        blocks.append(ds.GetRasterBand(band + 1).ReadBlock(x, y))
+        return blocks
+
+    decoded_ahead = []
+
+    def handler(eErrClass, err_no, msg):
+        if eErrClass == gdal.CE_Debug and "blocks decoded ahead" in msg:
+            decoded_ahead.append(int(msg.split(": ")[-1].split(" ")[0]))
+
+    # Returns the blocks, and the number of blocks decoded ahead, reported
+    # when the dataset is closed
+    def open_and_read_blocks(open_options, use_cache):
+        ds = gdal.OpenEx(tmpfile, open_options=open_options)
+        blocks = read_blocks(ds, use_cache)
+        del decoded_ahead[:]
+        gdal.PushErrorHandler(handler)
+        gdal.SetCurrentErrorHandlerCatchDebug(True)
+        try:
+            with gdaltest.config_option("CPL_DEBUG", "ON"):
+                ds = None
+        finally:
+            gdal.PopErrorHandler()
+        return blocks, sum(decoded_ahead)
+
+    try:
+        expected_blocks, count = open_and_read_blocks([], False)
+        assert count == 0
+        expected_windows, count = open_and_read_blocks([], True)
+        assert count == 0
+
+        blocks, count = open_and_read_blocks(["NUM_THREADS=4"], False)
+        assert blocks == expected_blocks
+        assert count > 0
+
+        blocks, count = open_and_read_blocks(["NUM_THREADS=4"], True)
+        assert blocks == expected_windows
+        assert count > 0
+    finally:
+        gdal.Unlink(tmpfile)
+
+
 ###############################################################################
 # Test that a user receives a warning when it queries
 # GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE")
@@ -10220,6 +10220,113 @@ def test_tiff_write_predictor_2_float64():
     gdal.Unlink(filename)
 
 
+###############################################################################
+# Scalar reference implementation of the libtiff horizontal differencing
+# (PREDICTOR=2) and floating point (PREDICTOR=3) predictors, applied on a row of
+# native endian pixel interleaved samples
+
+
+def _tiff_write_predictor_encode_row(row, predictor, nbands, itemsize):
+
+    if predictor == 2:
+        mask = (1 << (8 * itemsize)) - 1
+        vals = [
+            int.from_bytes(row[i : i + itemsize], sys.byteorder)
+            for i in range(0, len(row), itemsize)
+        ]
+        return b"".join(
+            (vals[i] if i < nbands else (vals[i] - vals[i - nbands]) & mask).to_bytes(
+                itemsize, sys.byteorder
+            )
+            for i in range(len(vals))
+        )
+
+    # Bytes of the samples are grouped by significance, most significant first
+    wc = len(row) // itemsize
+    shuffled = bytearray(len(row))
+    for count in range(wc):
+        for byte in range(itemsize):
+            if sys.byteorder == "little":
+                shuffled[(itemsize - byte - 1) * wc + count] = row[itemsize * count + byte]
+            else:
+                shuffled[byte * wc + count] = row[itemsize * count + byte]
+    return bytes(
+        shuffled[i] if i < nbands else (shuffled[i] - shuffled[i - nbands]) & 0xFF
+        for i in range(len(shuffled))
+    )
+
+
+###############################################################################
+# Test PREDICTOR=2/3 for all sample sizes and various strides and row widths
+# (to exercise the vectorized and scalar code paths), by comparing the
+# encoded strip with the one of a scalar implementation, and by round-tripping
+
+
+@pytest.mark.parametrize(
+    "dt,predictor",
+    [
+        (gdal.GDT_Byte, 2),
+        (gdal.GDT_UInt16, 2),
+        (gdal.GDT_Int32, 2),
+        (gdal.GDT_UInt64, 2),
+        (gdal.GDT_Float32, 3),
+        (gdal.GDT_Float64, 3),
+    ],
+)
+@pytest.mark.parametrize("nbands", [1, 2, 3, 4])
+def test_tiff_write_predictor_roundtrip(dt, predictor, nbands):
+
+    md = gdal.GetDriverByName("GTiff").GetMetadata()
+    if dt == gdal.GDT_UInt64 and md["LIBTIFF"] != "INTERNAL":
+        pytest.skip("libtiff > 4.3.0 or internal libtiff needed")
+
+    zlib = pytest.importorskip("zlib")
+
+    filename = "/vsimem/test_tiff_write_predictor_roundtrip.tif"
+    itemsize = gdal.GetDataTypeSizeBytes(dt)
+    for width in (1, 5, 17, 67, 131):
+        height = 3
+        ds = gdal.GetDriverByName("GTiff").Create(
+            filename,
+            width,
+            height,
+            nbands,
+            dt,
+            [
+                "COMPRESS=DEFLATE",
+                "PREDICTOR=%d" % predictor,
+                "INTERLEAVE=PIXEL",
+                "BLOCKYSIZE=%d" % height,
+            ],
+        )
+        size = width * height * nbands * itemsize
+        data = bytes((i * 7919 + (i >> 3) * 31) & 0xFF for i in range(size))
+        ds.WriteRaster(0, 0, width, height, data)
+        ds = None
+        ds = gdal.Open(filename)
+        assert ds.GetMetadataItem("PREDICTOR", "IMAGE_STRUCTURE") == str(predictor)
+        assert ds.ReadRaster() == data, width
+
+        # Check the encoded strip against the scalar implementation
+        band = ds.GetRasterBand(1)
+        offset = int(band.GetMetadataItem("BLOCK_OFFSET_0_0", "TIFF"))
+        strip_size = int(band.GetMetadataItem("BLOCK_SIZE_0_0", "TIFF"))
+        ds = None
+        f = gdal.VSIFOpenL(filename, "rb")
+        gdal.VSIFSeekL(f, offset, 0)
+        encoded = zlib.decompress(gdal.VSIFReadL(1, strip_size, f))
+        gdal.VSIFCloseL(f)
+        row_size = width * nbands * itemsize
+        expected = b"".join(
+            _tiff_write_predictor_encode_row(
+                data[y * row_size : (y + 1) * row_size], predictor, nbands, itemsize
+            )
+            for y in range(height)
+        )
+        assert encoded == expected, width
+        gdal.Unlink(filename)
+
+
 ###############################################################################
 
 
@@ -10621,5 +10728,88 @@ def test_tiff_write_webp_overview_turn_on_lossy_if_webp_level():
     gdal.Unlink(tmpfilename)
 
 
+###############################################################################
+# Test that compressed tiles are copied as they are when the source and target
+# have the same compression and tiling
+
+
+@pytest.mark.parametrize("interleave", ["PIXEL", "BAND"])
+def test_tiff_write_copy_compressed_blocks(interleave):
+
+    src_filename = "/vsimem/test_tiff_write_copy_compressed_blocks_src.tif"
+    dst_filename = "/vsimem/test_tiff_write_copy_compressed_blocks_dst.tif"
+    gdal.Translate(
+        src_filename,
+        "../gdrivers/data/small_world.tif",
+        options="-co TILED=YES -co BLOCKXSIZE=128 -co BLOCKYSIZE=128 "
+        + "-co COMPRESS=DEFLATE -co ZLEVEL=1 -co PREDICTOR=2 -co INTERLEAVE="
+        + interleave,
+    )
+    src_ds = gdal.Open(src_filename)
+
+    def get_block_sizes(ds):
+        return [
+            ds.GetRasterBand(i + 1).GetMetadataItem("BLOCK_SIZE_%d_%d" % (x, y), "TIFF")
+            for i in range(ds.RasterCount)
+            for y in range(2)
+            for x in range(4)
+        ]
+
+    options = [
+        "TILED=YES",
+        "BLOCKXSIZE=128",
+        "BLOCKYSIZE=128",
+        "COMPRESS=DEFLATE",
+        "PREDICTOR=2",
+        "INTERLEAVE=" + interleave,
+    ]
+    ds = gdal.GetDriverByName("GTiff").CreateCopy(dst_filename, src_ds, options=options)
+    ds = None
+    ds = gdal.Open(dst_filename)
+    assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == [
+        src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)
+    ]
+    # Tiles have not been recompressed with the default ZLEVEL
+    assert get_block_sizes(ds) == get_block_sizes(src_ds)
+    ds = None
+
+    with gdaltest.config_option("GDAL_COPY_COMPRESSED_BLOCKS", "NO"):
+        ds = gdal.GetDriverByName("GTiff").CreateCopy(
+            dst_filename, src_ds, options=options
+        )
+    ds = None
+    ds = gdal.Open(dst_filename)
+    assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == [
+        src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)
+    ]
+    assert get_block_sizes(ds) != get_block_sizes(src_ds)
+    ds = None
+
+    # An explicit encoder option disables the copy of compressed tiles
+    ds = gdal.GetDriverByName("GTiff").CreateCopy(
+        dst_filename, src_ds, options=options + ["ZLEVEL=9"]
+    )
+    ds = None
+    ds = gdal.Open(dst_filename)
+    assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == [
+        src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)
+    ]
+    assert get_block_sizes(ds) != get_block_sizes(src_ds)
+    ds = None
+
+    # Different predictor: tiles must be recompressed
+    options[-2] = "PREDICTOR=1"
+    ds = gdal.GetDriverByName("GTiff").CreateCopy(dst_filename, src_ds, options=options)
+    ds = None
+    ds = gdal.Open(dst_filename)
+    assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == [
+        src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)
+    ]
+    ds = None
+
+    gdal.Unlink(src_filename)
+    gdal.Unlink(dst_filename)
+
+
 def test_tiff_write_cleanup():
     gdaltest.tiff_drv = None
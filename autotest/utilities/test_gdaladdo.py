@@ -196,3 +196,43 @@ def test_gdaladdo_5():
     assert cnt == 1
 
     os.remove("tmp/test_gdaladdo_5.tif")
+
+
+###############################################################################
+# Test -ro with GDAL_IN_MEMORY_OVERVIEWS=YES: in-memory overviews must not be
+# taken as existing levels
+
+
+def test_gdaladdo_ro_in_memory_overviews():
+    if test_cli_utilities.get_gdaladdo_path() is None:
+        pytest.skip()
+
+    gdal.Translate(
+        "tmp/test_gdaladdo_ro_in_memory_overviews.tif",
+        "../gcore/data/nodata_byte.tif",
+        options="-outsize 1024 1024",
+    )
+
+    (_, err) = gdaltest.runexternal_out_and_err(
+        test_cli_utilities.get_gdaladdo_path()
+        + " --config GDAL_IN_MEMORY_OVERVIEWS YES -ro"
+        + " tmp/test_gdaladdo_ro_in_memory_overviews.tif 2 4"
+    )
+    assert err is None or err == "", "got error/warning"
+
+    assert os.path.exists("tmp/test_gdaladdo_ro_in_memory_overviews.tif.ovr")
+    ds = gdal.Open("tmp/test_gdaladdo_ro_in_memory_overviews.tif")
+    assert ds.GetRasterBand(1).GetOverviewCount() == 2
+    assert ds.GetRasterBand(1).GetOverview(0).Checksum() == 20683
+    ds = None
+
+    # Only the external overviews are cleaned
+    (_, err) = gdaltest.runexternal_out_and_err(
+        test_cli_utilities.get_gdaladdo_path()
+        + " --config GDAL_IN_MEMORY_OVERVIEWS YES -ro -clean"
+        + " tmp/test_gdaladdo_ro_in_memory_overviews.tif"
+    )
+    assert err is None or err == "", "got error/warning"
+    assert not os.path.exists("tmp/test_gdaladdo_ro_in_memory_overviews.tif.ovr")
+
+    os.remove("tmp/test_gdaladdo_ro_in_memory_overviews.tif")
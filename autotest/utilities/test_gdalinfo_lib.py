@@ -231,3 +231,30 @@ def test_gdalinfo_lib_nodata_full_precision_float64():
 
     ret = gdal.Info(ds, format="json")
     assert ret["bands"][0]["noDataValue"] == float(nodata_str)
+
+
+###############################################################################
+# Test -cachestats
+
+
+def test_gdalinfo_lib_cachestats():
+
+    ds = gdal.Open("../gcore/data/byte.tif")
+
+    ret = gdal.Info(ds, format="json", computeChecksum=True, blockCacheStats=True)
+    stats = ret["blockCacheStatistics"]
+    assert stats["misses"] >= 1
+    assert stats["evictions"] == 0
+    assert stats["dirtyBlockFlushes"] == 0
+    assert stats["residentBytes"] >= 20 * 20
+
+    ret = gdal.Info(ds, options="-checksum -cachestats -json")
+    assert ret["blockCacheStatistics"]["hits"] > stats["hits"]
+    assert ret["blockCacheStatistics"]["misses"] == stats["misses"]
+
+    ret = gdal.Info(ds, options="-cachestats")
+    assert "Block Cache Statistics:" in ret
+
+    ds.FlushCache()
+    ret = gdal.Info(ds, format="json", blockCacheStats=True)
+    assert ret["blockCacheStatistics"]["residentBytes"] == 0
@@ -28,6 +28,7 @@
 
 #include "cpl_port.h"
 
+#include "cpl_vsi_virtual.h"
 #include "gdal_priv.h"
 #include "gtiff.h"
 #include "gt_overview.h"
@@ -70,12 +71,15 @@ static bool HasZSTDCompression()
 /*                           GetTmpFilename()                           */
 /************************************************************************/
 
+// When bStreamOutput is set, the destination is not a suitable location for
+// temporary files, which are then created in the temporary directory.
 static CPLString GetTmpFilename(const char* pszFilename,
-                                const char* pszExt)
+                                const char* pszExt,
+                                bool bStreamOutput)
 {
     const bool bSupportsRandomWrite = VSISupportsRandomWrite(pszFilename, false);
     CPLString osTmpFilename;
-    if( !bSupportsRandomWrite ||
+    if( bStreamOutput || !bSupportsRandomWrite ||
         CPLGetConfigOption( "CPL_TMPDIR", nullptr ) != nullptr )
     {
         osTmpFilename = CPLGenerateTempFilename(CPLGetBasename(pszFilename));
@@ -88,6 +92,22 @@ static CPLString GetTmpFilename(const char* pszFilename,
     return osTmpFilename;
 }
 
+/************************************************************************/
+/*                          GetTmpMaxMemory()                           */
+/************************************************************************/
+
+// Maximum amount of RAM, in bytes, that may be used by the /vsimem/
+// temporary files of the COG creation process.
+static GIntBig GetTmpMaxMemory()
+{
+    const char* pszTmpMaxMemory =
+        CPLGetConfigOption("COG_TMP_MAX_MEMORY", nullptr);
+    if( pszTmpMaxMemory )
+        return std::max(static_cast<GIntBig>(0),
+                        CPLAtoGIntBig(pszTmpMaxMemory));
+    return GDALGetCacheMax64() / 2;
+}
+
 /************************************************************************/
 /*                             GetResampling()                          */
 /************************************************************************/
@@ -556,7 +576,8 @@ static std::unique_ptr<GDALDataset> CreateReprojectedDS(
                                 GDALProgressFunc pfnProgress,
                                 void * pProgressData,
                                 double& dfCurPixels,
-                                double& dfTotalPixelsToProcess)
+                                double& dfTotalPixelsToProcess,
+                                bool bStreamOutput)
 {
     char** papszArg = nullptr;
     // We could have done a warped VRT, but overview building on it might be
@@ -650,7 +671,8 @@ static std::unique_ptr<GDALDataset> CreateReprojectedDS(
 
     CPLDebug("COG", "Reprojecting source dataset: start");
     GDALWarpAppOptionsSetProgress(psOptions, GDALScaledProgress, pScaledProgress );
-    CPLString osTmpFile(GetTmpFilename(pszDstFilename, "warped.tif.tmp"));
+    CPLString osTmpFile(GetTmpFilename(pszDstFilename, "warped.tif.tmp",
+                                     bStreamOutput));
     auto hSrcDS = GDALDataset::ToHandle(poSrcDS);
     auto hRet = GDALWarp( osTmpFile, nullptr,
                           1, &hSrcDS,
@@ -673,9 +695,19 @@ struct GDALCOGCreator final
     std::unique_ptr<GDALDataset> m_poRGBMaskDS{};
     CPLString                    m_osTmpOverviewFilename{};
     CPLString                    m_osTmpMskOverviewFilename{};
+    CPLString                    m_osTmpFinalFilename{};
+    GIntBig                      m_nTmpMemoryBudget = 0;
+    bool                         m_bStreamOutput = false;
 
     ~GDALCOGCreator();
 
+    CPLString GetTmpFilenameMaybeInMemory(const char* pszFilename,
+                                          const char* pszExt,
+                                          double dfUncompressedSize);
+    bool StreamToDestination(const char* pszFilename,
+                             GDALProgressFunc pfnProgress,
+                             void * pProgressData);
+
     GDALDataset* Create(const char * pszFilename,
                         GDALDataset * const poSrcDS,
                         char ** papszOptions,
@@ -706,6 +738,95 @@ GDALCOGCreator::~GDALCOGCreator()
     {
         VSIUnlink(m_osTmpMskOverviewFilename);
     }
+    if( !m_osTmpFinalFilename.empty() )
+    {
+        VSIUnlink(m_osTmpFinalFilename);
+    }
+}
+
+/************************************************************************/
+/*             GDALCOGCreator::GetTmpFilenameMaybeInMemory()            */
+/************************************************************************/
+
+// Temporary files whose uncompressed size fits in the remaining
+// COG_TMP_MAX_MEMORY budget are created in /vsimem/, which saves writing
+// them to disk and reading them back.
+CPLString GDALCOGCreator::GetTmpFilenameMaybeInMemory(
+                                            const char* pszFilename,
+                                            const char* pszExt,
+                                            double dfUncompressedSize)
+{
+    if( dfUncompressedSize <= static_cast<double>(m_nTmpMemoryBudget) )
+    {
+        m_nTmpMemoryBudget -= static_cast<GIntBig>(dfUncompressedSize);
+        CPLString osTmpFilename(CPLSPrintf("/vsimem/cog_%p/%s.%s",
+                                           this,
+                                           CPLGetFilename(pszFilename),
+                                           pszExt));
+        VSIUnlink(osTmpFilename);
+        return osTmpFilename;
+    }
+    return GetTmpFilename(pszFilename, pszExt, m_bStreamOutput);
+}
+
+/************************************************************************/
+/*                GDALCOGCreator::StreamToDestination()                 */
+/************************************************************************/
+
+// Copy the final product, that has been generated in m_osTmpFinalFilename,
+// to a destination that only supports sequential writing.
+bool GDALCOGCreator::StreamToDestination(const char* pszFilename,
+                                         GDALProgressFunc pfnProgress,
+                                         void * pProgressData)
+{
+    VSILFILE* fpIn = VSIFOpenL(m_osTmpFinalFilename, "rb");
+    if( fpIn == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot open %s",
+                 m_osTmpFinalFilename.c_str());
+        return false;
+    }
+    VSIFSeekL(fpIn, 0, SEEK_END);
+    const vsi_l_offset nSize = VSIFTellL(fpIn);
+    VSIFSeekL(fpIn, 0, SEEK_SET);
+
+    VSILFILE* fpOut = VSIFOpenExL(pszFilename, "wb", true);
+    if( fpOut == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s", pszFilename);
+        VSIFCloseL(fpIn);
+        return false;
+    }
+
+    bool bRet = true;
+    constexpr size_t nChunkSize = 1024 * 1024;
+    std::vector<GByte> abyChunk(nChunkSize);
+    vsi_l_offset nCopied = 0;
+    while( nCopied < nSize )
+    {
+        const size_t nToCopy = static_cast<size_t>(
+            std::min(static_cast<vsi_l_offset>(nChunkSize), nSize - nCopied));
+        if( VSIFReadL(abyChunk.data(), 1, nToCopy, fpIn) != nToCopy ||
+            VSIFWriteL(abyChunk.data(), 1, nToCopy, fpOut) != nToCopy )
+        {
+            CPLError(CE_Failure, CPLE_FileIO, "Copy to %s failed",
+                     pszFilename);
+            bRet = false;
+            break;
+        }
+        nCopied += nToCopy;
+        if( !pfnProgress(static_cast<double>(nCopied) / nSize,
+                         "", pProgressData) )
+        {
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            bRet = false;
+            break;
+        }
+    }
+    VSIFCloseL(fpIn);
+    if( VSIFCloseL(fpOut) != 0 )
+        bRet = false;
+    return bRet;
 }
 
 /************************************************************************/
@@ -728,6 +849,22 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
         return nullptr;
     }
 
+    // The GTiff writer needs to seek back to patch the tile offsets, so for
+    // destinations that can only be written sequentially (/vsis3/ without
+    // CPL_VSIL_USE_TEMP_FILE_FOR_RANDOM_WRITE, /vsigzip/, etc.) or that
+    // cannot be read back (/vsistdout/), generate the final product in a
+    // temporary file and upload it afterwards.
+    const bool bStreamOutput =
+        !VSISupportsRandomWrite(pszFilename, true) ||
+        !VSIFileManager::GetHandler(pszFilename)->SupportsRead(pszFilename);
+    if( bStreamOutput && !VSISupportsSequentialWrite(pszFilename, false) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s does not support writing", pszFilename);
+        return nullptr;
+    }
+    m_bStreamOutput = bStreamOutput;
+
     CPLConfigOptionSetter oSetterReportDirtyBlockFlushing(
         "GDAL_REPORT_DIRTY_BLOCK_FLUSHING", "NO", true);
 
@@ -814,7 +951,8 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
                                     dfTargetMaxX, dfTargetMaxY,
                                     dfRes,
                                     pfnProgress, pProgressData,
-                                    dfCurPixels, dfTotalPixelsToProcess);
+                                    dfCurPixels, dfTotalPixelsToProcess,
+                                    bStreamOutput);
             if( !m_poReprojectedDS )
                 return nullptr;
             poCurDS = m_poReprojectedDS.get();
@@ -975,6 +1113,11 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
             double(nXSize) * nYSize * (nBands + (bHasMask ? 1 : 0)) * 4. / 3;
     }
 
+    m_nTmpMemoryBudget = GetTmpMaxMemory();
+    double dfOverviewPixels = 0;
+    for( const auto& oDim: asOverviewDims )
+        dfOverviewPixels += double(oDim.first) * oDim.second;
+
     CPLStringList aosOverviewOptions;
     aosOverviewOptions.SetNameValue("COMPRESS",
         CPLGetConfigOption("COG_TMP_COMPRESSION", // only for debug purposes
@@ -987,7 +1130,8 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
     if( bGenerateMskOvr )
     {
         CPLDebug("COG", "Generating overviews of the mask: start");
-        m_osTmpMskOverviewFilename = GetTmpFilename(pszFilename, "msk.ovr.tmp");
+        m_osTmpMskOverviewFilename = GetTmpFilenameMaybeInMemory(
+            pszFilename, "msk.ovr.tmp", dfOverviewPixels);
         GDALRasterBand* poSrcMask = poFirstBand->GetMaskBand();
         const char* pszResampling = CSLFetchNameValueDef(papszOptions,
             "OVERVIEW_RESAMPLING",
@@ -1021,7 +1165,10 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
     if( bGenerateOvr )
     {
         CPLDebug("COG", "Generating overviews of the imagery: start");
-        m_osTmpOverviewFilename = GetTmpFilename(pszFilename, "ovr.tmp");
+        m_osTmpOverviewFilename = GetTmpFilenameMaybeInMemory(
+            pszFilename, "ovr.tmp",
+            dfOverviewPixels * nBands *
+                GDALGetDataTypeSizeBytes(poFirstBand->GetRasterDataType()));
         std::vector<GDALRasterBand*> apoSrcBands;
         for( int i = 0; i < nBands; i++ )
             apoSrcBands.push_back( poCurDS->GetRasterBand(i+1) );
@@ -1201,16 +1348,32 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
     GDALDriver* poGTiffDrv = GDALDriver::FromHandle(GDALGetDriverByName("GTiff"));
     if( !poGTiffDrv )
         return nullptr;
+
+    CPLString osFinalFilename(pszFilename);
+    double dfFinalProgressEnd = 1.0;
+    if( bStreamOutput )
+    {
+        const double dfFinalSize =
+            double(nXSize) * nYSize * (nBands *
+                GDALGetDataTypeSizeBytes(poFirstBand->GetRasterDataType()) +
+                (bHasMask ? 1 : 0)) * 4. / 3;
+        m_osTmpFinalFilename =
+            GetTmpFilenameMaybeInMemory(pszFilename, "tmp", dfFinalSize);
+        osFinalFilename = m_osTmpFinalFilename;
+        dfFinalProgressEnd = dfCurPixels / dfTotalPixelsToProcess +
+            (1.0 - dfCurPixels / dfTotalPixelsToProcess) * 0.9;
+    }
+
     void* pScaledProgress = GDALCreateScaledProgress(
             dfCurPixels / dfTotalPixelsToProcess,
-            1.0,
+            dfFinalProgressEnd,
             pfnProgress, pProgressData );
 
     CPLConfigOptionSetter oSetterInternalMask(
         "GDAL_TIFF_INTERNAL_MASK", "YES", false);
 
     CPLDebug("COG", "Generating final product: start");
-    auto poRet = poGTiffDrv->CreateCopy(pszFilename, poCurDS, false,
+    auto poRet = poGTiffDrv->CreateCopy(osFinalFilename, poCurDS, false,
                                         aosOptions.List(),
                                         GDALScaledProgress, pScaledProgress);
 
@@ -1220,6 +1383,46 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
         poRet->FlushCache(false);
 
     CPLDebug("COG", "Generating final product: end");
+
+    if( poRet && bStreamOutput )
+    {
+        // Release the temporary overview files and the final product
+        // before uploading it.
+        delete poRet;
+        poRet = nullptr;
+
+        CPLDebug("COG", "Streaming final product to %s: start", pszFilename);
+        pScaledProgress = GDALCreateScaledProgress(
+                dfFinalProgressEnd, 1.0, pfnProgress, pProgressData );
+        const bool bOK = StreamToDestination(pszFilename,
+                                             GDALScaledProgress,
+                                             pScaledProgress);
+        GDALDestroyScaledProgress(pScaledProgress);
+        CPLDebug("COG", "Streaming final product to %s: end", pszFilename);
+        if( !bOK )
+            return nullptr;
+
+        // The destination may not be readable, or be slow to read: return
+        // the temporary file, which has the same content. It remains
+        // readable through the open dataset once unlinked.
+        const char* const apszAllowedDrivers[] = { "GTiff", nullptr };
+        poRet = GDALDataset::Open(m_osTmpFinalFilename,
+                                  GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR,
+                                  apszAllowedDrivers, nullptr, nullptr);
+        if( poRet )
+            poRet->SetDescription(pszFilename);
+        if( VSIUnlink(m_osTmpFinalFilename) != 0 && poRet )
+        {
+            // Open files cannot be deleted on some platforms: fall back to
+            // opening the destination.
+            delete poRet;
+            VSIUnlink(m_osTmpFinalFilename);
+            poRet = GDALDataset::Open(pszFilename,
+                                      GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR,
+                                      apszAllowedDrivers, nullptr, nullptr);
+        }
+        m_osTmpFinalFilename.clear();
+    }
     return poRet;
 }
 
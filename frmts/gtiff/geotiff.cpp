@@ -345,6 +345,8 @@ enum class GTiffProfile: GByte
 
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
 static void ThreadDecompressionFunc(void*);
+struct GTiffDecompressContext;
+class GTiffBlockReadAhead;
 #endif
 
 class GTiffDataset final : public GDALPamDataset
@@ -370,6 +372,7 @@ private:
 
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
     friend void  ThreadDecompressionFunc(void*);
+    friend class GTiffBlockReadAhead;
 #endif
 
     friend void  GTIFFSetJpegQuality( GDALDatasetH hGTIFFDS, int nJpegQuality );
@@ -405,6 +408,7 @@ private:
 
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
     lru11::Cache<int, std::pair<vsi_l_offset, vsi_l_offset>> m_oCacheStrileToOffsetByteCount{1024};
+    int         m_nBlocksDecodedAhead = 0; // by GTiffBlockReadAhead
 #endif
 
     MaskOffset* m_panMaskOffsetLsb = nullptr;
@@ -522,6 +526,7 @@ private:
     bool        m_bHasWarnedDisableAggressiveBandCaching:1;
     bool        m_bDontReloadFirstBlock:1;  // Hack for libtiff 3.X and #3633.
     bool        m_bWebPLossless:1;
+    bool        m_bHasEncoderOptions:1; // ZLEVEL, WEBP_LEVEL, etc. were set
     bool        m_bPromoteTo8Bits:1;
     bool        m_bDebugDontWriteBlocks:1;
     bool        m_bIsFinalized:1;
@@ -694,6 +699,7 @@ private:
                     const OGRSpatialReference* poSRS ) override;
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
     bool           IsMultiThreadedReadCompatible() const;
+    void           FetchDecompressionTags( GTiffDecompressContext& sContext );
     CPLErr         MultiThreadedRead(int nXOff, int nYOff, int nXSize, int nYSize,
                                      void * pData,
                                      GDALDataType eBufType,
@@ -748,6 +754,12 @@ private:
 
     bool GetRawBinaryLayout(GDALDataset::RawBinaryLayout&) override;
 
+    bool GetCompressedBlockLayout(GDALDataset::CompressedBlockLayout&) override;
+    CPLErr ReadCompressedData(int nPlane, int nXBlockOff, int nYBlockOff,
+                              std::vector<GByte>& abyData) override;
+    CPLErr WriteCompressedData(int nPlane, int nXBlockOff, int nYBlockOff,
+                               const void* pData, size_t nDataSize) override;
+
     // Only needed by createcopy and close code.
     static void     WriteRPC( GDALDataset *, TIFF *, int, GTiffProfile,
                               const char *, char **,
@@ -1358,6 +1370,7 @@ class GTiffRasterBand CPL_NON_FINAL: public GDALPamRasterBand
     GDALColorInterp    m_eBandInterp = GCI_Undefined;
     std::set<GTiffRasterBand **> m_aSetPSelf{};
     bool               m_bHaveOffsetScale = false;
+    int                m_nLastBlockIdRead = -1; // To detect sequential reads
 
     int                DirectIO( GDALRWFlag eRWFlag,
                                  int nXOff, int nYOff, int nXSize, int nYSize,
@@ -1491,6 +1504,8 @@ GTiffRasterBand::GTiffRasterBand( GTiffDataset *poDSIn, int nBandIn ):
 {
     poDS = poDSIn;
     nBand = nBandIn;
+    // IReadBlock() does not depend on blocks being cached.
+    m_bBypassCacheForLargeReads = true;
 
 /* -------------------------------------------------------------------- */
 /*      Get the GDAL data type.                                         */
@@ -2532,6 +2547,7 @@ struct GTiffDecompressContext
     bool     bUseDeinterleaveOptimBlockCache = false;
     bool     bIsTiled = false;
     bool     bTIFFIsBigEndian = false;
+    bool     bCacheOnly = false; // Only fill the block cache. pabyData unset
     int      nBlocksPerRow = 0;
 
     uint16_t nPredictor = 0;
@@ -2621,7 +2637,7 @@ static void ThreadDecompressionFunc(void* pData)
     {
         {
             std::lock_guard<std::mutex> oLock(psContext->oMutex);
-            if( !psContext->bSuccess )
+            if( !psContext->bSuccess || psContext->bCacheOnly )
                 return;
         }
         const double dfNoDataValue = poDS->m_bNoDataSet ? poDS->m_dfNoDataValue : 0;
@@ -2796,7 +2812,8 @@ static void ThreadDecompressionFunc(void* pData)
     }
 
     const int nDTSize = GDALGetDataTypeSizeBytes(psContext->eDT);
-    GByte* pDstPtr = psContext->pabyData
+    GByte* pDstPtr = psContext->bCacheOnly ? nullptr :
+                     psContext->pabyData
                    + nYOffsetInData * psContext->nLineSpace
                    + nXOffsetInData * psContext->nPixelSpace;
 
@@ -2952,6 +2969,24 @@ static void ThreadDecompressionFunc(void* pData)
             }
         }
 
+        if( psContext->bCacheOnly )
+        {
+            // Lines beyond the raster are zeroed, as done by IReadBlock()
+            if( nBlockReqYSize < poDS->m_nBlockYSize )
+            {
+                const size_t nLineSize =
+                    static_cast<size_t>(poDS->m_nBlockXSize) * nDTSize;
+                for( auto* poBlock: apoBlocks )
+                {
+                    memset(static_cast<GByte*>(poBlock->GetDataRef()) +
+                               nBlockReqYSize * nLineSize,
+                           0,
+                           (poDS->m_nBlockYSize - nBlockReqYSize) * nLineSize);
+                }
+            }
+            return;
+        }
+
         const GByte* pSrcPtr = pabyOutput +
                 (static_cast<size_t>(nYOffsetInBlock) *
                 poDS->m_nBlockXSize + nXOffsetInBlock) * nDTSize * nBandsPerStrile;
@@ -3032,6 +3067,8 @@ static void ThreadDecompressionFunc(void* pData)
     }
 
     CPLAssert( !psContext->bSkipBlockCache );
+    if( psContext->bCacheOnly )
+        return;
 
     // Compose cached blocks into final buffer
     for( int i = 0; i < nBandsToWrite; ++i )
@@ -3080,6 +3117,32 @@ bool GTiffDataset::IsMultiThreadedReadCompatible() const
             m_nCompression == COMPRESSION_JPEG);
 }
 
+/************************************************************************/
+/*                       FetchDecompressionTags()                       */
+/************************************************************************/
+
+// Fetch the tags needed by ThreadDecompressionFunc() to decode a strile.
+void GTiffDataset::FetchDecompressionTags( GTiffDecompressContext& sContext )
+{
+    if( GTIFFSupportsPredictor(m_nCompression) )
+    {
+        TIFFGetField( m_hTIFF, TIFFTAG_PREDICTOR, &sContext.nPredictor );
+    }
+    else if( m_nCompression == COMPRESSION_JPEG )
+    {
+        TIFFGetField( m_hTIFF, TIFFTAG_JPEGTABLES,
+                      &sContext.nJPEGTableSize, &sContext.pJPEGTable );
+        if( m_nPhotometric == PHOTOMETRIC_YCBCR )
+        {
+            TIFFGetFieldDefaulted( m_hTIFF, TIFFTAG_YCBCRSUBSAMPLING,
+                                   &sContext.nYCrbCrSubSampling0,
+                                   &sContext.nYCrbCrSubSampling1 );
+        }
+    }
+    TIFFGetField(m_hTIFF, TIFFTAG_EXTRASAMPLES,
+                 &sContext.nExtraSampleCount, &sContext.pExtraSamples);
+}
+
 /************************************************************************/
 /*                        MultiThreadedRead()                           */
 /************************************************************************/
@@ -3316,23 +3379,7 @@ CPLErr GTiffDataset::MultiThreadedRead( int nXOff, int nYOff, int nXSize, int nY
             sContext.poHandle->Flush();
     }
 
-    if( GTIFFSupportsPredictor(m_nCompression) )
-    {
-        TIFFGetField( m_hTIFF, TIFFTAG_PREDICTOR, &sContext.nPredictor );
-    }
-    else if( m_nCompression == COMPRESSION_JPEG )
-    {
-        TIFFGetField( m_hTIFF, TIFFTAG_JPEGTABLES,
-                      &sContext.nJPEGTableSize, &sContext.pJPEGTable );
-        if( m_nPhotometric == PHOTOMETRIC_YCBCR )
-        {
-            TIFFGetFieldDefaulted( m_hTIFF, TIFFTAG_YCBCRSUBSAMPLING,
-                                   &sContext.nYCrbCrSubSampling0,
-                                   &sContext.nYCrbCrSubSampling1 );
-        }
-    }
-    TIFFGetField(m_hTIFF, TIFFTAG_EXTRASAMPLES,
-                 &sContext.nExtraSampleCount, &sContext.pExtraSamples);
+    FetchDecompressionTags(sContext);
 
     // We need to do that as threads will access the block cache
     TemporarilyDropReadWriteLock();
@@ -3410,6 +3457,230 @@ CPLErr GTiffDataset::MultiThreadedRead( int nXOff, int nYOff, int nXSize, int nY
     return sContext.bSuccess ? CE_None : CE_Failure;
 }
 
+/************************************************************************/
+/*                         GTiffBlockReadAhead                          */
+/************************************************************************/
+
+// Decodes, in the threads of GTiffDataset::m_poThreadPool, the blocks that
+// follow a block being read by GTiffRasterBand::IReadBlock() and stores
+// them in the block cache, so that block-level consumers (GetLockedBlockRef(),
+// VRT sources, the warper, ReadBlock(), etc.) also benefit from
+// multi-threaded decompression.
+
+class GTiffBlockReadAhead
+{
+    CPL_DISALLOW_COPY_ASSIGN(GTiffBlockReadAhead)
+
+    GTiffDataset* m_poDS = nullptr;
+    GTiffDecompressContext m_sContext{};
+    std::vector<int> m_anBandMap{};
+    std::vector<GTiffDecompressJob> m_asJobs{};
+    std::unique_ptr<CPLJobQueue> m_poQueue{};
+
+    static void ThreadFunc(void* pData);
+
+  public:
+    explicit GTiffBlockReadAhead(GTiffDataset* poDS): m_poDS(poDS) {}
+    ~GTiffBlockReadAhead();
+
+    static std::unique_ptr<GTiffBlockReadAhead> Start(GTiffDataset* poDS,
+                                                      int nBand,
+                                                      int nBlockXOff,
+                                                      int nBlockYOff,
+                                                      int& nLastBlockIdBand0);
+    void Wait();
+};
+
+/************************************************************************/
+/*                             ThreadFunc()                             */
+/************************************************************************/
+
+void GTiffBlockReadAhead::ThreadFunc(void* pData)
+{
+    // Errors are reported when the blocks are actually read.
+    CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+    ThreadDecompressionFunc(pData);
+}
+
+/************************************************************************/
+/*                                Start()                               */
+/************************************************************************/
+
+// nLastBlockIdBand0 is set to the index (in the first band) of the last
+// block covered by the read-ahead window.
+std::unique_ptr<GTiffBlockReadAhead>
+GTiffBlockReadAhead::Start( GTiffDataset* poDS, int nBand,
+                            int nBlockXOff, int nBlockYOff,
+                            int& nLastBlockIdBand0 )
+{
+    const int nBlocksPerRow =
+        DIV_ROUND_UP(poDS->nRasterXSize, poDS->m_nBlockXSize);
+    const int nBlockIdBand0 = nBlockXOff + nBlockYOff * nBlocksPerRow;
+    nLastBlockIdBand0 = nBlockIdBand0;
+    if( poDS->m_poThreadPool == nullptr ||
+        poDS->eAccess != GA_ReadOnly ||
+        poDS->m_bLoadingOtherBands ||
+        !poDS->IsMultiThreadedReadCompatible() )
+    {
+        return nullptr;
+    }
+
+    const bool bIsTiled = CPL_TO_BOOL( TIFFIsTiled(poDS->m_hTIFF) );
+    // Tiles are read ahead up to the end of their row, as readers of a
+    // window go to the next row at its right edge. Strips up to the end.
+    const int nMaxBlockIdBand0 = bIsTiled ?
+        nBlockYOff * nBlocksPerRow + nBlocksPerRow - 1 :
+        poDS->m_nBlocksPerBand - 1;
+
+    const bool bContig = poDS->m_nPlanarConfig == PLANARCONFIG_CONTIG;
+    const int nBandsToCache = bContig ? poDS->nBands : 1;
+    const GDALDataType eDT = poDS->GetRasterBand(1)->GetRasterDataType();
+    const GIntBig nBlockBytes =
+        static_cast<GIntBig>(poDS->m_nBlockXSize) * poDS->m_nBlockYSize *
+        GDALGetDataTypeSizeBytes(eDT) * nBandsToCache;
+    // Do not use more than a quarter of the block cache.
+    const int nMaxBlocks = static_cast<int>(std::min<GIntBig>(
+        poDS->m_poThreadPool->GetThreadCount(),
+        GDALGetCacheMax64() / 4 / std::max<GIntBig>(1, nBlockBytes)));
+    if( nMaxBlocks <= 0 || nBlockIdBand0 >= nMaxBlockIdBand0 )
+        return nullptr;
+
+    auto poBand = poDS->GetRasterBand(nBand);
+    std::unique_ptr<GTiffBlockReadAhead> poReadAhead(
+        new GTiffBlockReadAhead(poDS));
+    auto& sContext = poReadAhead->m_sContext;
+
+    for( int nBlockIdBand0Next = nBlockIdBand0 + 1;
+         nBlockIdBand0Next <= nMaxBlockIdBand0 &&
+         static_cast<int>(poReadAhead->m_asJobs.size()) < nMaxBlocks;
+         ++nBlockIdBand0Next )
+    {
+        nLastBlockIdBand0 = nBlockIdBand0Next;
+        const int nXBlock = nBlockIdBand0Next % nBlocksPerRow;
+        const int nYBlock = nBlockIdBand0Next / nBlocksPerRow;
+        GDALRasterBlock* poBlock =
+            poBand->TryGetLockedBlockRef(nXBlock, nYBlock);
+        if( poBlock != nullptr )
+        {
+            poBlock->DropLock();
+            continue;
+        }
+
+        int nBlockId = nBlockIdBand0Next;
+        if( !bContig )
+            nBlockId += (nBand - 1) * poDS->m_nBlocksPerBand;
+        if( nBlockId == poDS->m_nLoadedBlock )
+            continue;
+
+        GTiffDecompressJob sJob;
+        if( !poDS->IsBlockAvailable(nBlockId, &sJob.nOffset, &sJob.nSize) ||
+            sJob.nSize == 0 || sJob.nSize > 100U * 1024 * 1024 )
+        {
+            // Left to IReadBlock()
+            continue;
+        }
+        sJob.psContext = &sContext;
+        sJob.iBand = bContig ? -1 : nBand - 1;
+        sJob.nXBlock = nXBlock;
+        sJob.nYBlock = nYBlock;
+        poReadAhead->m_asJobs.push_back(sJob);
+    }
+    if( poReadAhead->m_asJobs.empty() )
+        return nullptr;
+
+    poReadAhead->m_poQueue = poDS->m_poThreadPool->CreateJobQueue();
+    if( poReadAhead->m_poQueue == nullptr )
+        return nullptr;
+
+    if( bContig )
+    {
+        for( int i = 0; i < poDS->nBands; ++i )
+            poReadAhead->m_anBandMap.push_back(i + 1);
+    }
+    else
+    {
+        poReadAhead->m_anBandMap.push_back(nBand);
+    }
+
+    sContext.poHandle = reinterpret_cast<VSIVirtualHandle*>(
+        VSI_TIFFGetVSILFile(TIFFClientdata( poDS->m_hTIFF )));
+    sContext.bHasPRead = sContext.poHandle->HasPRead()
+#ifdef DEBUG
+        && CPLTestBool(CPLGetConfigOption("GTIFF_ALLOW_PREAD", "YES"))
+#endif
+        ;
+    sContext.poDS = poDS;
+    sContext.eDT = eDT;
+    // The window is only used to compute offsets in the (unset) output
+    // buffer: make it cover the whole raster.
+    sContext.nXSize = poDS->nRasterXSize;
+    sContext.nYSize = poDS->nRasterYSize;
+    sContext.nBlockXEnd = nBlocksPerRow - 1;
+    sContext.nBlockYEnd =
+        DIV_ROUND_UP(poDS->nRasterYSize, poDS->m_nBlockYSize) - 1;
+    sContext.eBufType = eDT;
+    sContext.nBufDTSize = GDALGetDataTypeSizeBytes(eDT);
+    sContext.nBandCount = static_cast<int>(poReadAhead->m_anBandMap.size());
+    sContext.panBandMap = poReadAhead->m_anBandMap.data();
+    sContext.bCacheOnly = true;
+    sContext.bCacheAllBands = bContig && poDS->nBands > 1;
+    sContext.bUseDeinterleaveOptimBlockCache =
+        bContig && (poDS->nBands == 3 || poDS->nBands == 4) &&
+        (eDT == GDT_Byte || eDT == GDT_Int16 || eDT == GDT_UInt16);
+    sContext.bIsTiled = bIsTiled;
+    sContext.bTIFFIsBigEndian = CPL_TO_BOOL( TIFFIsBigEndian(poDS->m_hTIFF) );
+    sContext.nBlocksPerRow = nBlocksPerRow;
+    poDS->FetchDecompressionTags(sContext);
+
+    for( auto& sJob: poReadAhead->m_asJobs )
+        poReadAhead->m_poQueue->SubmitJob(ThreadFunc, &sJob);
+
+    // Without pread(), the jobs and the decoding of the current block in
+    // the calling thread would compete for the file position.
+    if( !sContext.bHasPRead )
+        poReadAhead->Wait();
+
+    return poReadAhead;
+}
+
+/************************************************************************/
+/*                                Wait()                                */
+/************************************************************************/
+
+void GTiffBlockReadAhead::Wait()
+{
+    if( m_poQueue == nullptr )
+        return;
+    m_poQueue->WaitCompletion();
+    m_poQueue.reset();
+
+    if( m_sContext.bSuccess )
+    {
+        m_poDS->m_nBlocksDecodedAhead += static_cast<int>(m_asJobs.size());
+    }
+    else
+    {
+        // Evict the blocks that might have been left partially decoded.
+        for( const auto& sJob: m_asJobs )
+        {
+            for( const int iBand: m_anBandMap )
+            {
+                m_poDS->GetRasterBand(iBand)->FlushBlock(
+                    sJob.nXBlock, sJob.nYBlock, FALSE);
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                        ~GTiffBlockReadAhead()                        */
+/************************************************************************/
+
+GTiffBlockReadAhead::~GTiffBlockReadAhead()
+{
+    Wait();
+}
+
 #endif
 
 /************************************************************************/
@@ -6061,6 +6332,51 @@ CPLErr GTiffRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     if( m_poGDS->m_nPlanarConfig == PLANARCONFIG_SEPARATE )
         nBlockId = nBlockIdBand0 + (nBand - 1) * m_poGDS->m_nBlocksPerBand;
 
+#ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
+    std::unique_ptr<GTiffBlockReadAhead> poReadAhead;
+    if( m_poGDS->m_poThreadPool != nullptr && eAccess == GA_ReadOnly &&
+        IsBaseGTiffClass() )
+    {
+/* -------------------------------------------------------------------- */
+/*      Blocks decoded ahead are in the block cache: use them when      */
+/*      this method is called directly, e.g. by ReadBlock().            */
+/* -------------------------------------------------------------------- */
+        GDALRasterBlock* poBlock =
+            TryGetLockedBlockRef(nBlockXOff, nBlockYOff);
+        if( poBlock != nullptr )
+        {
+            // When called from GetLockedBlockRef(), pImage is the data
+            // of the block being loaded.
+            const bool bCached = poBlock->GetDataRef() != pImage;
+            if( bCached )
+            {
+                memcpy(pImage, poBlock->GetDataRef(),
+                       static_cast<size_t>(nBlockXSize) * nBlockYSize *
+                           GDALGetDataTypeSizeBytes(eDataType));
+            }
+            poBlock->DropLock();
+            if( bCached )
+                return CE_None;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      When blocks are read sequentially, decode the next ones in      */
+/*      worker threads while this one is decoded below. They are        */
+/*      waited for when leaving this method.                            */
+/* -------------------------------------------------------------------- */
+        if( nBlockIdBand0 == m_nLastBlockIdRead + 1 )
+        {
+            poReadAhead = GTiffBlockReadAhead::Start(m_poGDS, nBand,
+                                                     nBlockXOff, nBlockYOff,
+                                                     m_nLastBlockIdRead);
+        }
+        else
+        {
+            m_nLastBlockIdRead = nBlockIdBand0;
+        }
+    }
+#endif
+
 /* -------------------------------------------------------------------- */
 /*      The bottom most partial tiles and strips are sometimes only     */
 /*      partially encoded.  This code reduces the requested data so     */
@@ -6427,6 +6743,10 @@ CPLErr GTiffRasterBand::IWriteBlock( int nBlockXOff, int nBlockYOff,
 
         if( poBlock != nullptr )
         {
+            cpl::down_cast<GTiffRasterBand *>(
+                m_poGDS->GetRasterBand( iBand + 1 ))
+                    ->UpdateWriteStatistics( nBlockXOff, nBlockYOff,
+                                             poBlock->GetDataRef() );
             poBlock->MarkClean();
             poBlock->DropLock();
         }
@@ -8546,6 +8866,10 @@ CPLErr GTiffOddBitsBand::IWriteBlock( int nBlockXOff, int nBlockYOff,
             }
 
             pabyThisImage = static_cast<GByte *>(poBlock->GetDataRef());
+            cpl::down_cast<GTiffOddBitsBand *>(
+                m_poGDS->GetRasterBand( iBand + 1 ))
+                    ->UpdateWriteStatistics( nBlockXOff, nBlockYOff,
+                                             pabyThisImage );
         }
 
         const int iPixelBitSkip = m_poGDS->m_nBitsPerSample * m_poGDS->nBands;
@@ -9404,6 +9728,7 @@ GTiffDataset::GTiffDataset():
     m_bHasWarnedDisableAggressiveBandCaching(false),
     m_bDontReloadFirstBlock(false),
     m_bWebPLossless(false),
+    m_bHasEncoderOptions(false),
     m_bPromoteTo8Bits(false),
     m_bDebugDontWriteBlocks(CPLTestBool(CPLGetConfigOption("GTIFF_DONT_WRITE_BLOCKS", "NO"))),
     m_bIsFinalized(false),
@@ -9462,6 +9787,14 @@ int GTiffDataset::Finalize()
 
     bool bHasDroppedRef = false;
 
+#ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
+    if( m_nBlocksDecodedAhead > 0 )
+    {
+        CPLDebug("GTiff", "%s: %d blocks decoded ahead in worker threads",
+                 GetDescription(), m_nBlocksDecodedAhead);
+    }
+#endif
+
     Crystalize();
 
     if( m_bColorProfileMetadataChanged )
@@ -13157,6 +13490,14 @@ CPLErr GTiffDataset::IBuildOverviews(
 
     eErr = CreateInternalMaskOverviews(nOvrBlockXSize, nOvrBlockYSize);
 
+    // Resampling uses GDAL_NUM_THREADS, which defaults to the number of
+    // compression threads of the dataset.
+    int nThreads = GDALGetNumThreads(papszOptions, "NUM_THREADS");
+    if( nThreads == 1 && !m_asCompressionJobs.empty() )
+        nThreads = static_cast<int>(m_asCompressionJobs.size()) - 1;
+    CPLConfigOptionSetter oNumThreadsSetter(
+        "GDAL_NUM_THREADS", CPLSPrintf("%d", nThreads), true);
+
 /* -------------------------------------------------------------------- */
 /*      Refresh overviews for the mask                                  */
 /* -------------------------------------------------------------------- */
@@ -13195,9 +13536,13 @@ CPLErr GTiffDataset::IBuildOverviews(
 
 /* -------------------------------------------------------------------- */
 /*      Refresh old overviews that were listed.                         */
+/*      With several threads, bands are also processed together for     */
+/*      band interleaved files, so that they are resampled concurrently */
+/*      and that overview levels are pipelined.                         */
 /* -------------------------------------------------------------------- */
     const auto poColorTable = GetRasterBand( panBandList[0] )->GetColorTable();
-    if( (m_nPlanarConfig == PLANARCONFIG_CONTIG || bHasAlphaBand ) &&
+    if( (m_nPlanarConfig == PLANARCONFIG_CONTIG || bHasAlphaBand ||
+         (nBandsIn > 1 && nThreads > 1)) &&
         GDALDataTypeIsComplex(GetRasterBand( panBandList[0] )->
                               GetRasterDataType()) == FALSE &&
         (poColorTable == nullptr ||
@@ -13283,10 +13628,14 @@ CPLErr GTiffDataset::IBuildOverviews(
             }
         }
 
-        GDALRegenerateOverviewsMultiBand( nBandsIn, papoBandList,
-                                          nNewOverviews, papapoOverviewBands,
-                                          pszResampling, pfnProgress,
-                                          pProgressData, papszOptions );
+        if( eErr == CE_None )
+        {
+            eErr = GDALRegenerateOverviewsMultiBand(
+                nBandsIn, papoBandList,
+                nNewOverviews, papapoOverviewBands,
+                pszResampling, pfnProgress,
+                pProgressData, papszOptions );
+        }
 
         for( int iBand = 0; iBand < nBandsIn; ++iBand )
         {
@@ -18017,6 +18366,25 @@ static double GTiffGetLERCMaxZError(char** papszOptions)
     return CPLAtof(CSLFetchNameValueDef( papszOptions, "MAX_Z_ERROR", "0.0") );
 }
 
+/************************************************************************/
+/*                       GTiffHasEncoderOptions()                       */
+/************************************************************************/
+
+// Whether options that tune the encoding of the striles are set.
+static bool GTiffHasEncoderOptions(CSLConstList papszOptions)
+{
+    for( const char* pszKey: { "ZLEVEL", "ZSTD_LEVEL", "LZMA_PRESET",
+                               "MAX_Z_ERROR", "MAX_Z_ERROR_OVERVIEW",
+                               "WEBP_LEVEL", "WEBP_LOSSLESS", "JPEG_QUALITY",
+                               "JXL_LOSSLESS", "JXL_EFFORT", "JXL_DISTANCE",
+                               "DISCARD_LSB" } )
+    {
+        if( CSLFetchNameValue(papszOptions, pszKey) != nullptr )
+            return true;
+    }
+    return false;
+}
+
 static signed char GTiffGetZLevel(char** papszOptions)
 {
     int nZLevel = -1;
@@ -18160,6 +18528,12 @@ static GTiffDataset::MaskOffset* GetDiscardLsbOption(TIFF* hTIFF, char** papszOp
 void GTiffDataset::GetDiscardLsbOption(char** papszOptions)
 {
     m_panMaskOffsetLsb = ::GetDiscardLsbOption(m_hTIFF, papszOptions);
+    // So that generic code (e.g. overview generation) knows that written
+    // values are not read back unchanged. Not persisted.
+    if( m_panMaskOffsetLsb )
+        m_oGTiffMDMD.SetMetadataItem(
+            "DISCARD_LSB", CSLFetchNameValue(papszOptions, "DISCARD_LSB"),
+            "IMAGE_STRUCTURE");
 }
 
 /************************************************************************/
@@ -19640,6 +20014,7 @@ GDALDataset *GTiffDataset::Create( const char * pszFilename,
 /* -------------------------------------------------------------------- */
     poDS->m_papszCreationOptions = CSLDuplicate( papszParamList );
 
+    poDS->m_bHasEncoderOptions = GTiffHasEncoderOptions(papszParamList);
     poDS->m_nZLevel = GTiffGetZLevel(papszParamList);
     poDS->m_nLZMAPreset = GTiffGetLZMAPreset(papszParamList);
     poDS->m_nZSTDLevel = GTiffGetZSTDPreset(papszParamList);
@@ -19734,6 +20109,19 @@ CPLErr GTiffDataset::CopyImageryAndMask(GTiffDataset* poDstDS,
         CPLAssert( poDstDS->m_poMaskDS->m_nBlockYSize == poDstDS->m_nBlockYSize );
     }
 
+    // If the source has the same compression and tiling as the target,
+    // copy the imagery tiles without decompressing them.
+    const bool bCopyCompressedBlocks =
+        GDALCanCopyCompressedBlocks(poSrcDS, poDstDS);
+    if( bCopyCompressedBlocks )
+    {
+        CPLDebug("GTiff", "Copying compressed blocks from %s",
+                 poSrcDS->GetDescription());
+        if( poSrcDS->GetAccess() == GA_Update )
+            poSrcDS->FlushCache(false);
+    }
+    std::vector<GByte> abyCompressedBlock;
+
     int iBlock = 0;
     for( int iY = 0, nYBlock = 0; iY < nYSize && eErr == CE_None;
             iY = ((nYSize - iY < poDstDS->m_nBlockYSize) ? nYSize :
@@ -19747,83 +20135,103 @@ CPLErr GTiffDataset::CopyImageryAndMask(GTiffDataset* poDstDS,
                 nXBlock++ )
         {
             const int nReqXSize = std::min(nXSize - iX, poDstDS->m_nBlockXSize);
-            if( nReqXSize < poDstDS->m_nBlockXSize ||
-                nReqYSize < poDstDS->m_nBlockYSize )
-            {
-                memset(pBlockBuffer, 0, static_cast<size_t>(
-                    poDstDS->m_nBlockXSize) * poDstDS->m_nBlockYSize *
-                    l_nBands * nDataTypeSize);
-            }
 
-            if( !bIsOddBand )
+            // Blocks missing in the source go through the regular path, so
+            // that SPARSE_OK is honoured.
+            bool bBlockCopied = false;
+            if( bCopyCompressedBlocks )
             {
-                eErr = poSrcDS->RasterIO( GF_Read,
-                    iX, iY, nReqXSize, nReqYSize,
-                    pBlockBuffer, nReqXSize, nReqYSize,
-                    eType,
-                    l_nBands, nullptr,
-                    nDataTypeSize * l_nBands,
-                    poDstDS->m_nBlockXSize * nDataTypeSize * l_nBands,
-                    nDataTypeSize,
-                    nullptr );
-                if( eErr == CE_None )
+                eErr = poSrcDS->ReadCompressedData(0, nXBlock, nYBlock,
+                                                   abyCompressedBlock);
+                if( eErr == CE_None && !abyCompressedBlock.empty() )
                 {
-                    eErr = poDstDS->WriteEncodedTileOrStrip(
-                        iBlock, pBlockBuffer, false);
+                    eErr = poDstDS->WriteCompressedData(
+                        0, nXBlock, nYBlock,
+                        abyCompressedBlock.data(), abyCompressedBlock.size());
+                    bBlockCopied = true;
                 }
             }
-            else
+
+            if( eErr == CE_None && !bBlockCopied )
             {
-                // In the odd bit case, this is a bit messy to ensure
-                // the strile gets written synchronously.
-                // We load the content of the n-1 bands in the cache,
-                // and for the last band we invoke WriteBlock() directly
-                // We also force FlushBlockBuf()
-                std::vector<GDALRasterBlock*> apoLockedBlocks;
-                for( int i = 0; eErr == CE_None && i < l_nBands - 1; i++ )
-                {
-                    auto poBlock = poDstDS->GetRasterBand(i+1)->GetLockedBlockRef(
-                        nXBlock, nYBlock, TRUE);
-                    if( poBlock )
-                    {
-                        eErr = poSrcDS->GetRasterBand(i+1)->RasterIO(
-                            GF_Read,
-                            iX, iY, nReqXSize, nReqYSize,
-                            poBlock->GetDataRef(), nReqXSize, nReqYSize,
-                            eType,
-                            nDataTypeSize,
-                            nDataTypeSize * poDstDS->m_nBlockXSize, nullptr);
-                        poBlock->MarkDirty();
-                        apoLockedBlocks.emplace_back(poBlock);
-                    }
-                    else
-                    {
-                        eErr = CE_Failure;
-                    }
-                }
-                if( eErr == CE_None )
+                if( nReqXSize < poDstDS->m_nBlockXSize ||
+                    nReqYSize < poDstDS->m_nBlockYSize )
                 {
-                    eErr = poSrcDS->GetRasterBand(l_nBands)->RasterIO(
-                            GF_Read,
-                            iX, iY, nReqXSize, nReqYSize,
-                            pBlockBuffer, nReqXSize, nReqYSize,
-                            eType,
-                            nDataTypeSize,
-                            nDataTypeSize * poDstDS->m_nBlockXSize, nullptr);
+                    memset(pBlockBuffer, 0, static_cast<size_t>(
+                        poDstDS->m_nBlockXSize) * poDstDS->m_nBlockYSize *
+                        l_nBands * nDataTypeSize);
                 }
-                if( eErr == CE_None )
+
+                if( !bIsOddBand )
                 {
-                    // Avoid any attempt to load from disk
-                    poDstDS->m_nLoadedBlock = iBlock;
-                    eErr = poDstDS->GetRasterBand(l_nBands)->WriteBlock(
-                        nXBlock, nYBlock, pBlockBuffer);
+                    eErr = poSrcDS->RasterIO( GF_Read,
+                        iX, iY, nReqXSize, nReqYSize,
+                        pBlockBuffer, nReqXSize, nReqYSize,
+                        eType,
+                        l_nBands, nullptr,
+                        nDataTypeSize * l_nBands,
+                        poDstDS->m_nBlockXSize * nDataTypeSize * l_nBands,
+                        nDataTypeSize,
+                        nullptr );
                     if( eErr == CE_None )
-                        eErr = poDstDS->FlushBlockBuf();
+                    {
+                        eErr = poDstDS->WriteEncodedTileOrStrip(
+                            iBlock, pBlockBuffer, false);
+                    }
                 }
-                for( auto poBlock: apoLockedBlocks )
+                else
                 {
-                    poBlock->MarkClean();
-                    poBlock->DropLock();
+                    // In the odd bit case, this is a bit messy to ensure
+                    // the strile gets written synchronously.
+                    // We load the content of the n-1 bands in the cache,
+                    // and for the last band we invoke WriteBlock() directly
+                    // We also force FlushBlockBuf()
+                    std::vector<GDALRasterBlock*> apoLockedBlocks;
+                    for( int i = 0; eErr == CE_None && i < l_nBands - 1; i++ )
+                    {
+                        auto poBlock = poDstDS->GetRasterBand(i+1)->GetLockedBlockRef(
+                            nXBlock, nYBlock, TRUE);
+                        if( poBlock )
+                        {
+                            eErr = poSrcDS->GetRasterBand(i+1)->RasterIO(
+                                GF_Read,
+                                iX, iY, nReqXSize, nReqYSize,
+                                poBlock->GetDataRef(), nReqXSize, nReqYSize,
+                                eType,
+                                nDataTypeSize,
+                                nDataTypeSize * poDstDS->m_nBlockXSize, nullptr);
+                            poBlock->MarkDirty();
+                            apoLockedBlocks.emplace_back(poBlock);
+                        }
+                        else
+                        {
+                            eErr = CE_Failure;
+                        }
+                    }
+                    if( eErr == CE_None )
+                    {
+                        eErr = poSrcDS->GetRasterBand(l_nBands)->RasterIO(
+                                GF_Read,
+                                iX, iY, nReqXSize, nReqYSize,
+                                pBlockBuffer, nReqXSize, nReqYSize,
+                                eType,
+                                nDataTypeSize,
+                                nDataTypeSize * poDstDS->m_nBlockXSize, nullptr);
+                    }
+                    if( eErr == CE_None )
+                    {
+                        // Avoid any attempt to load from disk
+                        poDstDS->m_nLoadedBlock = iBlock;
+                        eErr = poDstDS->GetRasterBand(l_nBands)->WriteBlock(
+                            nXBlock, nYBlock, pBlockBuffer);
+                        if( eErr == CE_None )
+                            eErr = poDstDS->FlushBlockBuf();
+                    }
+                    for( auto poBlock: apoLockedBlocks )
+                    {
+                        poBlock->MarkClean();
+                        poBlock->DropLock();
+                    }
                 }
             }
 
@@ -20923,6 +21331,7 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
     // TIFFTAG_ZIPQUALITY & TIFFTAG_JPEGQUALITY are not store in the TIFF file.
     // They are just TIFF session parameters.
 
+    poDS->m_bHasEncoderOptions = GTiffHasEncoderOptions(papszOptions);
     poDS->m_nZLevel = GTiffGetZLevel(papszOptions);
     poDS->m_nLZMAPreset = GTiffGetLZMAPreset(papszOptions);
     poDS->m_nZSTDLevel = GTiffGetZSTDPreset(papszOptions);
@@ -22654,6 +23063,175 @@ bool GTiffDataset::GetRawBinaryLayout(GDALDataset::RawBinaryLayout& sLayout)
     return true;
 }
 
+/************************************************************************/
+/*                      GetCompressedBlockLayout()                      */
+/************************************************************************/
+
+bool GTiffDataset::GetCompressedBlockLayout(
+                            GDALDataset::CompressedBlockLayout& sLayout)
+{
+    // JPEG strips/tiles are abbreviated streams that depend on the
+    // JPEGTABLES tag, and are dealt with by gt_jpeg_copy.cpp
+    if( m_nCompression == COMPRESSION_JPEG ||
+        m_nCompression == COMPRESSION_OJPEG ||
+        m_bStreamingIn || m_bStreamingOut )
+    {
+        return false;
+    }
+
+    // Copying encoded striles into a dataset being written is only
+    // equivalent to encoding them again if no encoding setting was
+    // requested, and if the codec is lossless.
+    if( eAccess == GA_Update &&
+        (m_bHasEncoderOptions || m_panMaskOffsetLsb != nullptr ||
+         (m_nCompression == COMPRESSION_WEBP && !m_bWebPLossless) ||
+         (m_nCompression == COMPRESSION_LERC && m_dfMaxZError > 0)
+#if HAVE_JXL
+         || (m_nCompression == COMPRESSION_JXL && !m_bJXLLossless)
+#endif
+        ) )
+    {
+        return false;
+    }
+
+    uint16_t nPredictor = PREDICTOR_NONE;
+    if( GTIFFSupportsPredictor(m_nCompression) )
+        TIFFGetField( m_hTIFF, TIFFTAG_PREDICTOR, &nPredictor );
+
+    uint16_t nFillOrder = FILLORDER_MSB2LSB;
+    TIFFGetFieldDefaulted( m_hTIFF, TIFFTAG_FILLORDER, &nFillOrder );
+
+    uint32_t anLercParams[2] = {0, 0};
+    if( m_nCompression == COMPRESSION_LERC )
+    {
+        anLercParams[0] = m_anLercAddCompressionAndVersion[0];
+        anLercParams[1] = m_anLercAddCompressionAndVersion[1];
+    }
+
+    // Everything that influences the decoding of the raw bytes of a
+    // strile must be part of the format string.
+    sLayout.osFormat = CPLSPrintf(
+        "GTiff;COMPRESS=%d;PREDICTOR=%d;NBITS=%d;SAMPLEFORMAT=%d;"
+        "SAMPLES=%d;PHOTOMETRIC=%d;FILLORDER=%d;%s;%s;LERC_PARAMETERS=%u,%u",
+        m_nCompression, nPredictor, m_nBitsPerSample, m_nSampleFormat,
+        m_nPlanarConfig == PLANARCONFIG_CONTIG ? nBands : 1,
+        m_nPhotometric, nFillOrder,
+        TIFFIsTiled(m_hTIFF) ? "TILED" : "STRIPPED",
+        TIFFIsBigEndian(m_hTIFF) ? "MSB" : "LSB",
+        anLercParams[0], anLercParams[1]);
+    sLayout.nBlockXSize = m_nBlockXSize;
+    sLayout.nBlockYSize = m_nBlockYSize;
+    sLayout.nPlaneCount =
+        m_nPlanarConfig == PLANARCONFIG_CONTIG ? 1 : nBands;
+    return true;
+}
+
+/************************************************************************/
+/*                         ReadCompressedData()                         */
+/************************************************************************/
+
+CPLErr GTiffDataset::ReadCompressedData(int nPlane,
+                                        int nXBlockOff, int nYBlockOff,
+                                        std::vector<GByte>& abyData)
+{
+    abyData.clear();
+
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, m_nBlockXSize);
+    const int nBlockId = nXBlockOff + nYBlockOff * nBlocksPerRow +
+                         nPlane * m_nBlocksPerBand;
+
+    vsi_l_offset nOffset = 0;
+    vsi_l_offset nSize = 0;
+    bool bErrOccurred = false;
+    if( !IsBlockAvailable(nBlockId, &nOffset, &nSize, &bErrOccurred) )
+    {
+        return bErrOccurred ? CE_Failure : CE_None;
+    }
+
+    if( nSize > static_cast<vsi_l_offset>(std::numeric_limits<int>::max()) )
+    {
+        ReportError(CE_Failure, CPLE_NotSupported,
+                    "Too large strile size: " CPL_FRMT_GUIB,
+                    static_cast<GUIntBig>(nSize));
+        return CE_Failure;
+    }
+
+    try
+    {
+        abyData.resize(static_cast<size_t>(nSize));
+    }
+    catch( const std::exception& )
+    {
+        ReportError(CE_Failure, CPLE_OutOfMemory,
+                    "Cannot allocate " CPL_FRMT_GUIB " bytes",
+                    static_cast<GUIntBig>(nSize));
+        return CE_Failure;
+    }
+
+    VSILFILE* fp = VSI_TIFFGetVSILFile(TIFFClientdata(m_hTIFF));
+    if( VSIFSeekL(fp, nOffset, SEEK_SET) != 0 ||
+        VSIFReadL(abyData.data(), 1, abyData.size(), fp) != abyData.size() )
+    {
+        ReportError(CE_Failure, CPLE_FileIO,
+                    "Cannot read strile %d", nBlockId);
+        abyData.clear();
+        return CE_Failure;
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                        WriteCompressedData()                         */
+/************************************************************************/
+
+CPLErr GTiffDataset::WriteCompressedData(int nPlane,
+                                         int nXBlockOff, int nYBlockOff,
+                                         const void* pData, size_t nDataSize)
+{
+    if( eAccess != GA_Update )
+    {
+        ReportError(CE_Failure, CPLE_NotSupported,
+                    "Dataset opened in read-only mode");
+        return CE_Failure;
+    }
+
+    Crystalize();
+
+    if( m_bDebugDontWriteBlocks )
+        return CE_None;
+
+    if( m_bWriteError )
+        return CE_Failure;
+
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, m_nBlockXSize);
+    const int nBlockId = nXBlockOff + nYBlockOff * nBlocksPerRow +
+                         nPlane * m_nBlocksPerBand;
+
+    if( m_bLoadedBlockDirty && m_nLoadedBlock != -1 )
+        FlushBlockBuf();
+    if( m_nLoadedBlock == nBlockId )
+        m_nLoadedBlock = -1;
+
+    // Striles pending in the compression queue must be written first, so
+    // that the strile order of the file is preserved.
+    auto poQueue = m_poBaseDS ?
+        m_poBaseDS->m_poCompressQueue.get() : m_poCompressQueue.get();
+    if( poQueue )
+    {
+        auto& oQueue = m_poBaseDS ? m_poBaseDS->m_asQueueJobIdx : m_asQueueJobIdx;
+        while( !oQueue.empty() )
+        {
+            WaitCompletionForJobIdx(oQueue.front());
+        }
+    }
+
+    WriteRawStripOrTile(nBlockId,
+                        static_cast<GByte*>(const_cast<void*>(pData)),
+                        static_cast<GPtrDiff_t>(nDataSize));
+
+    return m_bWriteError ? CE_Failure : CE_None;
+}
+
 /************************************************************************/
 /*                       PrepareTIFFErrorFormat()                       */
 /*                                                                      */
@@ -45,6 +45,7 @@
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "gtiff.h"
 #include "tiff.h"
 #include "tiffvers.h"
@@ -1052,11 +1053,29 @@ GTIFFBuildOverviewsEx( const char * pszFilename,
             bHasAlphaBand = true;
     }
 
+    // With several threads, bands are also processed together for band
+    // interleaved overviews, so that they are resampled concurrently and
+    // that overview levels are pipelined.
+    bool bMultiThreadedBands =
+        nBands > 1 && GDALGetNumThreads(papszOptions, "NUM_THREADS") > 1;
+    for( int iBand = 1; bMultiThreadedBands && iBand < nBands; iBand++ )
+    {
+        // GDALRegenerateOverviewsMultiBand() requires the same data type,
+        // and decides whether to use masks from the first band.
+        if( papoBandList[iBand]->GetRasterDataType() !=
+                papoBandList[0]->GetRasterDataType() ||
+            (papoBandList[iBand]->GetMaskFlags() & GMF_ALL_VALID) !=
+                (papoBandList[0]->GetMaskFlags() & GMF_ALL_VALID) )
+        {
+            bMultiThreadedBands = false;
+        }
+    }
+
     const auto poColorTable = papoBandList[0]->GetColorTable();
     if(  ((((bSourceIsPixelInterleaved && bSourceIsJPEG2000) ||
             (nCompression != COMPRESSION_NONE)) &&
            nPlanarConfig == PLANARCONFIG_CONTIG) ||
-          bHasAlphaBand) &&
+          bHasAlphaBand || bMultiThreadedBands) &&
          !GDALDataTypeIsComplex(papoBandList[0]->GetRasterDataType()) &&
           (poColorTable == nullptr ||
            STARTS_WITH_CI(pszResampling, "NEAR") ||
@@ -15,4 +15,10 @@ for i in *.h; do
   fi
 done
 
+# GDAL specific changes, until they are merged upstream
+for i in *.patch; do
+  echo "Apply $i"
+  patch -p0 < "$i" || exit 1
+done
+
 rm -rf tmp_libtiff
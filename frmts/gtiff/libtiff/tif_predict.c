@@ -282,6 +282,335 @@ PredictorSetupEncode(TIFF* tif)
     case 0:  ;			\
     }
 
+/*
+ * SSE2 kernels for the horizontal differencing and floating point
+ * predictors. SSE2 is part of the baseline of x86_64, so no runtime
+ * dispatching is needed. Rows that are too short, or strides that are not
+ * handled, are left to the scalar code.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PREDICTOR_USE_SSE2
+#include <emmintrin.h>
+
+/* Wrapping addition / subtraction of elements of elsize bytes. */
+static inline __m128i
+predAddSSE2(__m128i a, __m128i b, int elsize)
+{
+	switch (elsize) {
+	case 1: return _mm_add_epi8(a, b);
+	case 2: return _mm_add_epi16(a, b);
+	case 4: return _mm_add_epi32(a, b);
+	default: return _mm_add_epi64(a, b);
+	}
+}
+
+static inline __m128i
+predSubSSE2(__m128i a, __m128i b, int elsize)
+{
+	switch (elsize) {
+	case 1: return _mm_sub_epi8(a, b);
+	case 2: return _mm_sub_epi16(a, b);
+	case 4: return _mm_sub_epi32(a, b);
+	default: return _mm_sub_epi64(a, b);
+	}
+}
+
+/* Replicate the last nbytes bytes of v, with nbytes = 1, 2, 4 or 8. */
+static inline __m128i
+predBroadcastLastSSE2(__m128i v, int nbytes)
+{
+	switch (nbytes) {
+	case 1:
+		v = _mm_unpackhi_epi8(v, v);
+		/*-fallthrough*/
+	case 2:
+		v = _mm_shufflehi_epi16(v, 0xFF);
+		return _mm_unpackhi_epi64(v, v);
+	case 4:
+		return _mm_shuffle_epi32(v, 0xFF);
+	default:
+		return _mm_unpackhi_epi64(v, v);
+	}
+}
+
+/*
+ * In-register prefix sum of the elements of v that are nbytes apart
+ * (nbytes = stride * elsize = 1, 2, 4 or 8).
+ */
+static inline __m128i
+predScanSSE2(__m128i v, int nbytes, int elsize)
+{
+	if (nbytes <= 1)
+		v = predAddSSE2(v, _mm_slli_si128(v, 1), elsize);
+	if (nbytes <= 2)
+		v = predAddSSE2(v, _mm_slli_si128(v, 2), elsize);
+	if (nbytes <= 4)
+		v = predAddSSE2(v, _mm_slli_si128(v, 4), elsize);
+	return predAddSSE2(v, _mm_slli_si128(v, 8), elsize);
+}
+
+static inline tmsize_t
+horAccSSE2Impl(uint8_t* cp, tmsize_t cc, int nbytes, int elsize)
+{
+	__m128i carry = _mm_setzero_si128();
+	tmsize_t i = 0;
+	for ( ; i + 16 <= cc; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(cp + i));
+		v = predAddSSE2(predScanSSE2(v, nbytes, elsize), carry, elsize);
+		_mm_storeu_si128((__m128i*)(cp + i), v);
+		carry = predBroadcastLastSSE2(v, nbytes);
+	}
+	return i;
+}
+
+/* Scalar accumulation of the elements of index [first, wc[ */
+TIFF_NOSANITIZE_UNSIGNED_INT_OVERFLOW
+static void
+horAccTail(uint8_t* cp, tmsize_t first, tmsize_t wc, tmsize_t stride,
+           int elsize)
+{
+	tmsize_t i;
+	switch (elsize) {
+	case 1:
+		for (i = first; i < wc; i++)
+			cp[i] = (uint8_t)((cp[i] + cp[i - stride]) & 0xff);
+		break;
+	case 2: {
+		uint16_t* wp = (uint16_t*) cp;
+		for (i = first; i < wc; i++)
+			wp[i] = (uint16_t)(((unsigned int)wp[i] +
+			                    (unsigned int)wp[i - stride]) & 0xffff);
+		break;
+	}
+	case 4: {
+		uint32_t* wp = (uint32_t*) cp;
+		for (i = first; i < wc; i++)
+			wp[i] += wp[i - stride];
+		break;
+	}
+	default: {
+		uint64_t* wp = (uint64_t*) cp;
+		for (i = first; i < wc; i++)
+			wp[i] += wp[i - stride];
+		break;
+	}
+	}
+}
+
+/*
+ * Horizontal accumulation of a row of cc bytes, made of elements of elsize
+ * bytes. Returns 0 if the row must be processed by the scalar code, that is
+ * if it is smaller than a register or if stride * elsize is not 1, 2, 4 or 8.
+ */
+static int
+horAccSSE2(uint8_t* cp, tmsize_t cc, tmsize_t stride, int elsize)
+{
+	tmsize_t done;
+	switch (stride * elsize) {
+	case 1:
+		done = horAccSSE2Impl(cp, cc, 1, 1);
+		break;
+	case 2:
+		done = elsize == 1 ? horAccSSE2Impl(cp, cc, 2, 1) :
+		                     horAccSSE2Impl(cp, cc, 2, 2);
+		break;
+	case 4:
+		switch (elsize) {
+		case 1: done = horAccSSE2Impl(cp, cc, 4, 1); break;
+		case 2: done = horAccSSE2Impl(cp, cc, 4, 2); break;
+		default: done = horAccSSE2Impl(cp, cc, 4, 4); break;
+		}
+		break;
+	case 8:
+		switch (elsize) {
+		case 1: done = horAccSSE2Impl(cp, cc, 8, 1); break;
+		case 2: done = horAccSSE2Impl(cp, cc, 8, 2); break;
+		case 4: done = horAccSSE2Impl(cp, cc, 8, 4); break;
+		default: done = horAccSSE2Impl(cp, cc, 8, 8); break;
+		}
+		break;
+	default:
+		return 0;
+	}
+	if (done == 0)
+		return 0;
+	/* done is a multiple of 16, hence of stride * elsize */
+	horAccTail(cp, done / elsize, cc / elsize, stride, elsize);
+	return 1;
+}
+
+static inline tmsize_t
+horDiffSSE2Impl(uint8_t* cp, tmsize_t cc, tmsize_t nbytes, int elsize)
+{
+	/*
+	 * Go backwards so that the values at i - nbytes are still the original
+	 * ones when they are loaded.
+	 */
+	tmsize_t i = cc;
+	while (i - 16 >= nbytes) {
+		__m128i v, prev;
+		i -= 16;
+		v = _mm_loadu_si128((const __m128i*)(cp + i));
+		prev = _mm_loadu_si128((const __m128i*)(cp + i - nbytes));
+		_mm_storeu_si128((__m128i*)(cp + i), predSubSSE2(v, prev, elsize));
+	}
+	return i;
+}
+
+/* Scalar differencing of the elements of index [stride, wc[ */
+TIFF_NOSANITIZE_UNSIGNED_INT_OVERFLOW
+static void
+horDiffHead(uint8_t* cp, tmsize_t wc, tmsize_t stride, int elsize)
+{
+	tmsize_t i;
+	switch (elsize) {
+	case 1:
+		for (i = wc - 1; i >= stride; i--)
+			cp[i] = (uint8_t)((cp[i] - cp[i - stride]) & 0xff);
+		break;
+	case 2: {
+		uint16_t* wp = (uint16_t*) cp;
+		for (i = wc - 1; i >= stride; i--)
+			wp[i] = (uint16_t)(((unsigned int)wp[i] -
+			                    (unsigned int)wp[i - stride]) & 0xffff);
+		break;
+	}
+	case 4: {
+		uint32_t* wp = (uint32_t*) cp;
+		for (i = wc - 1; i >= stride; i--)
+			wp[i] -= wp[i - stride];
+		break;
+	}
+	default: {
+		uint64_t* wp = (uint64_t*) cp;
+		for (i = wc - 1; i >= stride; i--)
+			wp[i] -= wp[i - stride];
+		break;
+	}
+	}
+}
+
+/*
+ * Horizontal differencing of a row of cc bytes, made of elements of elsize
+ * bytes, for any stride. Returns 0 if the row must be processed by the scalar
+ * code, that is if it is smaller than a register.
+ */
+static int
+horDiffSSE2(uint8_t* cp, tmsize_t cc, tmsize_t stride, int elsize)
+{
+	tmsize_t remaining;
+	if (cc - stride * elsize < 16)
+		return 0;
+	switch (elsize) {
+	case 1: remaining = horDiffSSE2Impl(cp, cc, stride, 1); break;
+	case 2: remaining = horDiffSSE2Impl(cp, cc, stride * 2, 2); break;
+	case 4: remaining = horDiffSSE2Impl(cp, cc, stride * 4, 4); break;
+	default: remaining = horDiffSSE2Impl(cp, cc, stride * 8, 8); break;
+	}
+	/* remaining = cc - 16 * k is a multiple of elsize */
+	horDiffHead(cp, remaining / elsize, stride, elsize);
+	return 1;
+}
+
+/*
+ * Interleave the bps byte planes of tmp (most significant byte first) into
+ * little-endian words of cp, 16 words at a time. Returns the number of words
+ * processed.
+ */
+static tmsize_t
+fpInterleaveSSE2(uint8_t* cp, const uint8_t* tmp, tmsize_t wc, uint32_t bps)
+{
+	tmsize_t count = 0;
+	if (bps == 2) {
+		for ( ; count + 16 <= wc; count += 16) {
+			__m128i b0 = _mm_loadu_si128((const __m128i*)(tmp + wc + count));
+			__m128i b1 = _mm_loadu_si128((const __m128i*)(tmp + count));
+			__m128i* out = (__m128i*)(cp + 2 * count);
+			_mm_storeu_si128(out, _mm_unpacklo_epi8(b0, b1));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi8(b0, b1));
+		}
+	} else if (bps == 4) {
+		for ( ; count + 16 <= wc; count += 16) {
+			__m128i b0 = _mm_loadu_si128((const __m128i*)(tmp + 3 * wc + count));
+			__m128i b1 = _mm_loadu_si128((const __m128i*)(tmp + 2 * wc + count));
+			__m128i b2 = _mm_loadu_si128((const __m128i*)(tmp + wc + count));
+			__m128i b3 = _mm_loadu_si128((const __m128i*)(tmp + count));
+			__m128i b01lo = _mm_unpacklo_epi8(b0, b1);
+			__m128i b01hi = _mm_unpackhi_epi8(b0, b1);
+			__m128i b23lo = _mm_unpacklo_epi8(b2, b3);
+			__m128i b23hi = _mm_unpackhi_epi8(b2, b3);
+			__m128i* out = (__m128i*)(cp + 4 * count);
+			_mm_storeu_si128(out, _mm_unpacklo_epi16(b01lo, b23lo));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(b01lo, b23lo));
+			_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(b01hi, b23hi));
+			_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(b01hi, b23hi));
+		}
+	} else if (bps == 8) {
+		for ( ; count + 16 <= wc; count += 16) {
+			__m128i b[8], b2[8], b4[8];
+			__m128i* out = (__m128i*)(cp + 8 * count);
+			int k;
+			for (k = 0; k < 8; k++)
+				b[k] = _mm_loadu_si128(
+				    (const __m128i*)(tmp + (7 - k) * wc + count));
+			/* Pairs of bytes, then of 16-bit and 32-bit values. */
+			for (k = 0; k < 4; k++) {
+				b2[2 * k] = _mm_unpacklo_epi8(b[2 * k], b[2 * k + 1]);
+				b2[2 * k + 1] = _mm_unpackhi_epi8(b[2 * k], b[2 * k + 1]);
+			}
+			for (k = 0; k < 2; k++) {
+				b4[4 * k] = _mm_unpacklo_epi16(b2[4 * k], b2[4 * k + 2]);
+				b4[4 * k + 1] = _mm_unpackhi_epi16(b2[4 * k], b2[4 * k + 2]);
+				b4[4 * k + 2] = _mm_unpacklo_epi16(b2[4 * k + 1], b2[4 * k + 3]);
+				b4[4 * k + 3] = _mm_unpackhi_epi16(b2[4 * k + 1], b2[4 * k + 3]);
+			}
+			for (k = 0; k < 4; k++) {
+				_mm_storeu_si128(out + 2 * k,
+				                 _mm_unpacklo_epi32(b4[k], b4[k + 4]));
+				_mm_storeu_si128(out + 2 * k + 1,
+				                 _mm_unpackhi_epi32(b4[k], b4[k + 4]));
+			}
+		}
+	}
+	return count;
+}
+
+/*
+ * Split the little-endian words of tmp into the bps byte planes of cp (most
+ * significant byte first), 16 words at a time. Each pass interleaves the
+ * first and second halves of the registers, and log2(16) passes transpose
+ * the 16 x bps byte matrix. Returns the number of words processed.
+ */
+static tmsize_t
+fpDeinterleaveSSE2(uint8_t* cp, const uint8_t* tmp, tmsize_t wc, uint32_t bps)
+{
+	tmsize_t count = 0;
+	if (bps != 2 && bps != 4 && bps != 8)
+		return 0;
+	for ( ; count + 16 <= wc; count += 16) {
+		__m128i x[8], y[8];
+		uint32_t k, half = bps / 2;
+		int pass;
+		for (k = 0; k < bps; k++)
+			x[k] = _mm_loadu_si128(
+			    (const __m128i*)(tmp + bps * count + 16 * k));
+		for (pass = 0; pass < 4; pass++) {
+			for (k = 0; k < half; k++) {
+				y[2 * k] = _mm_unpacklo_epi8(x[k], x[k + half]);
+				y[2 * k + 1] = _mm_unpackhi_epi8(x[k], x[k + half]);
+			}
+			for (k = 0; k < bps; k++)
+				x[k] = y[k];
+		}
+		for (k = 0; k < bps; k++)
+			_mm_storeu_si128((__m128i*)(cp + (bps - k - 1) * wc + count),
+			                 x[k]);
+	}
+	return count;
+}
+#endif /* PREDICTOR_USE_SSE2 */
+
 /* Remarks related to C standard compliance in all below functions : */
 /* - to avoid any undefined behavior, we only operate on unsigned types */
 /*   since the behavior of "overflows" is defined (wrap over) */
@@ -302,6 +631,11 @@ horAcc8(TIFF* tif, uint8_t* cp0, tmsize_t cc)
         return 0;
     }
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horAccSSE2(cp, cc, stride, 1))
+		return 1;
+#endif
+
 	if (cc > stride) {
 		/*
 		 * Pipeline the most common cases.
@@ -365,6 +699,11 @@ horAcc16(TIFF* tif, uint8_t* cp0, tmsize_t cc)
         return 0;
     }
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horAccSSE2(cp0, cc, stride, 2))
+		return 1;
+#endif
+
 	if (wc > stride) {
 		wc -= stride;
 		do {
@@ -400,6 +739,11 @@ horAcc32(TIFF* tif, uint8_t* cp0, tmsize_t cc)
         return 0;
     }
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horAccSSE2(cp0, cc, stride, 4))
+		return 1;
+#endif
+
 	if (wc > stride) {
 		wc -= stride;
 		do {
@@ -435,6 +779,11 @@ horAcc64(TIFF* tif, uint8_t* cp0, tmsize_t cc)
 		return 0;
 	}
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horAccSSE2(cp0, cc, stride, 8))
+		return 1;
+#endif
+
 	if (wc > stride) {
 		wc -= stride;
 		do {
@@ -469,6 +818,10 @@ fpAcc(TIFF* tif, uint8_t* cp0, tmsize_t cc)
 	if (!tmp)
 		return 0;
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horAccSSE2(cp, cc, stride, 1))
+		count = 0; /* already accumulated */
+#endif
 	while (count > stride) {
 		REPEAT4(stride, cp[stride] =
                         (unsigned char) ((cp[stride] + cp[0]) & 0xff); cp++)
@@ -477,7 +830,12 @@ fpAcc(TIFF* tif, uint8_t* cp0, tmsize_t cc)
 
 	_TIFFmemcpy(tmp, cp0, cc);
 	cp = (uint8_t *) cp0;
-	for (count = 0; count < wc; count++) {
+#ifdef PREDICTOR_USE_SSE2
+	count = fpInterleaveSSE2(cp, tmp, wc, bps);
+#else
+	count = 0;
+#endif
+	for ( ; count < wc; count++) {
 		uint32_t byte;
 		for (byte = 0; byte < bps; byte++) {
 			#if WORDS_BIGENDIAN
@@ -561,6 +919,11 @@ horDiff8(TIFF* tif, uint8_t* cp0, tmsize_t cc)
         return 0;
     }
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horDiffSSE2(cp, cc, stride, 1))
+		return 1;
+#endif
+
 	if (cc > stride) {
 		cc -= stride;
 		/*
@@ -616,6 +979,11 @@ horDiff16(TIFF* tif, uint8_t* cp0, tmsize_t cc)
         return 0;
     }
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horDiffSSE2(cp0, cc, stride, 2))
+		return 1;
+#endif
+
 	if (wc > stride) {
 		wc -= stride;
 		wp += wc - 1;
@@ -656,6 +1024,11 @@ horDiff32(TIFF* tif, uint8_t* cp0, tmsize_t cc)
         return 0;
     }
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horDiffSSE2(cp0, cc, stride, 4))
+		return 1;
+#endif
+
 	if (wc > stride) {
 		wc -= stride;
 		wp += wc - 1;
@@ -696,6 +1069,11 @@ horDiff64(TIFF* tif, uint8_t* cp0, tmsize_t cc)
 		return 0;
 	}
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horDiffSSE2(cp0, cc, stride, 8))
+		return 1;
+#endif
+
 	if (wc > stride) {
 		wc -= stride;
 		wp += wc - 1;
@@ -746,7 +1124,12 @@ fpDiff(TIFF* tif, uint8_t* cp0, tmsize_t cc)
 		return 0;
 
 	_TIFFmemcpy(tmp, cp0, cc);
-	for (count = 0; count < wc; count++) {
+#ifdef PREDICTOR_USE_SSE2
+	count = fpDeinterleaveSSE2(cp, tmp, wc, bps);
+#else
+	count = 0;
+#endif
+	for ( ; count < wc; count++) {
 		uint32_t byte;
 		for (byte = 0; byte < bps; byte++) {
 			#if WORDS_BIGENDIAN
@@ -759,6 +1142,10 @@ fpDiff(TIFF* tif, uint8_t* cp0, tmsize_t cc)
 	}
 	_TIFFfreeExt(tif, tmp);
 
+#ifdef PREDICTOR_USE_SSE2
+	if (horDiffSSE2(cp0, cc, stride, 1))
+		return 1;
+#endif
 	cp = (uint8_t *) cp0;
 	cp += cc - stride - 1;
 	for (count = cc; count > stride; count -= stride)
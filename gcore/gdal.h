@@ -865,6 +865,22 @@ GDALDatasetH CPL_DLL CPL_STDCALL GDALOpenShared( const char *, GDALAccess ) CPL_
 #define     GDAL_OF_BLOCK_ACCESS_MASK     0x300
 #endif
 
+/** Open a read-only raster dataset whose handle can be shared by several
+ * threads for reading, for example with GDALDatasetRasterIO() or
+ * GDALRasterIO(). The bands of the returned dataset own a block cache
+ * shared by all threads. Missing blocks are decoded concurrently through
+ * underlying dataset handles borrowed from a pool, which keeps at most as many
+ * idle handles as there are CPUs.
+ *
+ * Must be combined with GDAL_OF_RASTER, and cannot be used with
+ * GDAL_OF_UPDATE or GDAL_OF_SHARED. Methods that modify the dataset are
+ * not supported.
+ *
+ * Used by GDALOpenEx().
+ * @since GDAL 3.7
+ */
+#define     GDAL_OF_THREAD_SAFE           0x800
+
 GDALDatasetH CPL_DLL CPL_STDCALL GDALOpenEx( const char* pszFilename,
                                              unsigned int nOpenFlags,
                                              const char* const* papszAllowedDrivers,
@@ -1241,6 +1257,10 @@ CPLErr CPL_DLL CPL_STDCALL GDALComputeRasterStatistics(
 CPLErr CPL_DLL CPL_STDCALL GDALSetRasterStatistics(
     GDALRasterBandH hBand,
     double dfMin, double dfMax, double dfMean, double dfStdDev );
+CPLErr CPL_DLL CPL_STDCALL GDALComputeRasterQuantiles(
+    GDALRasterBandH hBand, int bApproxOK,
+    int nQuantiles, const double *padfProbabilities, double *padfQuantiles,
+    GDALProgressFunc pfnProgress, void *pProgressData );
 
 GDALMDArrayH CPL_DLL GDALRasterBandAsMDArray(GDALRasterBandH) CPL_WARN_UNUSED_RESULT;
 
@@ -1747,6 +1767,42 @@ GIntBig CPL_DLL CPL_STDCALL GDALGetCacheUsed64(void);
 
 int CPL_DLL CPL_STDCALL GDALFlushCacheBlock(void);
 
+/** Block cache statistics.
+ *
+ * Returned by GDALGetBlockCacheStatistics(),
+ * GDALDatasetGetBlockCacheStatistics() and
+ * GDALGetRasterBandBlockCacheStatistics().
+ *
+ * @since GDAL 3.7
+ */
+typedef struct
+{
+    /** Number of block requests satisfied from the block cache. */
+    GIntBig nHits;
+    /** Number of block requests that required a new block to be
+     * instantiated (and generally read from the driver). */
+    GIntBig nMisses;
+    /** Number of blocks evicted from the cache to honor the cache limit. */
+    GIntBig nEvictions;
+    /** Number of dirty blocks written back to the driver. */
+    GIntBig nDirtyBlockFlushes;
+    /** Number of bytes currently used by cached blocks. */
+    GIntBig nResidentBytes;
+    /** Number of missing blocks whose data was restored from the second tier
+     * block cache (see GDAL_BLOCK_CACHE_SECOND_TIER_MAX), instead of being
+     * read from the driver. Also counted in nMisses. */
+    GIntBig nSecondTierRecalls;
+} GDALBlockCacheStatistics;
+
+void CPL_DLL GDALGetBlockCacheStatistics( GDALBlockCacheStatistics* psStats );
+void CPL_DLL GDALResetBlockCacheStatistics( void );
+void CPL_DLL GDALDatasetGetBlockCacheStatistics(
+                                        GDALDatasetH hDS,
+                                        GDALBlockCacheStatistics* psStats );
+void CPL_DLL GDALGetRasterBandBlockCacheStatistics(
+                                        GDALRasterBandH hBand,
+                                        GDALBlockCacheStatistics* psStats );
+
 /* ==================================================================== */
 /*      GDAL virtual memory                                             */
 /* ==================================================================== */
@@ -0,0 +1,280 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Kernels building packed-bit validity masks from nodata values
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDAL_MASK_KERNELS_PRIV_H_INCLUDED
+#define GDAL_MASK_KERNELS_PRIV_H_INCLUDED
+
+#ifndef DOXYGEN_SKIP
+
+#include "cpl_port.h"
+#include "cpl_mask.h"
+#include "gdal_priv.h"
+
+#include <cstddef>
+#include <limits>
+
+// The masks built here use the cpl_mask.h layout: bit i of a mask is stored
+// in word i / 32, so 32 consecutive pixels map to exactly one GUInt32 and
+// can be evaluated together with SIMD compares + movemask.
+
+namespace gdal_mask_kernels
+{
+
+template<class T> inline bool IsNan(T) { return false; }
+template<> inline bool IsNan<float>(float fVal) { return CPLIsNan(fVal); }
+template<> inline bool IsNan<double>(double dfVal) { return CPLIsNan(dfVal); }
+
+template<class T> inline bool IsNoData(T val, T noData, bool /* bNoDataIsNan */)
+{
+    return val == noData;
+}
+
+template<> inline bool IsNoData<float>(float fVal, float fNoData,
+                                       bool bNoDataIsNan)
+{
+    return bNoDataIsNan ? CPLIsNan(fVal) : ARE_REAL_EQUAL(fVal, fNoData);
+}
+
+template<> inline bool IsNoData<double>(double dfVal, double dfNoData,
+                                        bool bNoDataIsNan)
+{
+    return bNoDataIsNan ? CPLIsNan(dfVal) : ARE_REAL_EQUAL(dfVal, dfNoData);
+}
+
+/************************************************************************/
+/*                          NoDataBitsScalar                            */
+/************************************************************************/
+
+// Returns a word whose bit i is set if p[i] is nodata.
+template<class T> class NoDataBitsScalar
+{
+  protected:
+    const T m_noData;
+    const bool m_bNoDataIsNan;
+
+  public:
+    explicit NoDataBitsScalar(T noData) :
+        m_noData(noData), m_bNoDataIsNan(IsNan(noData)) {}
+
+    GUInt32 Get(const T* p, size_t n) const
+    {
+        GUInt32 nBits = 0;
+        for( size_t i = 0; i < n; ++i )
+        {
+            if( IsNoData(p[i], m_noData, m_bNoDataIsNan) )
+                nBits |= 1U << i;
+        }
+        return nBits;
+    }
+
+    GUInt32 Get32(const T* p) const { return Get(p, 32); }
+};
+
+template<class T> class NoDataBits: public NoDataBitsScalar<T>
+{
+  public:
+    explicit NoDataBits(T noData) : NoDataBitsScalar<T>(noData) {}
+};
+
+#ifdef CPL_MASK_USE_SSE2
+
+template<> class NoDataBits<GByte>: public NoDataBitsScalar<GByte>
+{
+  public:
+    explicit NoDataBits(GByte noData) : NoDataBitsScalar<GByte>(noData) {}
+
+    GUInt32 Get32(const GByte* p) const
+    {
+        const __m128i nd = _mm_set1_epi8(static_cast<char>(m_noData));
+        const __m128i lo =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i hi =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+        return static_cast<GUInt32>(
+                   _mm_movemask_epi8(_mm_cmpeq_epi8(lo, nd))) |
+               (static_cast<GUInt32>(
+                   _mm_movemask_epi8(_mm_cmpeq_epi8(hi, nd))) << 16);
+    }
+};
+
+// Shared by Int16 and UInt16 as only bit equality matters.
+template<class T> class NoDataBits16: public NoDataBitsScalar<T>
+{
+  public:
+    explicit NoDataBits16(T noData) : NoDataBitsScalar<T>(noData) {}
+
+    GUInt32 Get32(const T* p) const
+    {
+        const __m128i nd =
+            _mm_set1_epi16(static_cast<short>(this->m_noData));
+        GUInt32 nBits = 0;
+        for( int k = 0; k < 2; ++k )
+        {
+            const __m128i a = _mm_cmpeq_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k)),
+                nd);
+            const __m128i b = _mm_cmpeq_epi16(
+                _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(p + 16 * k + 8)),
+                nd);
+            nBits |= static_cast<GUInt32>(
+                _mm_movemask_epi8(_mm_packs_epi16(a, b))) << (16 * k);
+        }
+        return nBits;
+    }
+};
+
+template<> class NoDataBits<GInt16>: public NoDataBits16<GInt16>
+{
+  public:
+    explicit NoDataBits(GInt16 noData) : NoDataBits16<GInt16>(noData) {}
+};
+
+template<> class NoDataBits<GUInt16>: public NoDataBits16<GUInt16>
+{
+  public:
+    explicit NoDataBits(GUInt16 noData) : NoDataBits16<GUInt16>(noData) {}
+};
+
+// Vectorized ARE_REAL_EQUAL(): a == b || |a - b| < FLT_EPSILON * |a + b| * 2
+template<> class NoDataBits<float>: public NoDataBitsScalar<float>
+{
+  public:
+    explicit NoDataBits(float noData) : NoDataBitsScalar<float>(noData) {}
+
+    GUInt32 Get32(const float* p) const
+    {
+        GUInt32 nBits = 0;
+        if( m_bNoDataIsNan )
+        {
+            for( int k = 0; k < 8; ++k )
+            {
+                const __m128 v = _mm_loadu_ps(p + 4 * k);
+                nBits |= static_cast<GUInt32>(
+                    _mm_movemask_ps(_mm_cmpunord_ps(v, v))) << (4 * k);
+            }
+            return nBits;
+        }
+        const __m128 nd = _mm_set1_ps(m_noData);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 eps = _mm_set1_ps(std::numeric_limits<float>::epsilon());
+        const __m128 two = _mm_set1_ps(2.0f);
+        for( int k = 0; k < 8; ++k )
+        {
+            const __m128 v = _mm_loadu_ps(p + 4 * k);
+            const __m128 absDiff =
+                _mm_andnot_ps(signMask, _mm_sub_ps(v, nd));
+            const __m128 tol = _mm_mul_ps(
+                _mm_mul_ps(eps, _mm_andnot_ps(signMask, _mm_add_ps(v, nd))),
+                two);
+            const __m128 eq = _mm_or_ps(_mm_cmpeq_ps(v, nd),
+                                        _mm_cmplt_ps(absDiff, tol));
+            nBits |= static_cast<GUInt32>(_mm_movemask_ps(eq)) << (4 * k);
+        }
+        return nBits;
+    }
+};
+
+template<> class NoDataBits<double>: public NoDataBitsScalar<double>
+{
+  public:
+    explicit NoDataBits(double noData) : NoDataBitsScalar<double>(noData) {}
+
+    GUInt32 Get32(const double* p) const
+    {
+        GUInt32 nBits = 0;
+        if( m_bNoDataIsNan )
+        {
+            for( int k = 0; k < 16; ++k )
+            {
+                const __m128d v = _mm_loadu_pd(p + 2 * k);
+                nBits |= static_cast<GUInt32>(
+                    _mm_movemask_pd(_mm_cmpunord_pd(v, v))) << (2 * k);
+            }
+            return nBits;
+        }
+        const __m128d nd = _mm_set1_pd(m_noData);
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        const __m128d eps = _mm_set1_pd(
+            static_cast<double>(std::numeric_limits<float>::epsilon()));
+        const __m128d two = _mm_set1_pd(2.0);
+        for( int k = 0; k < 16; ++k )
+        {
+            const __m128d v = _mm_loadu_pd(p + 2 * k);
+            const __m128d absDiff =
+                _mm_andnot_pd(signMask, _mm_sub_pd(v, nd));
+            const __m128d tol = _mm_mul_pd(
+                _mm_mul_pd(eps, _mm_andnot_pd(signMask, _mm_add_pd(v, nd))),
+                two);
+            const __m128d eq = _mm_or_pd(_mm_cmpeq_pd(v, nd),
+                                         _mm_cmplt_pd(absDiff, tol));
+            nBits |= static_cast<GUInt32>(_mm_movemask_pd(eq)) << (2 * k);
+        }
+        return nBits;
+    }
+};
+
+#endif // CPL_MASK_USE_SSE2
+
+} // namespace gdal_mask_kernels
+
+/************************************************************************/
+/*                        GDALMaskClearNoData()                         */
+/************************************************************************/
+
+/** Clear the bits of a cpl_mask.h bit mask for the pixels equal to noData.
+ *
+ * Floating-point values are compared with ARE_REAL_EQUAL(), and a NaN noData
+ * matches all NaN values, as done by GDALNoDataMaskBand.
+ *
+ * @return true if no bit was cleared (all pixels are valid).
+ */
+template<class T>
+inline bool GDALMaskClearNoData( GUInt32* panMask, const T* pData,
+                                 size_t nPixels, T noData )
+{
+    const gdal_mask_kernels::NoDataBits<T> oKernel(noData);
+    GUInt32 nAnyNoData = 0;
+    size_t i = 0;
+    for( ; i + 32 <= nPixels; i += 32 )
+    {
+        const GUInt32 nBits = oKernel.Get32(pData + i);
+        panMask[i >> 5] &= ~nBits;
+        nAnyNoData |= nBits;
+    }
+    if( i < nPixels )
+    {
+        const GUInt32 nBits = oKernel.Get(pData + i, nPixels - i);
+        panMask[i >> 5] &= ~nBits;
+        nAnyNoData |= nBits;
+    }
+    return nAnyNoData == 0;
+}
+
+#endif /* #ifndef DOXYGEN_SKIP */
+
+#endif /* GDAL_MASK_KERNELS_PRIV_H_INCLUDED */
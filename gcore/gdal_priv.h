@@ -69,6 +69,7 @@ class GDALRelationship;
 
 #include <stdarg.h>
 
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <iterator>
@@ -210,6 +211,16 @@ class CPL_DLL GDALDefaultOverviews
     bool        bInitNameIsOVR;
     char      **papszInitSiblingFiles;
 
+    // Overviews computed on demand when GDAL_IN_MEMORY_OVERVIEWS=YES and
+    // the dataset has none. The configuration options are read by
+    // Initialize().
+    bool        bInMemoryOverviewsEnabled = false;
+    CPLString   osInMemoryOverviewsResampling{};
+    bool        bCheckedForInMemoryOverviews = false;
+    std::vector<GDALDataset*> apoInMemoryOvrDS{};
+    void        CreateInMemoryOverviews();
+    void        DropInMemoryOverviews();
+
   public:
                GDALDefaultOverviews();
                ~GDALDefaultOverviews();
@@ -515,6 +526,7 @@ class CPL_DLL GDALDataset : public GDALMajorObject
     Bands              GetBands();
 
     virtual void FlushCache(bool bAtClosing = false);
+    void GetBlockCacheStatistics( GDALBlockCacheStatistics* psStats );
 
     virtual const OGRSpatialReference* GetSpatialRef() const;
     virtual CPLErr SetSpatialRef(const OGRSpatialReference* poSRS);
@@ -587,6 +599,33 @@ class CPL_DLL GDALDataset : public GDALMajorObject
     virtual bool GetRawBinaryLayout(RawBinaryLayout&);
 //! @endcond
 
+    /** Description of how the compressed blocks of a dataset are organized,
+     * as returned by GetCompressedBlockLayout().
+     * @since GDAL 3.7
+     */
+    struct CompressedBlockLayout
+    {
+        /** Driver specific description of the encoding of a block. Two
+         * datasets whose blocks can be copied without decompression report
+         * the same string. */
+        std::string osFormat{};
+        /** Block width. */
+        int         nBlockXSize = 0;
+        /** Block height. */
+        int         nBlockYSize = 0;
+        /** Number of separately encoded planes: 1 when a block contains all
+         * the bands (pixel interleaving), the number of bands otherwise. */
+        int         nPlaneCount = 0;
+    };
+
+    virtual bool GetCompressedBlockLayout(CompressedBlockLayout&);
+    virtual CPLErr ReadCompressedData(int nPlane,
+                                      int nXBlockOff, int nYBlockOff,
+                                      std::vector<GByte>& abyData);
+    virtual CPLErr WriteCompressedData(int nPlane,
+                                       int nXBlockOff, int nYBlockOff,
+                                       const void* pData, size_t nDataSize);
+
     CPLErr      RasterIO( GDALRWFlag, int, int, int, int,
                           void *, int, int, GDALDataType,
                           int, int *, GSpacing, GSpacing, GSpacing,
@@ -615,6 +654,12 @@ class CPL_DLL GDALDataset : public GDALMajorObject
      */
     char        **GetOpenOptions() { return papszOpenOptions; }
 
+    /** Return whether the dataset has been opened with GDAL_OF_THREAD_SAFE.
+     * @since GDAL 3.7
+     */
+    bool          IsThreadSafe() const
+                        { return (nOpenFlags & GDAL_OF_THREAD_SAFE) != 0; }
+
     static GDALDataset **GetOpenDatasets( int *pnDatasetCount );
 
     CPLErr BuildOverviews( const char *,
@@ -926,9 +971,14 @@ using GDALDatasetUniquePtr = std::unique_ptr<GDALDataset, GDALDatasetUniquePtrDe
  *
  * And the global block manager that manages a least-recently-used list of
  * blocks from various datasets/bands */
+//! @cond Doxygen_Suppress
+struct GDALRasterBlockCacheShard;
+//! @endcond
+
 class CPL_DLL GDALRasterBlock
 {
     friend class GDALAbstractBandBlockCache;
+    friend struct GDALRasterBlockCacheShard;
 
     GDALDataType        eType;
 
@@ -948,8 +998,14 @@ class CPL_DLL GDALRasterBlock
     GDALRasterBlock     *poNext;
     GDALRasterBlock     *poPrevious;
 
+    // Value of the global cache tick when the block was last touched.
+    GUIntBig             nTouchTick;
+
     bool                 bMustDetach;
 
+    // Whether the block is in the probation list of the 2Q cache policy.
+    bool                 bProbation;
+
     CPL_INTERNAL void        Detach_unlocked( void );
     CPL_INTERNAL void        Touch_unlocked( void );
 
@@ -1100,6 +1156,14 @@ class GDALAbstractBandBlockCache
 
         volatile int      m_nDirtyBlocks = 0;
 
+        // Statistics, see GDALBlockCacheStatistics
+        std::atomic<GIntBig> m_nHits{0};
+        std::atomic<GIntBig> m_nMisses{0};
+        std::atomic<GIntBig> m_nEvictions{0};
+        std::atomic<GIntBig> m_nDirtyBlockFlushes{0};
+        std::atomic<GIntBig> m_nResidentBytes{0};
+        std::atomic<GIntBig> m_nSecondTierRecalls{0};
+
         CPL_DISALLOW_COPY_ASSIGN(GDALAbstractBandBlockCache)
 
     protected:
@@ -1126,6 +1190,16 @@ class GDALAbstractBandBlockCache
             void             WaitCompletionPendingTasks();
             void             DisableDirtyBlockWriting() { m_bWriteDirtyBlocks = false; }
 
+            void             AddHit();
+            void             AddMiss();
+            void             AddEviction();
+            void             AddDirtyBlockFlush();
+            void             AddResidentBytes( GIntBig nBytes );
+            void             AddSecondTierRecall();
+            void             GetStatistics( GDALBlockCacheStatistics* psStats ) const;
+            static void      GetGlobalStatistics( GDALBlockCacheStatistics* psStats );
+            static void      ResetGlobalStatistics();
+
             virtual bool             Init() = 0;
             virtual bool             IsInitOK() = 0;
             virtual CPLErr           FlushCache() = 0;
@@ -1140,6 +1214,20 @@ class GDALAbstractBandBlockCache
 GDALAbstractBandBlockCache* GDALArrayBandBlockCacheCreate(GDALRasterBand* poBand);
 GDALAbstractBandBlockCache* GDALHashSetBandBlockCacheCreate(GDALRasterBand* poBand);
 
+void GDALRasterBlockCacheDropBand(const GDALRasterBand* poBand);
+
+void GDALCompressedBlockCacheStore(GDALRasterBlock* poBlock);
+bool GDALCompressedBlockCacheRecall(GDALRasterBlock* poBlock);
+void GDALCompressedBlockCacheDropBand(const GDALRasterBand* poBand);
+
+bool GDALBlockPrefetcherRecall(GDALRasterBlock* poBlock, int nPrefetch);
+bool GDALBlockPrefetcherAdvise(GDALRasterBand* poMainBand, int iOverview,
+                               GDALRasterBand* poBand,
+                               int nXOff, int nYOff, int nXSize, int nYSize);
+void GDALBlockPrefetcherDropBand(const GDALRasterBand* poBand);
+
+struct GDALWriteStatsState;
+
 //! @endcond
 
 /* ******************************************************************** */
@@ -1186,6 +1274,11 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
 
     CPLErr eFlushBlockErr = CE_None;
     GDALAbstractBandBlockCache* poBandBlockCache = nullptr;
+    // GDAL_BLOCK_PREFETCH, read by InitBlockInfo()
+    int m_nBlockPrefetch = 0;
+    // Statistics of the written blocks, created by InitBlockInfo() when
+    // GDAL_STATISTICS_ON_WRITE=YES
+    GDALWriteStatsState* m_poWriteStats = nullptr;
 
     CPL_INTERNAL void           SetFlushBlockErr( CPLErr eErr );
     CPL_INTERNAL CPLErr         UnreferenceBlock( GDALRasterBlock* poBlock );
@@ -1210,6 +1303,9 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
 
     int         nBlockReads = 0;
     int         bForceCachedIO = 0;
+    // Set by drivers that let large reads bypass the block cache by default
+    // (see GDAL_RASTERIO_BYPASS_CACHE).
+    bool        m_bBypassCacheForLargeReads = false;
 
     GDALRasterBand *poMask = nullptr;
     bool        bOwnMask = false;
@@ -1220,15 +1316,32 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
 
     friend class GDALProxyRasterBand;
     friend class GDALDefaultOverviews;
+    friend class GDALInMemoryOverviewBand;
 
     CPLErr RasterIOResampled( GDALRWFlag, int, int, int, int,
                               void *, int, int, GDALDataType,
                               GSpacing, GSpacing, GDALRasterIOExtraArg* psExtraArg ) CPL_WARN_UNUSED_RESULT;
 
+    CPLErr TryDirectBlockRasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
+                                   void * pData, GDALDataType eBufType,
+                                   GSpacing nPixelSpace, GSpacing nLineSpace,
+                                   GDALRasterIOExtraArg* psExtraArg,
+                                   int* pbTried ) CPL_WARN_UNUSED_RESULT;
+
     int          EnterReadWrite(GDALRWFlag eRWFlag);
     void         LeaveReadWrite();
     void         InitRWLock();
     void         SetValidPercent( GUIntBig nSampleCount, GUIntBig nValidCount );
+    bool         GetQuantiles( bool bApproxOK, int nQuantiles,
+                               const double* padfProbabilities,
+                               double* padfQuantiles );
+    void         SetQuantiles( int nQuantiles,
+                               const double* padfProbabilities,
+                               const double* padfQuantiles,
+                               bool bApproximate );
+    void         InitWriteStatistics();
+    void         DisableWriteStatistics();
+    void         FlushWriteStatistics();
 
 //! @endcond
 
@@ -1260,6 +1373,9 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
     int            InitBlockInfo();
 
     void           AddBlockToFreeList( GDALRasterBlock * );
+
+    void           UpdateWriteStatistics( int nXBlockOff, int nYBlockOff,
+                                          const void* pData );
 //! @endcond
 
   public:
@@ -1296,6 +1412,7 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                                         int bJustInitialize = FALSE ) CPL_WARN_UNUSED_RESULT;
     GDALRasterBlock *TryGetLockedBlockRef( int nXBlockOff, int nYBlockYOff ) CPL_WARN_UNUSED_RESULT;
     CPLErr      FlushBlock( int, int, int bWriteDirtyBlock = TRUE );
+    void        GetBlockCacheStatistics( GDALBlockCacheStatistics* psStats ) const;
 
     unsigned char*  GetIndexColorTranslationTo(/* const */ GDALRasterBand* poReferenceBand,
                                                unsigned char* pTranslationTable = nullptr,
@@ -1337,6 +1454,10 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                                       GDALProgressFunc, void *pProgressData );
     virtual CPLErr SetStatistics( double dfMin, double dfMax,
                                   double dfMean, double dfStdDev );
+    virtual CPLErr ComputeQuantiles( int bApproxOK, int nQuantiles,
+                                     const double* padfProbabilities,
+                                     double* padfQuantiles,
+                                     GDALProgressFunc, void *pProgressData );
     virtual CPLErr ComputeRasterMinMax( int, double* );
 
 // Only defined when Doxygen enabled
@@ -3264,6 +3385,12 @@ void GDALRasterIOExtraArgSetResampleAlg(GDALRasterIOExtraArg* psExtraArg,
 GDALDataset* GDALCreateOverviewDataset(GDALDataset* poDS, int nOvrLevel,
                                        bool bThisLevelOnly);
 
+GDALDataset* GDALOpenThreadSafeDataset( const char* pszFilename,
+                                        unsigned int nOpenFlags,
+                                        const char* const* papszAllowedDrivers,
+                                        const char* const* papszOpenOptions,
+                                        const char* const* papszSiblingFiles );
+
 // Should cover particular cases of #3573, #4183, #4506, #6578
 // Behavior is undefined if fVal1 or fVal2 are NaN (should be tested before
 // calling this function)
@@ -3317,6 +3444,9 @@ bool CPL_DLL GDALBufferHasOnlyNoData(const void* pBuffer,
 void CPL_DLL GDALCopyNoDataValue(GDALRasterBand* poDstBand,
                                  GDALRasterBand* poSrcBand);
 
+bool CPL_DLL GDALCanCopyCompressedBlocks(GDALDataset* poSrcDS,
+                                        GDALDataset* poDstDS);
+
 double CPL_DLL GDALGetNoDataValueCastToDouble(int64_t nVal);
 double CPL_DLL GDALGetNoDataValueCastToDouble(uint64_t nVal);
 
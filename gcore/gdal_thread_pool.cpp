@@ -28,8 +28,55 @@
 
 #include "gdal_thread_pool.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <mutex>
 
+#include "cpl_conv.h"
+#include "cpl_multiproc.h"
+
+/************************************************************************/
+/*                         GDALGetNumThreads()                          */
+/************************************************************************/
+
+/** Return the number of threads requested through the GDAL_NUM_THREADS
+ * configuration option (a number, or ALL_CPUS).
+ *
+ * @param nMaxVal Upper bound of the returned value.
+ * @param bDefaultAllCPUs Whether to use all CPUs when the option is not set.
+ *                        Otherwise 1 is returned.
+ * @return a value in the [1, nMaxVal] range.
+ */
+int GDALGetNumThreads(int nMaxVal, bool bDefaultAllCPUs)
+{
+    return GDALGetNumThreads(nullptr, nullptr, nMaxVal, bDefaultAllCPUs);
+}
+
+/** Return the number of threads requested through the pszItem option of
+ * papszOptions, or the GDAL_NUM_THREADS configuration option when it is not
+ * set (a number, or ALL_CPUS).
+ *
+ * @param papszOptions Options, or nullptr.
+ * @param pszItem Name of the option in papszOptions (e.g. "NUM_THREADS"),
+ *                or nullptr.
+ * @param nMaxVal Upper bound of the returned value.
+ * @param bDefaultAllCPUs Whether to use all CPUs when no option is set.
+ *                        Otherwise 1 is returned.
+ * @return a value in the [1, nMaxVal] range.
+ */
+int GDALGetNumThreads(CSLConstList papszOptions, const char* pszItem,
+                      int nMaxVal, bool bDefaultAllCPUs)
+{
+    const char* pszValue = pszItem ?
+        CSLFetchNameValue(papszOptions, pszItem) : nullptr;
+    if( pszValue == nullptr )
+        pszValue = CPLGetConfigOption("GDAL_NUM_THREADS",
+                                      bDefaultAllCPUs ? "ALL_CPUS" : "1");
+    const int nThreads =
+        EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszValue);
+    return std::max(1, std::min(nMaxVal, nThreads));
+}
+
 static std::mutex gMutexThreadPool;
 static CPLWorkerThreadPool *gpoCompressThreadPool = nullptr;
 
@@ -29,8 +29,19 @@
 #ifndef GDAL_THREAD_POOL_H
 #define GDAL_THREAD_POOL_H
 
+#include "cpl_string.h"
 #include "cpl_worker_thread_pool.h"
 
+/** Maximum number of threads returned by default by GDALGetNumThreads() */
+constexpr int GDAL_DEFAULT_MAX_THREAD_COUNT = 1024;
+
+int CPL_DLL GDALGetNumThreads(int nMaxVal = GDAL_DEFAULT_MAX_THREAD_COUNT,
+                              bool bDefaultAllCPUs = false);
+
+int CPL_DLL GDALGetNumThreads(CSLConstList papszOptions, const char* pszItem,
+                              int nMaxVal = GDAL_DEFAULT_MAX_THREAD_COUNT,
+                              bool bDefaultAllCPUs = false);
+
 CPLWorkerThreadPool CPL_DLL* GDALGetGlobalThreadPool(int nThreads);
 
 void GDALDestroyGlobalThreadPool();
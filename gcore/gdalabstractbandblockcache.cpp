@@ -30,6 +30,7 @@
 #include "gdal_priv.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <new>
 
@@ -44,6 +45,14 @@
 static int nAllBandsKeptAlivedBlocks = 0;
 #endif
 
+// Statistics accumulated over all bands.
+static std::atomic<GIntBig> nGlobalHits{0};
+static std::atomic<GIntBig> nGlobalMisses{0};
+static std::atomic<GIntBig> nGlobalEvictions{0};
+static std::atomic<GIntBig> nGlobalDirtyBlockFlushes{0};
+static std::atomic<GIntBig> nGlobalResidentBytes{0};
+static std::atomic<GIntBig> nGlobalSecondTierRecalls{0};
+
 /************************************************************************/
 /*                       GDALArrayBandBlockCache()                      */
 /************************************************************************/
@@ -208,6 +217,113 @@ void GDALAbstractBandBlockCache::IncDirtyBlocks( int nInc )
     CPLAtomicAdd(&m_nDirtyBlocks, nInc);
 }
 
+/************************************************************************/
+/*                               AddHit()                               */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddHit()
+{
+    ++m_nHits;
+    ++nGlobalHits;
+}
+
+/************************************************************************/
+/*                               AddMiss()                              */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddMiss()
+{
+    ++m_nMisses;
+    ++nGlobalMisses;
+}
+
+/************************************************************************/
+/*                             AddEviction()                            */
+/*                                                                      */
+/*      Only for blocks dropped to honour the cache size limit, not     */
+/*      for dirty blocks flushed by FlushDirtyBlocks().                 */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddEviction()
+{
+    ++m_nEvictions;
+    ++nGlobalEvictions;
+}
+
+/************************************************************************/
+/*                         AddDirtyBlockFlush()                         */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddDirtyBlockFlush()
+{
+    ++m_nDirtyBlockFlushes;
+    ++nGlobalDirtyBlockFlushes;
+}
+
+/************************************************************************/
+/*                          AddResidentBytes()                          */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddResidentBytes( GIntBig nBytes )
+{
+    m_nResidentBytes += nBytes;
+    nGlobalResidentBytes += nBytes;
+}
+
+/************************************************************************/
+/*                         AddSecondTierRecall()                        */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddSecondTierRecall()
+{
+    ++m_nSecondTierRecalls;
+    ++nGlobalSecondTierRecalls;
+}
+
+/************************************************************************/
+/*                            GetStatistics()                           */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::GetStatistics(
+                                    GDALBlockCacheStatistics* psStats ) const
+{
+    psStats->nHits = m_nHits;
+    psStats->nMisses = m_nMisses;
+    psStats->nEvictions = m_nEvictions;
+    psStats->nDirtyBlockFlushes = m_nDirtyBlockFlushes;
+    psStats->nResidentBytes = m_nResidentBytes;
+    psStats->nSecondTierRecalls = m_nSecondTierRecalls;
+}
+
+/************************************************************************/
+/*                         GetGlobalStatistics()                        */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::GetGlobalStatistics(
+                                    GDALBlockCacheStatistics* psStats )
+{
+    psStats->nHits = nGlobalHits;
+    psStats->nMisses = nGlobalMisses;
+    psStats->nEvictions = nGlobalEvictions;
+    psStats->nDirtyBlockFlushes = nGlobalDirtyBlockFlushes;
+    psStats->nResidentBytes = nGlobalResidentBytes;
+    psStats->nSecondTierRecalls = nGlobalSecondTierRecalls;
+}
+
+/************************************************************************/
+/*                        ResetGlobalStatistics()                       */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::ResetGlobalStatistics()
+{
+    // Resident bytes is a gauge, not a counter: it is not reset.
+    nGlobalHits = 0;
+    nGlobalMisses = 0;
+    nGlobalEvictions = 0;
+    nGlobalDirtyBlockFlushes = 0;
+    nGlobalSecondTierRecalls = 0;
+}
+
 /************************************************************************/
 /*                      StartDirtyBlockFlushingLog()                    */
 /************************************************************************/
@@ -0,0 +1,660 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Background read-ahead of raster blocks
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_priv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+#include "gdal_thread_pool.h"
+
+//! @cond Doxygen_Suppress
+
+/* ******************************************************************** */
+/*                         GDALBlockPrefetcher                          */
+/* ******************************************************************** */
+
+// When the GDAL_BLOCK_PREFETCH configuration option is set to a positive
+// number N, sequential block misses on a band of a read-only dataset (that is
+// block indices increasing in raster order, as for scanline or tile-row
+// readers) trigger the reading of the next N blocks by jobs of the global
+// thread pool. Those jobs read from their own handles of the dataset, opened
+// with the same driver and open options, and store the result in buffers
+// owned by the prefetcher. When the block is then requested, its content
+// is copied from that buffer (waiting for the job to complete if needed)
+// instead of calling IReadBlock().
+// At most N blocks per band are kept in those buffers, and they are discarded
+// as soon as the access pattern stops being sequential.
+//
+// The same mechanism is used by the default implementation of
+// GDALRasterBand::AdviseRead(), when GDAL_NUM_THREADS is set: all blocks
+// intersecting the advised window, at the overview level that RasterIO()
+// would select, are read in the background, and are kept until they are
+// requested or the band cache is flushed.
+// Blocks are not inserted in the block cache of the band by the jobs, as
+// this would require them to lock blocks of a band that the caller might
+// be using at the same time. Instead, the buffers of advised blocks of all
+// bands are limited to half of the block cache size: when advising new
+// blocks would exceed that, the oldest advised blocks of the band are
+// discarded, and blocks that still do not fit are not read.
+
+namespace
+{
+
+// Size of the buffers of advised blocks, of all bands.
+std::atomic<GIntBig> gnAdvisedBytes{0};
+
+CPLWorkerThreadPool* GetThreadPool()
+{
+    return GDALGetGlobalThreadPool(
+        GDALGetNumThreads(128, /* bDefaultAllCPUs = */ true));
+}
+
+struct PrefetchSlot
+{
+    std::vector<GByte> abyData{};
+    bool               bReady = false;
+    bool               bOK = false;
+    // Part of gnAdvisedBytes owned by this slot, and key of the slot in
+    // m_oAdvisedOrder.
+    GIntBig            nAdvisedBytes = 0;
+    GIntBig            nAdvisedSequence = 0;
+
+    PrefetchSlot() = default;
+    ~PrefetchSlot() { gnAdvisedBytes -= nAdvisedBytes; }
+
+    CPL_DISALLOW_COPY_ASSIGN(PrefetchSlot)
+};
+
+class GDALBlockPrefetcher: public std::enable_shared_from_this<GDALBlockPrefetcher>
+{
+    struct Job
+    {
+        std::shared_ptr<GDALBlockPrefetcher> poPrefetcher{};
+        std::shared_ptr<PrefetchSlot>        poSlot{};
+        int                                  nXBlockOff = 0;
+        int                                  nYBlockOff = 0;
+    };
+
+    std::mutex                    m_oMutex{};
+    std::condition_variable       m_oCV{};
+    CPLString                     m_osFilename{};
+    CPLStringList                 m_aosAllowedDrivers{};
+    CPLStringList                 m_aosOpenOptions{};
+    int                           m_nBand = 0;
+    int                           m_iOverview = -1;
+    int                           m_nRasterXSize = 0;
+    int                           m_nRasterYSize = 0;
+    int                           m_nBandXSize = 0;
+    int                           m_nBandYSize = 0;
+    int                           m_nBlocksPerRow = 0;
+    GIntBig                       m_nTotalBlocks = 0;
+    size_t                        m_nBlockBytes = 0;
+    std::vector<GDALDataset*>     m_apoIdleDatasets{};
+    // Blocks scheduled because of sequential accesses.
+    std::map<GIntBig, std::shared_ptr<PrefetchSlot>> m_oSlots{};
+    // Blocks scheduled by AdviseRead(), and their indices from the oldest
+    // to the most recently advised one.
+    std::map<GIntBig, std::shared_ptr<PrefetchSlot>> m_oAdvisedSlots{};
+    std::map<GIntBig, GIntBig>    m_oAdvisedOrder{};
+    GIntBig                       m_nAdvisedSequence = 0;
+    GIntBig                       m_nLastIndex = -1;
+    int                           m_nSequentialMisses = 0;
+    int                           m_nPendingJobs = 0;
+    int                           m_nRecalledBlocks = 0;
+    bool                          m_bDisabled = false;
+
+    GDALDataset* AcquireDataset();
+    void         ReleaseDataset(GDALDataset* poDS);
+    bool         Submit_unlocked(
+                    CPLWorkerThreadPool* poThreadPool, GIntBig nIndex,
+                    std::map<GIntBig, std::shared_ptr<PrefetchSlot>>& oSlots,
+                    bool bAdvised = false);
+    bool         ReserveAdvisedBytes_unlocked();
+    void         Schedule_unlocked(GIntBig nIndex, int nPrefetch);
+
+    static void  JobFunc(void* pData);
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALBlockPrefetcher)
+
+  public:
+    GDALBlockPrefetcher(GDALRasterBand* poMainBand, int iOverview,
+                        GDALRasterBand* poBand, size_t nBlockBytes);
+    ~GDALBlockPrefetcher();
+
+    bool Recall(GDALRasterBlock* poBlock, int nPrefetch);
+    void Advise(GDALRasterBand* poBand, int nXBlockStart, int nYBlockStart,
+                int nXBlockEnd, int nYBlockEnd);
+    void WaitPendingJobs();
+
+    void ReportStatistics() const;
+};
+
+/************************************************************************/
+/*                        GDALBlockPrefetcher()                         */
+/************************************************************************/
+
+GDALBlockPrefetcher::GDALBlockPrefetcher(GDALRasterBand* poMainBand,
+                                         int iOverview,
+                                         GDALRasterBand* poBand,
+                                         size_t nBlockBytes):
+    m_iOverview(iOverview),
+    m_nBandXSize(poBand->GetXSize()),
+    m_nBandYSize(poBand->GetYSize()),
+    m_nBlockBytes(nBlockBytes)
+{
+    GDALDataset* poDS = poMainBand->GetDataset();
+    m_osFilename = poDS->GetDescription();
+    m_aosAllowedDrivers.AddString(poDS->GetDriver()->GetDescription());
+    m_aosOpenOptions = CSLDuplicate(poDS->GetOpenOptions());
+    m_nBand = poMainBand->GetBand();
+    m_nRasterXSize = poDS->GetRasterXSize();
+    m_nRasterYSize = poDS->GetRasterYSize();
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    m_nBlocksPerRow = DIV_ROUND_UP(poBand->GetXSize(), nBlockXSize);
+    m_nTotalBlocks = static_cast<GIntBig>(m_nBlocksPerRow) *
+                     DIV_ROUND_UP(poBand->GetYSize(), nBlockYSize);
+}
+
+/************************************************************************/
+/*                       ~GDALBlockPrefetcher()                         */
+/************************************************************************/
+
+GDALBlockPrefetcher::~GDALBlockPrefetcher()
+{
+    for( auto poDS: m_apoIdleDatasets )
+        GDALClose(poDS);
+}
+
+/************************************************************************/
+/*                          AcquireDataset()                            */
+/************************************************************************/
+
+GDALDataset* GDALBlockPrefetcher::AcquireDataset()
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( !m_apoIdleDatasets.empty() )
+        {
+            GDALDataset* poDS = m_apoIdleDatasets.back();
+            m_apoIdleDatasets.pop_back();
+            return poDS;
+        }
+        if( m_bDisabled )
+            return nullptr;
+    }
+
+    GDALDataset* poDS = GDALDataset::Open(
+        m_osFilename.c_str(),
+        GDAL_OF_RASTER | GDAL_OF_READONLY | GDAL_OF_INTERNAL,
+        m_aosAllowedDrivers.List(), m_aosOpenOptions.List(), nullptr);
+    if( poDS != nullptr &&
+        (poDS->GetRasterXSize() != m_nRasterXSize ||
+         poDS->GetRasterYSize() != m_nRasterYSize ||
+         poDS->GetRasterCount() < m_nBand) )
+    {
+        GDALClose(poDS);
+        poDS = nullptr;
+    }
+    if( poDS == nullptr )
+    {
+        CPLDebug("GDAL", "Cannot reopen %s for block prefetching",
+                 m_osFilename.c_str());
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_bDisabled = true;
+    }
+    return poDS;
+}
+
+/************************************************************************/
+/*                          ReleaseDataset()                            */
+/************************************************************************/
+
+void GDALBlockPrefetcher::ReleaseDataset(GDALDataset* poDS)
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_apoIdleDatasets.push_back(poDS);
+}
+
+/************************************************************************/
+/*                              JobFunc()                               */
+/************************************************************************/
+
+void GDALBlockPrefetcher::JobFunc(void* pData)
+{
+    std::unique_ptr<Job> poJob(static_cast<Job*>(pData));
+    GDALBlockPrefetcher* poThis = poJob->poPrefetcher.get();
+
+    bool bOK = false;
+    GDALDataset* poDS = poThis->AcquireDataset();
+    if( poDS != nullptr )
+    {
+        GDALRasterBand* poBand = poDS->GetRasterBand(poThis->m_nBand);
+        if( poThis->m_iOverview >= 0 )
+            poBand = poBand->GetOverview(poThis->m_iOverview);
+        if( poBand != nullptr &&
+            poBand->GetXSize() == poThis->m_nBandXSize &&
+            poBand->GetYSize() == poThis->m_nBandYSize )
+        {
+            // Errors are reported again when the block is read by the
+            // requesting thread.
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            bOK = poBand->ReadBlock(poJob->nXBlockOff, poJob->nYBlockOff,
+                                    poJob->poSlot->abyData.data()) == CE_None;
+            CPLPopErrorHandler();
+        }
+        poThis->ReleaseDataset(poDS);
+    }
+
+    std::lock_guard<std::mutex> oLock(poThis->m_oMutex);
+    poJob->poSlot->bReady = true;
+    poJob->poSlot->bOK = bOK;
+    poThis->m_nPendingJobs--;
+    poThis->m_oCV.notify_all();
+}
+
+/************************************************************************/
+/*                          Submit_unlocked()                           */
+/************************************************************************/
+
+bool GDALBlockPrefetcher::Submit_unlocked(
+    CPLWorkerThreadPool* poThreadPool, GIntBig nIndex,
+    std::map<GIntBig, std::shared_ptr<PrefetchSlot>>& oSlots,
+    bool bAdvised)
+{
+    auto poSlot = std::make_shared<PrefetchSlot>();
+    try
+    {
+        poSlot->abyData.resize(m_nBlockBytes);
+    }
+    catch( const std::bad_alloc& )
+    {
+        return false;
+    }
+    if( bAdvised )
+    {
+        if( !ReserveAdvisedBytes_unlocked() )
+            return false;
+        poSlot->nAdvisedBytes = static_cast<GIntBig>(m_nBlockBytes);
+        poSlot->nAdvisedSequence = ++m_nAdvisedSequence;
+        m_oAdvisedOrder[poSlot->nAdvisedSequence] = nIndex;
+    }
+    auto poJob = new Job();
+    poJob->poPrefetcher = shared_from_this();
+    poJob->poSlot = poSlot;
+    poJob->nXBlockOff = static_cast<int>(nIndex % m_nBlocksPerRow);
+    poJob->nYBlockOff = static_cast<int>(nIndex / m_nBlocksPerRow);
+    m_nPendingJobs++;
+    if( !poThreadPool->SubmitJob(JobFunc, poJob) )
+    {
+        m_nPendingJobs--;
+        delete poJob;
+        m_oAdvisedOrder.erase(poSlot->nAdvisedSequence);
+        return false;
+    }
+    oSlots[nIndex] = std::move(poSlot);
+    return true;
+}
+
+/************************************************************************/
+/*                    ReserveAdvisedBytes_unlocked()                    */
+/************************************************************************/
+
+// Account a new advised block in gnAdvisedBytes, discarding the oldest
+// advised blocks of this band if needed. Returns false if it does not fit.
+bool GDALBlockPrefetcher::ReserveAdvisedBytes_unlocked()
+{
+    const GIntBig nMaxBytes = GDALGetCacheMax64() / 2;
+    const GIntBig nBlockBytes = static_cast<GIntBig>(m_nBlockBytes);
+    while( gnAdvisedBytes.fetch_add(nBlockBytes) + nBlockBytes > nMaxBytes )
+    {
+        gnAdvisedBytes -= nBlockBytes;
+        if( m_oAdvisedOrder.empty() )
+            return false;
+        // The buffer of a discarded block is released once its job, if
+        // still running, completes.
+        auto oIter = m_oAdvisedOrder.begin();
+        m_oAdvisedSlots.erase(oIter->second);
+        m_oAdvisedOrder.erase(oIter);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         Schedule_unlocked()                          */
+/************************************************************************/
+
+void GDALBlockPrefetcher::Schedule_unlocked(GIntBig nIndex, int nPrefetch)
+{
+    if( m_bDisabled )
+        return;
+
+    auto poThreadPool = GetThreadPool();
+    if( poThreadPool == nullptr )
+        return;
+
+    const GIntBig nLastIndex = std::min(nIndex + nPrefetch, m_nTotalBlocks - 1);
+    for( GIntBig i = nIndex + 1; i <= nLastIndex &&
+                 static_cast<int>(m_oSlots.size()) < nPrefetch; ++i )
+    {
+        if( m_oSlots.find(i) != m_oSlots.end() ||
+            m_oAdvisedSlots.find(i) != m_oAdvisedSlots.end() )
+        {
+            continue;
+        }
+        if( !Submit_unlocked(poThreadPool, i, m_oSlots) )
+            return;
+    }
+}
+
+/************************************************************************/
+/*                               Advise()                               */
+/************************************************************************/
+
+void GDALBlockPrefetcher::Advise(GDALRasterBand* poBand,
+                                 int nXBlockStart, int nYBlockStart,
+                                 int nXBlockEnd, int nYBlockEnd)
+{
+    auto poThreadPool = GetThreadPool();
+    if( poThreadPool == nullptr )
+        return;
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_bDisabled )
+        return;
+    for( int iY = nYBlockStart; iY <= nYBlockEnd; ++iY )
+    {
+        for( int iX = nXBlockStart; iX <= nXBlockEnd; ++iX )
+        {
+            const GIntBig nIndex =
+                static_cast<GIntBig>(iY) * m_nBlocksPerRow + iX;
+            if( m_oSlots.find(nIndex) != m_oSlots.end() ||
+                m_oAdvisedSlots.find(nIndex) != m_oAdvisedSlots.end() )
+            {
+                continue;
+            }
+            GDALRasterBlock* poBlock = poBand->TryGetLockedBlockRef(iX, iY);
+            if( poBlock != nullptr )
+            {
+                poBlock->DropLock();
+                continue;
+            }
+            if( !Submit_unlocked(poThreadPool, nIndex, m_oAdvisedSlots,
+                                 /* bAdvised = */ true) )
+                return;
+        }
+    }
+}
+
+/************************************************************************/
+/*                               Recall()                               */
+/************************************************************************/
+
+bool GDALBlockPrefetcher::Recall(GDALRasterBlock* poBlock, int nPrefetch)
+{
+    const GIntBig nIndex =
+        static_cast<GIntBig>(poBlock->GetYOff()) * m_nBlocksPerRow +
+        poBlock->GetXOff();
+
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+
+    bool bRecalled = false;
+    std::shared_ptr<PrefetchSlot> poSlot;
+    for( auto poSlots: { &m_oSlots, &m_oAdvisedSlots } )
+    {
+        auto oIter = poSlots->find(nIndex);
+        if( oIter != poSlots->end() )
+        {
+            poSlot = std::move(oIter->second);
+            poSlots->erase(oIter);
+            m_oAdvisedOrder.erase(poSlot->nAdvisedSequence);
+            break;
+        }
+    }
+    if( poSlot )
+    {
+        m_oCV.wait(oLock, [&poSlot]{ return poSlot->bReady; });
+        if( poSlot->bOK )
+        {
+            memcpy(poBlock->GetDataRef(), poSlot->abyData.data(),
+                   m_nBlockBytes);
+            bRecalled = true;
+            m_nRecalledBlocks++;
+        }
+    }
+
+    // Blocks already in the block cache do not go through here, hence
+    // the tolerance on the gap with the previous miss.
+    if( nIndex > m_nLastIndex && nIndex - m_nLastIndex <= nPrefetch + 1 )
+    {
+        m_nSequentialMisses++;
+    }
+    else
+    {
+        m_nSequentialMisses = 0;
+        m_oSlots.clear();
+    }
+    m_nLastIndex = nIndex;
+
+    if( nPrefetch > 0 && m_nSequentialMisses >= 1 )
+        Schedule_unlocked(nIndex, nPrefetch);
+
+    return bRecalled;
+}
+
+/************************************************************************/
+/*                          WaitPendingJobs()                           */
+/************************************************************************/
+
+void GDALBlockPrefetcher::WaitPendingJobs()
+{
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    m_oSlots.clear();
+    m_oAdvisedSlots.clear();
+    m_oAdvisedOrder.clear();
+    m_oCV.wait(oLock, [this]{ return m_nPendingJobs == 0; });
+}
+
+/************************************************************************/
+/*                          ReportStatistics()                          */
+/************************************************************************/
+
+void GDALBlockPrefetcher::ReportStatistics() const
+{
+    if( m_nRecalledBlocks > 0 )
+    {
+        CPLDebug("GDAL", "%s, band %d%s: %d blocks read from prefetched "
+                 "buffers", m_osFilename.c_str(), m_nBand,
+                 m_iOverview >= 0 ? CPLSPrintf(", overview %d", m_iOverview)
+                                  : "",
+                 m_nRecalledBlocks);
+    }
+}
+
+std::mutex gMutexPrefetchers;
+std::map<const GDALRasterBand*, std::shared_ptr<GDALBlockPrefetcher>>
+                                                        gMapPrefetchers;
+std::atomic<size_t> gnPrefetchers{0};
+
+// Only bands of read-only datasets that can be reopened.
+bool IsEligible(GDALRasterBand* poBand)
+{
+    GDALDataset* poDS = poBand->GetDataset();
+    return poDS != nullptr && poDS->GetAccess() == GA_ReadOnly &&
+           poBand->GetAccess() == GA_ReadOnly &&
+           poBand->GetBand() >= 1 &&
+           poDS->GetRasterBand(poBand->GetBand()) == poBand &&
+           poDS->GetDriver() != nullptr &&
+           !EQUAL(poDS->GetDriver()->GetDescription(), "MEM") &&
+           poDS->GetDescription()[0] != '\0' &&
+           !STARTS_WITH(poDS->GetDescription(), "/vsistdin/");
+}
+
+} // namespace
+
+/************************************************************************/
+/*                      GDALBlockPrefetcherRecall()                     */
+/************************************************************************/
+
+// Called by GetLockedBlockRef() on a block cache miss, with the value of
+// GDAL_BLOCK_PREFETCH read when the block cache of the band was initialized.
+// Returns true if the content of the block has been filled from a prefetched
+// buffer.
+bool GDALBlockPrefetcherRecall(GDALRasterBlock* poBlock, int nPrefetch)
+{
+    if( nPrefetch <= 0 && gnPrefetchers == 0 )
+        return false;
+
+    GDALRasterBand* poBand = poBlock->GetBand();
+    std::shared_ptr<GDALBlockPrefetcher> poPrefetcher;
+    {
+        std::lock_guard<std::mutex> oLock(gMutexPrefetchers);
+        auto oIter = gMapPrefetchers.find(poBand);
+        if( oIter != gMapPrefetchers.end() )
+        {
+            poPrefetcher = oIter->second;
+        }
+        else
+        {
+            if( nPrefetch <= 0 || !IsEligible(poBand) )
+                return false;
+
+            poPrefetcher = std::make_shared<GDALBlockPrefetcher>(
+                poBand, -1, poBand,
+                static_cast<size_t>(poBlock->GetBlockSize()));
+            gMapPrefetchers[poBand] = poPrefetcher;
+            gnPrefetchers = gMapPrefetchers.size();
+        }
+    }
+
+    return poPrefetcher->Recall(poBlock, nPrefetch);
+}
+
+/************************************************************************/
+/*                      GDALBlockPrefetcherAdvise()                     */
+/************************************************************************/
+
+// Schedules the reading of the blocks of poBand (poMainBand, or its
+// iOverview-th overview) intersecting the window, if they are not already
+// in the block cache. Returns false if that is not possible.
+bool GDALBlockPrefetcherAdvise(GDALRasterBand* poMainBand, int iOverview,
+                               GDALRasterBand* poBand,
+                               int nXOff, int nYOff, int nXSize, int nYSize)
+{
+    if( !IsEligible(poMainBand) )
+        return false;
+
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const int nDTSize = GDALGetDataTypeSizeBytes(poBand->GetRasterDataType());
+    if( nBlockXSize <= 0 || nBlockYSize <= 0 || nDTSize == 0 ||
+        static_cast<GIntBig>(nBlockXSize) * nBlockYSize >
+                                        INT_MAX / nDTSize )
+    {
+        return false;
+    }
+    const size_t nBlockBytes =
+        static_cast<size_t>(nBlockXSize) * nBlockYSize * nDTSize;
+
+    const int nXBlockStart = nXOff / nBlockXSize;
+    const int nYBlockStart = nYOff / nBlockYSize;
+    const int nXBlockEnd = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nYBlockEnd = (nYOff + nYSize - 1) / nBlockYSize;
+
+    // Do not read more than what the block cache could hold, otherwise
+    // the first blocks would be evicted before being used.
+    const GIntBig nBlocks =
+        static_cast<GIntBig>(nXBlockEnd - nXBlockStart + 1) *
+        (nYBlockEnd - nYBlockStart + 1);
+    if( nBlocks < 2 ||
+        nBlocks > GDALGetCacheMax64() / 2 / static_cast<GIntBig>(nBlockBytes) )
+    {
+        return false;
+    }
+
+    std::shared_ptr<GDALBlockPrefetcher> poPrefetcher;
+    {
+        std::lock_guard<std::mutex> oLock(gMutexPrefetchers);
+        auto oIter = gMapPrefetchers.find(poBand);
+        if( oIter != gMapPrefetchers.end() )
+        {
+            poPrefetcher = oIter->second;
+        }
+        else
+        {
+            poPrefetcher = std::make_shared<GDALBlockPrefetcher>(
+                poMainBand, iOverview, poBand, nBlockBytes);
+            gMapPrefetchers[poBand] = poPrefetcher;
+            gnPrefetchers = gMapPrefetchers.size();
+        }
+    }
+
+    poPrefetcher->Advise(poBand, nXBlockStart, nYBlockStart,
+                         nXBlockEnd, nYBlockEnd);
+    return true;
+}
+
+/************************************************************************/
+/*                     GDALBlockPrefetcherDropBand()                    */
+/************************************************************************/
+
+// Called when the block cache of a band is flushed, including when it is
+// destroyed.
+void GDALBlockPrefetcherDropBand(const GDALRasterBand* poBand)
+{
+    if( gnPrefetchers == 0 )
+        return;
+
+    std::shared_ptr<GDALBlockPrefetcher> poPrefetcher;
+    {
+        std::lock_guard<std::mutex> oLock(gMutexPrefetchers);
+        auto oIter = gMapPrefetchers.find(poBand);
+        if( oIter == gMapPrefetchers.end() )
+            return;
+        poPrefetcher = std::move(oIter->second);
+        gMapPrefetchers.erase(oIter);
+        gnPrefetchers = gMapPrefetchers.size();
+    }
+    poPrefetcher->WaitPendingJobs();
+    poPrefetcher->ReportStatistics();
+}
+
+//! @endcond
@@ -0,0 +1,413 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Compressed second tier of the raster block cache
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_priv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cpl_compressor.h"
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+
+//! @cond Doxygen_Suppress
+
+/* ******************************************************************** */
+/*                       GDALCompressedBlockCache                       */
+/* ******************************************************************** */
+
+// Clean blocks of read-only bands that are evicted from the block cache
+// can be kept compressed in memory, with their own memory budget, set with
+// the GDAL_BLOCK_CACHE_SECOND_TIER_MAX configuration option (same syntax as
+// GDAL_CACHEMAX: a value in MB, in bytes, or a percentage of the usable
+// physical RAM. Default is 0, that is disabled).
+// When such a block is requested again, it is decompressed instead of being
+// read again from the driver, which is generally much faster for formats
+// with expensive codecs.
+// The compression method is set with GDAL_BLOCK_CACHE_SECOND_TIER_COMPRESSOR
+// (default lz4, if available, otherwise zstd, otherwise zlib).
+
+namespace
+{
+
+struct BlockKey
+{
+    const GDALRasterBand* poBand = nullptr;
+    int                   nXOff = 0;
+    int                   nYOff = 0;
+
+    BlockKey() = default;
+    BlockKey(const GDALRasterBand* poBandIn, int nXOffIn, int nYOffIn):
+        poBand(poBandIn), nXOff(nXOffIn), nYOff(nYOffIn) {}
+
+    bool operator==(const BlockKey& other) const
+    {
+        return poBand == other.poBand &&
+               nXOff == other.nXOff && nYOff == other.nYOff;
+    }
+};
+
+struct BlockKeyHasher
+{
+    size_t operator()(const BlockKey& k) const
+    {
+        return std::hash<const void*>()(k.poBand) ^
+               (static_cast<size_t>(k.nYOff) * 1000003U +
+                static_cast<size_t>(k.nXOff));
+    }
+};
+
+// Approximate memory overhead of an entry, in addition to its data.
+constexpr size_t ENTRY_OVERHEAD = 96;
+
+class GDALCompressedBlockCache
+{
+    struct Entry
+    {
+        BlockKey             oKey{};
+        std::vector<GByte>   abyData{};
+        size_t               nUncompressedSize = 0;
+    };
+
+    std::mutex                 m_oMutex{};
+    // Most recently stored entries at the front.
+    std::list<Entry>           m_oList{};
+    std::unordered_map<BlockKey, std::list<Entry>::iterator,
+                       BlockKeyHasher> m_oMap{};
+    // Number of entries per band, to quickly skip bands without entries.
+    std::unordered_map<const GDALRasterBand*, int> m_oMapBandCount{};
+    std::atomic<size_t>        m_nEntries{0};
+    size_t                     m_nUsed = 0;
+    size_t                     m_nMax = 0;
+    CPLString                  m_osCompressor{};
+    CPLStringList              m_aosOptions{};
+
+    Entry Remove_unlocked(std::list<Entry>::iterator oIter);
+
+  public:
+    GDALCompressedBlockCache(size_t nMax, const std::string& osCompressor);
+
+    void Store(GDALRasterBlock* poBlock);
+    bool Recall(GDALRasterBlock* poBlock);
+    void DropBand(const GDALRasterBand* poBand);
+};
+
+/************************************************************************/
+/*                      GDALCompressedBlockCache()                      */
+/************************************************************************/
+
+GDALCompressedBlockCache::GDALCompressedBlockCache(
+    size_t nMax, const std::string& osCompressor):
+    m_nMax(nMax), m_osCompressor(osCompressor)
+{
+    // Favor speed over compression ratio.
+    if( m_osCompressor == "zstd" || m_osCompressor == "zlib" )
+        m_aosOptions.SetNameValue("LEVEL", "1");
+}
+
+/************************************************************************/
+/*                           Remove_unlocked()                          */
+/************************************************************************/
+
+GDALCompressedBlockCache::Entry GDALCompressedBlockCache::Remove_unlocked(
+                                        std::list<Entry>::iterator oIter)
+{
+    m_nUsed -= oIter->abyData.size() + ENTRY_OVERHEAD;
+    auto oIterCount = m_oMapBandCount.find(oIter->oKey.poBand);
+    if( --(oIterCount->second) == 0 )
+        m_oMapBandCount.erase(oIterCount);
+    m_oMap.erase(oIter->oKey);
+    Entry oEntry = std::move(*oIter);
+    m_oList.erase(oIter);
+    --m_nEntries;
+    return oEntry;
+}
+
+/************************************************************************/
+/*                                Store()                               */
+/************************************************************************/
+
+void GDALCompressedBlockCache::Store(GDALRasterBlock* poBlock)
+{
+    const auto psCompressor = CPLGetCompressor(m_osCompressor.c_str());
+    if( psCompressor == nullptr )
+        return;
+
+    const size_t nSize = static_cast<size_t>(poBlock->GetBlockSize());
+    if( nSize + ENTRY_OVERHEAD > m_nMax )
+        return;
+
+    // Compress in a per-thread scratch buffer, and only keep the block if
+    // it is actually compressible.
+    thread_local std::vector<GByte> abyScratch;
+    if( abyScratch.size() < nSize )
+    {
+        try
+        {
+            abyScratch.resize(nSize);
+        }
+        catch( const std::exception& )
+        {
+            return;
+        }
+    }
+    void* pOutput = abyScratch.data();
+    size_t nOutputSize = nSize;
+    if( !psCompressor->pfnFunc(poBlock->GetDataRef(), nSize,
+                               &pOutput, &nOutputSize,
+                               m_aosOptions.List(),
+                               psCompressor->user_data) ||
+        nOutputSize >= nSize )
+    {
+        return;
+    }
+
+    Entry oEntry;
+    oEntry.oKey = BlockKey{poBlock->GetBand(), poBlock->GetXOff(),
+                           poBlock->GetYOff()};
+    oEntry.nUncompressedSize = nSize;
+    try
+    {
+        oEntry.abyData.assign(abyScratch.data(),
+                              abyScratch.data() + nOutputSize);
+    }
+    catch( const std::exception& )
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    auto oIter = m_oMap.find(oEntry.oKey);
+    if( oIter != m_oMap.end() )
+        Remove_unlocked(oIter->second);
+
+    const size_t nEntrySize = nOutputSize + ENTRY_OVERHEAD;
+    while( m_nUsed + nEntrySize > m_nMax && !m_oList.empty() )
+        Remove_unlocked(std::prev(m_oList.end()));
+
+    const BlockKey oKey = oEntry.oKey;
+    m_oList.emplace_front(std::move(oEntry));
+    m_oMap[oKey] = m_oList.begin();
+    m_oMapBandCount[oKey.poBand]++;
+    m_nUsed += nEntrySize;
+    ++m_nEntries;
+}
+
+/************************************************************************/
+/*                               Recall()                               */
+/************************************************************************/
+
+bool GDALCompressedBlockCache::Recall(GDALRasterBlock* poBlock)
+{
+    if( m_nEntries == 0 )
+        return false;
+
+    Entry oEntry;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto oIter = m_oMap.find(BlockKey{poBlock->GetBand(),
+                                          poBlock->GetXOff(),
+                                          poBlock->GetYOff()});
+        if( oIter == m_oMap.end() )
+            return false;
+        // The block goes back to the first tier: no need to keep it here.
+        oEntry = Remove_unlocked(oIter->second);
+    }
+
+    const size_t nSize = static_cast<size_t>(poBlock->GetBlockSize());
+    if( oEntry.nUncompressedSize != nSize )
+        return false;
+
+    const auto psDecompressor = CPLGetDecompressor(m_osCompressor.c_str());
+    if( psDecompressor == nullptr )
+        return false;
+
+    void* pOutput = poBlock->GetDataRef();
+    size_t nOutputSize = nSize;
+    return psDecompressor->pfnFunc(oEntry.abyData.data(),
+                                   oEntry.abyData.size(),
+                                   &pOutput, &nOutputSize, nullptr,
+                                   psDecompressor->user_data) &&
+           nOutputSize == nSize;
+}
+
+/************************************************************************/
+/*                              DropBand()                              */
+/************************************************************************/
+
+void GDALCompressedBlockCache::DropBand(const GDALRasterBand* poBand)
+{
+    if( m_nEntries == 0 )
+        return;
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_oMapBandCount.find(poBand) == m_oMapBandCount.end() )
+        return;
+    for( auto oIter = m_oList.begin(); oIter != m_oList.end(); )
+    {
+        auto oIterNext = std::next(oIter);
+        if( oIter->oKey.poBand == poBand )
+            Remove_unlocked(oIter);
+        oIter = oIterNext;
+    }
+}
+
+/************************************************************************/
+/*                        GetCompressedBlockCache()                     */
+/************************************************************************/
+
+// Returns nullptr if the second tier is disabled.
+static GDALCompressedBlockCache* GetCompressedBlockCache()
+{
+    static std::unique_ptr<GDALCompressedBlockCache> poCache = []() ->
+        std::unique_ptr<GDALCompressedBlockCache>
+    {
+        const char* pszMax =
+            CPLGetConfigOption("GDAL_BLOCK_CACHE_SECOND_TIER_MAX", "0");
+        GIntBig nMax = 0;
+        if( strchr(pszMax, '%') != nullptr )
+        {
+            const GIntBig nUsablePhysicalRAM = CPLGetUsablePhysicalRAM();
+            const double dfMax = static_cast<double>(nUsablePhysicalRAM) *
+                                 CPLAtof(pszMax) / 100.0;
+            if( dfMax >= 0 && dfMax < 1e15 )
+                nMax = static_cast<GIntBig>(dfMax);
+        }
+        else
+        {
+            nMax = CPLAtoGIntBig(pszMax);
+            if( nMax < 100000 )
+                nMax *= 1024 * 1024;
+        }
+        if( nMax <= 0 )
+            return nullptr;
+#if SIZEOF_VOIDP == 4
+        nMax = std::min<GIntBig>(nMax, INT_MAX);
+#endif
+
+        std::string osCompressor;
+        const char* pszCompressor =
+            CPLGetConfigOption("GDAL_BLOCK_CACHE_SECOND_TIER_COMPRESSOR",
+                               nullptr);
+        if( pszCompressor )
+        {
+            if( CPLGetCompressor(pszCompressor) == nullptr ||
+                CPLGetDecompressor(pszCompressor) == nullptr )
+            {
+                CPLError(CE_Warning, CPLE_NotSupported,
+                         "Compressor %s is not available. "
+                         "Using default one for "
+                         "GDAL_BLOCK_CACHE_SECOND_TIER_COMPRESSOR",
+                         pszCompressor);
+            }
+            else
+            {
+                osCompressor = pszCompressor;
+            }
+        }
+        if( osCompressor.empty() )
+        {
+            for( const char* pszCandidate : { "lz4", "zstd", "zlib" } )
+            {
+                if( CPLGetCompressor(pszCandidate) != nullptr &&
+                    CPLGetDecompressor(pszCandidate) != nullptr )
+                {
+                    osCompressor = pszCandidate;
+                    break;
+                }
+            }
+            if( osCompressor.empty() )
+                return nullptr;
+        }
+        CPLDebug("GDAL", "Using a " CPL_FRMT_GIB " bytes second tier block "
+                 "cache, with %s compression", nMax, osCompressor.c_str());
+        return std::unique_ptr<GDALCompressedBlockCache>(
+            new GDALCompressedBlockCache(static_cast<size_t>(nMax),
+                                         osCompressor));
+    }();
+    return poCache.get();
+}
+
+} // namespace
+
+/************************************************************************/
+/*                    GDALCompressedBlockCacheStore()                   */
+/************************************************************************/
+
+// Called when a clean block is evicted from the block cache, before its
+// data is released.
+void GDALCompressedBlockCacheStore(GDALRasterBlock* poBlock)
+{
+    GDALRasterBand* poBand = poBlock->GetBand();
+    if( poBlock->GetDirty() || poBlock->GetDataRef() == nullptr ||
+        poBand->GetAccess() != GA_ReadOnly )
+    {
+        return;
+    }
+    GDALDataset* poDS = poBand->GetDataset();
+    if( poDS != nullptr && poDS->GetAccess() != GA_ReadOnly )
+        return;
+
+    auto poCache = GetCompressedBlockCache();
+    if( poCache )
+        poCache->Store(poBlock);
+}
+
+/************************************************************************/
+/*                   GDALCompressedBlockCacheRecall()                   */
+/************************************************************************/
+
+// Fills the data of a newly instantiated block from the second tier.
+// Returns false if the block was not found in it.
+bool GDALCompressedBlockCacheRecall(GDALRasterBlock* poBlock)
+{
+    auto poCache = GetCompressedBlockCache();
+    return poCache != nullptr && poCache->Recall(poBlock);
+}
+
+/************************************************************************/
+/*                  GDALCompressedBlockCacheDropBand()                  */
+/************************************************************************/
+
+void GDALCompressedBlockCacheDropBand(const GDALRasterBand* poBand)
+{
+    auto poCache = GetCompressedBlockCache();
+    if( poCache )
+        poCache->DropBand(poBand);
+}
+
+//! @endcond
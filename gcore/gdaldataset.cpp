@@ -481,6 +481,63 @@ void CPL_STDCALL GDALFlushCache( GDALDatasetH hDS )
     GDALDataset::FromHandle(hDS)->FlushCache(false);
 }
 
+/************************************************************************/
+/*                      GetBlockCacheStatistics()                       */
+/************************************************************************/
+
+/**
+ * \brief Get block cache statistics of this dataset.
+ *
+ * The statistics are the sum of the ones of the raster bands of the dataset,
+ * as returned by GDALRasterBand::GetBlockCacheStatistics(). Overview and mask
+ * bands are not included.
+ *
+ * This method is the same as the C function
+ * GDALDatasetGetBlockCacheStatistics().
+ *
+ * @param psStats Pointer to the structure to fill. Must not be NULL.
+ *
+ * @since GDAL 3.7
+ */
+
+void GDALDataset::GetBlockCacheStatistics( GDALBlockCacheStatistics* psStats )
+{
+    memset(psStats, 0, sizeof(*psStats));
+    for( int i = 0; i < nBands; ++i )
+    {
+        GDALBlockCacheStatistics sBandStats;
+        papoBands[i]->GetBlockCacheStatistics(&sBandStats);
+        psStats->nHits += sBandStats.nHits;
+        psStats->nMisses += sBandStats.nMisses;
+        psStats->nEvictions += sBandStats.nEvictions;
+        psStats->nDirtyBlockFlushes += sBandStats.nDirtyBlockFlushes;
+        psStats->nResidentBytes += sBandStats.nResidentBytes;
+        psStats->nSecondTierRecalls += sBandStats.nSecondTierRecalls;
+    }
+}
+
+/************************************************************************/
+/*                 GDALDatasetGetBlockCacheStatistics()                 */
+/************************************************************************/
+
+/**
+ * \brief Get block cache statistics of a dataset.
+ *
+ * @see GDALDataset::GetBlockCacheStatistics()
+ *
+ * @since GDAL 3.7
+ */
+
+void GDALDatasetGetBlockCacheStatistics( GDALDatasetH hDS,
+                                         GDALBlockCacheStatistics* psStats )
+
+{
+    VALIDATE_POINTER0(hDS, "GDALDatasetGetBlockCacheStatistics");
+    VALIDATE_POINTER0(psStats, "GDALDatasetGetBlockCacheStatistics");
+
+    GDALDataset::FromHandle(hDS)->GetBlockCacheStatistics(psStats);
+}
+
 /************************************************************************/
 /*                        BlockBasedFlushCache()                        */
 /*                                                                      */
@@ -3185,6 +3242,15 @@ GDALOpen( const char * pszFilename, GDALAccess eAccess )
  * referenced and returned, if GDALOpenEx() is called from the same thread.</li>
  * <li>Verbose error: GDAL_OF_VERBOSE_ERROR. If set, a failed attempt to open
  * the file will lead to an error message to be reported.</li>
+ * <li>Thread-safe mode: GDAL_OF_THREAD_SAFE (GDAL &gt;= 3.7). If set, the
+ * returned raster dataset can be used simultaneously by several threads for
+ * read operations. Threads share the block cache of the bands of the returned
+ * dataset, and decode missing blocks concurrently through underlying dataset
+ * handles borrowed from a pool, which keeps at most as many idle handles as
+ * there are CPUs. Can only be used in read-only mode, with GDAL_OF_RASTER,
+ * and not with GDAL_OF_SHARED. Methods that modify the dataset fail with
+ * CPLE_NotSupported.
+ * </li>
  * </ul>
  *
  * @param papszAllowedDrivers NULL to consider all candidate drivers, or a NULL
@@ -3222,6 +3288,28 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char *pszFilename,
                                      const char *const *papszSiblingFiles )
 {
     VALIDATE_POINTER1(pszFilename, "GDALOpen", nullptr);
+
+/* -------------------------------------------------------------------- */
+/*      Thread-safe datasets are proxies over a pool of datasets.       */
+/* -------------------------------------------------------------------- */
+    if( nOpenFlags & GDAL_OF_THREAD_SAFE )
+    {
+        nOpenFlags &= ~GDAL_OF_THREAD_SAFE;
+        if( (nOpenFlags & GDAL_OF_KIND_MASK) == 0 )
+            nOpenFlags |= GDAL_OF_RASTER;
+        GDALDataset* poDS = GDALOpenThreadSafeDataset(pszFilename, nOpenFlags,
+                                                      papszAllowedDrivers,
+                                                      papszOpenOptions,
+                                                      papszSiblingFiles);
+        if( poDS != nullptr )
+        {
+            poDS->nOpenFlags = nOpenFlags | GDAL_OF_THREAD_SAFE;
+            if( !(nOpenFlags & GDAL_OF_INTERNAL) )
+                poDS->AddToDatasetOpenList();
+        }
+        return poDS;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      In case of shared dataset, first scan the existing list to see  */
 /*      if it could already contain the requested dataset.              */
@@ -3786,6 +3874,20 @@ int CPL_STDCALL GDALDumpOpenDatasets( FILE *fp )
  * the session (GDALAsyncReader) is destroyed with EndAsyncReader().  It
  * should be deallocated by the application at that point.
  *
+ * Drivers that do not implement a specific asynchronous reader use a default
+ * implementation. Starting with GDAL 3.7, it runs the request as a job of the
+ * global thread pool (whose size is controlled by the GDAL_NUM_THREADS
+ * configuration option, defaulting to the number of CPUs), so that several
+ * requests can be outstanding at the same time and GetNextUpdatedRegion() can
+ * be used to wait for their completion with a timeout. If the dataset has been
+ * opened with GDAL_OF_THREAD_SAFE, the job reads from it. Otherwise the job
+ * reads from a private handle, opened with the name, driver and open options
+ * of the dataset, which must then be opened in read-only mode. If no such
+ * handle can be opened, for example for a dataset that only exists in memory,
+ * the request is run synchronously by the first call to
+ * GetNextUpdatedRegion(). The ASYNC=NO option may be used to force the
+ * synchronous behavior.
+ *
  * Additional information on asynchronous IO in GDAL may be found at:
  *   https://gdal.org/development/rfc/rfc24_progressive_data_support.html
  *
@@ -8309,6 +8411,104 @@ bool GDALDataset::GetRawBinaryLayout(RawBinaryLayout& sLayout)
 //! @endcond
 
 
+/************************************************************************/
+/*                      GetCompressedBlockLayout()                      */
+/************************************************************************/
+
+/**
+ \brief Return the layout of the compressed blocks of the dataset.
+
+ Drivers that implement this method, ReadCompressedData() and
+ WriteCompressedData() allow GDALDatasetCopyWholeRaster() to copy blocks
+ between two datasets with the same layout without decompressing and
+ recompressing them.
+
+ A dataset being written should return false if settings of its encoder
+ (compression level, quality, etc.) have been explicitly requested, or if
+ its codec is lossy, as copying blocks would not honour them.
+
+ This is currently implemented by the GTiff driver (and thus COG) only.
+ GeoPackage raster tiles and Zarr chunks, whose blobs are also self-contained,
+ are not covered yet.
+
+ @param sLayout Structure that will be set if the dataset exposes its
+                compressed blocks.
+ @return true if the dataset exposes its compressed blocks.
+ @since GDAL 3.7
+*/
+
+bool GDALDataset::GetCompressedBlockLayout(CompressedBlockLayout& sLayout)
+{
+    CPL_IGNORE_RET_VAL(sLayout);
+    return false;
+}
+
+/************************************************************************/
+/*                         ReadCompressedData()                         */
+/************************************************************************/
+
+/**
+ \brief Read the compressed content of a block.
+
+ @param nPlane Plane index, between 0 and
+               CompressedBlockLayout::nPlaneCount - 1.
+ @param nXBlockOff the horizontal block offset.
+ @param nYBlockOff the vertical block offset.
+ @param abyData Output buffer. Set empty if the block is not present in
+                the dataset (sparse dataset).
+ @return CE_None on success.
+ @since GDAL 3.7
+*/
+
+CPLErr GDALDataset::ReadCompressedData(int nPlane,
+                                      int nXBlockOff, int nYBlockOff,
+                                      std::vector<GByte>& abyData)
+{
+    CPL_IGNORE_RET_VAL(nPlane);
+    CPL_IGNORE_RET_VAL(nXBlockOff);
+    CPL_IGNORE_RET_VAL(nYBlockOff);
+    CPL_IGNORE_RET_VAL(abyData);
+    ReportError(CE_Failure, CPLE_NotSupported,
+                "ReadCompressedData() not supported by this dataset");
+    return CE_Failure;
+}
+
+/************************************************************************/
+/*                        WriteCompressedData()                         */
+/************************************************************************/
+
+/**
+ \brief Write the compressed content of a block.
+
+ The content must be encoded as described by the layout returned by
+ GetCompressedBlockLayout(), typically by reading it with
+ ReadCompressedData() from a dataset with the same layout.
+
+ @param nPlane Plane index, between 0 and
+               CompressedBlockLayout::nPlaneCount - 1.
+ @param nXBlockOff the horizontal block offset.
+ @param nYBlockOff the vertical block offset.
+ @param pData Compressed data.
+ @param nDataSize Size of pData in bytes.
+ @return CE_None on success.
+ @since GDAL 3.7
+*/
+
+CPLErr GDALDataset::WriteCompressedData(int nPlane,
+                                       int nXBlockOff, int nYBlockOff,
+                                       const void* pData, size_t nDataSize)
+{
+    CPL_IGNORE_RET_VAL(nPlane);
+    CPL_IGNORE_RET_VAL(nXBlockOff);
+    CPL_IGNORE_RET_VAL(nYBlockOff);
+    CPL_IGNORE_RET_VAL(pData);
+    CPL_IGNORE_RET_VAL(nDataSize);
+    ReportError(CE_Failure, CPLE_NotSupported,
+                "WriteCompressedData() not supported by this dataset");
+    return CE_Failure;
+}
+
+
 /************************************************************************/
 /*                          ClearStatistics()                           */
 /************************************************************************/
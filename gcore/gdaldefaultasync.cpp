@@ -30,12 +30,20 @@
 #include "cpl_port.h"
 #include "gdal_priv.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_string.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 
 CPL_C_START
@@ -276,11 +284,45 @@ void CPL_STDCALL GDALARUnlockBuffer(GDALAsyncReaderH hARIO)
 /* ==================================================================== */
 /************************************************************************/
 
+// The request is run as a RasterIO() job of the global thread pool, so that
+// the caller can issue several requests and wait for them later. When the
+// dataset has been opened with GDAL_OF_THREAD_SAFE, the job reads from it
+// directly. Otherwise, as the dataset could not be safely used by the caller
+// while the job runs, the job reads from a private handle, re-opened from the
+// description, driver and open options of a read-only dataset. If such a
+// handle cannot be opened, the request is run synchronously by the first call
+// to GetNextUpdatedRegion().
+// Errors emitted by the job are collected, and re-emitted in the thread of
+// the caller once GetNextUpdatedRegion() observes its completion.
+// BeginAsyncReader()/GetNextUpdatedRegion() is the waitable handle of such
+// requests, so there is no separate RasterIOAsync() entry point, and drivers
+// need no specific code: the RasterIO() of each job is served by the regular
+// driver code path.
+
 class GDALDefaultAsyncReader : public GDALAsyncReader
 {
   private:
     char **papszOptions = nullptr;
 
+    std::mutex m_oMutex{};
+    std::condition_variable m_oCV{};
+    bool m_bAsync = false;
+    bool m_bPrivateHandle = false;
+    bool m_bDone = false;
+    bool m_bSyncFallback = false;
+    std::string m_osFilename{};
+    std::string m_osDriverName{};
+    CPLStringList m_aosOpenOptions{};
+    int m_nDSXSize = 0;
+    int m_nDSYSize = 0;
+    std::vector<GDALDataType> m_aeDataTypes{};
+    CPLErr m_eErr = CE_None;
+    std::vector<CPLErrorHandlerAccumulatorStruct> m_aoErrors{};
+
+    GDALDataset* OpenPrivateHandle() const;
+    CPLErr RunRasterIO(GDALDataset* poReadDS);
+    static void RunJob(void* pData);
+
     CPL_DISALLOW_COPY_ASSIGN(GDALDefaultAsyncReader)
 
   public:
@@ -367,6 +409,38 @@ GDALDefaultAsyncReader( GDALDataset* poDSIn,
     nBandSpace = nBandSpaceIn;
 
     papszOptions = CSLDuplicate(papszOptionsIn);
+
+    if( CPLTestBool(CSLFetchNameValueDef(papszOptions, "ASYNC", "YES")) )
+    {
+        m_bPrivateHandle = !poDS->IsThreadSafe();
+        if( !m_bPrivateHandle ||
+            (poDS->GetAccess() == GA_ReadOnly &&
+             poDS->GetDriver() != nullptr &&
+             poDS->GetDescription()[0] != '\0') )
+        {
+            if( m_bPrivateHandle )
+            {
+                // Capture what is needed to re-open the dataset, as it must
+                // not be accessed by the job.
+                m_osFilename = poDS->GetDescription();
+                m_osDriverName = poDS->GetDriver()->GetDescription();
+                m_aosOpenOptions.Assign(
+                    CSLDuplicate(poDS->GetOpenOptions()), TRUE);
+                m_nDSXSize = poDS->GetRasterXSize();
+                m_nDSYSize = poDS->GetRasterYSize();
+                for( int i = 0; i < poDS->GetRasterCount(); i++ )
+                {
+                    m_aeDataTypes.push_back(
+                        poDS->GetRasterBand(i + 1)->GetRasterDataType());
+                }
+            }
+            const int nThreads = GDALGetNumThreads(
+                128, /* bDefaultAllCPUs = */ true);
+            auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+            m_bAsync = poThreadPool != nullptr &&
+                       poThreadPool->SubmitJob(RunJob, this);
+        }
+    }
 }
 
 /************************************************************************/
@@ -376,28 +450,148 @@ GDALDefaultAsyncReader( GDALDataset* poDSIn,
 GDALDefaultAsyncReader::~GDALDefaultAsyncReader()
 
 {
+    if( m_bAsync )
+    {
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        m_oCV.wait(oLock, [this]{ return m_bDone; });
+    }
     CPLFree( panBandMap );
     CSLDestroy( papszOptions );
 }
 
+/************************************************************************/
+/*                         OpenPrivateHandle()                          */
+/************************************************************************/
+
+GDALDataset* GDALDefaultAsyncReader::OpenPrivateHandle() const
+{
+    const char* const apszAllowedDrivers[] = {
+        m_osDriverName.c_str(), nullptr };
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    auto poReadDS = GDALDataset::Open(m_osFilename.c_str(),
+                                      GDAL_OF_RASTER,
+                                      apszAllowedDrivers,
+                                      m_aosOpenOptions.List());
+    CPLPopErrorHandler();
+    if( poReadDS == nullptr )
+        return nullptr;
+
+    // Make sure that the re-opened dataset looks like the one of the caller.
+    bool bMatch =
+        poReadDS->GetRasterXSize() == m_nDSXSize &&
+        poReadDS->GetRasterYSize() == m_nDSYSize &&
+        poReadDS->GetRasterCount() == static_cast<int>(m_aeDataTypes.size());
+    for( int i = 0; bMatch && i < poReadDS->GetRasterCount(); i++ )
+    {
+        bMatch = poReadDS->GetRasterBand(i + 1)->GetRasterDataType() ==
+                 m_aeDataTypes[i];
+    }
+    if( !bMatch )
+    {
+        GDALClose(poReadDS);
+        return nullptr;
+    }
+    return poReadDS;
+}
+
+/************************************************************************/
+/*                            RunRasterIO()                             */
+/************************************************************************/
+
+CPLErr GDALDefaultAsyncReader::RunRasterIO(GDALDataset* poReadDS)
+{
+    return poReadDS->RasterIO( GF_Read, nXOff, nYOff, nXSize, nYSize,
+                               pBuf, nBufXSize, nBufYSize, eBufType,
+                               nBandCount, panBandMap,
+                               nPixelSpace, nLineSpace, nBandSpace,
+                               nullptr );
+}
+
+/************************************************************************/
+/*                               RunJob()                               */
+/************************************************************************/
+
+void GDALDefaultAsyncReader::RunJob(void* pData)
+{
+    auto poThis = static_cast<GDALDefaultAsyncReader*>(pData);
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors;
+    CPLErr eErr = CE_None;
+    bool bSyncFallback = false;
+    CPLInstallErrorHandlerAccumulator(aoErrors);
+    if( poThis->m_bPrivateHandle )
+    {
+        GDALDataset* poReadDS = poThis->OpenPrivateHandle();
+        if( poReadDS )
+        {
+            eErr = poThis->RunRasterIO(poReadDS);
+            GDALClose(poReadDS);
+        }
+        else
+        {
+            bSyncFallback = true;
+        }
+    }
+    else
+    {
+        eErr = poThis->RunRasterIO(poThis->poDS);
+    }
+    CPLUninstallErrorHandlerAccumulator();
+
+    std::lock_guard<std::mutex> oLock(poThis->m_oMutex);
+    poThis->m_eErr = eErr;
+    poThis->m_bSyncFallback = bSyncFallback;
+    poThis->m_aoErrors = std::move(aoErrors);
+    poThis->m_bDone = true;
+    poThis->m_oCV.notify_all();
+}
+
 /************************************************************************/
 /*                        GetNextUpdatedRegion()                        */
 /************************************************************************/
 
 GDALAsyncStatusType
-GDALDefaultAsyncReader::GetNextUpdatedRegion( double /*dfTimeout*/,
+GDALDefaultAsyncReader::GetNextUpdatedRegion( double dfTimeout,
                                               int* pnBufXOff,
                                               int* pnBufYOff,
                                               int* pnBufXSize,
                                               int* pnBufYSize )
 {
-    CPLErr eErr;
+    CPLErr eErr = CE_None;
+    bool bSyncRead = !m_bAsync;
 
-    eErr = poDS->RasterIO( GF_Read, nXOff, nYOff, nXSize, nYSize,
-                           pBuf, nBufXSize, nBufYSize, eBufType,
-                           nBandCount, panBandMap,
-                           nPixelSpace, nLineSpace, nBandSpace,
-                           nullptr );
+    if( m_bAsync )
+    {
+        std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors;
+        {
+            std::unique_lock<std::mutex> oLock(m_oMutex);
+            const auto isDone = [this]{ return m_bDone; };
+            if( dfTimeout < 0 )
+                m_oCV.wait(oLock, isDone);
+            else if( !m_oCV.wait_for(oLock,
+                            std::chrono::duration<double>(dfTimeout), isDone) )
+            {
+                *pnBufXOff = 0;
+                *pnBufYOff = 0;
+                *pnBufXSize = 0;
+                *pnBufYSize = 0;
+                return GARIO_PENDING;
+            }
+            eErr = m_eErr;
+            std::swap(aoErrors, m_aoErrors);
+            std::swap(bSyncRead, m_bSyncFallback);
+        }
+
+        // Re-emit the errors of the job, only once.
+        for( const auto& oError : aoErrors )
+        {
+            CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+    }
+
+    if( bSyncRead )
+    {
+        eErr = RunRasterIO(poDS);
+    }
 
     *pnBufXOff = 0;
     *pnBufYOff = 0;
@@ -95,6 +95,8 @@ int GDALDefaultOverviews::CloseDependentDatasets()
         poODS = nullptr;
     }
 
+    DropInMemoryOverviews();
+
     if( poMaskDS != nullptr )
     {
         if( bOwnMaskDS )
@@ -165,6 +167,11 @@ void GDALDefaultOverviews::Initialize( GDALDataset *poDSIn,
     papszInitSiblingFiles = nullptr;
     if( papszSiblingFiles != nullptr )
         papszInitSiblingFiles = CSLDuplicate(papszSiblingFiles);
+
+    bInMemoryOverviewsEnabled =
+        CPLTestBool(CPLGetConfigOption("GDAL_IN_MEMORY_OVERVIEWS", "NO"));
+    osInMemoryOverviewsResampling =
+        CPLGetConfigOption("GDAL_IN_MEMORY_OVERVIEWS_RESAMPLING", "AVERAGE");
 }
 
 /************************************************************************/
@@ -407,6 +414,223 @@ void GDALDefaultOverviews::OverviewScan()
     --antiRec.nRecLevel;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                       GDALInMemoryOverviewBand                       */
+/* ==================================================================== */
+/************************************************************************/
+
+// Overview band whose blocks are computed, on first access, by resampling
+// the band of the previous overview level (or the full resolution band).
+// Computed blocks are kept in the global block cache, whose size is bounded
+// by GDAL_CACHEMAX, and are recomputed if they have been evicted from it.
+class GDALInMemoryOverviewBand final: public GDALRasterBand
+{
+    GDALRasterBand     *m_poSrcBand = nullptr;
+    GDALRasterBand     *m_poBaseBand = nullptr;
+    GDALRIOResampleAlg  m_eResampleAlg = GRIORA_Average;
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALInMemoryOverviewBand)
+
+  protected:
+    CPLErr IReadBlock( int nBlockXOff, int nBlockYOff, void *pImage ) override;
+
+  public:
+    GDALInMemoryOverviewBand( GDALDataset* poDSIn, int nBandIn,
+                              GDALRasterBand* poSrcBand,
+                              GDALRasterBand* poBaseBand,
+                              GDALRIOResampleAlg eResampleAlg );
+
+    double GetNoDataValue( int *pbSuccess = nullptr ) override
+        { return m_poBaseBand->GetNoDataValue(pbSuccess); }
+    GDALColorInterp GetColorInterpretation() override
+        { return m_poBaseBand->GetColorInterpretation(); }
+    GDALColorTable *GetColorTable() override
+        { return m_poBaseBand->GetColorTable(); }
+};
+
+/************************************************************************/
+/*                      GDALInMemoryOverviewBand()                      */
+/************************************************************************/
+
+GDALInMemoryOverviewBand::GDALInMemoryOverviewBand(
+                                        GDALDataset* poDSIn, int nBandIn,
+                                        GDALRasterBand* poSrcBand,
+                                        GDALRasterBand* poBaseBand,
+                                        GDALRIOResampleAlg eResampleAlg ) :
+    m_poSrcBand(poSrcBand),
+    m_poBaseBand(poBaseBand),
+    m_eResampleAlg(eResampleAlg)
+{
+    poDS = poDSIn;
+    nBand = nBandIn;
+    nRasterXSize = poDSIn->GetRasterXSize();
+    nRasterYSize = poDSIn->GetRasterYSize();
+    eDataType = poBaseBand->GetRasterDataType();
+    nBlockXSize = std::min(256, nRasterXSize);
+    nBlockYSize = std::min(256, nRasterYSize);
+
+    const char* pszNBITS =
+        poBaseBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+    if( pszNBITS )
+        GDALRasterBand::SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr GDALInMemoryOverviewBand::IReadBlock( int nBlockXOff, int nBlockYOff,
+                                             void *pImage )
+{
+    const int nXOff = nBlockXOff * nBlockXSize;
+    const int nYOff = nBlockYOff * nBlockYSize;
+    const int nReqXSize = std::min(nBlockXSize, nRasterXSize - nXOff);
+    const int nReqYSize = std::min(nBlockYSize, nRasterYSize - nYOff);
+
+    const int nSrcXSize = m_poSrcBand->GetXSize();
+    const int nSrcYSize = m_poSrcBand->GetYSize();
+    const double dfXRatio = static_cast<double>(nSrcXSize) / nRasterXSize;
+    const double dfYRatio = static_cast<double>(nSrcYSize) / nRasterYSize;
+
+    GDALRasterIOExtraArg sExtraArg;
+    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+    sExtraArg.eResampleAlg = m_eResampleAlg;
+    sExtraArg.bFloatingPointWindowValidity = TRUE;
+    sExtraArg.dfXOff = nXOff * dfXRatio;
+    sExtraArg.dfYOff = nYOff * dfYRatio;
+    sExtraArg.dfXSize =
+        std::min(nReqXSize * dfXRatio, nSrcXSize - sExtraArg.dfXOff);
+    sExtraArg.dfYSize =
+        std::min(nReqYSize * dfYRatio, nSrcYSize - sExtraArg.dfYOff);
+
+    const int nSrcXOff = static_cast<int>(sExtraArg.dfXOff);
+    const int nSrcYOff = static_cast<int>(sExtraArg.dfYOff);
+    const int nSrcXCount = std::min(nSrcXSize - nSrcXOff,
+        static_cast<int>(ceil(sExtraArg.dfXOff + sExtraArg.dfXSize - 1e-10)) -
+            nSrcXOff);
+    const int nSrcYCount = std::min(nSrcYSize - nSrcYOff,
+        static_cast<int>(ceil(sExtraArg.dfYOff + sExtraArg.dfYSize - 1e-10)) -
+            nSrcYOff);
+
+    // Directly use the resampling code, as RasterIO() on the source band
+    // would be redirected to this overview.
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    return m_poSrcBand->RasterIOResampled(
+        GF_Read, nSrcXOff, nSrcYOff, nSrcXCount, nSrcYCount,
+        pImage, nReqXSize, nReqYSize, eDataType,
+        nDTSize, static_cast<GSpacing>(nDTSize) * nBlockXSize, &sExtraArg );
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                     GDALInMemoryOverviewDataset                      */
+/* ==================================================================== */
+/************************************************************************/
+
+class GDALInMemoryOverviewDataset final: public GDALDataset
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALInMemoryOverviewDataset)
+
+  public:
+    GDALInMemoryOverviewDataset( int nXSize, int nYSize )
+    {
+        nRasterXSize = nXSize;
+        nRasterYSize = nYSize;
+    }
+
+    void AddBand( GDALRasterBand* poSrcBand, GDALRasterBand* poBaseBand,
+                  GDALRIOResampleAlg eResampleAlg )
+    {
+        SetBand( nBands + 1,
+                 new GDALInMemoryOverviewBand( this, nBands + 1,
+                                               poSrcBand, poBaseBand,
+                                               eResampleAlg ) );
+    }
+};
+
+/************************************************************************/
+/*                      CreateInMemoryOverviews()                       */
+/*                                                                      */
+/*      If the GDAL_IN_MEMORY_OVERVIEWS configuration option was set    */
+/*      when the dataset was initialized,                               */
+/*      expose power-of-two overview levels, down to 256 pixels, whose  */
+/*      content is computed on demand. Nothing is computed until        */
+/*      blocks of the overviews are read.                               */
+/************************************************************************/
+
+void GDALDefaultOverviews::CreateInMemoryOverviews()
+
+{
+    if( bCheckedForInMemoryOverviews )
+        return;
+    bCheckedForInMemoryOverviews = true;
+
+    if( !bInMemoryOverviewsEnabled || poDS == nullptr ||
+        poBaseDS != nullptr || poDS->GetAccess() != GA_ReadOnly )
+        return;
+
+    const int nBands = poDS->GetRasterCount();
+    const int nXSize = poDS->GetRasterXSize();
+    const int nYSize = poDS->GetRasterYSize();
+    if( nBands == 0 || std::max(nXSize, nYSize) <= 256 )
+        return;
+
+    // Overviews of the mask of per-dataset or alpha masks are not handled,
+    // so only expose overviews when they can carry validity information.
+    for( int iBand = 1; iBand <= nBands; ++iBand )
+    {
+        const int nMaskFlags = poDS->GetRasterBand(iBand)->GetMaskFlags();
+        if( nMaskFlags != GMF_ALL_VALID && nMaskFlags != GMF_NODATA )
+        {
+            CPLDebug( "GDAL", "In-memory overviews not supported on "
+                      "datasets with mask or alpha bands" );
+            return;
+        }
+    }
+
+    const GDALRIOResampleAlg eResampleAlg =
+        GDALRasterIOGetResampleAlg(osInMemoryOverviewsResampling.c_str());
+
+    GDALDataset* poSrcDS = poDS;
+    for( int nOvFactor = 2; ; nOvFactor *= 2 )
+    {
+        const int nOvXSize = (nXSize + nOvFactor - 1) / nOvFactor;
+        const int nOvYSize = (nYSize + nOvFactor - 1) / nOvFactor;
+        auto poOvrDS = new GDALInMemoryOverviewDataset(nOvXSize, nOvYSize);
+        for( int iBand = 1; iBand <= nBands; ++iBand )
+        {
+            poOvrDS->AddBand( poSrcDS->GetRasterBand(iBand),
+                              poDS->GetRasterBand(iBand),
+                              eResampleAlg );
+        }
+        apoInMemoryOvrDS.push_back(poOvrDS);
+        poSrcDS = poOvrDS;
+        if( std::max(nOvXSize, nOvYSize) <= 256 )
+            break;
+    }
+
+    CPLDebug( "GDAL", "Exposing %d in-memory overview levels with %s "
+              "resampling",
+              static_cast<int>(apoInMemoryOvrDS.size()),
+              GDALRasterIOGetResampleAlg(eResampleAlg) );
+}
+
+/************************************************************************/
+/*                       DropInMemoryOverviews()                        */
+/************************************************************************/
+
+void GDALDefaultOverviews::DropInMemoryOverviews()
+
+{
+    // Destroy the finer overview levels last, as coarser ones refer to them.
+    while( !apoInMemoryOvrDS.empty() )
+    {
+        delete apoInMemoryOvrDS.back();
+        apoInMemoryOvrDS.pop_back();
+    }
+}
+
 /************************************************************************/
 /*                          GetOverviewCount()                          */
 /************************************************************************/
@@ -414,6 +638,14 @@ void GDALDefaultOverviews::OverviewScan()
 int GDALDefaultOverviews::GetOverviewCount( int nBand )
 
 {
+    if( poODS == nullptr )
+    {
+        CreateInMemoryOverviews();
+        if( !apoInMemoryOvrDS.empty() && nBand >= 1 &&
+            nBand <= apoInMemoryOvrDS[0]->GetRasterCount() )
+            return static_cast<int>(apoInMemoryOvrDS.size());
+    }
+
     if( poODS == nullptr || nBand < 1 || nBand > poODS->GetRasterCount() )
         return 0;
 
@@ -435,6 +667,16 @@ GDALRasterBand *
 GDALDefaultOverviews::GetOverview( int nBand, int iOverview )
 
 {
+    if( poODS == nullptr )
+    {
+        CreateInMemoryOverviews();
+        if( iOverview >= 0 &&
+            iOverview < static_cast<int>(apoInMemoryOvrDS.size()) &&
+            nBand >= 1 &&
+            nBand <= apoInMemoryOvrDS[iOverview]->GetRasterCount() )
+            return apoInMemoryOvrDS[iOverview]->GetRasterBand(nBand);
+    }
+
     if( poODS == nullptr || nBand < 1 || nBand > poODS->GetRasterCount() )
         return nullptr;
 
@@ -523,6 +765,11 @@ int GDALComputeOvFactor( int nOvrXSize, int nRasterXSize,
 CPLErr GDALDefaultOverviews::CleanOverviews()
 
 {
+    // In-memory overviews are not persistent, and must not be exposed
+    // anymore.
+    DropInMemoryOverviews();
+    bCheckedForInMemoryOverviews = true;
+
     // Anything to do?
     if( poODS == nullptr )
         return CE_None;
@@ -637,6 +884,11 @@ GDALDefaultOverviews::BuildOverviews(
     if( nOverviews == 0 )
         return CleanOverviews();
 
+    // In-memory overviews must not be taken as existing levels, and are
+    // superseded by the ones that are going to be created.
+    DropInMemoryOverviews();
+    bCheckedForInMemoryOverviews = true;
+
     const auto GetOptionValue = [papszOptions](const char* pszOptionKey,
                                                const char* pszConfigOptionKey)
     {
@@ -36,8 +36,10 @@
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_mask.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_mask_kernels_priv.h"
 #include "gdal_priv_templates.hpp"
 
 
@@ -200,6 +202,39 @@ CPLErr GDALNoDataMaskBand::IReadBlock( int nXBlockOff, int nYBlockOff,
                      GDT_Byte, 1, nBlockXSize, &sExtraArg);
 }
 
+/************************************************************************/
+/*                            SetZeroOr255()                            */
+/************************************************************************/
+
+// Builds the validity bits of each line with the SIMD mask kernels, and
+// expands them to 0/255 bytes. Source lines must be contiguous.
+template<class T>
+static void SetZeroOr255( const T* pSrc, GPtrDiff_t nSrcLineStride, T noData,
+                          GByte* pabyDest, int nBufXSize, int nBufYSize,
+                          GSpacing nPixelSpace, GSpacing nLineSpace,
+                          GUInt32* panLineMask )
+{
+    for( int iY = 0; iY < nBufYSize; iY++ )
+    {
+        GByte* pabyLineDest = pabyDest + iY * nLineSpace;
+        CPLMaskSetAll(panLineMask, nBufXSize);
+        GDALMaskClearNoData(panLineMask, pSrc + iY * nSrcLineStride,
+                            static_cast<size_t>(nBufXSize), noData);
+        if( nPixelSpace == 1 )
+        {
+            CPLMaskExpandToBytes(panLineMask, pabyLineDest, nBufXSize);
+        }
+        else
+        {
+            for( int iX = 0; iX < nBufXSize; iX++ )
+            {
+                *pabyLineDest = CPLMaskGet(panLineMask, iX) ? 255 : 0;
+                pabyLineDest += nPixelSpace;
+            }
+        }
+    }
+}
+
 /************************************************************************/
 /*                             IRasterIO()                              */
 /************************************************************************/
@@ -218,7 +253,16 @@ CPLErr GDALNoDataMaskBand::IRasterIO( GDALRWFlag eRWFlag,
         return CE_Failure;
     }
     const auto eParentDT = poParent->GetRasterDataType();
-    const GDALDataType eWrkDT = GetWorkDataType( eParentDT );
+    GDALDataType eWrkDT = GetWorkDataType( eParentDT );
+    // 16-bit data can be checked in its own type by the SIMD mask kernels,
+    // provided the nodata value is representable.
+    if( (eParentDT == GDT_Int16 &&
+         GDALIsValueInRange<GInt16>(dfNoDataValue)) ||
+        (eParentDT == GDT_UInt16 &&
+         GDALIsValueInRange<GUInt16>(dfNoDataValue)) )
+    {
+        eWrkDT = eParentDT;
+    }
 
     // Optimization in common use case (#4488).
     // This avoids triggering the block cache on this band, which helps
@@ -236,13 +280,15 @@ CPLErr GDALNoDataMaskBand::IRasterIO( GDALRWFlag eRWFlag,
         GByte* pabyData = static_cast<GByte*>( pData );
         const GByte byNoData = static_cast<GByte>( dfNoDataValue );
 
-        if( nPixelSpace == 1 && nLineSpace == nBufXSize )
+        if( nPixelSpace == 1 )
         {
-            const size_t nBufSize = static_cast<size_t>(nBufXSize) * nBufYSize;
-            for( size_t i = 0; i < nBufSize; ++i )
-            {
-                pabyData[i] = pabyData[i] == byNoData ? 0 : 255;
-            }
+            GUInt32* panLineMask = CPLMaskCreate(nBufXSize, true);
+            if( panLineMask == nullptr )
+                return CE_Failure;
+            SetZeroOr255(pabyData, static_cast<GPtrDiff_t>(nLineSpace),
+                         byNoData, pabyData, nBufXSize, nBufYSize,
+                         nPixelSpace, nLineSpace, panLineMask);
+            VSIFree(panLineMask);
         }
         else
         {
@@ -285,150 +331,81 @@ CPLErr GDALNoDataMaskBand::IRasterIO( GDALRWFlag eRWFlag,
             return eErr;
         }
 
-        const bool bIsNoDataNan = CPLIsNan(dfNoDataValue) != 0;
         GByte* pabyDest = static_cast<GByte*>(pData);
+        GUInt32* panLineMask = CPLMaskCreate(nBufXSize, true);
+        if( panLineMask == nullptr )
+        {
+            VSIFree(pTemp);
+            return CE_Failure;
+        }
 
 /* -------------------------------------------------------------------- */
 /*      Process different cases.                                        */
 /* -------------------------------------------------------------------- */
         switch( eWrkDT )
         {
-            case GDT_UInt32:
-            {
-                const GUInt32 nNoData = static_cast<GUInt32>( dfNoDataValue );
-                const GUInt32* panSrc = static_cast<const GUInt32 *>(pTemp);
+            case GDT_Int16:
+                SetZeroOr255(static_cast<const GInt16*>(pTemp), nBufXSize,
+                             static_cast<GInt16>(dfNoDataValue),
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
-                size_t i = 0;
-                for( int iY = 0; iY < nBufYSize; iY++ )
-                {
-                    GByte* pabyLineDest = pabyDest + iY * nLineSpace;
-                    for( int iX = 0; iX < nBufXSize; iX++ )
-                    {
-                        *pabyLineDest = panSrc[i] == nNoData ? 0 : 255;
-                        ++i;
-                        pabyLineDest += nPixelSpace;
-                    }
-                }
-            }
-            break;
+            case GDT_UInt16:
+                SetZeroOr255(static_cast<const GUInt16*>(pTemp), nBufXSize,
+                             static_cast<GUInt16>(dfNoDataValue),
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
-            case GDT_Int32:
-            {
-                const GInt32 nNoData = static_cast<GInt32>( dfNoDataValue );
-                const GInt32* panSrc = static_cast<const GInt32 *>(pTemp);
+            case GDT_UInt32:
+                SetZeroOr255(static_cast<const GUInt32*>(pTemp), nBufXSize,
+                             static_cast<GUInt32>(dfNoDataValue),
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
-                size_t i = 0;
-                for( int iY = 0; iY < nBufYSize; iY++ )
-                {
-                    GByte* pabyLineDest = pabyDest + iY * nLineSpace;
-                    for( int iX = 0; iX < nBufXSize; iX++ )
-                    {
-                        *pabyLineDest = panSrc[i] == nNoData ? 0 : 255;
-                        ++i;
-                        pabyLineDest += nPixelSpace;
-                    }
-                }
-            }
-            break;
+            case GDT_Int32:
+                SetZeroOr255(static_cast<const GInt32*>(pTemp), nBufXSize,
+                             static_cast<GInt32>(dfNoDataValue),
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
             case GDT_Float32:
-            {
-                const float fNoData = static_cast<float>( dfNoDataValue );
-                const float* pafSrc = static_cast<const float *>(pTemp);
-
-                size_t i = 0;
-                for( int iY = 0; iY < nBufYSize; iY++ )
-                {
-                    GByte* pabyLineDest = pabyDest + iY * nLineSpace;
-                    for( int iX = 0; iX < nBufXSize; iX++ )
-                    {
-                        const float fVal = pafSrc[i];
-                        if( bIsNoDataNan && CPLIsNan(fVal))
-                            *pabyLineDest = 0;
-                        else if( ARE_REAL_EQUAL(fVal, fNoData) )
-                            *pabyLineDest = 0;
-                        else
-                            *pabyLineDest = 255;
-                        ++i;
-                        pabyLineDest += nPixelSpace;
-                    }
-                }
-            }
-            break;
+                SetZeroOr255(static_cast<const float*>(pTemp), nBufXSize,
+                             static_cast<float>(dfNoDataValue),
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
             case GDT_Float64:
-            {
-                const double* padfSrc = static_cast<const double *>(pTemp);
-
-                size_t i = 0;
-                for( int iY = 0; iY < nBufYSize; iY++ )
-                {
-                    GByte* pabyLineDest = pabyDest + iY * nLineSpace;
-                    for( int iX = 0; iX < nBufXSize; iX++ )
-                    {
-                        const double dfVal = padfSrc[i];
-                        if( bIsNoDataNan && CPLIsNan(dfVal))
-                            *pabyLineDest = 0;
-                        else if( ARE_REAL_EQUAL(dfVal, dfNoDataValue) )
-                            *pabyLineDest = 0;
-                        else
-                            *pabyLineDest = 255;
-                        ++i;
-                        pabyLineDest += nPixelSpace;
-                    }
-                }
-            }
-            break;
+                SetZeroOr255(static_cast<const double*>(pTemp), nBufXSize,
+                             dfNoDataValue,
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
             case GDT_Int64:
-            {
-                const auto* panSrc = static_cast<const int64_t *>(pTemp);
-
-                size_t i = 0;
-                for( int iY = 0; iY < nBufYSize; iY++ )
-                {
-                    GByte* pabyLineDest = pabyDest + iY * nLineSpace;
-                    for( int iX = 0; iX < nBufXSize; iX++ )
-                    {
-                        const auto nVal = panSrc[i];
-                        if( nVal == nNoDataValueInt64 )
-                            *pabyLineDest = 0;
-                        else
-                            *pabyLineDest = 255;
-                        ++i;
-                        pabyLineDest += nPixelSpace;
-                    }
-                }
-            }
-            break;
+                SetZeroOr255(static_cast<const int64_t*>(pTemp), nBufXSize,
+                             nNoDataValueInt64,
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
             case GDT_UInt64:
-            {
-                const auto* panSrc = static_cast<const uint64_t *>(pTemp);
-
-                size_t i = 0;
-                for( int iY = 0; iY < nBufYSize; iY++ )
-                {
-                    GByte* pabyLineDest = pabyDest + iY * nLineSpace;
-                    for( int iX = 0; iX < nBufXSize; iX++ )
-                    {
-                        const auto nVal = panSrc[i];
-                        if( nVal == nNoDataValueUInt64 )
-                            *pabyLineDest = 0;
-                        else
-                            *pabyLineDest = 255;
-                        ++i;
-                        pabyLineDest += nPixelSpace;
-                    }
-                }
-            }
-            break;
+                SetZeroOr255(static_cast<const uint64_t*>(pTemp), nBufXSize,
+                             nNoDataValueUInt64,
+                             pabyDest, nBufXSize, nBufYSize,
+                             nPixelSpace, nLineSpace, panLineMask);
+                break;
 
             default:
                 CPLAssert( false );
                 break;
         }
 
+        VSIFree(panLineMask);
         VSIFree(pTemp);
         return CE_None;
     }
@@ -36,9 +36,11 @@
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_mask.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_mask_kernels_priv.h"
 
 
 //! @cond Doxygen_Suppress
@@ -86,33 +88,42 @@ GDALNoDataValuesMaskBand::~GDALNoDataValuesMaskBand()
 /*                            FillOutBuffer()                           */
 /************************************************************************/
 
-template<class T> static void FillOutBuffer(GPtrDiff_t nBlockOffsetPixels,
+template<class T> static bool FillOutBuffer(GPtrDiff_t nBlockOffsetPixels,
                                             int nBands,
                                             const void* pabySrc,
                                             const double* padfNodataValues,
                                             void* pImage)
 {
-    T* paNoData = static_cast<T*>(
-        CPLMalloc(nBands * sizeof(T)) );
-    for( int iBand = 0; iBand < nBands; ++iBand )
+    // A pixel is valid as soon as one of its bands is not at its nodata
+    // value, so OR the per-band validity bits together and only expand to
+    // bytes at the end.
+    const size_t nPixels = static_cast<size_t>(nBlockOffsetPixels);
+    GUInt32* panValid = CPLMaskCreate(nPixels, false);
+    GUInt32* panBandValid = CPLMaskCreate(nPixels, true);
+    if( panValid == nullptr || panBandValid == nullptr )
     {
-        paNoData[iBand] = static_cast<T>(padfNodataValues[iBand]);
+        CPLFree(panValid);
+        CPLFree(panBandValid);
+        return false;
     }
 
-    for( GPtrDiff_t i = 0; i < nBlockOffsetPixels; i++ )
+    for( int iBand = 0; iBand < nBands; ++iBand )
     {
-        int nCountNoData = 0;
-        for( int iBand = 0; iBand < nBands; ++iBand )
-        {
-            if( static_cast<const T *>(pabySrc)[i + iBand * nBlockOffsetPixels] ==
-                paNoData[iBand] )
-                ++nCountNoData;
-        }
-        static_cast<GByte *>(pImage)[i] =
-            nCountNoData == nBands ? 0 : 255;
+        if( iBand > 0 )
+            CPLMaskSetAll(panBandValid, nPixels);
+        GDALMaskClearNoData(panBandValid,
+                            static_cast<const T *>(pabySrc) +
+                                iBand * nBlockOffsetPixels,
+                            nPixels,
+                            static_cast<T>(padfNodataValues[iBand]));
+        CPLMaskMerge(panValid, panBandValid, nPixels);
     }
 
-    CPLFree(paNoData);
+    CPLMaskExpandToBytes(panValid, static_cast<GByte *>(pImage), nPixels);
+
+    CPLFree(panValid);
+    CPLFree(panBandValid);
+    return true;
 }
 
 /************************************************************************/
@@ -216,45 +227,46 @@ CPLErr GDALNoDataValuesMaskBand::IReadBlock( int nXBlockOff, int nYBlockOff,
 /* -------------------------------------------------------------------- */
 /*      Process different cases.                                        */
 /* -------------------------------------------------------------------- */
+    bool bOK = false;
     switch( eWrkDT )
     {
       case GDT_Byte:
       {
-          FillOutBuffer<GByte> (nBlockOffsetPixels, nBands,
-                                pabySrc, padfNodataValues,
-                                pImage);
+          bOK = FillOutBuffer<GByte>(nBlockOffsetPixels, nBands,
+                                     pabySrc, padfNodataValues,
+                                     pImage);
       }
       break;
 
       case GDT_UInt32:
       {
-          FillOutBuffer<GUInt32>(nBlockOffsetPixels, nBands,
-                                 pabySrc, padfNodataValues,
-                                 pImage);
+          bOK = FillOutBuffer<GUInt32>(nBlockOffsetPixels, nBands,
+                                       pabySrc, padfNodataValues,
+                                       pImage);
       }
       break;
 
       case GDT_Int32:
       {
-          FillOutBuffer<GInt32>(nBlockOffsetPixels, nBands,
-                                pabySrc, padfNodataValues,
-                                pImage);
+          bOK = FillOutBuffer<GInt32>(nBlockOffsetPixels, nBands,
+                                      pabySrc, padfNodataValues,
+                                      pImage);
       }
       break;
 
       case GDT_Float32:
       {
-          FillOutBuffer<float> (nBlockOffsetPixels, nBands,
-                                pabySrc, padfNodataValues,
-                                pImage);
+          bOK = FillOutBuffer<float>(nBlockOffsetPixels, nBands,
+                                     pabySrc, padfNodataValues,
+                                     pImage);
       }
       break;
 
       case GDT_Float64:
       {
-          FillOutBuffer<double>(nBlockOffsetPixels, nBands,
-                                pabySrc, padfNodataValues,
-                                pImage);
+          bOK = FillOutBuffer<double>(nBlockOffsetPixels, nBands,
+                                      pabySrc, padfNodataValues,
+                                      pImage);
       }
       break;
 
@@ -265,6 +277,6 @@ CPLErr GDALNoDataValuesMaskBand::IReadBlock( int nXBlockOff, int nYBlockOff,
 
     CPLFree( pabySrc );
 
-    return CE_None;
+    return bOK ? CE_None : CE_Failure;
 }
 //! @endcond
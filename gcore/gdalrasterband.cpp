@@ -39,10 +39,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <type_traits>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -53,6 +58,7 @@
 #include "gdal.h"
 #include "gdal_rat.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 
 
 /************************************************************************/
@@ -75,6 +81,8 @@ GDALRasterBand::GDALRasterBand(int bForceCachedIOIn):
 {
 }
 
+static void GDALWriteStatisticsFree(GDALWriteStatsState* psState);
+
 /************************************************************************/
 /*                          ~GDALRasterBand()                           */
 /************************************************************************/
@@ -90,9 +98,16 @@ GDALRasterBand::~GDALRasterBand()
         if( poBandBlockCache )
             poBandBlockCache->DisableDirtyBlockWriting();
     }
+    // Too late to set the statistics of blocks written by the flush below:
+    // virtual methods of the derived class can no longer be called. The
+    // state is only freed once the flush has waited for the blocks being
+    // written by other threads.
+    DisableWriteStatistics();
     GDALRasterBand::FlushCache(true);
 
     delete poBandBlockCache;
+    GDALWriteStatisticsFree(m_poWriteStats);
+    GDALRasterBlockCacheDropBand(this);
 
     if( static_cast<GIntBig>(nBlockReads) > static_cast<GIntBig>(nBlocksPerRow) * nBlocksPerColumn
         && nBand == 1 && poDS != nullptr )
@@ -1004,6 +1019,9 @@ int GDALRasterBand::InitBlockInfo()
     nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
     nBlocksPerColumn = DIV_ROUND_UP(nRasterYSize, nBlockYSize);
 
+    m_nBlockPrefetch = atoi(CPLGetConfigOption("GDAL_BLOCK_PREFETCH", "0"));
+    InitWriteStatistics();
+
     const char* pszBlockStrategy = CPLGetConfigOption("GDAL_BAND_BLOCK_CACHE", nullptr);
     bool bUseArray = true;
     if( pszBlockStrategy == nullptr )
@@ -1074,7 +1092,22 @@ CPLErr GDALRasterBand::FlushCache(bool bAtClosing)
     if (poBandBlockCache == nullptr || !poBandBlockCache->IsInitOK())
         return eGlobalErr;
 
-    return poBandBlockCache->FlushCache();
+    const CPLErr eErr = poBandBlockCache->FlushCache();
+
+    // Done after FlushCache(), which waits for blocks being evicted by other
+    // threads, so that none of them can be stored afterwards.
+    GDALCompressedBlockCacheDropBand(this);
+    GDALBlockPrefetcherDropBand(this);
+
+    if( bAtClosing )
+    {
+        if( poDS && poDS->bSuppressOnClose )
+            DisableWriteStatistics();
+        else
+            FlushWriteStatistics();
+    }
+
+    return eErr;
 }
 
 /************************************************************************/
@@ -1095,6 +1128,58 @@ CPLErr CPL_STDCALL GDALFlushRasterCache( GDALRasterBandH hBand )
     return GDALRasterBand::FromHandle(hBand)->FlushCache(false);
 }
 
+/************************************************************************/
+/*                      GetBlockCacheStatistics()                       */
+/************************************************************************/
+
+/**
+ * \brief Get block cache statistics of this band.
+ *
+ * The hit, miss, eviction and dirty block flush counters are accumulated
+ * since the block cache of the band was initialized, that is generally the
+ * first block access. See GDALGetBlockCacheStatistics() for their meaning.
+ *
+ * This method is the same as the C function
+ * GDALGetRasterBandBlockCacheStatistics().
+ *
+ * @param psStats Pointer to the structure to fill. Must not be NULL.
+ *
+ * @since GDAL 3.7
+ */
+
+void GDALRasterBand::GetBlockCacheStatistics(
+                                    GDALBlockCacheStatistics* psStats ) const
+{
+    if( poBandBlockCache == nullptr )
+    {
+        memset(psStats, 0, sizeof(*psStats));
+        return;
+    }
+    poBandBlockCache->GetStatistics(psStats);
+}
+
+/************************************************************************/
+/*               GDALGetRasterBandBlockCacheStatistics()                */
+/************************************************************************/
+
+/**
+ * \brief Get block cache statistics of a band.
+ *
+ * @see GDALRasterBand::GetBlockCacheStatistics()
+ *
+ * @since GDAL 3.7
+ */
+
+void GDALGetRasterBandBlockCacheStatistics( GDALRasterBandH hBand,
+                                            GDALBlockCacheStatistics* psStats )
+
+{
+    VALIDATE_POINTER0( hBand, "GDALGetRasterBandBlockCacheStatistics" );
+    VALIDATE_POINTER0( psStats, "GDALGetRasterBandBlockCacheStatistics" );
+
+    GDALRasterBand::FromHandle(hBand)->GetBlockCacheStatistics(psStats);
+}
+
 /************************************************************************/
 /*                        UnreferenceBlock()                            */
 /*                                                                      */
@@ -1290,6 +1375,8 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
 /*      Try and fetch from cache.                                       */
 /* -------------------------------------------------------------------- */
     GDALRasterBlock *poBlock = TryGetLockedBlockRef( nXBlockOff, nYBlockOff );
+    if( poBlock != nullptr )
+        poBandBlockCache->AddHit();
 
 /* -------------------------------------------------------------------- */
 /*      If we didn't find it in our memory cache, instantiate a         */
@@ -1324,6 +1411,7 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             return( nullptr );
         }
 
+        poBandBlockCache->AddMiss();
         poBlock = poBandBlockCache->CreateBlock( nXBlockOff, nYBlockOff );
         if( poBlock == nullptr )
             return nullptr;
@@ -1358,7 +1446,14 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             return nullptr;
         }
 
-        if( !bJustInitialize )
+        bool bHasData = bJustInitialize ||
+                        GDALBlockPrefetcherRecall(poBlock, m_nBlockPrefetch);
+        if( !bHasData && GDALCompressedBlockCacheRecall(poBlock) )
+        {
+            poBandBlockCache->AddSecondTierRecall();
+            bHasData = true;
+        }
+        if( !bHasData )
         {
             const GUInt32 nErrorCounter = CPLGetErrorCounter();
             int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
@@ -4055,6 +4150,18 @@ CPLErr CPL_STDCALL GDALGetDefaultHistogramEx(
  * Many drivers just ignore the AdviseRead() call, but it can dramatically
  * accelerate access via some drivers.
  *
+ * Starting with GDAL 3.7, for drivers that do not implement AdviseRead(),
+ * and if the GDAL_NUM_THREADS configuration option is set to ALL_CPUS or a
+ * value greater than one, the blocks intersecting the region, at the
+ * overview level that RasterIO() would use for the buffer size, are read in
+ * the background by the global thread pool (using other handles of the
+ * dataset), as long as they could fit in half of the block cache. They are
+ * kept in buffers attached to the band until a block cache miss on the band
+ * requests them: they are then copied into the block cache. The buffers of
+ * all bands are limited to half of GDAL_CACHEMAX, the oldest advised blocks
+ * of a band being discarded to make room for new ones. They are also
+ * discarded by FlushCache().
+ *
  * Depending on call paths, drivers might receive several calls to
  * AdviseRead() with the same parameters.
  *
@@ -4089,15 +4196,44 @@ CPLErr CPL_STDCALL GDALGetDefaultHistogramEx(
 /**/
 
 CPLErr GDALRasterBand::AdviseRead(
-    int /*nXOff*/,
-    int /*nYOff*/,
-    int /*nXSize*/,
-    int /*nYSize*/,
-    int /*nBufXSize*/,
-    int /*nBufYSize*/,
+    int nXOff,
+    int nYOff,
+    int nXSize,
+    int nYSize,
+    int nBufXSize,
+    int nBufYSize,
     GDALDataType /*eBufType*/,
     char ** /*papszOptions*/ )
 {
+    // Warm the block cache in the background when multithreading is allowed.
+    if( GDALGetNumThreads() <= 1 )
+    {
+        return CE_None;
+    }
+
+    if( nXOff < 0 || nYOff < 0 || nXSize < 1 || nYSize < 1 ||
+        nBufXSize < 1 || nBufYSize < 1 ||
+        nXOff > nRasterXSize - nXSize || nYOff > nRasterYSize - nYSize )
+    {
+        return CE_None;
+    }
+
+    GDALRasterBand* poBand = this;
+    int iOverview = -1;
+    if( (nBufXSize < nXSize || nBufYSize < nYSize) && GetOverviewCount() > 0 )
+    {
+        iOverview = GDALBandGetBestOverviewLevel2(
+            this, nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize, nullptr);
+        if( iOverview >= 0 )
+        {
+            poBand = GetOverview(iOverview);
+            if( poBand == nullptr )
+                return CE_None;
+        }
+    }
+
+    GDALBlockPrefetcherAdvise(this, iOverview, poBand,
+                              nXOff, nYOff, nXSize, nYSize);
     return CE_None;
 }
 
@@ -5353,159 +5489,1515 @@ inline double GetPixelValue( GDALDataType eDataType,
 }
 
 /************************************************************************/
-/*                         SetValidPercent()                            */
+/*                           GDALBlockStats                             */
 /************************************************************************/
 
-//! @cond Doxygen_Suppress
-/**
- * \brief Set percentage of valid (not nodata) pixels.
- *
- * Stores the percentage of valid pixels in the metadata item
- * STATISTICS_VALID_PERCENT
- *
- * @param nSampleCount Number of sampled pixels.
- *
- * @param nValidCount Number of valid pixels.
- */
+#if defined(__x86_64) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
-void GDALRasterBand::SetValidPercent(GUIntBig nSampleCount, GUIntBig nValidCount)
+namespace
 {
-    if( nValidCount == 0 )
-    {
-        SetMetadataItem( "STATISTICS_VALID_PERCENT", "0" );
-    }
-    else if( nValidCount == nSampleCount )
-    {
-        SetMetadataItem( "STATISTICS_VALID_PERCENT", "100" );
-    }
-    else /* nValidCount < nSampleCount */
+
+// Statistics of the pixels of a block, or of several merged blocks.
+struct GDALBlockStats
+{
+    GUIntBig nSampleCount = 0;
+    GUIntBig nValidCount = 0;
+    double   dfMin = std::numeric_limits<double>::max();
+    double   dfMax = -std::numeric_limits<double>::max();
+    double   dfMean = 0.0;
+    // Sum of square of differences to the mean.
+    double   dfM2 = 0.0;
+
+    GDALBlockStats() = default;
+
+    // Welford algorithm.
+    void Add( double dfValue )
     {
-        char szValue[128] = { 0 };
+        dfMin = std::min(dfMin, dfValue);
+        dfMax = std::max(dfMax, dfValue);
 
-        /* percentage is only an indicator: limit precision */
-        CPLsnprintf( szValue, sizeof(szValue), "%.4g",
-                 100. * static_cast<double>(nValidCount) / nSampleCount );
+        nValidCount++;
+        const double dfDelta = dfValue - dfMean;
+        dfMean += dfDelta / nValidCount;
+        dfM2 += dfDelta * (dfValue - dfMean);
+    }
 
-        if (EQUAL(szValue, "100"))
-        {
-            /* don't set 100 percent valid
-             * because some of the sampled pixels were nodata */
-            SetMetadataItem( "STATISTICS_VALID_PERCENT", "99.999" );
-        }
-        else
+    // Parallel algorithm of Chan et al.
+    void Merge( const GDALBlockStats& other )
+    {
+        nSampleCount += other.nSampleCount;
+        dfMin = std::min(dfMin, other.dfMin);
+        dfMax = std::max(dfMax, other.dfMax);
+        if( other.nValidCount == 0 )
+            return;
+        if( nValidCount == 0 )
         {
-            SetMetadataItem( "STATISTICS_VALID_PERCENT", szValue );
+            nValidCount = other.nValidCount;
+            dfMean = other.dfMean;
+            dfM2 = other.dfM2;
+            return;
         }
+        const double dfCount = static_cast<double>(nValidCount);
+        const double dfOtherCount = static_cast<double>(other.nValidCount);
+        const double dfTotalCount = dfCount + dfOtherCount;
+        const double dfDelta = other.dfMean - dfMean;
+        dfMean += dfDelta * (dfOtherCount / dfTotalCount);
+        dfM2 += other.dfM2 +
+                dfDelta * dfDelta * (dfCount / dfTotalCount) * dfOtherCount;
+        nValidCount += other.nValidCount;
     }
+};
+
+// Type in which values are compared to the nodata value, consistently with
+// GetPixelValue().
+template<class T> struct StatsComputeType { typedef double type; };
+template<> struct StatsComputeType<float> { typedef float type; };
+
+template<class T>
+inline bool IsValidStatsValue( T tValue, bool bHasNoData,
+                               typename StatsComputeType<T>::type noData )
+{
+    typedef typename StatsComputeType<T>::type CT;
+    const CT value = static_cast<CT>(tValue);
+    return !CPLIsNan(value) &&
+           !(bHasNoData && ARE_REAL_EQUAL(value, noData));
 }
-//! @endcond
 
 /************************************************************************/
-/*                         ComputeStatistics()                          */
+/*                       ComputeBlockStatsSSE2()                        */
 /************************************************************************/
 
-/**
- * \brief Compute image statistics.
- *
- * Returns the minimum, maximum, mean and standard deviation of all
- * pixel values in this band.  If approximate statistics are sufficient,
- * the bApproxOK flag can be set to true in which case overviews, or a
- * subset of image tiles may be used in computing the statistics.
- *
- * Once computed, the statistics will generally be "set" back on the
- * raster band using SetStatistics().
- *
- * Cached statistics can be cleared with GDALDataset::ClearStatistics().
- *
- * This method is the same as the C function GDALComputeRasterStatistics().
- *
- * @param bApproxOK If TRUE statistics may be computed based on overviews
- * or a subset of all tiles.
- *
- * @param pdfMin Location into which to load image minimum (may be NULL).
- *
- * @param pdfMax Location into which to load image maximum (may be NULL).-
- *
- * @param pdfMean Location into which to load image mean (may be NULL).
- *
- * @param pdfStdDev Location into which to load image standard deviation
- * (may be NULL).
- *
- * @param pfnProgress a function to call to report progress, or NULL.
- *
- * @param pProgressData application data to pass to the progress function.
- *
- * @return CE_None on success, or CE_Failure if an error occurs or processing
- * is terminated by the user.
- */
+#if defined(__x86_64) || defined(_M_X64)
 
-CPLErr
-GDALRasterBand::ComputeStatistics( int bApproxOK,
-                                   double *pdfMin, double *pdfMax,
-                                   double *pdfMean, double *pdfStdDev,
-                                   GDALProgressFunc pfnProgress,
-                                   void *pProgressData )
+// Loads 4 values as 2 vectors of 2 doubles, and sets the corresponding
+// masks to all bits set for valid values.
 
+inline __m128d NoDataMaskSSE2( __m128d v, __m128d noData )
 {
-    if( pfnProgress == nullptr )
-        pfnProgress = GDALDummyProgress;
+    // Same as ARE_REAL_EQUAL()
+    const __m128d absMask =
+        _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    const __m128d diff = _mm_and_pd(_mm_sub_pd(v, noData), absMask);
+    const __m128d sum = _mm_and_pd(_mm_add_pd(v, noData), absMask);
+    const __m128d tolerance = _mm_mul_pd(
+        _mm_mul_pd(_mm_set1_pd(std::numeric_limits<float>::epsilon()), sum),
+        _mm_set1_pd(2.0));
+    return _mm_or_pd(_mm_cmpeq_pd(v, noData), _mm_cmplt_pd(diff, tolerance));
+}
 
-/* -------------------------------------------------------------------- */
-/*      If we have overview bands, use them for statistics.             */
-/* -------------------------------------------------------------------- */
-    if( bApproxOK && GetOverviewCount() > 0 && !HasArbitraryOverviews() )
-    {
-        GDALRasterBand *poBand
-            = GetRasterSampleOverview( GDALSTAT_APPROX_NUMSAMPLES );
+inline __m128 NoDataMaskSSE2( __m128 v, __m128 noData )
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 diff = _mm_and_ps(_mm_sub_ps(v, noData), absMask);
+    const __m128 sum = _mm_and_ps(_mm_add_ps(v, noData), absMask);
+    const __m128 tolerance = _mm_mul_ps(
+        _mm_mul_ps(_mm_set1_ps(std::numeric_limits<float>::epsilon()), sum),
+        _mm_set1_ps(2.0f));
+    return _mm_or_ps(_mm_cmpeq_ps(v, noData), _mm_cmplt_ps(diff, tolerance));
+}
 
-        if( poBand != this )
+template<bool HAS_NAN, bool HAS_NODATA>
+inline __m128d ValidMaskSSE2( __m128d v, __m128d noData )
+{
+    __m128d valid = HAS_NAN ? _mm_cmpord_pd(v, v) :
+                              _mm_castsi128_pd(_mm_set1_epi32(-1));
+    if( HAS_NODATA )
+        valid = _mm_andnot_pd(NoDataMaskSSE2(v, noData), valid);
+    return valid;
+}
+
+template<bool HAS_NODATA>
+inline void LoadForStatsSSE2( const GInt32* p, __m128d noData,
+                              __m128d& lo, __m128d& hi,
+                              __m128d& validLo, __m128d& validHi )
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    lo = _mm_cvtepi32_pd(v);
+    hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(3,2,3,2)));
+    validLo = ValidMaskSSE2<false, HAS_NODATA>(lo, noData);
+    validHi = ValidMaskSSE2<false, HAS_NODATA>(hi, noData);
+}
+
+template<bool HAS_NODATA>
+inline void LoadForStatsSSE2( const GInt16* p, __m128d noData,
+                              __m128d& lo, __m128d& hi,
+                              __m128d& validLo, __m128d& validHi )
+{
+    const __m128i v16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    // Sign extension to 32 bit
+    const __m128i v = _mm_srai_epi32(_mm_unpacklo_epi16(v16, v16), 16);
+    lo = _mm_cvtepi32_pd(v);
+    hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(3,2,3,2)));
+    validLo = ValidMaskSSE2<false, HAS_NODATA>(lo, noData);
+    validHi = ValidMaskSSE2<false, HAS_NODATA>(hi, noData);
+}
+
+template<bool HAS_NODATA>
+inline void LoadForStatsSSE2( const double* p, __m128d noData,
+                              __m128d& lo, __m128d& hi,
+                              __m128d& validLo, __m128d& validHi )
+{
+    lo = _mm_loadu_pd(p);
+    hi = _mm_loadu_pd(p + 2);
+    validLo = ValidMaskSSE2<true, HAS_NODATA>(lo, noData);
+    validHi = ValidMaskSSE2<true, HAS_NODATA>(hi, noData);
+}
+
+template<bool HAS_NODATA>
+inline void LoadForStatsSSE2( const float* p, __m128 noData,
+                              __m128d& lo, __m128d& hi,
+                              __m128d& validLo, __m128d& validHi )
+{
+    // The nodata value is compared in single precision.
+    const __m128 v = _mm_loadu_ps(p);
+    __m128 valid = _mm_cmpord_ps(v, v);
+    if( HAS_NODATA )
+        valid = _mm_andnot_ps(NoDataMaskSSE2(v, noData), valid);
+    lo = _mm_cvtps_pd(v);
+    hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+    validLo = _mm_castps_pd(_mm_unpacklo_ps(valid, valid));
+    validHi = _mm_castps_pd(_mm_unpackhi_ps(valid, valid));
+}
+
+inline __m128d SetNoDataSSE2( double dfNoData )
+{
+    return _mm_set1_pd(dfNoData);
+}
+
+inline __m128 SetNoDataSSE2( float fNoData )
+{
+    return _mm_set1_ps(fNoData);
+}
+
+inline double HorizontalMin( __m128d v )
+{
+    double ad[2];
+    _mm_storeu_pd(ad, v);
+    return std::min(ad[0], ad[1]);
+}
+
+inline double HorizontalMax( __m128d v )
+{
+    double ad[2];
+    _mm_storeu_pd(ad, v);
+    return std::max(ad[0], ad[1]);
+}
+
+inline double HorizontalSum( __m128d v )
+{
+    double ad[2];
+    _mm_storeu_pd(ad, v);
+    return ad[0] + ad[1];
+}
+
+// Two pass algorithm: mean first, then sum of square of differences to it.
+// Masked out values are replaced by the neutral element of each reduction.
+template<class T, bool HAS_NODATA, bool COMPUTE_OTHER_STATS>
+void ComputeBlockStatsSSE2( const T* pData, int nXCheck, int nYCheck,
+                            int nBlockXSize,
+                            typename StatsComputeType<T>::type noData,
+                            GDALBlockStats& sStats )
+{
+    constexpr bool HAS_MASK = HAS_NODATA ||
+                              !std::numeric_limits<T>::is_integer;
+    const auto vNoData = SetNoDataSSE2(noData);
+    const __m128d vNeutralMin = _mm_set1_pd(std::numeric_limits<double>::max());
+    const __m128d vNeutralMax = _mm_set1_pd(-std::numeric_limits<double>::max());
+    __m128d vMin = vNeutralMin;
+    __m128d vMax = vNeutralMax;
+    __m128d vSumLo = _mm_setzero_pd();
+    __m128d vSumHi = _mm_setzero_pd();
+    __m128i vCount = _mm_setzero_si128();
+    double dfMin = std::numeric_limits<double>::max();
+    double dfMax = -std::numeric_limits<double>::max();
+    double dfSum = 0;
+    GUIntBig nValidCount = 0;
+    const int nXCheckVector = nXCheck & ~3;
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheckVector; iX += 4 )
         {
-            CPLErr eErr = poBand->ComputeStatistics( FALSE,
-                                              pdfMin, pdfMax,
-                                              pdfMean, pdfStdDev,
-                                              pfnProgress, pProgressData );
-            if( eErr == CE_None )
+            __m128d lo, hi, validLo, validHi;
+            LoadForStatsSSE2<HAS_NODATA>(pLine + iX, vNoData,
+                                         lo, hi, validLo, validHi);
+            if( HAS_MASK )
             {
-                if( pdfMin && pdfMax && pdfMean && pdfStdDev )
+                vMin = _mm_min_pd(vMin, _mm_or_pd(
+                    _mm_and_pd(validLo, lo),
+                    _mm_andnot_pd(validLo, vNeutralMin)));
+                vMin = _mm_min_pd(vMin, _mm_or_pd(
+                    _mm_and_pd(validHi, hi),
+                    _mm_andnot_pd(validHi, vNeutralMin)));
+                vMax = _mm_max_pd(vMax, _mm_or_pd(
+                    _mm_and_pd(validLo, lo),
+                    _mm_andnot_pd(validLo, vNeutralMax)));
+                vMax = _mm_max_pd(vMax, _mm_or_pd(
+                    _mm_and_pd(validHi, hi),
+                    _mm_andnot_pd(validHi, vNeutralMax)));
+                if( COMPUTE_OTHER_STATS )
                 {
-                    SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
-                    SetStatistics( *pdfMin,*pdfMax, *pdfMean, *pdfStdDev );
+                    vSumLo = _mm_add_pd(vSumLo, _mm_and_pd(validLo, lo));
+                    vSumHi = _mm_add_pd(vSumHi, _mm_and_pd(validHi, hi));
+                    // All bits set is -1
+                    vCount = _mm_sub_epi64(vCount, _mm_castpd_si128(validLo));
+                    vCount = _mm_sub_epi64(vCount, _mm_castpd_si128(validHi));
                 }
-
-                /* transfer metadata from overview band to this */
-                const char *pszPercentValid = poBand->GetMetadataItem("STATISTICS_VALID_PERCENT");
-
-                if ( pszPercentValid != nullptr )
+            }
+            else
+            {
+                vMin = _mm_min_pd(vMin, _mm_min_pd(lo, hi));
+                vMax = _mm_max_pd(vMax, _mm_max_pd(lo, hi));
+                if( COMPUTE_OTHER_STATS )
                 {
-                    SetMetadataItem( "STATISTICS_VALID_PERCENT", pszPercentValid );
+                    vSumLo = _mm_add_pd(vSumLo, lo);
+                    vSumHi = _mm_add_pd(vSumHi, hi);
                 }
             }
-            return eErr;
+        }
+        for( int iX = nXCheckVector; iX < nXCheck; iX++ )
+        {
+            if( !IsValidStatsValue(pLine[iX], HAS_NODATA, noData) )
+                continue;
+            const double dfValue = static_cast<double>(pLine[iX]);
+            dfMin = std::min(dfMin, dfValue);
+            dfMax = std::max(dfMax, dfValue);
+            dfSum += dfValue;
+            nValidCount++;
         }
     }
 
-    if( !pfnProgress( 0.0, "Compute Statistics", pProgressData ) )
+    GDALBlockStats sBlockStats;
+    sBlockStats.nSampleCount = static_cast<GUIntBig>(nXCheck) * nYCheck;
+    sBlockStats.dfMin = std::min(dfMin, HorizontalMin(vMin));
+    sBlockStats.dfMax = std::max(dfMax, HorizontalMax(vMax));
+    if( COMPUTE_OTHER_STATS )
     {
-        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-        return CE_Failure;
+        if( HAS_MASK )
+        {
+            GUIntBig anCount[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anCount), vCount);
+            nValidCount += anCount[0] + anCount[1];
+        }
+        else
+        {
+            nValidCount += static_cast<GUIntBig>(nXCheckVector) * nYCheck;
+        }
+        dfSum += HorizontalSum(_mm_add_pd(vSumLo, vSumHi));
+        sBlockStats.nValidCount = nValidCount;
+    }
+    else if( sBlockStats.dfMin <= sBlockStats.dfMax )
+    {
+        // Only used to know if there are valid values.
+        sBlockStats.nValidCount = 1;
     }
 
-/* -------------------------------------------------------------------- */
-/*      Read actual data and compute statistics.                        */
-/* -------------------------------------------------------------------- */
-    // Using Welford algorithm:
-    // http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
-    // to compute standard deviation in a more numerically robust way than
-    // the difference of the sum of square values with the square of the sum.
-    // dfMean and dfM2 are updated at each sample.
-    // dfM2 is the sum of square of differences to the current mean.
-    double dfMin = std::numeric_limits<double>::max();
-    double dfMax = -std::numeric_limits<double>::max();
-    double dfMean = 0.0;
-    double dfM2 = 0.0;
+    if( COMPUTE_OTHER_STATS && nValidCount > 0 )
+    {
+        if( !CPLIsFinite(dfSum) )
+        {
+            // Overflow of the sum of huge values: use the slower but more
+            // robust Welford algorithm.
+            sBlockStats = GDALBlockStats();
+            sBlockStats.nSampleCount = static_cast<GUIntBig>(nXCheck) * nYCheck;
+            for( int iY = 0; iY < nYCheck; iY++ )
+            {
+                const T* pLine =
+                    pData + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+                for( int iX = 0; iX < nXCheck; iX++ )
+                {
+                    if( IsValidStatsValue(pLine[iX], HAS_NODATA, noData) )
+                        sBlockStats.Add(static_cast<double>(pLine[iX]));
+                }
+            }
+            sStats.Merge(sBlockStats);
+            return;
+        }
 
-    GDALRasterIOExtraArg sExtraArg;
-    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+        const double dfMean = dfSum / static_cast<double>(nValidCount);
+        const __m128d vMean = _mm_set1_pd(dfMean);
+        __m128d vM2Lo = _mm_setzero_pd();
+        __m128d vM2Hi = _mm_setzero_pd();
+        double dfM2 = 0;
+        for( int iY = 0; iY < nYCheck; iY++ )
+        {
+            const T* pLine = pData + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+            for( int iX = 0; iX < nXCheckVector; iX += 4 )
+            {
+                __m128d lo, hi, validLo, validHi;
+                LoadForStatsSSE2<HAS_NODATA>(pLine + iX, vNoData,
+                                             lo, hi, validLo, validHi);
+                __m128d deltaLo = _mm_sub_pd(lo, vMean);
+                __m128d deltaHi = _mm_sub_pd(hi, vMean);
+                if( HAS_MASK )
+                {
+                    deltaLo = _mm_and_pd(validLo, deltaLo);
+                    deltaHi = _mm_and_pd(validHi, deltaHi);
+                }
+                vM2Lo = _mm_add_pd(vM2Lo, _mm_mul_pd(deltaLo, deltaLo));
+                vM2Hi = _mm_add_pd(vM2Hi, _mm_mul_pd(deltaHi, deltaHi));
+            }
+            for( int iX = nXCheckVector; iX < nXCheck; iX++ )
+            {
+                if( !IsValidStatsValue(pLine[iX], HAS_NODATA, noData) )
+                    continue;
+                const double dfDelta = static_cast<double>(pLine[iX]) - dfMean;
+                dfM2 += dfDelta * dfDelta;
+            }
+        }
+        sBlockStats.dfMean = dfMean;
+        sBlockStats.dfM2 = dfM2 + HorizontalSum(_mm_add_pd(vM2Lo, vM2Hi));
+    }
+
+    sStats.Merge(sBlockStats);
+}
+
+#endif // defined(__x86_64) || defined(_M_X64)
+
+/************************************************************************/
+/*                         ComputeBlockStats()                          */
+/************************************************************************/
+
+// Portable version of ComputeBlockStatsSSE2()
+template<class T, bool HAS_NODATA, bool COMPUTE_OTHER_STATS>
+void ComputeBlockStatsGeneric( const T* pData, int nXCheck, int nYCheck,
+                               int nBlockXSize,
+                               typename StatsComputeType<T>::type noData,
+                               GDALBlockStats& sStats )
+{
+    GDALBlockStats sBlockStats;
+    sBlockStats.nSampleCount = static_cast<GUIntBig>(nXCheck) * nYCheck;
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            if( !IsValidStatsValue(pLine[iX], HAS_NODATA, noData) )
+                continue;
+            const double dfValue = static_cast<double>(pLine[iX]);
+            if( COMPUTE_OTHER_STATS )
+            {
+                sBlockStats.Add(dfValue);
+            }
+            else
+            {
+                sBlockStats.dfMin = std::min(sBlockStats.dfMin, dfValue);
+                sBlockStats.dfMax = std::max(sBlockStats.dfMax, dfValue);
+                sBlockStats.nValidCount = 1;
+            }
+        }
+    }
+    sStats.Merge(sBlockStats);
+}
+
+// Merges the statistics of the valid values of a block of Int16, Int32,
+// Float32 or Float64 values into sStats. If bComputeOtherStats is false,
+// only the minimum and maximum values are computed.
+template<class T>
+void ComputeBlockStats( const T* pData, int nXCheck, int nYCheck,
+                        int nBlockXSize, bool bHasNoData,
+                        typename StatsComputeType<T>::type noData,
+                        bool bComputeOtherStats,
+                        GDALBlockStats& sStats )
+{
+#if defined(__x86_64) || defined(_M_X64)
+#define ComputeBlockStatsImpl ComputeBlockStatsSSE2
+#else
+#define ComputeBlockStatsImpl ComputeBlockStatsGeneric
+#endif
+    if( bHasNoData )
+    {
+        if( bComputeOtherStats )
+            ComputeBlockStatsImpl<T, true, true>(
+                pData, nXCheck, nYCheck, nBlockXSize, noData, sStats);
+        else
+            ComputeBlockStatsImpl<T, true, false>(
+                pData, nXCheck, nYCheck, nBlockXSize, noData, sStats);
+    }
+    else
+    {
+        if( bComputeOtherStats )
+            ComputeBlockStatsImpl<T, false, true>(
+                pData, nXCheck, nYCheck, nBlockXSize, noData, sStats);
+        else
+            ComputeBlockStatsImpl<T, false, false>(
+                pData, nXCheck, nYCheck, nBlockXSize, noData, sStats);
+    }
+#undef ComputeBlockStatsImpl
+}
+
+} // namespace
+
+/************************************************************************/
+/*                     ComputeBlockStatistics()                         */
+/************************************************************************/
+
+// Merges the statistics of the valid values of a block into sStats.
+static void ComputeBlockStatistics( const void* pData,
+                                    GDALDataType eDataType,
+                                    bool bSignedByte,
+                                    int nXCheck,
+                                    int nYCheck,
+                                    int nBlockXSize,
+                                    bool bGotNoDataValue,
+                                    double dfNoDataValue,
+                                    bool bGotFloatNoDataValue,
+                                    float fNoDataValue,
+                                    GDALBlockStats& sStats )
+{
+    switch( eDataType )
+    {
+        case GDT_Int16:
+            ComputeBlockStats(static_cast<const GInt16*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotNoDataValue, dfNoDataValue, true, sStats);
+            return;
+        case GDT_Int32:
+            ComputeBlockStats(static_cast<const GInt32*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotNoDataValue, dfNoDataValue, true, sStats);
+            return;
+        case GDT_Float32:
+            ComputeBlockStats(static_cast<const float*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotFloatNoDataValue, fNoDataValue, true, sStats);
+            return;
+        case GDT_Float64:
+            ComputeBlockStats(static_cast<const double*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotNoDataValue, dfNoDataValue, true, sStats);
+            return;
+        default:
+            break;
+    }
+
+    GDALBlockStats sBlockStats;
+    sBlockStats.nSampleCount = static_cast<GUIntBig>(nXCheck) * nYCheck;
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const GPtrDiff_t iOffset = iX + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+            bool bValid = true;
+            const double dfValue = GetPixelValue( eDataType,
+                                                  bSignedByte,
+                                                  pData,
+                                                  iOffset,
+                                                  bGotNoDataValue,
+                                                  dfNoDataValue,
+                                                  bGotFloatNoDataValue,
+                                                  fNoDataValue,
+                                                  bValid );
+            if( bValid )
+                sBlockStats.Add(dfValue);
+        }
+    }
+    sStats.Merge(sBlockStats);
+}
+
+/************************************************************************/
+/*                        ForEachSampledBlock()                         */
+/************************************************************************/
+
+namespace
+{
+struct SampledBlockJob
+{
+    const std::function<void(int, const void*, int, int)>* pfnProcess = nullptr;
+    GDALRasterBlock* poBlock = nullptr;
+    int iSample = 0;
+    int nXCheck = 0;
+    int nYCheck = 0;
+
+    static void Run( void* pData )
+    {
+        SampledBlockJob* psJob = static_cast<SampledBlockJob*>(pData);
+        (*psJob->pfnProcess)(psJob->iSample, psJob->poBlock->GetDataRef(),
+                             psJob->nXCheck, psJob->nYCheck);
+        psJob->poBlock->DropLock();
+        delete psJob;
+    }
+};
+} // namespace
+
+// Calls pfnProcess(iSample, pData, nXCheck, nYCheck) on every nSampleRate-th
+// block of the band, iSample being the rank of the block among the sampled
+// ones. Blocks are always read in the calling thread, as drivers are
+// generally not thread-safe, but if the GDAL_NUM_THREADS configuration option
+// is set to ALL_CPUS or a value greater than one, they are processed by jobs
+// of the global thread pool while the next ones are read. pfnProcess must
+// then only modify state specific to iSample.
+// pfnContinue(dfComplete) is called after each block has been read, and the
+// iteration stops if it returns false.
+// Returns false if a block could not be read.
+static bool ForEachSampledBlock(
+        GDALRasterBand* poBand,
+        int nSampleRate,
+        const std::function<void(int, const void*, int, int)>& pfnProcess,
+        const std::function<bool(double)>& pfnContinue )
+{
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const int nBlocksPerRow =
+        DIV_ROUND_UP(poBand->GetXSize(), nBlockXSize);
+    const int nBlocksPerColumn =
+        DIV_ROUND_UP(poBand->GetYSize(), nBlockYSize);
+    const int nTotalBlocks = nBlocksPerRow * nBlocksPerColumn;
+
+    const int nThreads =
+        nTotalBlocks / nSampleRate > 1 ? GDALGetNumThreads(128) : 1;
+    CPLWorkerThreadPool* poThreadPool =
+        nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
+    auto poQueue = poThreadPool ? poThreadPool->CreateJobQueue() : nullptr;
+    // Maximum number of blocks locked by pending jobs
+    const int nMaxPendingJobs = 2 * nThreads;
+
+    bool bRet = true;
+    for( int iSampleBlock = 0, iSample = 0;
+         iSampleBlock < nTotalBlocks;
+         iSampleBlock += nSampleRate, ++iSample )
+    {
+        const int iYBlock = iSampleBlock / nBlocksPerRow;
+        const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
+
+        GDALRasterBlock * const poBlock =
+            poBand->GetLockedBlockRef( iXBlock, iYBlock );
+        if( poBlock == nullptr )
+        {
+            bRet = false;
+            break;
+        }
+
+        int nXCheck = 0, nYCheck = 0;
+        poBand->GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+
+        SampledBlockJob* psJob = new SampledBlockJob();
+        psJob->pfnProcess = &pfnProcess;
+        psJob->poBlock = poBlock;
+        psJob->iSample = iSample;
+        psJob->nXCheck = nXCheck;
+        psJob->nYCheck = nYCheck;
+        if( poQueue )
+        {
+            poQueue->WaitCompletion(nMaxPendingJobs - 1);
+            if( !poQueue->SubmitJob(SampledBlockJob::Run, psJob) )
+                SampledBlockJob::Run(psJob);
+        }
+        else
+        {
+            SampledBlockJob::Run(psJob);
+        }
+
+        if( !pfnContinue( iSampleBlock / static_cast<double>(nTotalBlocks) ) )
+            break;
+    }
+
+    if( poQueue )
+        poQueue->WaitCompletion();
+    return bRet;
+}
+
+/************************************************************************/
+/*                         SetValidPercent()                            */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+/**
+ * \brief Set percentage of valid (not nodata) pixels.
+ *
+ * Stores the percentage of valid pixels in the metadata item
+ * STATISTICS_VALID_PERCENT
+ *
+ * @param nSampleCount Number of sampled pixels.
+ *
+ * @param nValidCount Number of valid pixels.
+ */
+
+void GDALRasterBand::SetValidPercent(GUIntBig nSampleCount, GUIntBig nValidCount)
+{
+    if( nValidCount == 0 )
+    {
+        SetMetadataItem( "STATISTICS_VALID_PERCENT", "0" );
+    }
+    else if( nValidCount == nSampleCount )
+    {
+        SetMetadataItem( "STATISTICS_VALID_PERCENT", "100" );
+    }
+    else /* nValidCount < nSampleCount */
+    {
+        char szValue[128] = { 0 };
+
+        /* percentage is only an indicator: limit precision */
+        CPLsnprintf( szValue, sizeof(szValue), "%.4g",
+                 100. * static_cast<double>(nValidCount) / nSampleCount );
+
+        if (EQUAL(szValue, "100"))
+        {
+            /* don't set 100 percent valid
+             * because some of the sampled pixels were nodata */
+            SetMetadataItem( "STATISTICS_VALID_PERCENT", "99.999" );
+        }
+        else
+        {
+            SetMetadataItem( "STATISTICS_VALID_PERCENT", szValue );
+        }
+    }
+}
+//! @endcond
+
+/************************************************************************/
+/*                         ComputeStatistics()                          */
+/************************************************************************/
+
+/**
+ * \brief Compute image statistics.
+ *
+ * Returns the minimum, maximum, mean and standard deviation of all
+ * pixel values in this band.  If approximate statistics are sufficient,
+ * the bApproxOK flag can be set to true in which case overviews, or a
+ * subset of image tiles may be used in computing the statistics.
+ *
+ * Once computed, the statistics will generally be "set" back on the
+ * raster band using SetStatistics().
+ *
+ * Cached statistics can be cleared with GDALDataset::ClearStatistics().
+ *
+ * Starting with GDAL 3.7, if the GDAL_NUM_THREADS configuration option is set
+ * to ALL_CPUS or a value greater than one, the blocks, which are still read
+ * by the calling thread, are processed by several threads. The result does
+ * not depend on the number of threads.
+ *
+ * This method is the same as the C function GDALComputeRasterStatistics().
+ *
+ * @param bApproxOK If TRUE statistics may be computed based on overviews
+ * or a subset of all tiles.
+ *
+ * @param pdfMin Location into which to load image minimum (may be NULL).
+ *
+ * @param pdfMax Location into which to load image maximum (may be NULL).-
+ *
+ * @param pdfMean Location into which to load image mean (may be NULL).
+ *
+ * @param pdfStdDev Location into which to load image standard deviation
+ * (may be NULL).
+ *
+ * @param pfnProgress a function to call to report progress, or NULL.
+ *
+ * @param pProgressData application data to pass to the progress function.
+ *
+ * @return CE_None on success, or CE_Failure if an error occurs or processing
+ * is terminated by the user.
+ */
+
+CPLErr
+GDALRasterBand::ComputeStatistics( int bApproxOK,
+                                   double *pdfMin, double *pdfMax,
+                                   double *pdfMean, double *pdfStdDev,
+                                   GDALProgressFunc pfnProgress,
+                                   void *pProgressData )
+
+{
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+/* -------------------------------------------------------------------- */
+/*      If we have overview bands, use them for statistics.             */
+/* -------------------------------------------------------------------- */
+    if( bApproxOK && GetOverviewCount() > 0 && !HasArbitraryOverviews() )
+    {
+        GDALRasterBand *poBand
+            = GetRasterSampleOverview( GDALSTAT_APPROX_NUMSAMPLES );
+
+        if( poBand != this )
+        {
+            CPLErr eErr = poBand->ComputeStatistics( FALSE,
+                                              pdfMin, pdfMax,
+                                              pdfMean, pdfStdDev,
+                                              pfnProgress, pProgressData );
+            if( eErr == CE_None )
+            {
+                if( pdfMin && pdfMax && pdfMean && pdfStdDev )
+                {
+                    SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+                    SetStatistics( *pdfMin,*pdfMax, *pdfMean, *pdfStdDev );
+                }
+
+                /* transfer metadata from overview band to this */
+                const char *pszPercentValid = poBand->GetMetadataItem("STATISTICS_VALID_PERCENT");
+
+                if ( pszPercentValid != nullptr )
+                {
+                    SetMetadataItem( "STATISTICS_VALID_PERCENT", pszPercentValid );
+                }
+            }
+            return eErr;
+        }
+    }
+
+    if( !pfnProgress( 0.0, "Compute Statistics", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read actual data and compute statistics.                        */
+/* -------------------------------------------------------------------- */
+    // Using Welford algorithm:
+    // http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+    // to compute standard deviation in a more numerically robust way than
+    // the difference of the sum of square values with the square of the sum.
+    // dfMean and dfM2 are updated at each sample.
+    // dfM2 is the sum of square of differences to the current mean.
+    double dfMin = std::numeric_limits<double>::max();
+    double dfMax = -std::numeric_limits<double>::max();
+    double dfMean = 0.0;
+    double dfM2 = 0.0;
+
+    GDALRasterIOExtraArg sExtraArg;
+    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+
+    int bGotNoDataValue = FALSE;
+    const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
+    bGotNoDataValue = bGotNoDataValue && !CPLIsNan(dfNoDataValue);
+    bool bGotFloatNoDataValue = false;
+    float fNoDataValue = 0.0f;
+    ComputeFloatNoDataValue( eDataType, dfNoDataValue, bGotNoDataValue,
+                            fNoDataValue, bGotFloatNoDataValue );
+
+    bool bSignedByte = false;
+    if( eDataType == GDT_Byte )
+    {
+        EnablePixelTypeSignedByteWarning(false);
+        const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+        EnablePixelTypeSignedByteWarning(true);
+        bSignedByte =
+            pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
+    }
+
+    GUIntBig nSampleCount = 0;
+    GUIntBig nValidCount = 0;
+
+    if ( bApproxOK && HasArbitraryOverviews() )
+    {
+/* -------------------------------------------------------------------- */
+/*      Figure out how much the image should be reduced to get an       */
+/*      approximate value.                                              */
+/* -------------------------------------------------------------------- */
+        double  dfReduction = sqrt(
+            static_cast<double>(nRasterXSize) * nRasterYSize /
+            GDALSTAT_APPROX_NUMSAMPLES );
+
+        int nXReduced = nRasterXSize;
+        int nYReduced = nRasterYSize;
+        if ( dfReduction > 1.0 )
+        {
+            nXReduced = static_cast<int>( nRasterXSize / dfReduction );
+            nYReduced = static_cast<int>( nRasterYSize / dfReduction );
+
+            // Catch the case of huge resizing ratios here
+            if ( nXReduced == 0 )
+                nXReduced = 1;
+            if ( nYReduced == 0 )
+                nYReduced = 1;
+        }
+
+        void *pData =
+            CPLMalloc(
+                GDALGetDataTypeSizeBytes(eDataType) * nXReduced * nYReduced );
+
+        const CPLErr eErr = IRasterIO(
+            GF_Read, 0, 0, nRasterXSize, nRasterYSize, pData,
+            nXReduced, nYReduced, eDataType, 0, 0, &sExtraArg );
+        if ( eErr != CE_None )
+        {
+            CPLFree(pData);
+            return eErr;
+        }
+
+        /* this isn't the fastest way to do this, but is easier for now */
+        for( int iY = 0; iY < nYReduced; iY++ )
+        {
+            for( int iX = 0; iX < nXReduced; iX++ )
+            {
+                const int iOffset = iX + iY * nXReduced;
+                bool bValid = true;
+                double dfValue = GetPixelValue( eDataType,
+                                                bSignedByte,
+                                                pData,
+                                                iOffset,
+                                                CPL_TO_BOOL(bGotNoDataValue),
+                                                dfNoDataValue,
+                                                bGotFloatNoDataValue,
+                                                fNoDataValue,
+                                                bValid );
+                if( !bValid )
+                    continue;
+
+                dfMin = std::min(dfMin, dfValue);
+                dfMax = std::max(dfMax, dfValue);
+
+                nValidCount++;
+                const double dfDelta = dfValue - dfMean;
+                dfMean += dfDelta / nValidCount;
+                dfM2 += dfDelta * (dfValue - dfMean);
+            }
+        }
+
+        nSampleCount = static_cast<GUIntBig>(nXReduced) * nYReduced;
+
+        CPLFree( pData );
+    }
+
+    else  // No arbitrary overviews.
+    {
+        if( !InitBlockInfo() )
+            return CE_Failure;
+
+/* -------------------------------------------------------------------- */
+/*      Figure out the ratio of blocks we will read to get an           */
+/*      approximate value.                                              */
+/* -------------------------------------------------------------------- */
+        int nSampleRate = 1;
+        if ( bApproxOK )
+        {
+            nSampleRate = static_cast<int>(
+                std::max(1.0,
+                         sqrt(static_cast<double>(nBlocksPerRow) *
+                              nBlocksPerColumn)));
+            // We want to avoid probing only the first column of blocks for
+            // a square shaped raster, because it is not unlikely that it may
+            // be padding only (#6378)
+            if( nSampleRate == nBlocksPerRow && nBlocksPerRow > 1 )
+              nSampleRate += 1;
+        }
+        if( nSampleRate == 1 )
+            bApproxOK = false;
+
+#ifdef CPL_HAS_GINT64
+        // Particular case for GDT_Byte that only use integral types for all
+        // intermediate computations. Only possible if the number of pixels
+        // explored is lower than GUINTBIG_MAX / (255*255), so that nSumSquare
+        // can fit on a uint64. Should be 99.99999% of cases.
+        // For GUInt16, this limits to raster of 4 giga pixels
+        if( (eDataType == GDT_Byte && !bSignedByte &&
+             static_cast<GUIntBig>(nBlocksPerRow)*nBlocksPerColumn/nSampleRate <
+                GUINTBIG_MAX / (255U * 255U) /
+                        (static_cast<GUInt64>(nBlockXSize) * static_cast<GUInt64>(nBlockYSize))) ||
+            (eDataType == GDT_UInt16 &&
+             static_cast<GUIntBig>(nBlocksPerRow)*nBlocksPerColumn/nSampleRate <
+                GUINTBIG_MAX / (65535U * 65535U) /
+                        (static_cast<GUInt64>(nBlockXSize) * static_cast<GUInt64>(nBlockYSize))) )
+        {
+            const GUInt32 nMaxValueType = (eDataType == GDT_Byte) ? 255 : 65535;
+            GUInt32 nMin = nMaxValueType;
+            GUInt32 nMax = 0;
+            GUIntBig nSum = 0;
+            GUIntBig nSumSquare = 0;
+            // If no valid nodata, map to invalid value (256 for Byte)
+            const GUInt32 nNoDataValue =
+                (bGotNoDataValue && dfNoDataValue >= 0 &&
+                 dfNoDataValue <= nMaxValueType &&
+                 fabs(dfNoDataValue -
+                      static_cast<GUInt32>(dfNoDataValue + 1e-10)) < 1e-10 ) ?
+                            static_cast<GUInt32>(dfNoDataValue + 1e-10) :
+                            nMaxValueType+1;
+
+            // Per sampled block statistics, merged in order afterwards
+            struct IntegerStats
+            {
+                GUInt32  nMin;
+                GUInt32  nMax;
+                GUIntBig nSum;
+                GUIntBig nSumSquare;
+                GUIntBig nSampleCount;
+                GUIntBig nValidCount;
+            };
+            std::vector<IntegerStats> asStats;
+            try
+            {
+                asStats.resize(DIV_ROUND_UP(nBlocksPerRow * nBlocksPerColumn,
+                                            nSampleRate));
+            }
+            catch( const std::exception& )
+            {
+                ReportError( CE_Failure, CPLE_OutOfMemory, "Out of memory" );
+                return CE_Failure;
+            }
+
+            const auto ProcessBlock = [this, &asStats, nMaxValueType,
+                                       nNoDataValue]
+                (int iSample, const void* pData, int nXCheck, int nYCheck)
+            {
+                IntegerStats& sStats = asStats[iSample];
+                sStats.nMin = nMaxValueType;
+                sStats.nMax = 0;
+                sStats.nSum = 0;
+                sStats.nSumSquare = 0;
+                sStats.nSampleCount = 0;
+                sStats.nValidCount = 0;
+                if( eDataType == GDT_Byte )
+                {
+                    ComputeStatisticsInternal<GByte, /* COMPUTE_OTHER_STATS = */ true>::f(
+                                               nXCheck,
+                                               nBlockXSize,
+                                               nYCheck,
+                                               static_cast<const GByte*>(pData),
+                                               nNoDataValue <= nMaxValueType,
+                                               nNoDataValue,
+                                               sStats.nMin, sStats.nMax,
+                                               sStats.nSum,
+                                               sStats.nSumSquare,
+                                               sStats.nSampleCount,
+                                               sStats.nValidCount );
+                }
+                else
+                {
+                    ComputeStatisticsInternal<GUInt16, /* COMPUTE_OTHER_STATS = */ true>::f(
+                                               nXCheck,
+                                               nBlockXSize,
+                                               nYCheck,
+                                               static_cast<const GUInt16*>(pData),
+                                               nNoDataValue <= nMaxValueType,
+                                               nNoDataValue,
+                                               sStats.nMin, sStats.nMax,
+                                               sStats.nSum,
+                                               sStats.nSumSquare,
+                                               sStats.nSampleCount,
+                                               sStats.nValidCount );
+                }
+            };
+
+            bool bInterrupted = false;
+            const auto Progress = [pfnProgress, pProgressData,
+                                   &bInterrupted](double dfComplete)
+            {
+                bInterrupted = !pfnProgress( dfComplete, "Compute Statistics",
+                                             pProgressData );
+                return !bInterrupted;
+            };
+
+            if( !ForEachSampledBlock(this, nSampleRate, ProcessBlock,
+                                     Progress) )
+            {
+                return CE_Failure;
+            }
+            if( bInterrupted )
+            {
+                ReportError( CE_Failure, CPLE_UserInterrupt,
+                             "User terminated" );
+                return CE_Failure;
+            }
+
+            for( const auto& sStats: asStats )
+            {
+                nMin = std::min(nMin, sStats.nMin);
+                nMax = std::max(nMax, sStats.nMax);
+                nSum += sStats.nSum;
+                nSumSquare += sStats.nSumSquare;
+                nSampleCount += sStats.nSampleCount;
+                nValidCount += sStats.nValidCount;
+            }
+
+            if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
+            {
+                ReportError( CE_Failure, CPLE_UserInterrupt,
+                             "User terminated" );
+                return CE_Failure;
+            }
+
+/* -------------------------------------------------------------------- */
+/*      Save computed information.                                      */
+/* -------------------------------------------------------------------- */
+            if( nValidCount )
+                dfMean = static_cast<double>(nSum) / nValidCount;
+
+            // To avoid potential precision issues when doing the difference,
+            // we need to do that computation on 128 bit rather than casting
+            // to double
+            const GDALUInt128 nTmpForStdDev(
+                    GDALUInt128::Mul(nSumSquare,nValidCount) -
+                    GDALUInt128::Mul(nSum,nSum));
+            const double dfStdDev =
+                nValidCount > 0 ?
+                    sqrt(static_cast<double>(nTmpForStdDev)) / nValidCount :
+                    0.0;
+
+            if( nValidCount > 0 )
+            {
+                if( bApproxOK )
+                {
+                    SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+                }
+                else if( GetMetadataItem( "STATISTICS_APPROXIMATE" ) )
+                {
+                    SetMetadataItem( "STATISTICS_APPROXIMATE",  nullptr );
+                }
+                SetStatistics( nMin, nMax, dfMean, dfStdDev );
+            }
+
+            SetValidPercent( nSampleCount, nValidCount );
+
+/* -------------------------------------------------------------------- */
+/*      Record results.                                                 */
+/* -------------------------------------------------------------------- */
+            if( pdfMin != nullptr )
+                *pdfMin = nValidCount ? nMin : 0;
+            if( pdfMax != nullptr )
+                *pdfMax = nValidCount ? nMax : 0;
+
+            if( pdfMean != nullptr )
+                *pdfMean = dfMean;
+
+            if( pdfStdDev != nullptr )
+                *pdfStdDev = dfStdDev;
+
+            if( nValidCount > 0 )
+                return CE_None;
+
+            ReportError(
+                CE_Failure, CPLE_AppDefined,
+                "Failed to compute statistics, no valid pixels found in sampling." );
+            return CE_Failure;
+        }
+#endif
+
+        // Per sampled block statistics, merged in order afterwards, so that
+        // the result does not depend on the number of threads.
+        std::vector<GDALBlockStats> asStats;
+        try
+        {
+            asStats.resize(DIV_ROUND_UP(nBlocksPerRow * nBlocksPerColumn,
+                                        nSampleRate));
+        }
+        catch( const std::exception& )
+        {
+            ReportError( CE_Failure, CPLE_OutOfMemory, "Out of memory" );
+            return CE_Failure;
+        }
+
+        const auto ProcessBlock = [this, &asStats, bSignedByte,
+                                   bGotNoDataValue, dfNoDataValue,
+                                   bGotFloatNoDataValue, fNoDataValue]
+            (int iSample, const void* pData, int nXCheck, int nYCheck)
+        {
+            ComputeBlockStatistics( pData, eDataType, bSignedByte,
+                                    nXCheck, nYCheck, nBlockXSize,
+                                    CPL_TO_BOOL(bGotNoDataValue),
+                                    dfNoDataValue,
+                                    bGotFloatNoDataValue,
+                                    fNoDataValue,
+                                    asStats[iSample] );
+        };
+
+        bool bInterrupted = false;
+        const auto Progress = [pfnProgress, pProgressData,
+                               &bInterrupted](double dfComplete)
+        {
+            bInterrupted = !pfnProgress( dfComplete, "Compute Statistics",
+                                         pProgressData );
+            return !bInterrupted;
+        };
+
+        if( !ForEachSampledBlock(this, nSampleRate, ProcessBlock, Progress) )
+            return CE_Failure;
+        if( bInterrupted )
+        {
+            ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            return CE_Failure;
+        }
+
+        GDALBlockStats sStats;
+        for( const auto& sBlockStats: asStats )
+            sStats.Merge(sBlockStats);
+        dfMin = sStats.dfMin;
+        dfMax = sStats.dfMax;
+        dfMean = sStats.dfMean;
+        dfM2 = sStats.dfM2;
+        nSampleCount = sStats.nSampleCount;
+        nValidCount = sStats.nValidCount;
+    }
+
+    if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Save computed information.                                      */
+/* -------------------------------------------------------------------- */
+    const double dfStdDev =
+        nValidCount > 0 ? sqrt(dfM2 / nValidCount) : 0.0;
+
+    if( nValidCount > 0 )
+    {
+        if( bApproxOK )
+        {
+            SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+        }
+        else if( GetMetadataItem( "STATISTICS_APPROXIMATE" ) )
+        {
+            SetMetadataItem( "STATISTICS_APPROXIMATE",  nullptr );
+        }
+        SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
+    }
+    else
+    {
+        dfMin = 0.0;
+        dfMax = 0.0;
+    }
+
+    SetValidPercent( nSampleCount, nValidCount );
+
+/* -------------------------------------------------------------------- */
+/*      Record results.                                                 */
+/* -------------------------------------------------------------------- */
+    if( pdfMin != nullptr )
+        *pdfMin = dfMin;
+    if( pdfMax != nullptr )
+        *pdfMax = dfMax;
+
+    if( pdfMean != nullptr )
+        *pdfMean = dfMean;
+
+    if( pdfStdDev != nullptr )
+        *pdfStdDev = dfStdDev;
+
+    if( nValidCount > 0 )
+        return CE_None;
+
+    ReportError(
+        CE_Failure, CPLE_AppDefined,
+        "Failed to compute statistics, no valid pixels found in sampling." );
+    return CE_Failure;
+}
+
+/************************************************************************/
+/*                    GDALComputeRasterStatistics()                     */
+/************************************************************************/
+
+/**
+  * \brief Compute image statistics.
+  *
+  * @see GDALRasterBand::ComputeStatistics()
+  */
+
+CPLErr CPL_STDCALL GDALComputeRasterStatistics(
+        GDALRasterBandH hBand, int bApproxOK,
+        double *pdfMin, double *pdfMax, double *pdfMean, double *pdfStdDev,
+        GDALProgressFunc pfnProgress, void *pProgressData )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALComputeRasterStatistics", CE_Failure );
+
+    GDALRasterBand *poBand = GDALRasterBand::FromHandle(hBand);
+
+    return poBand->ComputeStatistics(
+        bApproxOK, pdfMin, pdfMax, pdfMean, pdfStdDev,
+        pfnProgress, pProgressData );
+}
+
+/************************************************************************/
+/*                             GDALTDigest                              */
+/************************************************************************/
+
+namespace
+{
+
+// Merging t-digest of Dunning & Ertl: a mergeable sketch of a distribution,
+// from which quantiles can be estimated with a bounded memory footprint
+// (a few times the compression factor in centroids), and an accuracy that
+// is best towards the tails. Results only depend on the order in which
+// values are added and digests are merged.
+class GDALTDigest
+{
+    struct Centroid
+    {
+        double dfMean;
+        double dfWeight;
+    };
+
+    double m_dfCompression;
+    std::vector<Centroid> m_asCentroids{};  // sorted by mean
+    std::vector<Centroid> m_asBuffer{};     // not merged yet
+    double m_dfTotalWeight = 0;
+    double m_dfMin = std::numeric_limits<double>::infinity();
+    double m_dfMax = -std::numeric_limits<double>::infinity();
+
+    // k1 scale function, and its inverse.
+    double K( double dfQ ) const
+    {
+        return m_dfCompression / (2 * M_PI) *
+               asin(std::max(-1.0, std::min(1.0, 2 * dfQ - 1)));
+    }
+    double Q( double dfK ) const
+    {
+        return (sin(std::min(M_PI / 2, dfK * 2 * M_PI / m_dfCompression)) +
+                1) / 2;
+    }
+
+    void FlushIfNeeded()
+    {
+        if( m_asBuffer.size() >= 8 * static_cast<size_t>(m_dfCompression) )
+            Compress();
+    }
+
+  public:
+    explicit GDALTDigest( double dfCompression = 200 ) :
+        m_dfCompression(dfCompression) {}
+
+    void Add( double dfValue )
+    {
+        m_asBuffer.push_back(Centroid{dfValue, 1.0});
+        m_dfTotalWeight += 1;
+        m_dfMin = std::min(m_dfMin, dfValue);
+        m_dfMax = std::max(m_dfMax, dfValue);
+        FlushIfNeeded();
+    }
+
+    void Merge( const GDALTDigest& other )
+    {
+        m_asBuffer.insert(m_asBuffer.end(), other.m_asCentroids.begin(),
+                          other.m_asCentroids.end());
+        m_asBuffer.insert(m_asBuffer.end(), other.m_asBuffer.begin(),
+                          other.m_asBuffer.end());
+        m_dfTotalWeight += other.m_dfTotalWeight;
+        m_dfMin = std::min(m_dfMin, other.m_dfMin);
+        m_dfMax = std::max(m_dfMax, other.m_dfMax);
+        FlushIfNeeded();
+    }
+
+    double GetTotalWeight() const { return m_dfTotalWeight; }
+
+    void Compress();
+    double Quantile( double dfProbability ) const;
+};
+
+/************************************************************************/
+/*                        GDALTDigest::Compress()                       */
+/************************************************************************/
+
+void GDALTDigest::Compress()
+{
+    if( m_asBuffer.empty() )
+        return;
+    m_asBuffer.insert(m_asBuffer.end(), m_asCentroids.begin(),
+                      m_asCentroids.end());
+    std::sort(m_asBuffer.begin(), m_asBuffer.end(),
+              [](const Centroid& a, const Centroid& b)
+              {
+                  return a.dfMean < b.dfMean ||
+                         (a.dfMean == b.dfMean && a.dfWeight < b.dfWeight);
+              });
+    m_asCentroids.clear();
+
+    // Greedily merge neighbouring centroids, as long as the merged one
+    // spans at most one unit of the scale function.
+    double dfWeightSoFar = 0;
+    double dfWeightLimit =
+        m_dfTotalWeight * Q(K(0) + 1);
+    Centroid sCur = m_asBuffer[0];
+    for( size_t i = 1; i < m_asBuffer.size(); ++i )
+    {
+        const Centroid& sNext = m_asBuffer[i];
+        const double dfProposed = sCur.dfWeight + sNext.dfWeight;
+        if( dfWeightSoFar + dfProposed <= dfWeightLimit )
+        {
+            sCur.dfMean += (sNext.dfMean - sCur.dfMean) *
+                           sNext.dfWeight / dfProposed;
+            sCur.dfWeight = dfProposed;
+        }
+        else
+        {
+            dfWeightSoFar += sCur.dfWeight;
+            m_asCentroids.push_back(sCur);
+            dfWeightLimit = m_dfTotalWeight *
+                            Q(K(dfWeightSoFar / m_dfTotalWeight) + 1);
+            sCur = sNext;
+        }
+    }
+    m_asCentroids.push_back(sCur);
+    m_asBuffer.clear();
+}
+
+/************************************************************************/
+/*                        GDALTDigest::Quantile()                       */
+/************************************************************************/
+
+// Must be called after Compress().
+double GDALTDigest::Quantile( double dfProbability ) const
+{
+    CPLAssert( m_asBuffer.empty() );
+    if( m_asCentroids.empty() )
+        return std::numeric_limits<double>::quiet_NaN();
+    if( m_asCentroids.size() == 1 )
+        return m_asCentroids[0].dfMean;
+
+    // Centroid i is considered to be located at the middle of its weight.
+    // Interpolate linearly between the centers, and between the extreme
+    // centers and the exact minimum and maximum.
+    const double dfIndex = dfProbability * m_dfTotalWeight;
+    const Centroid& sFirst = m_asCentroids.front();
+    if( dfIndex < sFirst.dfWeight / 2 )
+    {
+        return m_dfMin + (sFirst.dfMean - m_dfMin) *
+                         dfIndex / (sFirst.dfWeight / 2);
+    }
+
+    double dfWeightSoFar = sFirst.dfWeight / 2;
+    for( size_t i = 0; i + 1 < m_asCentroids.size(); ++i )
+    {
+        const Centroid& sLeft = m_asCentroids[i];
+        const Centroid& sRight = m_asCentroids[i + 1];
+        const double dfDist = (sLeft.dfWeight + sRight.dfWeight) / 2;
+        if( dfIndex < dfWeightSoFar + dfDist )
+        {
+            return sLeft.dfMean + (sRight.dfMean - sLeft.dfMean) *
+                                  (dfIndex - dfWeightSoFar) / dfDist;
+        }
+        dfWeightSoFar += dfDist;
+    }
+
+    const Centroid& sLast = m_asCentroids.back();
+    const double dfRemaining = sLast.dfWeight / 2;
+    const double dfRatio =
+        std::min(1.0, (dfIndex - dfWeightSoFar) / dfRemaining);
+    return sLast.dfMean + (m_dfMax - sLast.dfMean) * dfRatio;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                         ComputeQuantiles()                           */
+/************************************************************************/
+
+/**
+ * \brief Compute quantiles of the pixel values.
+ *
+ * Computes, in a single pass over the data, the value of the quantile of
+ * each of the requested probabilities (for example 0.02, 0.5 and 0.98 for
+ * the 2nd percentile, the median and the 98th percentile). Nodata and NaN
+ * pixels are ignored, as done by ComputeStatistics().
+ *
+ * For Byte, Int8, Int16 and UInt16 bands, the quantiles are exact (unless
+ * bApproxOK is set): the quantile of probability p is the smallest value x
+ * such that at least a fraction p of the valid pixels are lower or equal to
+ * x. For other data types, they are estimated with a t-digest sketch, whose
+ * accuracy is the best towards the extreme probabilities.
+ *
+ * The quantiles are "set" back on the raster band as the
+ * STATISTICS_QUANTILE_{probability} metadata items (for example
+ * STATISTICS_QUANTILE_0.5), along with STATISTICS_QUANTILES_APPROXIMATE=YES
+ * if they are approximate, so that they are saved in the .aux.xml file for
+ * formats relying on PAM. When all the requested quantiles are already
+ * available in those metadata items, they are returned without reading the
+ * data, unless they are approximate and bApproxOK is FALSE. They can be
+ * cleared with GDALDataset::ClearStatistics().
+ *
+ * If the GDAL_NUM_THREADS configuration option is set to ALL_CPUS or a value
+ * greater than one, the blocks, which are still read by the calling thread,
+ * are processed by several threads. The result does not depend on the number
+ * of threads.
+ *
+ * This method is the same as the C function GDALComputeRasterQuantiles().
+ *
+ * @param bApproxOK If TRUE quantiles may be computed based on overviews
+ * or a subset of all tiles.
+ *
+ * @param nQuantiles Number of quantiles to compute.
+ *
+ * @param padfProbabilities Array of nQuantiles probabilities, in the [0,1]
+ * range.
+ *
+ * @param padfQuantiles Array of nQuantiles values, into which the quantiles
+ * are returned.
+ *
+ * @param pfnProgress a function to call to report progress, or NULL.
+ *
+ * @param pProgressData application data to pass to the progress function.
+ *
+ * @return CE_None on success, or CE_Failure if an error occurs, if there are
+ * no valid pixels, or if processing is terminated by the user.
+ *
+ * @since GDAL 3.7
+ */
+
+CPLErr GDALRasterBand::ComputeQuantiles( int bApproxOK, int nQuantiles,
+                                         const double* padfProbabilities,
+                                         double* padfQuantiles,
+                                         GDALProgressFunc pfnProgress,
+                                         void *pProgressData )
+
+{
+    if( nQuantiles <= 0 || padfProbabilities == nullptr ||
+        padfQuantiles == nullptr )
+    {
+        ReportError( CE_Failure, CPLE_IllegalArg,
+                     "Invalid arguments to ComputeQuantiles()" );
+        return CE_Failure;
+    }
+    for( int i = 0; i < nQuantiles; ++i )
+    {
+        if( !(padfProbabilities[i] >= 0 && padfProbabilities[i] <= 1) )
+        {
+            ReportError( CE_Failure, CPLE_IllegalArg,
+                         "Invalid probability: %g", padfProbabilities[i] );
+            return CE_Failure;
+        }
+    }
+
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+/* -------------------------------------------------------------------- */
+/*      Reuse the quantiles of a previous computation if possible.      */
+/* -------------------------------------------------------------------- */
+    if( GetQuantiles( CPL_TO_BOOL(bApproxOK), nQuantiles, padfProbabilities,
+                      padfQuantiles ) )
+    {
+        if( !pfnProgress( 1.0, "Compute Quantiles", pProgressData ) )
+        {
+            ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            return CE_Failure;
+        }
+        return CE_None;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      If we have overview bands, use them for quantiles.              */
+/* -------------------------------------------------------------------- */
+    if( bApproxOK && GetOverviewCount() > 0 && !HasArbitraryOverviews() )
+    {
+        GDALRasterBand *poBand
+            = GetRasterSampleOverview( GDALSTAT_APPROX_NUMSAMPLES );
+
+        if( poBand != this )
+        {
+            const CPLErr eErr = poBand->ComputeQuantiles(
+                FALSE, nQuantiles, padfProbabilities, padfQuantiles,
+                pfnProgress, pProgressData );
+            if( eErr == CE_None )
+            {
+                SetQuantiles( nQuantiles, padfProbabilities, padfQuantiles,
+                              true );
+            }
+            return eErr;
+        }
+    }
+
+    if( !InitBlockInfo() )
+        return CE_Failure;
+
+    if( !pfnProgress( 0.0, "Compute Quantiles", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
 
     int bGotNoDataValue = FALSE;
     const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
@@ -5513,408 +7005,592 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
     bool bGotFloatNoDataValue = false;
     float fNoDataValue = 0.0f;
     ComputeFloatNoDataValue( eDataType, dfNoDataValue, bGotNoDataValue,
-                            fNoDataValue, bGotFloatNoDataValue );
+                             fNoDataValue, bGotFloatNoDataValue );
 
     bool bSignedByte = false;
     if( eDataType == GDT_Byte )
     {
         EnablePixelTypeSignedByteWarning(false);
-        const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+        const char* pszPixelType =
+            GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
         EnablePixelTypeSignedByteWarning(true);
         bSignedByte =
             pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
     }
 
-    GUIntBig nSampleCount = 0;
-    GUIntBig nValidCount = 0;
-
-    if ( bApproxOK && HasArbitraryOverviews() )
-    {
 /* -------------------------------------------------------------------- */
-/*      Figure out how much the image should be reduced to get an       */
+/*      Figure out the ratio of blocks we will read to get an           */
 /*      approximate value.                                              */
 /* -------------------------------------------------------------------- */
-        double  dfReduction = sqrt(
-            static_cast<double>(nRasterXSize) * nRasterYSize /
-            GDALSTAT_APPROX_NUMSAMPLES );
-
-        int nXReduced = nRasterXSize;
-        int nYReduced = nRasterYSize;
-        if ( dfReduction > 1.0 )
-        {
-            nXReduced = static_cast<int>( nRasterXSize / dfReduction );
-            nYReduced = static_cast<int>( nRasterYSize / dfReduction );
-
-            // Catch the case of huge resizing ratios here
-            if ( nXReduced == 0 )
-                nXReduced = 1;
-            if ( nYReduced == 0 )
-                nYReduced = 1;
-        }
-
-        void *pData =
-            CPLMalloc(
-                GDALGetDataTypeSizeBytes(eDataType) * nXReduced * nYReduced );
-
-        const CPLErr eErr = IRasterIO(
-            GF_Read, 0, 0, nRasterXSize, nRasterYSize, pData,
-            nXReduced, nYReduced, eDataType, 0, 0, &sExtraArg );
-        if ( eErr != CE_None )
-        {
-            CPLFree(pData);
-            return eErr;
-        }
-
-        /* this isn't the fastest way to do this, but is easier for now */
-        for( int iY = 0; iY < nYReduced; iY++ )
-        {
-            for( int iX = 0; iX < nXReduced; iX++ )
-            {
-                const int iOffset = iX + iY * nXReduced;
-                bool bValid = true;
-                double dfValue = GetPixelValue( eDataType,
-                                                bSignedByte,
-                                                pData,
-                                                iOffset,
-                                                CPL_TO_BOOL(bGotNoDataValue),
-                                                dfNoDataValue,
-                                                bGotFloatNoDataValue,
-                                                fNoDataValue,
-                                                bValid );
-                if( !bValid )
-                    continue;
-
-                dfMin = std::min(dfMin, dfValue);
-                dfMax = std::max(dfMax, dfValue);
-
-                nValidCount++;
-                const double dfDelta = dfValue - dfMean;
-                dfMean += dfDelta / nValidCount;
-                dfM2 += dfDelta * (dfValue - dfMean);
-            }
-        }
-
-        nSampleCount = static_cast<GUIntBig>(nXReduced) * nYReduced;
-
-        CPLFree( pData );
+    int nSampleRate = 1;
+    if ( bApproxOK )
+    {
+        nSampleRate = static_cast<int>(
+            std::max(1.0,
+                     sqrt(static_cast<double>(nBlocksPerRow) *
+                          nBlocksPerColumn)));
+        if( nSampleRate == nBlocksPerRow && nBlocksPerRow > 1 )
+          nSampleRate += 1;
+    }
+    if( nSampleRate == 1 )
+        bApproxOK = false;
+
+    // Data types of at most 16 bits are counted in an exact histogram.
+    // Each job counts directly into a histogram taken from a pool, which
+    // holds at most one histogram per concurrently running job, so that the
+    // 65536 bins of 16 bit types are neither allocated nor merged per block.
+    // Integer additions being commutative, the pooled histograms are summed
+    // in any order once all blocks have been processed.
+    int nHistogramOffset = 0;
+    int nHistogramSize = 0;
+    if( eDataType == GDT_Byte )
+    {
+        nHistogramOffset = bSignedByte ? -128 : 0;
+        nHistogramSize = 256;
     }
-
-    else  // No arbitrary overviews.
+    else if( eDataType == GDT_Int8 )
     {
-        if( !InitBlockInfo() )
-            return CE_Failure;
-
-/* -------------------------------------------------------------------- */
-/*      Figure out the ratio of blocks we will read to get an           */
-/*      approximate value.                                              */
-/* -------------------------------------------------------------------- */
-        int nSampleRate = 1;
-        if ( bApproxOK )
-        {
-            nSampleRate = static_cast<int>(
-                std::max(1.0,
-                         sqrt(static_cast<double>(nBlocksPerRow) *
-                              nBlocksPerColumn)));
-            // We want to avoid probing only the first column of blocks for
-            // a square shaped raster, because it is not unlikely that it may
-            // be padding only (#6378)
-            if( nSampleRate == nBlocksPerRow && nBlocksPerRow > 1 )
-              nSampleRate += 1;
-        }
-        if( nSampleRate == 1 )
-            bApproxOK = false;
-
-#ifdef CPL_HAS_GINT64
-        // Particular case for GDT_Byte that only use integral types for all
-        // intermediate computations. Only possible if the number of pixels
-        // explored is lower than GUINTBIG_MAX / (255*255), so that nSumSquare
-        // can fit on a uint64. Should be 99.99999% of cases.
-        // For GUInt16, this limits to raster of 4 giga pixels
-        if( (eDataType == GDT_Byte && !bSignedByte &&
-             static_cast<GUIntBig>(nBlocksPerRow)*nBlocksPerColumn/nSampleRate <
-                GUINTBIG_MAX / (255U * 255U) /
-                        (static_cast<GUInt64>(nBlockXSize) * static_cast<GUInt64>(nBlockYSize))) ||
-            (eDataType == GDT_UInt16 &&
-             static_cast<GUIntBig>(nBlocksPerRow)*nBlocksPerColumn/nSampleRate <
-                GUINTBIG_MAX / (65535U * 65535U) /
-                        (static_cast<GUInt64>(nBlockXSize) * static_cast<GUInt64>(nBlockYSize))) )
+        nHistogramOffset = -128;
+        nHistogramSize = 256;
+    }
+    else if( eDataType == GDT_UInt16 )
+    {
+        nHistogramSize = 65536;
+    }
+    else if( eDataType == GDT_Int16 )
+    {
+        nHistogramOffset = -32768;
+        nHistogramSize = 65536;
+    }
+    std::vector<std::unique_ptr<std::vector<GUIntBig>>> apoHistograms;
+    std::vector<std::vector<GUIntBig>*> apoFreeHistograms;
+    bool bOutOfMemory = false;
+
+    // Other data types go through a t-digest per block. Block digests are
+    // merged in the order of the blocks, so that the result does not depend
+    // on the number of threads.
+    GDALTDigest oDigest;
+    std::map<int, GDALTDigest> oMapPendingDigests;
+    int iNextSampleToMerge = 0;
+
+    std::mutex oMutex;
+
+    const auto ProcessBlock = [this, bSignedByte,
+                               bGotNoDataValue, dfNoDataValue,
+                               bGotFloatNoDataValue, fNoDataValue,
+                               nHistogramOffset, nHistogramSize,
+                               &apoHistograms, &apoFreeHistograms,
+                               &bOutOfMemory, &oDigest,
+                               &oMapPendingDigests, &iNextSampleToMerge,
+                               &oMutex]
+        (int iSample, const void* pData, int nXCheck, int nYCheck)
+    {
+        std::vector<GUIntBig>* panHistogram = nullptr;
+        if( nHistogramSize )
         {
-            const GUInt32 nMaxValueType = (eDataType == GDT_Byte) ? 255 : 65535;
-            GUInt32 nMin = nMaxValueType;
-            GUInt32 nMax = 0;
-            GUIntBig nSum = 0;
-            GUIntBig nSumSquare = 0;
-            // If no valid nodata, map to invalid value (256 for Byte)
-            const GUInt32 nNoDataValue =
-                (bGotNoDataValue && dfNoDataValue >= 0 &&
-                 dfNoDataValue <= nMaxValueType &&
-                 fabs(dfNoDataValue -
-                      static_cast<GUInt32>(dfNoDataValue + 1e-10)) < 1e-10 ) ?
-                            static_cast<GUInt32>(dfNoDataValue + 1e-10) :
-                            nMaxValueType+1;
-
-            for( int iSampleBlock = 0;
-                iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-                iSampleBlock += nSampleRate )
-            {
-                const int iYBlock = iSampleBlock / nBlocksPerRow;
-                const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-                GDALRasterBlock * const poBlock =
-                    GetLockedBlockRef( iXBlock, iYBlock );
-                if( poBlock == nullptr )
-                    return CE_Failure;
-
-                void* const pData = poBlock->GetDataRef();
-
-                int nXCheck = 0, nYCheck = 0;
-                GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
-
-                if( eDataType == GDT_Byte )
-                {
-                    ComputeStatisticsInternal<GByte, /* COMPUTE_OTHER_STATS = */ true>::f(
-                                               nXCheck,
-                                               nBlockXSize,
-                                               nYCheck,
-                                               static_cast<const GByte*>(pData),
-                                               nNoDataValue <= nMaxValueType,
-                                               nNoDataValue,
-                                               nMin, nMax, nSum,
-                                               nSumSquare,
-                                               nSampleCount,
-                                               nValidCount );
-                }
-                else
-                {
-                    ComputeStatisticsInternal<GUInt16, /* COMPUTE_OTHER_STATS = */ true>::f(
-                                               nXCheck,
-                                               nBlockXSize,
-                                               nYCheck,
-                                               static_cast<const GUInt16*>(pData),
-                                               nNoDataValue <= nMaxValueType,
-                                               nNoDataValue,
-                                               nMin, nMax, nSum,
-                                               nSumSquare,
-                                               nSampleCount,
-                                               nValidCount );
-                }
-
-                poBlock->DropLock();
-
-                if ( !pfnProgress( iSampleBlock
-                        / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
-                        "Compute Statistics", pProgressData) )
-                {
-                    ReportError( CE_Failure, CPLE_UserInterrupt,
-                                 "User terminated" );
-                    return CE_Failure;
-                }
-            }
-
-            if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
+            std::lock_guard<std::mutex> oLock(oMutex);
+            if( bOutOfMemory )
+                return;
+            if( !apoFreeHistograms.empty() )
             {
-                ReportError( CE_Failure, CPLE_UserInterrupt,
-                             "User terminated" );
-                return CE_Failure;
+                panHistogram = apoFreeHistograms.back();
+                apoFreeHistograms.pop_back();
             }
-
-/* -------------------------------------------------------------------- */
-/*      Save computed information.                                      */
-/* -------------------------------------------------------------------- */
-            if( nValidCount )
-                dfMean = static_cast<double>(nSum) / nValidCount;
-
-            // To avoid potential precision issues when doing the difference,
-            // we need to do that computation on 128 bit rather than casting
-            // to double
-            const GDALUInt128 nTmpForStdDev(
-                    GDALUInt128::Mul(nSumSquare,nValidCount) -
-                    GDALUInt128::Mul(nSum,nSum));
-            const double dfStdDev =
-                nValidCount > 0 ?
-                    sqrt(static_cast<double>(nTmpForStdDev)) / nValidCount :
-                    0.0;
-
-            if( nValidCount > 0 )
+            else
             {
-                if( bApproxOK )
+                try
                 {
-                    SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+                    apoHistograms.emplace_back(
+                        new std::vector<GUIntBig>(nHistogramSize));
+                    // Reserve room to give the histogram back without
+                    // allocating.
+                    apoFreeHistograms.reserve(apoHistograms.size());
                 }
-                else if( GetMetadataItem( "STATISTICS_APPROXIMATE" ) )
+                catch( const std::exception& )
                 {
-                    SetMetadataItem( "STATISTICS_APPROXIMATE",  nullptr );
+                    bOutOfMemory = true;
+                    return;
                 }
-                SetStatistics( nMin, nMax, dfMean, dfStdDev );
+                panHistogram = apoHistograms.back().get();
             }
-
-            SetValidPercent( nSampleCount, nValidCount );
-
-/* -------------------------------------------------------------------- */
-/*      Record results.                                                 */
-/* -------------------------------------------------------------------- */
-            if( pdfMin != nullptr )
-                *pdfMin = nValidCount ? nMin : 0;
-            if( pdfMax != nullptr )
-                *pdfMax = nValidCount ? nMax : 0;
-
-            if( pdfMean != nullptr )
-                *pdfMean = dfMean;
-
-            if( pdfStdDev != nullptr )
-                *pdfStdDev = dfStdDev;
-
-            if( nValidCount > 0 )
-                return CE_None;
-
-            ReportError(
-                CE_Failure, CPLE_AppDefined,
-                "Failed to compute statistics, no valid pixels found in sampling." );
-            return CE_Failure;
         }
-#endif
 
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
+        GDALTDigest oBlockDigest;
+        for( int iY = 0; iY < nYCheck; iY++ )
         {
-            const int iYBlock = iSampleBlock / nBlocksPerRow;
-            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == nullptr )
-                return CE_Failure;
-
-            void* const pData = poBlock->GetDataRef();
-
-            int nXCheck = 0, nYCheck = 0;
-            GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
-
-            // This isn't the fastest way to do this, but is easier for now.
-            for( int iY = 0; iY < nYCheck; iY++ )
-            {
-                for( int iX = 0; iX < nXCheck; iX++ )
-                {
-                    const GPtrDiff_t iOffset = iX + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
-                    bool bValid = true;
-                    double dfValue = GetPixelValue( eDataType,
-                                                    bSignedByte,
-                                                    pData,
-                                                    iOffset,
-                                                    CPL_TO_BOOL(bGotNoDataValue),
-                                                    dfNoDataValue,
-                                                    bGotFloatNoDataValue,
-                                                    fNoDataValue,
-                                                    bValid );
-
-                    if( !bValid )
-                        continue;
-
-                    dfMin = std::min(dfMin, dfValue);
-                    dfMax = std::max(dfMax, dfValue);
-
-                    nValidCount++;
-                    const double dfDelta = dfValue - dfMean;
-                    dfMean += dfDelta / nValidCount;
-                    dfM2 += dfDelta * (dfValue - dfMean);
-                }
-            }
-
-            nSampleCount += static_cast<GUIntBig>(nXCheck) * nYCheck;
-
-            poBlock->DropLock();
-
-            if ( !pfnProgress(
-                     iSampleBlock
-                         / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
-                     "Compute Statistics", pProgressData) )
+            for( int iX = 0; iX < nXCheck; iX++ )
             {
-                ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-                return CE_Failure;
+                const GPtrDiff_t iOffset =
+                    iX + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+                bool bValid = true;
+                const double dfValue = GetPixelValue( eDataType,
+                                                      bSignedByte,
+                                                      pData,
+                                                      iOffset,
+                                                      CPL_TO_BOOL(bGotNoDataValue),
+                                                      dfNoDataValue,
+                                                      bGotFloatNoDataValue,
+                                                      fNoDataValue,
+                                                      bValid );
+                if( !bValid )
+                    continue;
+                if( panHistogram )
+                    (*panHistogram)[static_cast<int>(dfValue) -
+                                    nHistogramOffset]++;
+                else
+                    oBlockDigest.Add(dfValue);
             }
         }
-    }
 
-    if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
+        std::lock_guard<std::mutex> oLock(oMutex);
+        if( panHistogram )
+        {
+            apoFreeHistograms.push_back(panHistogram);
+            return;
+        }
+        oMapPendingDigests[iSample] = std::move(oBlockDigest);
+        while( true )
+        {
+            auto oIter = oMapPendingDigests.find(iNextSampleToMerge);
+            if( oIter == oMapPendingDigests.end() )
+                break;
+            oDigest.Merge(oIter->second);
+            oMapPendingDigests.erase(oIter);
+            ++iNextSampleToMerge;
+        }
+    };
+
+    bool bInterrupted = false;
+    const auto Progress = [pfnProgress, pProgressData,
+                           &bInterrupted](double dfComplete)
+    {
+        bInterrupted = !pfnProgress( dfComplete, "Compute Quantiles",
+                                     pProgressData );
+        return !bInterrupted;
+    };
+
+    if( !ForEachSampledBlock(this, nSampleRate, ProcessBlock, Progress) )
+        return CE_Failure;
+    if( bOutOfMemory )
+    {
+        ReportError( CE_Failure, CPLE_OutOfMemory, "Out of memory" );
+        return CE_Failure;
+    }
+    if( bInterrupted )
     {
         ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
         return CE_Failure;
     }
 
 /* -------------------------------------------------------------------- */
-/*      Save computed information.                                      */
+/*      Extract the quantiles.                                          */
 /* -------------------------------------------------------------------- */
-    const double dfStdDev =
-        nValidCount > 0 ? sqrt(dfM2 / nValidCount) : 0.0;
-
-    if( nValidCount > 0 )
+    GUIntBig nValidCount = 0;
+    if( nHistogramSize && !apoHistograms.empty() )
     {
-        if( bApproxOK )
+        std::vector<GUIntBig>& anHistogram = *(apoHistograms[0]);
+        for( size_t j = 1; j < apoHistograms.size(); ++j )
         {
-            SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+            const std::vector<GUIntBig>& anOtherHistogram = *(apoHistograms[j]);
+            for( int i = 0; i < nHistogramSize; ++i )
+                anHistogram[i] += anOtherHistogram[i];
         }
-        else if( GetMetadataItem( "STATISTICS_APPROXIMATE" ) )
+
+        for( const auto nCount: anHistogram )
+            nValidCount += nCount;
+        for( int i = 0; i < nQuantiles && nValidCount > 0; ++i )
         {
-            SetMetadataItem( "STATISTICS_APPROXIMATE",  nullptr );
+            // 1-based rank of the quantile among the sorted valid values
+            const GUIntBig nRank = std::max<GUIntBig>(1,
+                static_cast<GUIntBig>(
+                    ceil(padfProbabilities[i] *
+                         static_cast<double>(nValidCount))));
+            GUIntBig nCumulated = 0;
+            int iBucket = 0;
+            for( ; iBucket < nHistogramSize - 1; ++iBucket )
+            {
+                nCumulated += anHistogram[iBucket];
+                if( nCumulated >= nRank )
+                    break;
+            }
+            padfQuantiles[i] = iBucket + nHistogramOffset;
         }
-        SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
     }
-    else
+    else if( !nHistogramSize )
     {
-        dfMin = 0.0;
-        dfMax = 0.0;
+        oDigest.Compress();
+        nValidCount = static_cast<GUIntBig>(oDigest.GetTotalWeight());
+        for( int i = 0; i < nQuantiles && nValidCount > 0; ++i )
+            padfQuantiles[i] = oDigest.Quantile(padfProbabilities[i]);
     }
 
-    SetValidPercent( nSampleCount, nValidCount );
+    if( !pfnProgress( 1.0, "Compute Quantiles", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
 
-/* -------------------------------------------------------------------- */
-/*      Record results.                                                 */
-/* -------------------------------------------------------------------- */
-    if( pdfMin != nullptr )
-        *pdfMin = dfMin;
-    if( pdfMax != nullptr )
-        *pdfMax = dfMax;
+    if( nValidCount == 0 )
+    {
+        ReportError(
+            CE_Failure, CPLE_AppDefined,
+            "Failed to compute quantiles, no valid pixels found in sampling." );
+        return CE_Failure;
+    }
 
-    if( pdfMean != nullptr )
-        *pdfMean = dfMean;
+    SetQuantiles( nQuantiles, padfProbabilities, padfQuantiles,
+                  bApproxOK || nHistogramSize == 0 );
+    return CE_None;
+}
 
-    if( pdfStdDev != nullptr )
-        *pdfStdDev = dfStdDev;
+/************************************************************************/
+/*                          GetQuantileKey()                            */
+/************************************************************************/
 
-    if( nValidCount > 0 )
-        return CE_None;
+static std::string GetQuantileKey( double dfProbability )
+{
+    return CPLSPrintf( "STATISTICS_QUANTILE_%.10g", dfProbability );
+}
 
-    ReportError(
-        CE_Failure, CPLE_AppDefined,
-        "Failed to compute statistics, no valid pixels found in sampling." );
-    return CE_Failure;
+/************************************************************************/
+/*                           GetQuantiles()                             */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+// Fetches quantiles previously stored by SetQuantiles(). Returns false if
+// one of them is missing, or if they are approximate and bApproxOK is false.
+bool GDALRasterBand::GetQuantiles( bool bApproxOK, int nQuantiles,
+                                   const double* padfProbabilities,
+                                   double* padfQuantiles )
+{
+    if( !bApproxOK && GetMetadataItem( "STATISTICS_QUANTILES_APPROXIMATE" ) )
+        return false;
+    std::vector<double> adfQuantiles(nQuantiles);
+    for( int i = 0; i < nQuantiles; ++i )
+    {
+        const char* pszValue =
+            GetMetadataItem( GetQuantileKey(padfProbabilities[i]).c_str() );
+        if( pszValue == nullptr )
+            return false;
+        adfQuantiles[i] = CPLAtof(pszValue);
+    }
+    std::copy(adfQuantiles.begin(), adfQuantiles.end(), padfQuantiles);
+    return true;
 }
+//! @endcond
 
 /************************************************************************/
-/*                    GDALComputeRasterStatistics()                     */
+/*                           SetQuantiles()                             */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+// Stores quantiles as STATISTICS_QUANTILE_{probability} metadata items.
+void GDALRasterBand::SetQuantiles( int nQuantiles,
+                                   const double* padfProbabilities,
+                                   const double* padfQuantiles,
+                                   bool bApproximate )
+{
+    // Do not let quantiles of a previous computation be reported with
+    // the accuracy of this one.
+    const bool bWasApproximate =
+        GetMetadataItem( "STATISTICS_QUANTILES_APPROXIMATE" ) != nullptr;
+    if( bWasApproximate != bApproximate )
+    {
+        const CPLStringList aosMD(CSLDuplicate(GetMetadata()));
+        for( int i = 0; i < aosMD.size(); ++i )
+        {
+            const char* pszItem = aosMD[i];
+            if( STARTS_WITH(pszItem, "STATISTICS_QUANTILE_") )
+            {
+                char* pszKey = nullptr;
+                CPLParseNameValue( pszItem, &pszKey );
+                if( pszKey )
+                    SetMetadataItem( pszKey, nullptr );
+                CPLFree( pszKey );
+            }
+        }
+    }
+
+    for( int i = 0; i < nQuantiles; ++i )
+    {
+        const std::string osKey = GetQuantileKey(padfProbabilities[i]);
+        char szValue[128] = { 0 };
+        CPLsnprintf( szValue, sizeof(szValue), "%.14g", padfQuantiles[i] );
+        SetMetadataItem( osKey.c_str(), szValue );
+    }
+    if( bApproximate )
+    {
+        SetMetadataItem( "STATISTICS_QUANTILES_APPROXIMATE", "YES" );
+    }
+    else if( GetMetadataItem( "STATISTICS_QUANTILES_APPROXIMATE" ) )
+    {
+        SetMetadataItem( "STATISTICS_QUANTILES_APPROXIMATE", nullptr );
+    }
+}
+//! @endcond
+
+/************************************************************************/
+/*                     GDALComputeRasterQuantiles()                     */
 /************************************************************************/
 
 /**
-  * \brief Compute image statistics.
+  * \brief Compute quantiles of the pixel values.
   *
-  * @see GDALRasterBand::ComputeStatistics()
+  * @see GDALRasterBand::ComputeQuantiles()
+  * @since GDAL 3.7
   */
 
-CPLErr CPL_STDCALL GDALComputeRasterStatistics(
+CPLErr CPL_STDCALL GDALComputeRasterQuantiles(
         GDALRasterBandH hBand, int bApproxOK,
-        double *pdfMin, double *pdfMax, double *pdfMean, double *pdfStdDev,
+        int nQuantiles, const double *padfProbabilities,
+        double *padfQuantiles,
         GDALProgressFunc pfnProgress, void *pProgressData )
 
 {
-    VALIDATE_POINTER1( hBand, "GDALComputeRasterStatistics", CE_Failure );
+    VALIDATE_POINTER1( hBand, "GDALComputeRasterQuantiles", CE_Failure );
 
     GDALRasterBand *poBand = GDALRasterBand::FromHandle(hBand);
 
-    return poBand->ComputeStatistics(
-        bApproxOK, pdfMin, pdfMax, pdfMean, pdfStdDev,
+    return poBand->ComputeQuantiles(
+        bApproxOK, nQuantiles, padfProbabilities, padfQuantiles,
         pfnProgress, pProgressData );
 }
 
+/************************************************************************/
+/*                       Statistics on write                            */
+/************************************************************************/
+
+// When the GDAL_STATISTICS_ON_WRITE configuration option is set to YES,
+// the statistics of the blocks written by IWriteBlock() are computed from
+// the block buffers while they are still in memory. They are kept per
+// block, so that a rewritten block replaces its previous contribution, and
+// are merged in block order and set on the band (with SetStatistics(), and
+// SetDefaultHistogram() for Byte bands) when its cache is flushed at
+// closing, so that no second pass over the written data is needed.
+
+namespace
+{
+
+struct GDALWriteBlockStats
+{
+    GDALBlockStats sStats{};
+    std::vector<GUInt32> anHistogram{};  // Only for (unsigned) Byte bands
+};
+
+} // namespace
+
+// Blocks may be written by the thread evicting them from the block cache:
+// the nodata value and pixel type are captured once by the thread owning
+// the band, and the block statistics are protected by a mutex.
+struct GDALWriteStatsState
+{
+    bool bHasNoData = false;
+    double dfNoData = 0.0;
+    bool bGotNoDataValue = false;
+    bool bGotFloatNoDataValue = false;
+    float fNoDataValue = 0.0f;
+    bool bSignedByte = false;
+
+    std::mutex oMutex{};
+    bool bDisabled = false;
+    std::map<int, GDALWriteBlockStats> oMapBlockStats{};
+};
+
+static void GDALWriteStatisticsFree(GDALWriteStatsState* psState)
+{
+    delete psState;
+}
+
+/************************************************************************/
+/*                        InitWriteStatistics()                         */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+// Called by InitBlockInfo(), in the thread owning the band.
+void GDALRasterBand::InitWriteStatistics()
+{
+    if( m_poWriteStats != nullptr || poDS == nullptr ||
+        poDS->GetAccess() != GA_Update || nBand < 1 ||
+        poDS->GetRasterBand(nBand) != this ||
+        !CPLTestBool(CPLGetConfigOption("GDAL_STATISTICS_ON_WRITE", "NO")) )
+    {
+        return;
+    }
+
+    m_poWriteStats = new GDALWriteStatsState();
+    int bHasNoData = FALSE;
+    m_poWriteStats->dfNoData = GetNoDataValue( &bHasNoData );
+    m_poWriteStats->bHasNoData = CPL_TO_BOOL(bHasNoData);
+    int bGotNoDataValue = bHasNoData && !CPLIsNan(m_poWriteStats->dfNoData);
+    ComputeFloatNoDataValue( eDataType, m_poWriteStats->dfNoData,
+                             bGotNoDataValue,
+                             m_poWriteStats->fNoDataValue,
+                             m_poWriteStats->bGotFloatNoDataValue );
+    m_poWriteStats->bGotNoDataValue = CPL_TO_BOOL(bGotNoDataValue);
+
+    if( eDataType == GDT_Byte )
+    {
+        EnablePixelTypeSignedByteWarning(false);
+        const char* pszPixelType =
+            GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+        EnablePixelTypeSignedByteWarning(true);
+        m_poWriteStats->bSignedByte =
+            pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
+    }
+}
+
+/************************************************************************/
+/*                       DisableWriteStatistics()                       */
+/************************************************************************/
+
+// Forgets the statistics of the blocks written so far, and ignores the
+// blocks written afterwards.
+void GDALRasterBand::DisableWriteStatistics()
+{
+    if( m_poWriteStats == nullptr )
+        return;
+    std::lock_guard<std::mutex> oLock(m_poWriteStats->oMutex);
+    m_poWriteStats->bDisabled = true;
+    m_poWriteStats->oMapBlockStats.clear();
+}
+
+/************************************************************************/
+/*                       UpdateWriteStatistics()                        */
+/************************************************************************/
+
+// Records the statistics of a block about to be written by IWriteBlock().
+// Called by GDALRasterBlock::Write(), and by drivers that write cached
+// blocks of several bands at once.
+void GDALRasterBand::UpdateWriteStatistics( int nXBlockOff, int nYBlockOff,
+                                            const void* pData )
+{
+    GDALWriteStatsState* const psState = m_poWriteStats;
+    if( psState == nullptr )
+        return;
+
+    int nXCheck = 0;
+    int nYCheck = 0;
+    if( GetActualBlockSize(nXBlockOff, nYBlockOff,
+                           &nXCheck, &nYCheck) != CE_None )
+        return;
+
+    GDALWriteBlockStats sBlockStats;
+    ComputeBlockStatistics( pData, eDataType, psState->bSignedByte,
+                            nXCheck, nYCheck, nBlockXSize,
+                            psState->bGotNoDataValue, psState->dfNoData,
+                            psState->bGotFloatNoDataValue,
+                            psState->fNoDataValue,
+                            sBlockStats.sStats );
+    if( eDataType == GDT_Byte && !psState->bSignedByte )
+    {
+        const double dfNoData = psState->dfNoData;
+        const int nNoData =
+            (psState->bGotNoDataValue && GDALIsValueInRange<GByte>(dfNoData) &&
+             dfNoData == static_cast<int>(dfNoData)) ?
+                static_cast<int>(dfNoData) : -1;
+        sBlockStats.anHistogram.resize(256);
+        for( int iY = 0; iY < nYCheck; iY++ )
+        {
+            const GByte* pabyLine = static_cast<const GByte*>(pData) +
+                static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+            for( int iX = 0; iX < nXCheck; iX++ )
+                sBlockStats.anHistogram[pabyLine[iX]]++;
+        }
+        if( nNoData >= 0 )
+            sBlockStats.anHistogram[nNoData] = 0;
+    }
+
+    const int nBlockId = nXBlockOff + nYBlockOff * nBlocksPerRow;
+    std::lock_guard<std::mutex> oLock(psState->oMutex);
+    if( !psState->bDisabled )
+        psState->oMapBlockStats[nBlockId] = std::move(sBlockStats);
+}
+
+/************************************************************************/
+/*                        FlushWriteStatistics()                        */
+/************************************************************************/
+
+// Sets the statistics accumulated by UpdateWriteStatistics() on the band,
+// provided that all its blocks have been written with the current nodata
+// value and pixel type.
+void GDALRasterBand::FlushWriteStatistics()
+{
+    if( m_poWriteStats == nullptr )
+        return;
+    std::map<int, GDALWriteBlockStats> oMapBlockStats;
+    {
+        std::lock_guard<std::mutex> oLock(m_poWriteStats->oMutex);
+        if( m_poWriteStats->bDisabled ||
+            m_poWriteStats->oMapBlockStats.empty() )
+            return;
+        std::swap(oMapBlockStats, m_poWriteStats->oMapBlockStats);
+    }
+
+    if( static_cast<GIntBig>(oMapBlockStats.size()) !=
+            static_cast<GIntBig>(nBlocksPerRow) * nBlocksPerColumn )
+    {
+        CPLDebug("GDAL", "Statistics on write not set on band %d: "
+                 "not all blocks have been written", nBand);
+        return;
+    }
+
+    int bHasNoData = FALSE;
+    const double dfNoData = GetNoDataValue( &bHasNoData );
+    const double dfWrittenNoData = m_poWriteStats->dfNoData;
+    bool bSignedByte = false;
+    if( eDataType == GDT_Byte )
+    {
+        EnablePixelTypeSignedByteWarning(false);
+        const char* pszPixelType =
+            GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+        EnablePixelTypeSignedByteWarning(true);
+        bSignedByte =
+            pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
+    }
+    if( m_poWriteStats->bHasNoData != CPL_TO_BOOL(bHasNoData) ||
+        (bHasNoData && !(dfWrittenNoData == dfNoData ||
+                         (CPLIsNan(dfWrittenNoData) && CPLIsNan(dfNoData)))) ||
+        m_poWriteStats->bSignedByte != bSignedByte )
+    {
+        CPLDebug("GDAL", "Statistics on write not set on band %d: "
+                 "nodata value or pixel type changed after the first "
+                 "block access", nBand);
+        return;
+    }
+
+    GDALBlockStats sStats;
+    std::vector<GUIntBig> anHistogram;
+    for( const auto& oKV: oMapBlockStats )
+    {
+        sStats.Merge(oKV.second.sStats);
+        if( !oKV.second.anHistogram.empty() )
+        {
+            anHistogram.resize(oKV.second.anHistogram.size());
+            for( size_t i = 0; i < anHistogram.size(); ++i )
+                anHistogram[i] += oKV.second.anHistogram[i];
+        }
+    }
+
+    if( sStats.nValidCount > 0 )
+    {
+        if( GetMetadataItem( "STATISTICS_APPROXIMATE" ) )
+            SetMetadataItem( "STATISTICS_APPROXIMATE", nullptr );
+        SetStatistics( sStats.dfMin, sStats.dfMax, sStats.dfMean,
+                       sqrt(sStats.dfM2 / sStats.nValidCount) );
+    }
+    SetValidPercent( sStats.nSampleCount, sStats.nValidCount );
+
+    if( !anHistogram.empty() )
+    {
+        // Not all drivers can store a histogram: do not make it an error.
+        CPLErrorStateBackuper oErrorStateBackuper;
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        SetDefaultHistogram( -0.5, 255.5, 256, anHistogram.data() );
+        CPLPopErrorHandler();
+    }
+}
+//! @endcond
+
 /************************************************************************/
 /*                           SetStatistics()                            */
 /************************************************************************/
@@ -6107,10 +7783,18 @@ static void ComputeMinMaxGeneric(const void* pData,
                 bGotNoDataValue, dfNoDataValue, false, 0, dfMin, dfMax);
             break;
         case GDT_Int32:
-            ComputeMinMaxGeneric<GDT_Int32, false>(
-                pData, nXCheck, nYCheck, nBlockXSize,
-                bGotNoDataValue, dfNoDataValue, false, 0, dfMin, dfMax);
+        {
+            GDALBlockStats sStats;
+            sStats.dfMin = dfMin;
+            sStats.dfMax = dfMax;
+            ComputeBlockStats(static_cast<const GInt32*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotNoDataValue, dfNoDataValue,
+                              /* bComputeOtherStats = */ false, sStats);
+            dfMin = sStats.dfMin;
+            dfMax = sStats.dfMax;
             break;
+        }
         case GDT_UInt64:
             ComputeMinMaxGeneric<GDT_UInt64, false>(
                 pData, nXCheck, nYCheck, nBlockXSize,
@@ -6122,15 +7806,31 @@ static void ComputeMinMaxGeneric(const void* pData,
                 bGotNoDataValue, dfNoDataValue, false, 0, dfMin, dfMax);
             break;
         case GDT_Float32:
-            ComputeMinMaxGeneric<GDT_Float32, false>(
-                pData, nXCheck, nYCheck, nBlockXSize,
-                false, 0, bGotFloatNoDataValue, fNoDataValue, dfMin, dfMax);
+        {
+            GDALBlockStats sStats;
+            sStats.dfMin = dfMin;
+            sStats.dfMax = dfMax;
+            ComputeBlockStats(static_cast<const float*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotFloatNoDataValue, fNoDataValue,
+                              /* bComputeOtherStats = */ false, sStats);
+            dfMin = sStats.dfMin;
+            dfMax = sStats.dfMax;
             break;
+        }
         case GDT_Float64:
-            ComputeMinMaxGeneric<GDT_Float64, false>(
-                pData, nXCheck, nYCheck, nBlockXSize,
-                bGotNoDataValue, dfNoDataValue, false, 0, dfMin, dfMax);
+        {
+            GDALBlockStats sStats;
+            sStats.dfMin = dfMin;
+            sStats.dfMax = dfMax;
+            ComputeBlockStats(static_cast<const double*>(pData),
+                              nXCheck, nYCheck, nBlockXSize,
+                              bGotNoDataValue, dfNoDataValue,
+                              /* bComputeOtherStats = */ false, sStats);
+            dfMin = sStats.dfMin;
+            dfMax = sStats.dfMax;
             break;
+        }
         case GDT_CInt16:
             ComputeMinMaxGeneric<GDT_CInt16, false>(
                 pData, nXCheck, nYCheck, nBlockXSize,
@@ -6163,7 +7863,6 @@ ComputeMinMaxGenericIterBlocks(GDALRasterBand* poBand,
                                bool bSignedByte,
                                            int nTotalBlocks,
                                            int nSampleRate,
-                                           int nBlocksPerRow,
                                            bool bGotNoDataValue,
                                            double dfNoDataValue,
                                            bool bGotFloatNoDataValue,
@@ -6174,31 +7873,46 @@ ComputeMinMaxGenericIterBlocks(GDALRasterBand* poBand,
 {
     int nBlockXSize, nBlockYSize;
     poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
-    for( int iSampleBlock = 0;
-         iSampleBlock < nTotalBlocks;
-         iSampleBlock += nSampleRate )
-    {
-        const int iYBlock = iSampleBlock / nBlocksPerRow;
-        const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-        GDALRasterBlock *poBlock = poBand->GetLockedBlockRef( iXBlock, iYBlock );
-        if( poBlock == nullptr )
-            return false;
-
-        void * const pData = poBlock->GetDataRef();
 
-        int nXCheck = 0, nYCheck = 0;
-        poBand->GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+    // Per sampled block min/max.
+    std::vector<std::pair<double, double>> aoMinMax;
+    try
+    {
+        aoMinMax.resize(DIV_ROUND_UP(nTotalBlocks, nSampleRate));
+    }
+    catch( const std::exception& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory, "Out of memory" );
+        return false;
+    }
 
+    const auto ProcessBlock = [&aoMinMax, eDataType, bSignedByte,
+                               nBlockXSize, bGotNoDataValue, dfNoDataValue,
+                               bGotFloatNoDataValue, fNoDataValue]
+        (int iSample, const void* pData, int nXCheck, int nYCheck)
+    {
+        double dfBlockMin = std::numeric_limits<double>::max();
+        double dfBlockMax = -std::numeric_limits<double>::max();
         ComputeMinMaxGeneric(pData, eDataType, bSignedByte,
                              nXCheck, nYCheck, nBlockXSize,
-                             CPL_TO_BOOL(bGotNoDataValue),
+                             bGotNoDataValue,
                              dfNoDataValue,
                              bGotFloatNoDataValue,
                              fNoDataValue,
-                             dfMin, dfMax);
+                             dfBlockMin, dfBlockMax);
+        aoMinMax[iSample] = std::pair<double, double>(dfBlockMin, dfBlockMax);
+    };
+
+    if( !ForEachSampledBlock(poBand, nSampleRate, ProcessBlock,
+                             [](double) { return true; }) )
+    {
+        return false;
+    }
 
-        poBlock->DropLock();
+    for( const auto& oMinMax: aoMinMax )
+    {
+        dfMin = std::min(dfMin, oMinMax.first);
+        dfMax = std::max(dfMax, oMinMax.second);
     }
     return true;
 }
@@ -6214,6 +7928,10 @@ ComputeMinMaxGenericIterBlocks(GDALRasterBand* poBand,
  * If bApprox is FALSE, then all pixels will be read and used to compute
  * an exact range.
  *
+ * Starting with GDAL 3.7, if the GDAL_NUM_THREADS configuration option is set
+ * to ALL_CPUS or a value greater than one, the blocks, which are still read
+ * by the calling thread, are processed by several threads.
+ *
  * This method is the same as the C function GDALComputeRasterMinMax().
  *
  * @param bApproxOK TRUE if an approximate (faster) answer is OK, otherwise
@@ -6295,9 +8013,9 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
 
     const auto ComputeMinMaxForBlock = [
         this, bSignedByte,
-        bGotNoDataValue, dfNoDataValue,
-        &nMin, &nMax, &nMinInt16, &nMaxInt16]
-        (const void* pData, int nXCheck, int nBufferWidth, int nYCheck)
+        bGotNoDataValue, dfNoDataValue]
+        (const void* pData, int nXCheck, int nBufferWidth, int nYCheck,
+         GUInt32& nBlockMin, GUInt32& nBlockMax, GInt16& nBlockMinInt16, GInt16& nBlockMaxInt16)
     {
         if( eDataType == GDT_Byte && !bSignedByte )
         {
@@ -6312,8 +8030,8 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
                 static_cast<const GByte*>(pData),
                 bHasNoData,
                 nNoDataValue,
-                nMin,
-                nMax,
+                nBlockMin,
+                nBlockMax,
                 nSum, nSumSquare, nSampleCount, nValidCount);
         }
         else if( eDataType == GDT_UInt16 )
@@ -6329,8 +8047,8 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
                 static_cast<const GUInt16*>(pData),
                 bHasNoData,
                 nNoDataValue,
-                nMin,
-                nMax,
+                nBlockMin,
+                nBlockMax,
                 nSum, nSumSquare, nSampleCount, nValidCount);
         }
         else if( eDataType == GDT_Int16 )
@@ -6348,8 +8066,8 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
                         static_cast<const int16_t*>(pData) + static_cast<size_t>(iY) * nBufferWidth,
                         nXCheck,
                         nNoDataValue,
-                        &nMinInt16,
-                        &nMaxInt16);
+                        &nBlockMinInt16,
+                        &nBlockMaxInt16);
                 }
             }
             else
@@ -6360,8 +8078,8 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
                         static_cast<const int16_t*>(pData) + static_cast<size_t>(iY) * nBufferWidth,
                         nXCheck,
                         0,
-                        &nMinInt16,
-                        &nMaxInt16);
+                        &nBlockMinInt16,
+                        &nBlockMaxInt16);
                 }
             }
         }
@@ -6406,7 +8124,8 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
 
         if( bUseOptimizedPath )
         {
-            ComputeMinMaxForBlock(pData, nXReduced, nXReduced, nYReduced);
+            ComputeMinMaxForBlock(pData, nXReduced, nXReduced, nYReduced,
+                                  nMin, nMax, nMinInt16, nMaxInt16);
         }
         else
         {
@@ -6449,28 +8168,63 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
 
         if( bUseOptimizedPath )
         {
-            for( int iSampleBlock = 0;
-                 iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-                 iSampleBlock += nSampleRate )
+            // Per sampled block min/max.
+            struct IntegerMinMax
             {
-                const int iYBlock = iSampleBlock / nBlocksPerRow;
-                const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-                GDALRasterBlock *poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-                if( poBlock == nullptr )
-                    return CE_Failure;
-
-                void * const pData = poBlock->GetDataRef();
-
-                int nXCheck = 0, nYCheck = 0;
-                GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+                GUInt32 nMin;
+                GUInt32 nMax;
+                GInt16  nMinInt16;
+                GInt16  nMaxInt16;
+            };
+            std::vector<IntegerMinMax> asMinMax;
+            try
+            {
+                asMinMax.resize(DIV_ROUND_UP(nBlocksPerRow * nBlocksPerColumn,
+                                             nSampleRate));
+            }
+            catch( const std::exception& )
+            {
+                ReportError( CE_Failure, CPLE_OutOfMemory, "Out of memory" );
+                return CE_Failure;
+            }
+            for( auto& sMinMax: asMinMax )
+            {
+                sMinMax.nMin = nMin;
+                sMinMax.nMax = nMax;
+                sMinMax.nMinInt16 = nMinInt16;
+                sMinMax.nMaxInt16 = nMaxInt16;
+            }
 
-                ComputeMinMaxForBlock(pData, nXCheck, nBlockXSize, nYCheck);
+            // Set as soon as a Byte block reaches the [0,255] full range.
+            std::atomic<bool> bFullRange{false};
+            const auto ProcessBlock = [this, &ComputeMinMaxForBlock,
+                                       &asMinMax, &bFullRange, bSignedByte]
+                (int iSample, const void* pData, int nXCheck, int nYCheck)
+            {
+                IntegerMinMax& sMinMax = asMinMax[iSample];
+                ComputeMinMaxForBlock(pData, nXCheck, nBlockXSize, nYCheck,
+                                      sMinMax.nMin, sMinMax.nMax,
+                                      sMinMax.nMinInt16, sMinMax.nMaxInt16);
+                if( eDataType == GDT_Byte && !bSignedByte &&
+                    sMinMax.nMin == 0 && sMinMax.nMax == 255 )
+                {
+                    bFullRange = true;
+                }
+            };
 
-                poBlock->DropLock();
+            if( !ForEachSampledBlock(this, nSampleRate, ProcessBlock,
+                                     [&bFullRange](double)
+                                     { return !bFullRange; }) )
+            {
+                return CE_Failure;
+            }
 
-                if( eDataType == GDT_Byte && !bSignedByte && nMin == 0 && nMax == 255 )
-                    break;
+            for( const auto& sMinMax: asMinMax )
+            {
+                nMin = std::min(nMin, sMinMax.nMin);
+                nMax = std::max(nMax, sMinMax.nMax);
+                nMinInt16 = std::min(nMinInt16, sMinMax.nMinInt16);
+                nMaxInt16 = std::max(nMaxInt16, sMinMax.nMaxInt16);
             }
         }
         else
@@ -6480,7 +8234,6 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
                                                 bSignedByte,
                                                 nTotalBlocks,
                                                 nSampleRate,
-                                                nBlocksPerRow,
                                                 CPL_TO_BOOL(bGotNoDataValue),
                                                 dfNoDataValue,
                                                 bGotFloatNoDataValue,
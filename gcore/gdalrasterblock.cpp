@@ -33,8 +33,15 @@
 #include "gdal_priv.h"
 
 #include <algorithm>
+#include <atomic>
 #include <climits>
+#include <cstdint>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
@@ -47,21 +54,269 @@
 static bool bCacheMaxInitialized = false;
 // Will later be overridden by the default 5% if GDAL_CACHEMAX not defined.
 static GIntBig nCacheMax = 40 * 1024 * 1024;
-static GIntBig nCacheUsed = 0;
+static std::atomic<GIntBig> nCacheUsed{0};
+// Part of nCacheUsed used by probation lists of the 2Q policy.
+static std::atomic<GIntBig> nCacheProbationUsed{0};
 
-static GDALRasterBlock *poOldest = nullptr;  // Tail.
-static GDALRasterBlock *poNewest = nullptr;  // Head.
+// Incremented each time a new block enters the cache. Blocks are stamped
+// with it when touched, which gives an approximate global LRU order across
+// shards without requiring a global lock.
+static std::atomic<GUIntBig> nCacheTick{0};
 
 static int nDisableDirtyBlockFlushCounter = 0;
 
-#if 0
-static CPLMutex *hRBLock = nullptr;
-#define INITIALIZE_LOCK CPLMutexHolderD( &hRBLock )
-#define TAKE_LOCK       CPLMutexHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK    CPLDestroyMutex( hRBLock )
-#else
+/* -------------------------------------------------------------------- */
+/*      The LRU list of cached blocks is split into several shards,     */
+/*      each with its own lock, so that threads working on different    */
+/*      bands/datasets do not contend on a single process-wide lock.    */
+/*      All the blocks of a given band belong to the same shard.        */
+/*      The GDAL_CACHEMAX limit remains global: when it is exceeded,    */
+/*      blocks are evicted from the shard holding the least recently    */
+/*      used block.                                                     */
+/*                                                                      */
+/*      The eviction policy within a shard is selected with the         */
+/*      GDAL_BLOCK_CACHE_POLICY configuration option:                   */
+/*      - LRU (default): a single least recently used list.             */
+/*      - 2Q: the "full 2Q" algorithm of Johnson and Shasha. Blocks     */
+/*        enter a FIFO probation list, and only reach the main LRU      */
+/*        list when re-referenced after having been evicted from the    */
+/*        probation list (which is remembered in a ghost list). This    */
+/*        prevents a single pass over a large raster from evicting the  */
+/*        blocks that are frequently accessed.                          */
+/* -------------------------------------------------------------------- */
+
+namespace {
+enum class BlockCachePolicy
+{
+    LRU,
+    TWO_Q
+};
+} // namespace
+
+static BlockCachePolicy GetCachePolicy()
+{
+    static const BlockCachePolicy ePolicy = []()
+    {
+        const char* pszPolicy =
+            CPLGetConfigOption("GDAL_BLOCK_CACHE_POLICY", "LRU");
+        if( EQUAL(pszPolicy, "2Q") )
+            return BlockCachePolicy::TWO_Q;
+        if( !EQUAL(pszPolicy, "LRU") )
+        {
+            CPLError(
+                CE_Warning, CPLE_NotSupported,
+                "GDAL_BLOCK_CACHE_POLICY=%s not supported. Falling back to LRU",
+                pszPolicy);
+        }
+        return BlockCachePolicy::LRU;
+    }();
+    return ePolicy;
+}
+
+namespace {
+struct GhostKey
+{
+    const GDALRasterBand *poBand;
+    int                   nXOff;
+    int                   nYOff;
+
+    bool operator==(const GhostKey& other) const
+    {
+        return poBand == other.poBand && nXOff == other.nXOff &&
+               nYOff == other.nYOff;
+    }
+};
+
+struct GhostKeyHasher
+{
+    size_t operator()(const GhostKey& k) const
+    {
+        return std::hash<const void*>()(k.poBand) ^
+               (std::hash<int>()(k.nXOff) << 1) ^
+               (std::hash<int>()(k.nYOff) << 2);
+    }
+};
+} // namespace
+
+struct GDALRasterBlockCacheShard
+{
+    CPLLock         *hLock = nullptr;
+
+    // Main LRU list.
+    GDALRasterBlock *poOldest = nullptr;  // Tail.
+    GDALRasterBlock *poNewest = nullptr;  // Head.
+
+    // 2Q policy only: FIFO of blocks that were referenced only once.
+    GDALRasterBlock *poProbationOldest = nullptr;
+    GDALRasterBlock *poProbationNewest = nullptr;
+
+    // Protected by hLock.
+    GIntBig          nUsed = 0;
+    GIntBig          nProbationUsed = 0;
+    int              nBlockCount = 0;
+
+    // Touch tick of the tail of the main and probation lists, or UINT64_MAX
+    // if they are empty. May be read without holding hLock.
+    std::atomic<GUIntBig> nOldestTick{std::numeric_limits<GUIntBig>::max()};
+    std::atomic<GUIntBig> nProbationOldestTick{
+                                        std::numeric_limits<GUIntBig>::max()};
+
+    // 2Q policy only: blocks recently evicted from the probation list,
+    // with their eviction sequence number. Protected by hLock.
+    std::unordered_map<GhostKey, GUIntBig, GhostKeyHasher> oGhosts{};
+    std::deque<std::pair<GhostKey, GUIntBig>> aoGhostQueue{};
+    GUIntBig         nGhostSeq = 0;
+
+    void UpdateOldestTick()
+    {
+        nOldestTick = poOldest ? poOldest->nTouchTick :
+                                 std::numeric_limits<GUIntBig>::max();
+        nProbationOldestTick = poProbationOldest ?
+                                 poProbationOldest->nTouchTick :
+                                 std::numeric_limits<GUIntBig>::max();
+    }
+
+    void Link( GDALRasterBlock* poBlock, bool bProbation )
+    {
+        GDALRasterBlock*& poHead = bProbation ? poProbationNewest : poNewest;
+        GDALRasterBlock*& poTail = bProbation ? poProbationOldest : poOldest;
+
+        poBlock->bProbation = bProbation;
+        poBlock->nTouchTick = nCacheTick.load(std::memory_order_relaxed);
+        poBlock->poPrevious = nullptr;
+        poBlock->poNext = poHead;
+        if( poHead != nullptr )
+        {
+            CPLAssert( poHead->poPrevious == nullptr );
+            poHead->poPrevious = poBlock;
+        }
+        poHead = poBlock;
+        if( poTail == nullptr )
+            poTail = poBlock;
+
+        ++nBlockCount;
+        UpdateOldestTick();
+    }
+
+    void Unlink( GDALRasterBlock* poBlock )
+    {
+        GDALRasterBlock*& poHead =
+            poBlock->bProbation ? poProbationNewest : poNewest;
+        GDALRasterBlock*& poTail =
+            poBlock->bProbation ? poProbationOldest : poOldest;
+
+        const bool bLinked = poBlock->poPrevious != nullptr ||
+                             poBlock->poNext != nullptr || poHead == poBlock;
+
+        if( poTail == poBlock )
+            poTail = poBlock->poPrevious;
+
+        if( poHead == poBlock )
+            poHead = poBlock->poNext;
+
+        if( poBlock->poPrevious != nullptr )
+            poBlock->poPrevious->poNext = poBlock->poNext;
+
+        if( poBlock->poNext != nullptr )
+            poBlock->poNext->poPrevious = poBlock->poPrevious;
+
+        poBlock->poPrevious = nullptr;
+        poBlock->poNext = nullptr;
+
+        if( bLinked )
+        {
+            --nBlockCount;
+            UpdateOldestTick();
+        }
+    }
+
+    // Remember a block evicted from the probation list.
+    void AddGhost( const GDALRasterBlock* poBlock )
+    {
+        const GhostKey oKey{poBlock->poBand, poBlock->nXOff, poBlock->nYOff};
+        ++nGhostSeq;
+        oGhosts[oKey] = nGhostSeq;
+        aoGhostQueue.emplace_back(oKey, nGhostSeq);
+
+        // Remember at most as many evicted blocks as half the number of
+        // cached blocks.
+        const size_t nMaxGhosts =
+            static_cast<size_t>(std::max(64, nBlockCount / 2));
+        while( aoGhostQueue.size() > nMaxGhosts )
+        {
+            const auto& oOldest = aoGhostQueue.front();
+            auto oIter = oGhosts.find(oOldest.first);
+            if( oIter != oGhosts.end() && oIter->second == oOldest.second )
+                oGhosts.erase(oIter);
+            aoGhostQueue.pop_front();
+        }
+    }
+
+    // Return whether the block was recently evicted from the probation
+    // list, and forget about it.
+    bool RemoveGhost( const GDALRasterBlock* poBlock )
+    {
+        return oGhosts.erase(
+            GhostKey{poBlock->poBand, poBlock->nXOff, poBlock->nYOff}) > 0;
+    }
+
+    // Forget about the evicted blocks of a band.
+    void DropGhosts( const GDALRasterBand* poBand )
+    {
+        for( auto oIter = oGhosts.begin(); oIter != oGhosts.end(); )
+        {
+            if( oIter->first.poBand == poBand )
+                oIter = oGhosts.erase(oIter);
+            else
+                ++oIter;
+        }
+    }
+
+    // Position cursors at the tail of the lists, for iteration with
+    // NextEvictionCandidate().
+    void InitCursors( GDALRasterBlock* apoCursor[2] ) const
+    {
+        apoCursor[0] = poProbationOldest;
+        apoCursor[1] = poOldest;
+    }
+
+    // Return the next block accepted by oFilter whose lock could be taken
+    // for eviction, or nullptr. The list to look into first is given by
+    // ProbationFirst().
+    template<class Filter> GDALRasterBlock* NextEvictionCandidate(
+                            GDALRasterBlock* apoCursor[2], bool bProbationFirst,
+                            Filter oFilter )
+    {
+        const int iFirst = bProbationFirst ? 0 : 1;
+        for( int k = 0; k < 2; ++k )
+        {
+            GDALRasterBlock*& poCursor = apoCursor[(iFirst + k) % 2];
+            while( poCursor != nullptr )
+            {
+                GDALRasterBlock* poCandidate = poCursor;
+                poCursor = poCursor->poPrevious;
+                if( oFilter(poCandidate) &&
+                    CPLAtomicCompareAndExchange(
+                        &(poCandidate->nLockCount), 0, -1) )
+                {
+                    return poCandidate;
+                }
+            }
+        }
+        return nullptr;
+    }
+};
+
+// With the 2Q policy, blocks are evicted from the probation lists as long as
+// they use more than 25% of the cache.
+static bool ProbationFirst()
+{
+    return nCacheProbationUsed > nCacheUsed / 4;
+}
+
+constexpr int MAX_SHARD_COUNT = 64;
+static GDALRasterBlockCacheShard aoShards[MAX_SHARD_COUNT];
 
-static CPLLock* hRBLock = nullptr;
 static bool bDebugContention = false;
 static bool bSleepsForBockCacheDebug = false;
 static CPLLockType GetLockType()
@@ -91,12 +346,99 @@ static CPLLockType GetLockType()
     return static_cast<CPLLockType>(nLockType);
 }
 
-#define INITIALIZE_LOCK         CPLLockHolderD( &hRBLock, GetLockType() ); \
-                                CPLLockSetDebugPerf(hRBLock, bDebugContention)
-#define TAKE_LOCK               CPLLockHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK            CPLDestroyLock( hRBLock )
+/************************************************************************/
+/*                           GetShardCount()                            */
+/************************************************************************/
+
+// Number of shards of the block cache. Always a power of two.
+static int GetShardCount()
+{
+    static const int nShardCount = []()
+    {
+        const char* pszShards =
+            CPLGetConfigOption("GDAL_BLOCK_CACHE_SHARDS", nullptr);
+        int nRequested = pszShards ? atoi(pszShards) : CPLGetNumCPUs();
+        nRequested = std::max(1, std::min(MAX_SHARD_COUNT, nRequested));
+        int nCount = 1;
+        while( nCount < nRequested )
+            nCount *= 2;
+        return nCount;
+    }();
+    return nShardCount;
+}
 
-#endif
+/************************************************************************/
+/*                              GetShard()                              */
+/************************************************************************/
+
+static GDALRasterBlockCacheShard& GetShard( const GDALRasterBand* poBand )
+{
+    const int nShardCount = GetShardCount();
+    if( nShardCount == 1 )
+        return aoShards[0];
+    // Fibonacci hashing of the band address.
+    const GUIntBig nHash = static_cast<GUIntBig>(
+        reinterpret_cast<std::uintptr_t>(poBand)) * 11400714819323198485ULL;
+    return aoShards[static_cast<int>(nHash >> 40) & (nShardCount - 1)];
+}
+
+/************************************************************************/
+/*                          GetShardsByAge()                            */
+/************************************************************************/
+
+// Fill panShards with the indices of the shards, sorted from the one
+// holding the least recently used block to the most recently used one,
+// considering first the probation or the main lists.
+static int GetShardsByAge( int* panShards, bool bProbationFirst )
+{
+    const int nShardCount = GetShardCount();
+    for( int i = 0; i < nShardCount; ++i )
+        panShards[i] = i;
+    if( nShardCount > 1 )
+    {
+        GUIntBig anTicks[MAX_SHARD_COUNT];
+        for( int i = 0; i < nShardCount; ++i )
+        {
+            anTicks[i] = bProbationFirst ? aoShards[i].nProbationOldestTick :
+                                           aoShards[i].nOldestTick;
+        }
+        std::sort(panShards, panShards + nShardCount,
+                  [&anTicks](int a, int b) { return anTicks[a] < anTicks[b]; });
+    }
+    return nShardCount;
+}
+
+static void InitializeLocks()
+{
+    const int nShardCount = GetShardCount();
+    for( int i = 0; i < nShardCount; ++i )
+    {
+        if( aoShards[i].hLock == nullptr )
+        {
+            CPLLockHolderD( &(aoShards[i].hLock), GetLockType() );
+            CPLLockSetDebugPerf(aoShards[i].hLock, bDebugContention);
+        }
+    }
+}
+
+#define INITIALIZE_LOCK         InitializeLocks()
+#define TAKE_LOCK(oShard)       CPLLockHolderOptionalLockD( (oShard).hLock )
+
+/************************************************************************/
+/*                    GDALRasterBlockCacheDropBand()                    */
+/************************************************************************/
+
+// Called when a band is destroyed. Ghost entries are keyed by the band
+// address, so they must be removed for a band later allocated at the same
+// address not to inherit them.
+void GDALRasterBlockCacheDropBand( const GDALRasterBand* poBand )
+{
+    if( GetCachePolicy() != BlockCachePolicy::TWO_Q )
+        return;
+    GDALRasterBlockCacheShard& oShard = GetShard(poBand);
+    TAKE_LOCK(oShard);
+    oShard.DropGhosts(poBand);
+}
 
 //#define ENABLE_DEBUG
 
@@ -323,7 +665,8 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 
 int CPL_STDCALL GDALGetCacheUsed()
 {
-    if (nCacheUsed > INT_MAX)
+    const GIntBig nCurCacheUsed = nCacheUsed;
+    if (nCurCacheUsed > INT_MAX)
     {
         static bool bHasWarned = false;
         if (!bHasWarned)
@@ -335,7 +678,7 @@ int CPL_STDCALL GDALGetCacheUsed()
         }
         return INT_MAX;
     }
-    return static_cast<int>(nCacheUsed);
+    return static_cast<int>(nCurCacheUsed);
 }
 
 /************************************************************************/
@@ -374,6 +717,52 @@ int CPL_STDCALL GDALFlushCacheBlock()
     return GDALRasterBlock::FlushCacheBlock();
 }
 
+/************************************************************************/
+/*                    GDALGetBlockCacheStatistics()                     */
+/************************************************************************/
+
+/**
+ * \brief Get statistics of the block cache, accumulated over all bands.
+ *
+ * Hits and misses are counted by GDALRasterBand::GetLockedBlockRef(),
+ * evictions when a block is discarded to honor the cache limit (see
+ * GDALSetCacheMax64()), and dirty block flushes each time a modified block
+ * is written back to its band. The resident bytes are the memory currently
+ * used by cached blocks. Second tier recalls are the misses served by the
+ * compressed second tier of the block cache, when it is enabled with the
+ * GDAL_BLOCK_CACHE_SECOND_TIER_MAX configuration option.
+ *
+ * The counters can be reset with GDALResetBlockCacheStatistics().
+ *
+ * @param psStats Pointer to the structure to fill. Must not be NULL.
+ *
+ * @since GDAL 3.7
+ */
+
+void GDALGetBlockCacheStatistics( GDALBlockCacheStatistics* psStats )
+{
+    VALIDATE_POINTER0( psStats, "GDALGetBlockCacheStatistics" );
+    GDALAbstractBandBlockCache::GetGlobalStatistics(psStats);
+}
+
+/************************************************************************/
+/*                   GDALResetBlockCacheStatistics()                    */
+/************************************************************************/
+
+/**
+ * \brief Reset the global hit, miss, eviction and dirty block flush counters.
+ *
+ * The resident bytes, as well as the statistics of individual datasets and
+ * bands, are not affected.
+ *
+ * @since GDAL 3.7
+ */
+
+void GDALResetBlockCacheStatistics()
+{
+    GDALAbstractBandBlockCache::ResetGlobalStatistics();
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                           GDALRasterBlock                            */
@@ -390,6 +779,14 @@ int CPL_STDCALL GDALFlushCacheBlock()
  * a least recently used (LRU) list and an upper cache limit (see
  * GDALSetCacheMax()) under which the cache size is normally kept.
  *
+ * The LRU list is split into shards, each protected by its own lock, so that
+ * concurrent accesses to blocks of different bands or datasets do not
+ * contend on a single lock. All blocks of a band belong to the same shard,
+ * and eviction picks the shard holding the least recently used block, so
+ * the global cache limit still applies. The number of shards defaults to
+ * the number of CPUs, and can be set with the GDAL_BLOCK_CACHE_SHARDS
+ * configuration option (rounded up to a power of two, max 64).
+ *
  * Some blocks in the cache may be modified relative to the state on disk
  * (they are marked "Dirty") and must be flushed to disk before they can
  * be discarded.  Other (Clean) blocks may just be discarded if their memory
@@ -430,26 +827,30 @@ int CPL_STDCALL GDALFlushCacheBlock()
 int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
 
 {
-    GDALRasterBlock *poTarget;
+    GDALRasterBlock *poTarget = nullptr;
+
+    INITIALIZE_LOCK;
 
+    int anShards[MAX_SHARD_COUNT];
+    const bool bProbationFirst = ProbationFirst();
+    const int nShardCount = GetShardsByAge(anShards, bProbationFirst);
+    for( int iShard = 0; iShard < nShardCount && poTarget == nullptr; ++iShard )
     {
-        INITIALIZE_LOCK;
-        poTarget = poOldest;
+        GDALRasterBlockCacheShard& oShard = aoShards[anShards[iShard]];
+        TAKE_LOCK(oShard);
 
-        while( poTarget != nullptr )
-        {
-            if( !bDirtyBlocksOnly ||
-                (poTarget->GetDirty() && nDisableDirtyBlockFlushCounter == 0) )
+        GDALRasterBlock* apoCursor[2];
+        oShard.InitCursors(apoCursor);
+        poTarget = oShard.NextEvictionCandidate(apoCursor, bProbationFirst,
+            [bDirtyBlocksOnly](const GDALRasterBlock* poBlock)
             {
-                if( CPLAtomicCompareAndExchange(
-                        &(poTarget->nLockCount), 0, -1) )
-                    break;
-            }
-            poTarget = poTarget->poPrevious;
-        }
+                return !bDirtyBlocksOnly ||
+                       (poBlock->GetDirty() &&
+                        nDisableDirtyBlockFlushCounter == 0);
+            });
 
         if( poTarget == nullptr )
-            return FALSE;
+            continue;
         if( bSleepsForBockCacheDebug )
         {
             // coverity[tainted_data]
@@ -460,10 +861,18 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
                 CPLSleep(dfDelay);
         }
 
+        if( poTarget->bProbation )
+            oShard.AddGhost(poTarget);
         poTarget->Detach_unlocked();
         poTarget->GetBand()->UnreferenceBlock(poTarget);
+        // Flushes of dirty blocks are not evictions due to cache pressure.
+        if( !bDirtyBlocksOnly )
+            poTarget->poBand->poBandBlockCache->AddEviction();
     }
 
+    if( poTarget == nullptr )
+        return FALSE;
+
     if( bSleepsForBockCacheDebug )
     {
         // coverity[tainted_data]
@@ -482,6 +891,10 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
             poTarget->GetBand()->SetFlushBlockErr(eErr);
         }
     }
+    else
+    {
+        GDALCompressedBlockCacheStore(poTarget);
+    }
 
     VSIFreeAligned(poTarget->pData);
     poTarget->pData = nullptr;
@@ -592,7 +1005,9 @@ GDALRasterBlock::GDALRasterBlock( GDALRasterBand *poBandIn,
     poBand(poBandIn),
     poNext(nullptr),
     poPrevious(nullptr),
-    bMustDetach(true)
+    nTouchTick(0),
+    bMustDetach(true),
+    bProbation(false)
 {
     CPLAssert( poBandIn != nullptr );
     poBand->GetBlockSize( &nXSize, &nYSize );
@@ -628,7 +1043,9 @@ GDALRasterBlock::GDALRasterBlock( int nXOffIn, int nYOffIn ) :
     poBand(nullptr),
     poNext(nullptr),
     poPrevious(nullptr),
-    bMustDetach(false)
+    nTouchTick(0),
+    bMustDetach(false),
+    bProbation(false)
 {}
 
 /************************************************************************/
@@ -654,6 +1071,7 @@ void GDALRasterBlock::RecycleFor( int nXOffIn, int nYOffIn )
     nXOff = nXOffIn;
     nYOff = nYOffIn;
     bMustDetach = true;
+    bProbation = false;
 }
 
 /************************************************************************/
@@ -716,33 +1134,32 @@ void GDALRasterBlock::Detach()
 {
     if( bMustDetach )
     {
-        TAKE_LOCK;
+        TAKE_LOCK(GetShard(poBand));
         Detach_unlocked();
     }
 }
 
 void GDALRasterBlock::Detach_unlocked()
 {
-    if( poOldest == this )
-        poOldest = poPrevious;
-
-    if( poNewest == this )
-    {
-        poNewest = poNext;
-    }
-
-    if( poPrevious != nullptr )
-        poPrevious->poNext = poNext;
-
-    if( poNext != nullptr )
-        poNext->poPrevious = poPrevious;
+    GDALRasterBlockCacheShard& oShard = GetShard(poBand);
 
-    poPrevious = nullptr;
-    poNext = nullptr;
+    oShard.Unlink(this);
     bMustDetach = false;
 
     if( pData )
-        nCacheUsed -= GetEffectiveBlockSize(GetBlockSize());
+    {
+        const GIntBig nEffectiveSize = GetEffectiveBlockSize(GetBlockSize());
+        oShard.nUsed -= nEffectiveSize;
+        if( bProbation )
+        {
+            oShard.nProbationUsed -= nEffectiveSize;
+            nCacheProbationUsed -= nEffectiveSize;
+        }
+        nCacheUsed -= nEffectiveSize;
+        if( poBand->poBandBlockCache )
+            poBand->poBandBlockCache->AddResidentBytes(-nEffectiveSize);
+    }
+    bProbation = false;
 
 #ifdef ENABLE_DEBUG
     Verify();
@@ -762,27 +1179,44 @@ void GDALRasterBlock::Detach_unlocked()
 void GDALRasterBlock::Verify()
 
 {
-    TAKE_LOCK;
-
-    CPLAssert( (poNewest == nullptr && poOldest == nullptr)
-               || (poNewest != nullptr && poOldest != nullptr) );
-
-    if( poNewest != nullptr )
+    const int nShardCount = GetShardCount();
+    for( int iShard = 0; iShard < nShardCount; ++iShard )
     {
-        CPLAssert( poNewest->poPrevious == nullptr );
-        CPLAssert( poOldest->poNext == nullptr );
+        GDALRasterBlockCacheShard& oShard = aoShards[iShard];
+        TAKE_LOCK(oShard);
 
-        GDALRasterBlock* poLast = nullptr;
-        for( GDALRasterBlock *poBlock = poNewest;
-             poBlock != nullptr;
-             poBlock = poBlock->poNext )
+        int nBlockCount = 0;
+        for( int iList = 0; iList < 2; ++iList )
         {
-            CPLAssert( poBlock->poPrevious == poLast );
+            GDALRasterBlock* poHead =
+                iList == 0 ? oShard.poNewest : oShard.poProbationNewest;
+            GDALRasterBlock* poTail =
+                iList == 0 ? oShard.poOldest : oShard.poProbationOldest;
 
-            poLast = poBlock;
-        }
+            CPLAssert( (poHead == nullptr && poTail == nullptr)
+                       || (poHead != nullptr && poTail != nullptr) );
+
+            if( poHead != nullptr )
+            {
+                CPLAssert( poHead->poPrevious == nullptr );
+                CPLAssert( poTail->poNext == nullptr );
+
+                GDALRasterBlock* poLast = nullptr;
+                for( GDALRasterBlock *poBlock = poHead;
+                     poBlock != nullptr;
+                     poBlock = poBlock->poNext )
+                {
+                    CPLAssert( poBlock->poPrevious == poLast );
+                    CPLAssert( poBlock->bProbation == (iList == 1) );
 
-        CPLAssert( poOldest == poLast );
+                    poLast = poBlock;
+                    ++nBlockCount;
+                }
+
+                CPLAssert( poTail == poLast );
+            }
+        }
+        CPLAssert( nBlockCount == oShard.nBlockCount );
     }
 }
 
@@ -793,8 +1227,9 @@ void GDALRasterBlock::Verify() {}
 #ifdef notdef
 void GDALRasterBlock::CheckNonOrphanedBlocks( GDALRasterBand* poBand )
 {
-    TAKE_LOCK;
-    for( GDALRasterBlock *poBlock = poNewest;
+    GDALRasterBlockCacheShard& oShard = GetShard(poBand);
+    TAKE_LOCK(oShard);
+    for( GDALRasterBlock *poBlock = oShard.poNewest;
                           poBlock != nullptr;
                           poBlock = poBlock->poNext )
     {
@@ -844,7 +1279,11 @@ CPLErr GDALRasterBlock::Write()
 
     if (poBand->eFlushBlockErr == CE_None)
     {
+        if( poBand->poBandBlockCache )
+            poBand->poBandBlockCache->AddDirtyBlockFlush();
         int bCallLeaveReadWrite = poBand->EnterReadWrite(GF_Write);
+        // Before IWriteBlock(), as drivers may alter the buffer in place.
+        poBand->UpdateWriteStatistics( nXOff, nYOff, pData );
         CPLErr eErr = poBand->IWriteBlock( nXOff, nYOff, pData );
         if( bCallLeaveReadWrite ) poBand->LeaveReadWrite();
         return eErr;
@@ -867,54 +1306,42 @@ CPLErr GDALRasterBlock::Write()
 void GDALRasterBlock::Touch()
 
 {
+    // Blocks of the probation list of the 2Q policy are not moved when
+    // referenced again.
+    if( bProbation )
+        return;
+
+    GDALRasterBlockCacheShard& oShard = GetShard(poBand);
+
     // Can be safely tested outside the lock
-    if( poNewest == this )
+    if( oShard.poNewest == this )
         return;
 
-    TAKE_LOCK;
+    TAKE_LOCK(oShard);
     Touch_unlocked();
 }
 
 void GDALRasterBlock::Touch_unlocked()
 
 {
+    GDALRasterBlockCacheShard& oShard = GetShard(poBand);
+
     // Could happen even if tested in Touch() before taking the lock
     // Scenario would be :
     // 0. this is the second block (the one pointed by poNewest->poNext)
     // 1. Thread 1 calls Touch() and poNewest != this at that point
     // 2. Thread 2 detaches poNewest
     // 3. Thread 1 arrives here
-    if( poNewest == this )
+    if( oShard.poNewest == this || bProbation )
         return;
 
     // We should not try to touch a block that has been detached.
     // If that happen, corruption has already occurred.
     CPLAssert(bMustDetach);
 
-    if( poOldest == this )
-        poOldest = this->poPrevious;
-
-    if( poPrevious != nullptr )
-        poPrevious->poNext = poNext;
-
-    if( poNext != nullptr )
-        poNext->poPrevious = poPrevious;
-
-    poPrevious = nullptr;
-    poNext = poNewest;
-
-    if( poNewest != nullptr )
-    {
-        CPLAssert( poNewest->poPrevious == nullptr );
-        poNewest->poPrevious = this;
-    }
-    poNewest = this;
+    oShard.Unlink(this);
+    oShard.Link(this, false);
 
-    if( poOldest == nullptr )
-    {
-        CPLAssert( poPrevious == nullptr && poNext == nullptr );
-        poOldest = this;
-    }
 #ifdef ENABLE_DEBUG
     Verify();
 #endif
@@ -942,91 +1369,70 @@ CPLErr GDALRasterBlock::Internalize()
 
     void        *pNewData = nullptr;
 
-    // This call will initialize the hRBLock mutex. Other call places can
+    // This call will initialize the shard locks. Other call places can
     // only be called if we have go through there.
     const GIntBig nCurCacheMax = GDALGetCacheMax64();
 
     // No risk of overflow as it is checked in GDALRasterBand::InitBlockInfo().
     const auto nSizeInBytes = GetBlockSize();
+    const GIntBig nEffectiveSize = GetEffectiveBlockSize(nSizeInBytes);
+
+    nCacheUsed += nEffectiveSize;
+    ++nCacheTick;
 
 /* -------------------------------------------------------------------- */
 /*      Flush old blocks if we are nearing our memory limit.            */
 /* -------------------------------------------------------------------- */
-    bool bFirstIter = true;
-    bool bLoopAgain = false;
     GDALDataset* poThisDS = poBand->GetDataset();
-    do
+    bool bLoopAgain = nCacheUsed > nCurCacheMax;
+    while( bLoopAgain )
     {
-        bLoopAgain = false;
         GDALRasterBlock* apoBlocksToFree[64] = { nullptr };
         int nBlocksToFree = 0;
-        {
-            TAKE_LOCK;
 
-            if( bFirstIter )
-                nCacheUsed += GetEffectiveBlockSize(nSizeInBytes);
-            GDALRasterBlock *poTarget = poOldest;
-            while( nCacheUsed > nCurCacheMax )
+        int anShards[MAX_SHARD_COUNT];
+        const bool bProbationFirst = ProbationFirst();
+        const int nShardCount = GetShardsByAge(anShards, bProbationFirst);
+
+        // In the first pass, only discard clean blocks and dirty blocks of
+        // this dataset. We do this to decrease significantly the likelihood
+        // of the following weakness of the block cache design:
+        // 1. Thread 1 fills block B with ones
+        // 2. Thread 2 evicts this dirty block, while thread 1 almost
+        //    at the same time (but slightly after) tries to reacquire
+        //    this block. As it has been removed from the block cache
+        //    array/set, thread 1 now tries to read block B from disk,
+        //    so gets the old value.
+        // The second pass also accepts dirty blocks of other datasets.
+        for( int iPass = 0; iPass < 2 && nBlocksToFree == 0; ++iPass )
+        {
+            for( int iShard = 0;
+                 iShard < nShardCount && nBlocksToFree == 0 &&
+                 nCacheUsed > nCurCacheMax;
+                 ++iShard )
             {
-                GDALRasterBlock* poDirtyBlockOtherDataset = nullptr;
-                // In this first pass, only discard dirty blocks of this
-                // dataset. We do this to decrease significantly the likelihood
-                // of the following weakness of the block cache design:
-                // 1. Thread 1 fills block B with ones
-                // 2. Thread 2 evicts this dirty block, while thread 1 almost
-                //    at the same time (but slightly after) tries to reacquire
-                //    this block. As it has been removed from the block cache
-                //    array/set, thread 1 now tries to read block B from disk,
-                //    so gets the old value.
-                while( poTarget != nullptr )
+                GDALRasterBlockCacheShard& oShard = aoShards[anShards[iShard]];
+                TAKE_LOCK(oShard);
+
+                const auto oFilter = [iPass, poThisDS](
+                                            const GDALRasterBlock* poBlock)
                 {
-                    if( !poTarget->GetDirty() )
-                    {
-                        if( CPLAtomicCompareAndExchange(
-                                &(poTarget->nLockCount), 0, -1) )
-                            break;
-                    }
-                    else if (nDisableDirtyBlockFlushCounter == 0)
-                    {
-                        if( poTarget->poBand->GetDataset() == poThisDS )
-                        {
-                            if( CPLAtomicCompareAndExchange(
-                                    &(poTarget->nLockCount), 0, -1) )
-                                break;
-                        }
-                        else if( poDirtyBlockOtherDataset == nullptr )
-                        {
-                            poDirtyBlockOtherDataset = poTarget;
-                        }
-                    }
-                    poTarget = poTarget->poPrevious;
-                }
-                if( poTarget == nullptr && poDirtyBlockOtherDataset )
+                    return !poBlock->GetDirty() ||
+                           (nDisableDirtyBlockFlushCounter == 0 &&
+                            (iPass == 1 ||
+                             poBlock->poBand->GetDataset() == poThisDS));
+                };
+
+                GDALRasterBlock* apoCursor[2];
+                oShard.InitCursors(apoCursor);
+                while( nCacheUsed > nCurCacheMax )
                 {
-                    if( CPLAtomicCompareAndExchange(
-                            &(poDirtyBlockOtherDataset->nLockCount), 0, -1) )
-                    {
-                        CPLDebug("GDAL", "Evicting dirty block of another dataset");
-                        poTarget = poDirtyBlockOtherDataset;
-                    }
-                    else
-                    {
-                        poTarget = poOldest;
-                        while( poTarget != nullptr )
-                        {
-                            if( CPLAtomicCompareAndExchange(
-                                &(poTarget->nLockCount), 0, -1) )
-                            {
-                                CPLDebug("GDAL", "Evicting dirty block of another dataset");
-                                break;
-                            }
-                            poTarget = poTarget->poPrevious;
-                        }
-                    }
-                }
+                    GDALRasterBlock *poTarget =
+                        oShard.NextEvictionCandidate(apoCursor,
+                                                     bProbationFirst, oFilter);
+                    if( poTarget == nullptr )
+                        break;
 
-                if( poTarget != nullptr )
-                {
                     if( bSleepsForBockCacheDebug )
                     {
                         // coverity[tainted_data]
@@ -1038,43 +1444,29 @@ CPLErr GDALRasterBlock::Internalize()
                             CPLSleep(dfDelay);
                     }
 
-                    GDALRasterBlock* _poPrevious = poTarget->poPrevious;
-
+                    if( poTarget->bProbation )
+                        oShard.AddGhost(poTarget);
                     poTarget->Detach_unlocked();
                     poTarget->GetBand()->UnreferenceBlock(poTarget);
+                    poTarget->poBand->poBandBlockCache->AddEviction();
 
                     apoBlocksToFree[nBlocksToFree++] = poTarget;
                     if( poTarget->GetDirty() )
                     {
+                        if( poTarget->poBand->GetDataset() != poThisDS )
+                            CPLDebug("GDAL",
+                                     "Evicting dirty block of another dataset");
                         // Only free one dirty block at a time so that
                         // other dirty blocks of other bands with the same
                         // coordinates can be found with TryGetLockedBlock()
-                        bLoopAgain = nCacheUsed > nCurCacheMax;
                         break;
                     }
                     if( nBlocksToFree == 64 )
-                    {
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
                         break;
-                    }
-
-                    poTarget = _poPrevious;
-                }
-                else
-                {
-                    break;
                 }
             }
-
-        /* ------------------------------------------------------------------ */
-        /*      Add this block to the list.                                   */
-        /* ------------------------------------------------------------------ */
-            if( !bLoopAgain )
-                Touch_unlocked();
         }
 
-        bFirstIter = false;
-
         // Now free blocks we have detached and removed from their band.
         for( int i = 0; i < nBlocksToFree; ++i)
         {
@@ -1100,6 +1492,10 @@ CPLErr GDALRasterBlock::Internalize()
                     poBlock->GetBand()->SetFlushBlockErr(eErr);
                 }
             }
+            else
+            {
+                GDALCompressedBlockCacheStore(poBlock);
+            }
 
             // Try to recycle the data of an existing block.
             void* pDataBlock = poBlock->pData;
@@ -1116,20 +1512,45 @@ CPLErr GDALRasterBlock::Internalize()
 
             poBlock->GetBand()->AddBlockToFreeList(poBlock);
         }
+
+        // If no block could be evicted, give up and stay over the limit.
+        bLoopAgain = nBlocksToFree > 0 && nCacheUsed > nCurCacheMax;
     }
-    while(bLoopAgain);
 
     if( pNewData == nullptr )
     {
         pNewData = VSI_MALLOC_ALIGNED_AUTO_VERBOSE( nSizeInBytes );
         if( pNewData == nullptr )
         {
+            nCacheUsed -= nEffectiveSize;
             return( CE_Failure );
         }
     }
 
     pData = pNewData;
 
+/* -------------------------------------------------------------------- */
+/*      Add this block to the list.                                     */
+/* -------------------------------------------------------------------- */
+    {
+        GDALRasterBlockCacheShard& oShard = GetShard(poBand);
+        TAKE_LOCK(oShard);
+
+        // With the 2Q policy, blocks enter the probation list, unless they
+        // have recently been evicted from it.
+        const bool bInProbation = GetCachePolicy() == BlockCachePolicy::TWO_Q
+                                  && !oShard.RemoveGhost(this);
+        oShard.nUsed += nEffectiveSize;
+        if( bInProbation )
+        {
+            oShard.nProbationUsed += nEffectiveSize;
+            nCacheProbationUsed += nEffectiveSize;
+        }
+        oShard.Link(this, bInProbation);
+    }
+    if( poBand->poBandBlockCache )
+        poBand->poBandBlockCache->AddResidentBytes(nEffectiveSize);
+
     return CE_None;
 }
 
@@ -1180,9 +1601,12 @@ void GDALRasterBlock::MarkClean()
 /*! @cond Doxygen_Suppress */
 void GDALRasterBlock::DestroyRBMutex()
 {
-    if( hRBLock != nullptr )
-        DESTROY_LOCK;
-    hRBLock = nullptr;
+    for( auto& oShard: aoShards )
+    {
+        if( oShard.hLock != nullptr )
+            CPLDestroyLock(oShard.hLock);
+        oShard.hLock = nullptr;
+    }
 }
 /*! @endcond */
 
@@ -1261,7 +1685,7 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #endif
 
     // Wait for the block for having been unreferenced.
-    TAKE_LOCK;
+    TAKE_LOCK(GetShard(poBand));
 
     return FALSE;
 }
@@ -1270,14 +1694,23 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 void GDALRasterBlock::DumpAll()
 {
     int iBlock = 0;
-    for( GDALRasterBlock *poBlock = poNewest;
-         poBlock != nullptr;
-         poBlock = poBlock->poNext )
+    for( int iShard = 0; iShard < GetShardCount(); ++iShard )
     {
-        printf("Block %d\n", iBlock);/*ok*/
-        poBlock->DumpBlock();
-        printf("\n");/*ok*/
-        iBlock++;
+        for( int iList = 0; iList < 2; ++iList )
+        {
+            for( GDALRasterBlock *poBlock = iList == 0 ?
+                        aoShards[iShard].poNewest :
+                        aoShards[iShard].poProbationNewest;
+                 poBlock != nullptr;
+                 poBlock = poBlock->poNext )
+            {
+                printf("Block %d (shard %d, %s)\n", iBlock, iShard,/*ok*/
+                       iList == 0 ? "main" : "probation");
+                poBlock->DumpBlock();
+                printf("\n");/*ok*/
+                iBlock++;
+            }
+        }
     }
 }
 
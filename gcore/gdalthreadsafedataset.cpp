@@ -0,0 +1,966 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Read-only dataset that can be shared by several threads
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_proxy.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cpl_error.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+#include "gdal.h"
+#include "gdal_priv.h"
+
+/*! @cond Doxygen_Suppress */
+
+// A dataset opened with GDAL_OF_THREAD_SAFE is a proxy whose bands own the
+// block cache shared by all threads. Blocks missing from it are decoded
+// without holding any lock, through a dataset handle borrowed from a pool:
+// handles are opened when all existing ones are in use, and handles that
+// become idle are kept for reuse up to the number of CPUs, and closed beyond
+// that. Other requests (metadata, georeferencing, statistics, ...) are
+// forwarded to the handle used to open the dataset, one thread at a time.
+// The proxy is read-only: methods that would modify the underlying handles
+// are rejected with CPLE_NotSupported.
+
+class GDALThreadSafeRasterBand;
+
+/* ******************************************************************** */
+/*                        GDALThreadSafeDataset                         */
+/* ******************************************************************** */
+
+class GDALThreadSafeDataset final : public GDALProxyDataset
+{
+    friend class GDALThreadSafeRasterBand;
+
+    CPLString       m_osFilename{};
+    unsigned int    m_nOpenFlags = 0;
+    CPLStringList   m_aosAllowedDrivers{};
+    CPLStringList   m_aosSiblingFiles{};
+
+    // Handle used to open the dataset, for requests other than block reads.
+    GDALDataset*    m_poPrototypeDS = nullptr;
+    mutable std::recursive_mutex m_oPrototypeMutex{};
+
+    // Idle handles used to read blocks.
+    std::mutex      m_oPoolMutex{};
+    std::vector<GDALDataset*> m_apoIdleHandles{};
+    size_t          m_nMaxIdleHandles = 1;
+
+    GDALDataset    *AcquireHandle();
+    void            ReleaseHandle( GDALDataset* poHandle );
+    void            CloseIdleHandles();
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALThreadSafeDataset)
+
+  protected:
+    GDALDataset *RefUnderlyingDataset() const override;
+    void UnrefUnderlyingDataset( GDALDataset* poUnderlyingDataset )
+                                                        const override;
+
+    CPLErr IBuildOverviews( const char *,
+                            int, const int *,
+                            int, const int *,
+                            GDALProgressFunc, void *,
+                            CSLConstList papszOptions ) override;
+    CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                      void *, int, int, GDALDataType,
+                      int, int *, GSpacing, GSpacing, GSpacing,
+                      GDALRasterIOExtraArg* psExtraArg ) override;
+
+  public:
+    GDALThreadSafeDataset( GDALDataset* poPrototypeDS,
+                           const char* pszFilename,
+                           unsigned int nOpenFlagsIn,
+                           const char* const* papszAllowedDrivers,
+                           const char* const* papszOpenOptionsIn,
+                           const char* const* papszSiblingFiles );
+    ~GDALThreadSafeDataset() override;
+
+    void FlushCache(bool bAtClosing) override;
+
+    CPLErr SetMetadata( char ** papszMetadata,
+                        const char * pszDomain ) override;
+    CPLErr SetMetadataItem( const char * pszName,
+                            const char * pszValue,
+                            const char * pszDomain ) override;
+    CPLErr SetSpatialRef( const OGRSpatialReference* poSRS ) override;
+    CPLErr SetGeoTransform( double * ) override;
+    CPLErr SetGCPs( int nGCPCount, const GDAL_GCP *pasGCPList,
+                    const OGRSpatialReference * poGCP_SRS ) override;
+    CPLErr CreateMaskBand( int nFlags ) override;
+};
+
+/* ******************************************************************** */
+/*                       GDALThreadSafeRasterBand                       */
+/* ******************************************************************** */
+
+class GDALThreadSafeRasterBand final : public GDALProxyRasterBand
+{
+    GDALThreadSafeDataset*    m_poTSDS = nullptr;
+    // Band from which this one is derived, or nullptr for a dataset band.
+    GDALThreadSafeRasterBand* m_poParent = nullptr;
+    // Overview index in m_poParent, or -1 for its mask band.
+    int                       m_iOverview = -1;
+
+    std::mutex                m_oMutex{};
+    bool                      m_bOverviewsInit = false;
+    std::vector<std::unique_ptr<GDALThreadSafeRasterBand>> m_apoOverviews{};
+    std::unique_ptr<GDALThreadSafeRasterBand> m_poMaskBand{};
+
+    // Held while the block cache of this band is used.
+    std::mutex                m_oCacheMutex{};
+
+    GDALRasterBand* GetBandOf( GDALDataset* poHandle ) const;
+    void            CacheBlocks( int nXOff, int nYOff,
+                                 int nXSize, int nYSize );
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALThreadSafeRasterBand)
+
+  protected:
+    GDALRasterBand* RefUnderlyingRasterBand() const override;
+    void UnrefUnderlyingRasterBand( GDALRasterBand* poUnderlyingRasterBand )
+                                                        const override;
+
+    CPLErr IReadBlock( int, int, void * ) override;
+    CPLErr IWriteBlock( int, int, void * ) override;
+    CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                      void *, int, int, GDALDataType,
+                      GSpacing, GSpacing,
+                      GDALRasterIOExtraArg* psExtraArg ) override;
+
+  public:
+    GDALThreadSafeRasterBand( GDALThreadSafeDataset* poTSDS,
+                              GDALThreadSafeRasterBand* poParent,
+                              int iOverview, int nBandIn,
+                              GDALRasterBand* poModelBand );
+
+    CPLErr FlushCache(bool bAtClosing) override;
+
+    int GetOverviewCount() override;
+    GDALRasterBand *GetOverview( int ) override;
+    GDALRasterBand *GetRasterSampleOverview( GUIntBig ) override;
+    GDALRasterBand *GetMaskBand() override;
+
+    CPLErr SetMetadata( char ** papszMetadata,
+                        const char * pszDomain ) override;
+    CPLErr SetMetadataItem( const char * pszName,
+                            const char * pszValue,
+                            const char * pszDomain ) override;
+    CPLErr Fill( double dfRealValue, double dfImaginaryValue = 0 ) override;
+    CPLErr SetCategoryNames( char ** ) override;
+    CPLErr SetNoDataValue( double ) override;
+    CPLErr DeleteNoDataValue() override;
+    CPLErr SetColorTable( GDALColorTable * ) override;
+    CPLErr SetColorInterpretation( GDALColorInterp ) override;
+    CPLErr SetOffset( double ) override;
+    CPLErr SetScale( double ) override;
+    CPLErr SetUnitType( const char * ) override;
+    CPLErr SetStatistics( double dfMin, double dfMax,
+                          double dfMean, double dfStdDev ) override;
+    CPLErr BuildOverviews( const char *, int, const int *,
+                           GDALProgressFunc, void *,
+                           CSLConstList papszOptions ) override;
+    CPLErr SetDefaultHistogram( double dfMin, double dfMax,
+                                int nBuckets, GUIntBig *panHistogram ) override;
+    CPLErr SetDefaultRAT( const GDALRasterAttributeTable * ) override;
+    CPLErr CreateMaskBand( int nFlags ) override;
+    CPLVirtualMem *GetVirtualMemAuto( GDALRWFlag eRWFlag,
+                                      int *pnPixelSpace,
+                                      GIntBig *pnLineSpace,
+                                      char **papszOptions ) override;
+};
+
+/************************************************************************/
+/*                         ReportNotSupported()                         */
+/************************************************************************/
+
+static CPLErr ReportNotSupported( const char* pszMethod )
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "%s() not supported on a dataset opened with GDAL_OF_THREAD_SAFE",
+             pszMethod);
+    return CE_Failure;
+}
+
+/************************************************************************/
+/*                        GDALThreadSafeDataset()                       */
+/************************************************************************/
+
+GDALThreadSafeDataset::GDALThreadSafeDataset(
+                                GDALDataset* poPrototypeDS,
+                                const char* pszFilename,
+                                unsigned int nOpenFlagsIn,
+                                const char* const* papszAllowedDrivers,
+                                const char* const* papszOpenOptionsIn,
+                                const char* const* papszSiblingFiles ) :
+    m_osFilename(pszFilename),
+    m_nOpenFlags(nOpenFlagsIn),
+    m_aosAllowedDrivers(CSLDuplicate(papszAllowedDrivers)),
+    m_aosSiblingFiles(CSLDuplicate(papszSiblingFiles))
+{
+    papszOpenOptions = CSLDuplicate(papszOpenOptionsIn);
+
+    m_poPrototypeDS = poPrototypeDS;
+    m_nMaxIdleHandles = static_cast<size_t>(std::max(1, CPLGetNumCPUs()));
+
+    nRasterXSize = poPrototypeDS->GetRasterXSize();
+    nRasterYSize = poPrototypeDS->GetRasterYSize();
+    eAccess = GA_ReadOnly;
+    SetDescription(poPrototypeDS->GetDescription());
+
+    for( int i = 1; i <= poPrototypeDS->GetRasterCount(); ++i )
+    {
+        SetBand(i, new GDALThreadSafeRasterBand(
+                        this, nullptr, 0, i,
+                        poPrototypeDS->GetRasterBand(i)));
+    }
+}
+
+/************************************************************************/
+/*                       ~GDALThreadSafeDataset()                       */
+/************************************************************************/
+
+GDALThreadSafeDataset::~GDALThreadSafeDataset()
+{
+    CloseIdleHandles();
+    GDALClose(GDALDataset::ToHandle(m_poPrototypeDS));
+}
+
+/************************************************************************/
+/*                        RefUnderlyingDataset()                        */
+/************************************************************************/
+
+GDALDataset* GDALThreadSafeDataset::RefUnderlyingDataset() const
+{
+    // Released by UnrefUnderlyingDataset()
+    m_oPrototypeMutex.lock();
+    return m_poPrototypeDS;
+}
+
+/************************************************************************/
+/*                       UnrefUnderlyingDataset()                       */
+/************************************************************************/
+
+void GDALThreadSafeDataset::UnrefUnderlyingDataset( GDALDataset* ) const
+{
+    m_oPrototypeMutex.unlock();
+}
+
+/************************************************************************/
+/*                           AcquireHandle()                            */
+/************************************************************************/
+
+// Return a handle that the calling thread uses exclusively until it gives
+// it back with ReleaseHandle().
+GDALDataset* GDALThreadSafeDataset::AcquireHandle()
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oPoolMutex);
+        if( !m_apoIdleHandles.empty() )
+        {
+            GDALDataset* poHandle = m_apoIdleHandles.back();
+            m_apoIdleHandles.pop_back();
+            return poHandle;
+        }
+    }
+
+    // Open outside of the lock, so that several threads can open a handle
+    // at the same time.
+    auto poDS = GDALDataset::Open(m_osFilename.c_str(),
+                                  m_nOpenFlags | GDAL_OF_INTERNAL,
+                                  m_aosAllowedDrivers.List(),
+                                  papszOpenOptions,
+                                  m_aosSiblingFiles.List());
+    if( poDS == nullptr )
+        return nullptr;
+    if( poDS->GetRasterXSize() != nRasterXSize ||
+        poDS->GetRasterYSize() != nRasterYSize ||
+        poDS->GetRasterCount() != nBands )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s has changed since it has been opened",
+                 m_osFilename.c_str());
+        GDALClose(GDALDataset::ToHandle(poDS));
+        return nullptr;
+    }
+    return poDS;
+}
+
+/************************************************************************/
+/*                           ReleaseHandle()                            */
+/************************************************************************/
+
+void GDALThreadSafeDataset::ReleaseHandle( GDALDataset* poHandle )
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oPoolMutex);
+        if( m_apoIdleHandles.size() < m_nMaxIdleHandles )
+        {
+            m_apoIdleHandles.push_back(poHandle);
+            return;
+        }
+    }
+    GDALClose(GDALDataset::ToHandle(poHandle));
+}
+
+/************************************************************************/
+/*                          CloseIdleHandles()                          */
+/************************************************************************/
+
+void GDALThreadSafeDataset::CloseIdleHandles()
+{
+    std::vector<GDALDataset*> apoHandles;
+    {
+        std::lock_guard<std::mutex> oLock(m_oPoolMutex);
+        std::swap(apoHandles, m_apoIdleHandles);
+    }
+    for( auto poHandle : apoHandles )
+        GDALClose(GDALDataset::ToHandle(poHandle));
+}
+
+/************************************************************************/
+/*                             FlushCache()                             */
+/************************************************************************/
+
+void GDALThreadSafeDataset::FlushCache(bool bAtClosing)
+{
+    // Flush the shared block cache of the bands, and the prototype handle.
+    GDALDataset::FlushCache(bAtClosing);
+    GDALProxyDataset::FlushCache(bAtClosing);
+    // Idle handles only hold blocks cached by their driver (e.g. the other
+    // bands of a pixel interleaved strip), so release them.
+    CloseIdleHandles();
+}
+
+/************************************************************************/
+/*                          IBuildOverviews()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::IBuildOverviews( const char *, int, const int *,
+                                               int, const int *,
+                                               GDALProgressFunc, void *,
+                                               CSLConstList )
+{
+    return ReportNotSupported("BuildOverviews");
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                         int nXOff, int nYOff,
+                                         int nXSize, int nYSize,
+                                         void * pData,
+                                         int nBufXSize, int nBufYSize,
+                                         GDALDataType eBufType,
+                                         int nBandCount, int *panBandMap,
+                                         GSpacing nPixelSpace,
+                                         GSpacing nLineSpace,
+                                         GSpacing nBandSpace,
+                                         GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Write )
+        return ReportNotSupported("RasterIO");
+    // Go through the bands, and thus through their shared block cache.
+    // GDALDataset::IRasterIO() could use BlockBasedRasterIO(), which fetches
+    // blocks without the lock of the bands.
+    return BandBasedRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                             pData, nBufXSize, nBufYSize, eBufType,
+                             nBandCount, panBandMap,
+                             nPixelSpace, nLineSpace, nBandSpace,
+                             psExtraArg);
+}
+
+/************************************************************************/
+/*                            SetMetadata()                             */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::SetMetadata( char **, const char * )
+{
+    return ReportNotSupported("SetMetadata");
+}
+
+/************************************************************************/
+/*                          SetMetadataItem()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::SetMetadataItem( const char *, const char *,
+                                               const char * )
+{
+    return ReportNotSupported("SetMetadataItem");
+}
+
+/************************************************************************/
+/*                           SetSpatialRef()                            */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::SetSpatialRef( const OGRSpatialReference* )
+{
+    return ReportNotSupported("SetSpatialRef");
+}
+
+/************************************************************************/
+/*                          SetGeoTransform()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::SetGeoTransform( double * )
+{
+    return ReportNotSupported("SetGeoTransform");
+}
+
+/************************************************************************/
+/*                              SetGCPs()                               */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::SetGCPs( int, const GDAL_GCP *,
+                                       const OGRSpatialReference * )
+{
+    return ReportNotSupported("SetGCPs");
+}
+
+/************************************************************************/
+/*                           CreateMaskBand()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeDataset::CreateMaskBand( int )
+{
+    return ReportNotSupported("CreateMaskBand");
+}
+
+/************************************************************************/
+/*                      GDALThreadSafeRasterBand()                      */
+/************************************************************************/
+
+GDALThreadSafeRasterBand::GDALThreadSafeRasterBand(
+                                        GDALThreadSafeDataset* poTSDS,
+                                        GDALThreadSafeRasterBand* poParent,
+                                        int iOverview, int nBandIn,
+                                        GDALRasterBand* poModelBand ) :
+    m_poTSDS(poTSDS),
+    m_poParent(poParent),
+    m_iOverview(iOverview)
+{
+    poDS = poTSDS;
+    nBand = nBandIn;
+    eAccess = GA_ReadOnly;
+    nRasterXSize = poModelBand->GetXSize();
+    nRasterYSize = poModelBand->GetYSize();
+    eDataType = poModelBand->GetRasterDataType();
+    poModelBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    SetDescription(poModelBand->GetDescription());
+}
+
+/************************************************************************/
+/*                       RefUnderlyingRasterBand()                      */
+/************************************************************************/
+
+GDALRasterBand* GDALThreadSafeRasterBand::RefUnderlyingRasterBand() const
+{
+    GDALDataset* poPrototypeDS = m_poTSDS->RefUnderlyingDataset();
+    GDALRasterBand* poBand = GetBandOf(poPrototypeDS);
+    if( poBand == nullptr )
+        m_poTSDS->UnrefUnderlyingDataset(poPrototypeDS);
+    return poBand;
+}
+
+/************************************************************************/
+/*                      UnrefUnderlyingRasterBand()                     */
+/************************************************************************/
+
+void GDALThreadSafeRasterBand::UnrefUnderlyingRasterBand(
+                                                    GDALRasterBand* ) const
+{
+    m_poTSDS->UnrefUnderlyingDataset(nullptr);
+}
+
+/************************************************************************/
+/*                             GetBandOf()                              */
+/************************************************************************/
+
+// Return the band matching this one in a handle of the dataset.
+GDALRasterBand* GDALThreadSafeRasterBand::GetBandOf(
+                                            GDALDataset* poHandle ) const
+{
+    if( m_poParent == nullptr )
+        return poHandle->GetRasterBand(nBand);
+
+    GDALRasterBand* poParentBand = m_poParent->GetBandOf(poHandle);
+    if( poParentBand == nullptr )
+        return nullptr;
+    return m_iOverview >= 0 ? poParentBand->GetOverview(m_iOverview)
+                            : poParentBand->GetMaskBand();
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::IReadBlock( int nXBlockOff, int nYBlockOff,
+                                             void* pImage )
+{
+    GDALDataset* poHandle = m_poTSDS->AcquireHandle();
+    if( poHandle == nullptr )
+        return CE_Failure;
+    GDALRasterBand* poBand = GetBandOf(poHandle);
+    const CPLErr eErr = poBand ?
+        poBand->ReadBlock(nXBlockOff, nYBlockOff, pImage) : CE_Failure;
+    m_poTSDS->ReleaseHandle(poHandle);
+    return eErr;
+}
+
+/************************************************************************/
+/*                            CacheBlocks()                             */
+/************************************************************************/
+
+// Insert in the block cache the blocks intersecting a window that are not
+// cached yet. They are decoded without holding m_oCacheMutex, so that
+// threads reading different blocks of the band do it concurrently. Blocks
+// are only adopted, fully read, under m_oCacheMutex, so that a thread
+// holding it never sees a block being read.
+void GDALThreadSafeRasterBand::CacheBlocks( int nXOff, int nYOff,
+                                            int nXSize, int nYSize )
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oCacheMutex);
+        if( !InitBlockInfo() )
+            return;
+    }
+
+    const int nXBlockStart = nXOff / nBlockXSize;
+    const int nXBlockEnd = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nYBlockStart = nYOff / nBlockYSize;
+    const int nYBlockEnd = (nYOff + nYSize - 1) / nBlockYSize;
+    const size_t nBlockSize = static_cast<size_t>(nBlockXSize) * nBlockYSize *
+                              GDALGetDataTypeSizeBytes(eDataType);
+
+    GDALDataset* poHandle = nullptr;
+    GDALRasterBand* poBand = nullptr;
+    std::vector<GByte> abyBlock;
+    for( int nYBlockOff = nYBlockStart; nYBlockOff <= nYBlockEnd; ++nYBlockOff )
+    {
+        for( int nXBlockOff = nXBlockStart; nXBlockOff <= nXBlockEnd;
+             ++nXBlockOff )
+        {
+            {
+                std::lock_guard<std::mutex> oLock(m_oCacheMutex);
+                GDALRasterBlock* poBlock =
+                    TryGetLockedBlockRef(nXBlockOff, nYBlockOff);
+                if( poBlock != nullptr )
+                {
+                    poBlock->DropLock();
+                    continue;
+                }
+            }
+
+            if( poHandle == nullptr )
+            {
+                try
+                {
+                    abyBlock.resize(nBlockSize);
+                }
+                catch( const std::exception& )
+                {
+                    return;
+                }
+                poHandle = m_poTSDS->AcquireHandle();
+                if( poHandle == nullptr )
+                    return;
+                poBand = GetBandOf(poHandle);
+                if( poBand == nullptr )
+                {
+                    m_poTSDS->ReleaseHandle(poHandle);
+                    return;
+                }
+            }
+
+            // On failure, leave the block to IReadBlock(), which will report
+            // the error in the context of the request.
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            const CPLErr eErr =
+                poBand->ReadBlock(nXBlockOff, nYBlockOff, abyBlock.data());
+            CPLPopErrorHandler();
+            if( eErr != CE_None )
+                continue;
+
+            std::lock_guard<std::mutex> oLock(m_oCacheMutex);
+            GDALRasterBlock* poBlock =
+                TryGetLockedBlockRef(nXBlockOff, nYBlockOff);
+            if( poBlock == nullptr )
+            {
+                // Cached by another thread in the meantime otherwise
+                poBlock = GetLockedBlockRef(nXBlockOff, nYBlockOff, TRUE);
+                if( poBlock == nullptr )
+                    continue;
+                memcpy(poBlock->GetDataRef(), abyBlock.data(), nBlockSize);
+            }
+            poBlock->DropLock();
+        }
+    }
+
+    if( poHandle != nullptr )
+        m_poTSDS->ReleaseHandle(poHandle);
+}
+
+/************************************************************************/
+/*                             FlushCache()                             */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::FlushCache(bool bAtClosing)
+{
+    std::lock_guard<std::mutex> oLock(m_oCacheMutex);
+    return GDALProxyRasterBand::FlushCache(bAtClosing);
+}
+
+/************************************************************************/
+/*                          GetOverviewCount()                          */
+/************************************************************************/
+
+int GDALThreadSafeRasterBand::GetOverviewCount()
+{
+    // Overview bands are proxies too, so that they can also be shared by
+    // threads.
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( !m_bOverviewsInit )
+    {
+        GDALRasterBand* poUnderlyingBand = RefUnderlyingRasterBand();
+        if( poUnderlyingBand == nullptr )
+            return 0;
+        m_bOverviewsInit = true;
+        const int nOverviews = poUnderlyingBand->GetOverviewCount();
+        for( int i = 0; i < nOverviews; ++i )
+        {
+            GDALRasterBand* poOvrBand = poUnderlyingBand->GetOverview(i);
+            if( poOvrBand == nullptr )
+                break;
+            m_apoOverviews.emplace_back(new GDALThreadSafeRasterBand(
+                m_poTSDS, this, i, nBand, poOvrBand));
+        }
+        UnrefUnderlyingRasterBand(poUnderlyingBand);
+    }
+    return static_cast<int>(m_apoOverviews.size());
+}
+
+/************************************************************************/
+/*                             GetOverview()                            */
+/************************************************************************/
+
+GDALRasterBand* GDALThreadSafeRasterBand::GetOverview( int iOvr )
+{
+    if( iOvr < 0 || iOvr >= GetOverviewCount() )
+        return nullptr;
+    return m_apoOverviews[iOvr].get();
+}
+
+/************************************************************************/
+/*                       GetRasterSampleOverview()                      */
+/************************************************************************/
+
+GDALRasterBand* GDALThreadSafeRasterBand::GetRasterSampleOverview(
+                                                    GUIntBig nDesiredSamples )
+{
+    // Base implementation, which relies on GetOverview().
+    return GDALRasterBand::GetRasterSampleOverview(nDesiredSamples);
+}
+
+/************************************************************************/
+/*                             GetMaskBand()                            */
+/************************************************************************/
+
+GDALRasterBand* GDALThreadSafeRasterBand::GetMaskBand()
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_poMaskBand == nullptr )
+    {
+        GDALRasterBand* poUnderlyingBand = RefUnderlyingRasterBand();
+        if( poUnderlyingBand == nullptr )
+            return nullptr;
+        GDALRasterBand* poUnderlyingMaskBand = poUnderlyingBand->GetMaskBand();
+        if( poUnderlyingMaskBand != nullptr )
+        {
+            m_poMaskBand.reset(new GDALThreadSafeRasterBand(
+                m_poTSDS, this, -1, nBand, poUnderlyingMaskBand));
+        }
+        UnrefUnderlyingRasterBand(poUnderlyingBand);
+    }
+    return m_poMaskBand.get();
+}
+
+/************************************************************************/
+/*                            IWriteBlock()                             */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::IWriteBlock( int, int, void * )
+{
+    return ReportNotSupported("WriteBlock");
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                            int nXOff, int nYOff,
+                                            int nXSize, int nYSize,
+                                            void * pData,
+                                            int nBufXSize, int nBufYSize,
+                                            GDALDataType eBufType,
+                                            GSpacing nPixelSpace,
+                                            GSpacing nLineSpace,
+                                            GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Write )
+        return ReportNotSupported("RasterIO");
+
+    // Requests that are not downsampled read the blocks of this band, so
+    // decode the missing ones concurrently before taking the lock. Other
+    // requests are generally served by an overview band.
+    if( nBufXSize >= nXSize && nBufYSize >= nYSize )
+        CacheBlocks(nXOff, nYOff, nXSize, nYSize);
+
+    std::lock_guard<std::mutex> oLock(m_oCacheMutex);
+    return GDALRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                     pData, nBufXSize, nBufYSize,
+                                     eBufType, nPixelSpace, nLineSpace,
+                                     psExtraArg);
+}
+
+/************************************************************************/
+/*                            SetMetadata()                             */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetMetadata( char **, const char * )
+{
+    return ReportNotSupported("SetMetadata");
+}
+
+/************************************************************************/
+/*                          SetMetadataItem()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetMetadataItem( const char *, const char *,
+                                                  const char * )
+{
+    return ReportNotSupported("SetMetadataItem");
+}
+
+/************************************************************************/
+/*                                Fill()                                */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::Fill( double, double )
+{
+    return ReportNotSupported("Fill");
+}
+
+/************************************************************************/
+/*                          SetCategoryNames()                          */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetCategoryNames( char ** )
+{
+    return ReportNotSupported("SetCategoryNames");
+}
+
+/************************************************************************/
+/*                           SetNoDataValue()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetNoDataValue( double )
+{
+    return ReportNotSupported("SetNoDataValue");
+}
+
+/************************************************************************/
+/*                         DeleteNoDataValue()                          */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::DeleteNoDataValue()
+{
+    return ReportNotSupported("DeleteNoDataValue");
+}
+
+/************************************************************************/
+/*                           SetColorTable()                            */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetColorTable( GDALColorTable * )
+{
+    return ReportNotSupported("SetColorTable");
+}
+
+/************************************************************************/
+/*                       SetColorInterpretation()                       */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetColorInterpretation( GDALColorInterp )
+{
+    return ReportNotSupported("SetColorInterpretation");
+}
+
+/************************************************************************/
+/*                             SetOffset()                              */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetOffset( double )
+{
+    return ReportNotSupported("SetOffset");
+}
+
+/************************************************************************/
+/*                              SetScale()                              */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetScale( double )
+{
+    return ReportNotSupported("SetScale");
+}
+
+/************************************************************************/
+/*                            SetUnitType()                             */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetUnitType( const char * )
+{
+    return ReportNotSupported("SetUnitType");
+}
+
+/************************************************************************/
+/*                           SetStatistics()                            */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetStatistics( double, double, double, double )
+{
+    return ReportNotSupported("SetStatistics");
+}
+
+/************************************************************************/
+/*                           BuildOverviews()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::BuildOverviews( const char *, int, const int *,
+                                                 GDALProgressFunc, void *,
+                                                 CSLConstList )
+{
+    return ReportNotSupported("BuildOverviews");
+}
+
+/************************************************************************/
+/*                        SetDefaultHistogram()                         */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetDefaultHistogram( double, double, int, GUIntBig * )
+{
+    return ReportNotSupported("SetDefaultHistogram");
+}
+
+/************************************************************************/
+/*                           SetDefaultRAT()                            */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::SetDefaultRAT( const GDALRasterAttributeTable * )
+{
+    return ReportNotSupported("SetDefaultRAT");
+}
+
+/************************************************************************/
+/*                           CreateMaskBand()                           */
+/************************************************************************/
+
+CPLErr GDALThreadSafeRasterBand::CreateMaskBand( int )
+{
+    return ReportNotSupported("CreateMaskBand");
+}
+
+/************************************************************************/
+/*                         GetVirtualMemAuto()                          */
+/************************************************************************/
+
+CPLVirtualMem* GDALThreadSafeRasterBand::GetVirtualMemAuto(
+                                                    GDALRWFlag eRWFlag,
+                                                    int *pnPixelSpace,
+                                                    GIntBig *pnLineSpace,
+                                                    char **papszOptions )
+{
+    if( eRWFlag == GF_Write )
+    {
+        ReportNotSupported("GetVirtualMemAuto");
+        return nullptr;
+    }
+    // The mapping must not depend on the underlying handles, which are not
+    // reserved to the caller, so read through this band.
+    return GDALRasterBand::GetVirtualMemAuto(eRWFlag, pnPixelSpace,
+                                             pnLineSpace, papszOptions);
+}
+
+/************************************************************************/
+/*                     GDALOpenThreadSafeDataset()                      */
+/************************************************************************/
+
+// Called by GDALOpenEx() when the GDAL_OF_THREAD_SAFE flag is set.
+// nOpenFlags must not contain it.
+GDALDataset* GDALOpenThreadSafeDataset( const char* pszFilename,
+                                        unsigned int nOpenFlags,
+                                        const char* const* papszAllowedDrivers,
+                                        const char* const* papszOpenOptions,
+                                        const char* const* papszSiblingFiles )
+{
+    if( (nOpenFlags & GDAL_OF_UPDATE) != 0 ||
+        (nOpenFlags & GDAL_OF_SHARED) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "GDAL_OF_THREAD_SAFE is incompatible with GDAL_OF_UPDATE "
+                 "and GDAL_OF_SHARED");
+        return nullptr;
+    }
+    if( (nOpenFlags & GDAL_OF_KIND_MASK) != GDAL_OF_RASTER )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "GDAL_OF_THREAD_SAFE can only be used with GDAL_OF_RASTER");
+        return nullptr;
+    }
+
+    auto poPrototypeDS = GDALDataset::Open(pszFilename,
+                                           nOpenFlags | GDAL_OF_INTERNAL,
+                                           papszAllowedDrivers,
+                                           papszOpenOptions,
+                                           papszSiblingFiles);
+    if( poPrototypeDS == nullptr )
+        return nullptr;
+
+    return new GDALThreadSafeDataset(poPrototypeDS, pszFilename,
+                                     nOpenFlags & ~GDAL_OF_VERBOSE_ERROR,
+                                     papszAllowedDrivers, papszOpenOptions,
+                                     papszSiblingFiles);
+}
+
+/*! @endcond */
@@ -68,6 +68,12 @@
 #include <smmintrin.h>
 #endif
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+#define USE_AVX2_RUNTIME
+#include "cpl_cpu_features.h"
+#include "overview_avx2.h"
+#endif
+
 #endif
 
 
@@ -2126,7 +2132,34 @@ GDALResampleChunk32R_Mode( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
 
     const int nChunkRightXOff = nChunkXOff + nChunkXSize;
     const int nChunkBottomYOff = nChunkYOff + nChunkYSize;
-    std::vector<int> anVals(256, 0);
+
+    // Values of integer data types of at most 16 bits are counted in a
+    // histogram, reused across target pixels.
+    int nBins = 0;
+    int nBinsOffset = 0;
+    if( eSrcDataType == GDT_Byte )
+    {
+        if( !(poColorTable && poColorTable->GetColorEntryCount() > 256) )
+            nBins = 256;
+    }
+    else if( eSrcDataType == GDT_Int8 )
+    {
+        nBins = 256;
+        nBinsOffset = 128;
+    }
+    else if( eSrcDataType == GDT_UInt16 )
+    {
+        nBins = 65536;
+    }
+    else if( eSrcDataType == GDT_Int16 )
+    {
+        nBins = 65536;
+        nBinsOffset = 32768;
+    }
+    std::vector<int> anVals(nBins, 0);
+    // Indices of the non-zero bins of anVals, so that only them need to be
+    // reset between target pixels.
+    std::vector<int> anUsedBins(nBins);
 
 /* ==================================================================== */
 /*      Loop over destination scanlines.                                */
@@ -2199,8 +2232,7 @@ GDALResampleChunk32R_Mode( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
             if( nSrcXOff2 > nChunkRightXOff )
                 nSrcXOff2 = nChunkRightXOff;
 
-            if( eSrcDataType != GDT_Byte ||
-                (poColorTable && poColorTable->GetColorEntryCount() > 256) )
+            if( nBins == 0 )
             {
                 // Not sure how much sense it makes to run a majority
                 // filter on floating point data, but here it is for the sake
@@ -2289,17 +2321,14 @@ GDALResampleChunk32R_Mode( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
                 else
                     pafDstScanline[iDstPixel - nDstXOff] = pafVals[iMaxVal];
             }
-            else // if( eSrcDataType == GDT_Byte && nEntryCount < 256 )
+            else
             {
-                // So we go here for a paletted or non-paletted byte band.
-                // The input values are then between 0 and 255.
+                // So we go here for a paletted or non-paletted byte band,
+                // or a 8 or 16 bit integer band. The input values are then
+                // between -nBinsOffset and nBins - nBinsOffset - 1.
                 int nMaxVal = 0;
-                int iMaxInd = -1;
-
-                // The cost of this zeroing might be high. Perhaps we should just
-                // use the above generic case, and go to this one if the number
-                // of source pixels is large enough
-                std::fill(anVals.begin(), anVals.end(), 0);
+                int iMaxInd = 0;
+                int nUsedBins = 0;
 
                 for( int iY = nSrcYOff; iY < nSrcYOff2; ++iY )
                 {
@@ -2308,21 +2337,42 @@ GDALResampleChunk32R_Mode( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
                     for( int iX = nSrcXOff; iX < nSrcXOff2; ++iX )
                     {
                         const float val = pafSrcScanline[iX+iTotYOff];
-                        if( bHasNoData == FALSE || val != fNoDataValue )
+                        // Byte bands have always been filtered on the nodata
+                        // value only, and the other ones on the mask.
+                        const bool bValid =
+                            eSrcDataType == GDT_Byte ?
+                                (bHasNoData == FALSE || val != fNoDataValue) :
+                                (pabySrcScanlineNodataMask == nullptr ||
+                                 pabySrcScanlineNodataMask[iX+iTotYOff]);
+                        if( bValid )
                         {
-                            int nVal = static_cast<int>(val);
-                            if( ++anVals[nVal] > nMaxVal)
+                            const int nVal = static_cast<int>(val);
+                            const int iBin = nVal + nBinsOffset;
+                            if( anVals[iBin] == 0 )
+                                anUsedBins[nUsedBins++] = iBin;
+                            if( ++anVals[iBin] > nMaxVal)
                             {
                                 // Sum the density.
                                 // Is it the most common value so far?
                                 iMaxInd = nVal;
-                                nMaxVal = anVals[nVal];
+                                nMaxVal = anVals[iBin];
                             }
                         }
                     }
                 }
 
-                if( iMaxInd == -1 )
+                // Reset the histogram for the next target pixel.
+                if( nUsedBins > nBins / 16 )
+                {
+                    std::fill(anVals.begin(), anVals.end(), 0);
+                }
+                else
+                {
+                    for( int i = 0; i < nUsedBins; ++i )
+                        anVals[anUsedBins[i]] = 0;
+                }
+
+                if( nMaxVal == 0 )
                     pafDstScanline[iDstPixel - nDstXOff] = fNoDataValue;
                 else
                     pafDstScanline[iDstPixel - nDstXOff] =
@@ -2918,6 +2968,61 @@ GDALResampleConvolutionHorizontalPixelCount4_3rows<GUInt16>(
 
 #endif  // USE_SSE2
 
+#ifdef USE_AVX2_RUNTIME
+
+/************************************************************************/
+/*             GDALResampleConvolutionHorizontalLinesAVX2<T>            */
+/************************************************************************/
+
+// Returns false if there is no AVX2 kernel for the data type.
+template<class T> static inline bool
+GDALResampleConvolutionHorizontalLinesAVX2(
+    const T* /* pChunk */, size_t /* nChunkLineStride */, int /* nLines */,
+    const double* /* padfWeights */, int /* nSrcPixelCount */,
+    double* /* padfDst */, size_t /* nDstLineStride */ )
+{
+    return false;
+}
+
+template<> inline bool GDALResampleConvolutionHorizontalLinesAVX2<float>(
+    const float* pChunk, size_t nChunkLineStride, int nLines,
+    const double* padfWeights, int nSrcPixelCount,
+    double* padfDst, size_t nDstLineStride )
+{
+    GDALResampleConvolutionHorizontalFloat32_AVX2(
+        pChunk, nChunkLineStride, nLines, padfWeights, nSrcPixelCount,
+        padfDst, nDstLineStride );
+    return true;
+}
+
+template<class T> static inline bool
+GDALResampleConvolutionHorizontalLinesWithMaskAVX2(
+    const T* /* pChunk */, const GByte* /* pabyMask */,
+    size_t /* nChunkLineStride */, int /* nLines */,
+    const double* /* padfWeights */, int /* nSrcPixelCount */,
+    bool /* bKernelWithNegativeWeights */,
+    double* /* padfDst */, GByte* /* pabyDstMask */,
+    size_t /* nDstLineStride */ )
+{
+    return false;
+}
+
+template<> inline bool GDALResampleConvolutionHorizontalLinesWithMaskAVX2<float>(
+    const float* pChunk, const GByte* pabyMask,
+    size_t nChunkLineStride, int nLines,
+    const double* padfWeights, int nSrcPixelCount,
+    bool bKernelWithNegativeWeights,
+    double* padfDst, GByte* pabyDstMask, size_t nDstLineStride )
+{
+    GDALResampleConvolutionHorizontalWithMaskFloat32_AVX2(
+        pChunk, pabyMask, nChunkLineStride, nLines,
+        padfWeights, nSrcPixelCount, bKernelWithNegativeWeights,
+        padfDst, pabyDstMask, nDstLineStride );
+    return true;
+}
+
+#endif  // USE_AVX2_RUNTIME
+
 /************************************************************************/
 /*                   GDALResampleChunk32R_Convolution()                 */
 /************************************************************************/
@@ -3067,6 +3172,10 @@ GDALResampleChunk32R_ConvolutionT( double dfXRatioDstToSrc,
         return CE_Failure;
     }
 
+#ifdef USE_AVX2_RUNTIME
+    const bool bUseAVX2 = CPLHaveRuntimeAVX2();
+#endif
+
 /* ==================================================================== */
 /*      First pass: horizontal filter                                   */
 /* ==================================================================== */
@@ -3132,6 +3241,17 @@ GDALResampleChunk32R_ConvolutionT( double dfXRatioDstToSrc,
                     padfWeights[i] *= dfInvWeightSum;
             }
             int iSrcLineOff = 0;
+#ifdef USE_AVX2_RUNTIME
+            if( bUseAVX2 &&
+                GDALResampleConvolutionHorizontalLinesAVX2(
+                    pChunk + (nSrcPixelStart - nChunkXOff), nChunkXSize,
+                    nHeight, padfWeights, nSrcPixelCount,
+                    padfHorizontalFiltered + (iDstPixel - nDstXOff),
+                    nDstXSize) )
+            {
+                continue;
+            }
+#endif
 #ifdef USE_SSE2
             if( nSrcPixelCount == 4 )
             {
@@ -3214,6 +3334,21 @@ GDALResampleChunk32R_ConvolutionT( double dfXRatioDstToSrc,
         }
         else
         {
+#ifdef USE_AVX2_RUNTIME
+            if( bUseAVX2 &&
+                GDALResampleConvolutionHorizontalLinesWithMaskAVX2(
+                    pChunk + (nSrcPixelStart - nChunkXOff),
+                    pabyChunkNodataMask + (nSrcPixelStart - nChunkXOff),
+                    nChunkXSize, nHeight, padfWeights, nSrcPixelCount,
+                    bKernelWithNegativeWeights,
+                    padfHorizontalFiltered + (iDstPixel - nDstXOff),
+                    pabyChunkNodataMaskHorizontalFiltered +
+                        (iDstPixel - nDstXOff),
+                    nDstXSize) )
+            {
+                continue;
+            }
+#endif
             for( int iSrcLineOff = 0; iSrcLineOff < nHeight; ++iSrcLineOff )
             {
                 const GPtrDiff_t j =
@@ -3338,6 +3473,28 @@ GDALResampleChunk32R_ConvolutionT( double dfXRatioDstToSrc,
             size_t j = (nSrcLineStart - nChunkYOff) * static_cast<size_t>(nDstXSize);
 #ifdef USE_SSE2
 
+#if defined(USE_AVX2_RUNTIME) && !defined(__AVX__)
+            if( bUseAVX2 )
+            {
+                for( ;
+                     iFilteredPixelOff+15 < nDstXSize;
+                     iFilteredPixelOff += 16, j += 16 )
+                {
+                    GDALResampleConvolutionVertical_16cols_AVX2(
+                        padfHorizontalFiltered + j, nDstXSize, padfWeights,
+                        nSrcLineCount, pafDstScanline + iFilteredPixelOff );
+                    if( bHasNoData )
+                    {
+                        for( int k = 0; k < 16; k++ )
+                        {
+                            pafDstScanline[iFilteredPixelOff + k] =
+                                replaceValIfNodata(pafDstScanline[iFilteredPixelOff + k]);
+                        }
+                    }
+                }
+            }
+#endif
+
 #ifdef __AVX__
             for( ;
                  iFilteredPixelOff+15 < nDstXSize;
@@ -3410,7 +3567,42 @@ GDALResampleChunk32R_ConvolutionT( double dfXRatioDstToSrc,
         }
         else
         {
-            for( int iFilteredPixelOff = 0;
+            int iFilteredPixelOff = 0;  // Used after for.
+#ifdef USE_AVX2_RUNTIME
+            if( bUseAVX2 )
+            {
+                for( ;
+                     iFilteredPixelOff+7 < nDstXSize;
+                     iFilteredPixelOff += 8 )
+                {
+                    const size_t j =
+                        (nSrcLineStart - nChunkYOff) * static_cast<size_t>(nDstXSize)
+                        + iFilteredPixelOff;
+                    double adfVal[8];
+                    double adfWeightSum[8];
+                    GDALResampleConvolutionVerticalWithMask_8cols_AVX2(
+                        padfHorizontalFiltered + j,
+                        pabyChunkNodataMaskHorizontalFiltered + j,
+                        nDstXSize, padfWeights, nSrcLineCount,
+                        bKernelWithNegativeWeights,
+                        adfVal, adfWeightSum );
+                    for( int k = 0; k < 8; k++ )
+                    {
+                        if( adfWeightSum[k] > 0.0 )
+                        {
+                            pafDstScanline[iFilteredPixelOff + k] =
+                                replaceValIfNodata(static_cast<float>(
+                                    adfVal[k] / adfWeightSum[k]));
+                        }
+                        else
+                        {
+                            pafDstScanline[iFilteredPixelOff + k] = fNoDataValue;
+                        }
+                    }
+                }
+            }
+#endif
+            for( ;
                  iFilteredPixelOff < nDstXSize;
                  ++iFilteredPixelOff )
             {
@@ -4504,9 +4696,7 @@ GDALRegenerateOverviewsEx( GDALRasterBandH hSrcBand,
     GByte *pabyChunkNodataMask = nullptr;
     void *pChunk = nullptr;
 
-    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
-    const int nThreads = std::max(1, std::min(128,
-            EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszThreads)));
+    const int nThreads = GDALGetNumThreads(128);
     auto poThreadPool = nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
     auto poJobQueue = poThreadPool ? poThreadPool->CreateJobQueue() :
                             std::unique_ptr<CPLJobQueue>(nullptr);
@@ -4802,6 +4992,44 @@ GDALRegenerateOverviewsEx( GDALRasterBandH hSrcBand,
     return eErr;
 }
 
+/************************************************************************/
+/*                       GDALOvrBandIsLossless()                        */
+/************************************************************************/
+
+// Returns whether the values written to an overview band are read back
+// unchanged, that is if it is not compressed with a lossy method, and does
+// not reduce the precision of values (NBITS, DISCARD_LSB).
+static bool GDALOvrBandIsLossless( GDALRasterBand* poBand )
+{
+    // Values stored with fewer bits than the data type (e.g. Float32
+    // written as 16-bit floats) are altered.
+    const char* pszNBits = poBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+    if( pszNBits != nullptr &&
+        atoi(pszNBits) < GDALGetDataTypeSizeBits(poBand->GetRasterDataType()) )
+    {
+        return false;
+    }
+
+    const char* pszCompression = nullptr;
+    GDALDataset* poDS = poBand->GetDataset();
+    if( poDS )
+    {
+        // Reported by GTiff when created with the DISCARD_LSB option.
+        if( poDS->GetMetadataItem("DISCARD_LSB", "IMAGE_STRUCTURE") != nullptr )
+            return false;
+        pszCompression = poDS->GetMetadataItem("COMPRESSION",
+                                               "IMAGE_STRUCTURE");
+    }
+    if( pszCompression == nullptr )
+        pszCompression = poBand->GetMetadataItem("COMPRESSION",
+                                                 "IMAGE_STRUCTURE");
+    return pszCompression == nullptr ||
+           !(strstr(pszCompression, "JPEG") != nullptr ||
+             STARTS_WITH_CI(pszCompression, "WEBP") ||
+             STARTS_WITH_CI(pszCompression, "JXL") ||
+             STARTS_WITH_CI(pszCompression, "LERC"));
+}
+
 /************************************************************************/
 /*            GDALRegenerateOverviewsMultiBand()                        */
 /************************************************************************/
@@ -4838,7 +5066,11 @@ GDALRegenerateOverviewsEx( GDALRasterBandH hSrcBand,
  *
  * Starting with GDAL 3.2, the GDAL_NUM_THREADS configuration option can be set
  * to "ALL_CPUS" or a integer value to specify the number of threads to use for
- * overview computation.
+ * overview computation. Starting with GDAL 3.7, when an overview level is
+ * computed from the previous one, its computation starts as soon as the
+ * needed lines of the previous level are available (unless overviews are
+ * compressed with a lossy method). The result is the same as in
+ * single-threaded mode.
  *
  * @param nBands the number of bands, size of papoSrcBands and size of
  *               first dimension of papapoOverviewBands
@@ -5000,9 +5232,7 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand* const* papoSrcBand
     const bool bPropagateNoData =
         CPLTestBool( CPLGetConfigOption("GDAL_OVR_PROPAGATE_NODATA", "NO") );
 
-    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
-    const int nThreads = std::max(1, std::min(128,
-            EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszThreads)));
+    const int nThreads = GDALGetNumThreads(128);
     auto poThreadPool = nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
     auto poJobQueue = poThreadPool ? poThreadPool->CreateJobQueue() :
                             std::unique_ptr<CPLJobQueue>(nullptr);
@@ -5011,14 +5241,43 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand* const* papoSrcBand
     const int nChunkMaxSize =
         atoi(CPLGetConfigOption("GDAL_OVR_CHUNK_MAX_SIZE", "10485760"));
 
-    // Second pass to do the real job.
-    double dfCurPixelCount = 0;
-    CPLErr eErr = CE_None;
-    for( int iOverview = 0;
-         iOverview < nOverviews && eErr == CE_None;
-         ++iOverview )
+    // State of the computation of an overview level
+    struct OvrLevel
     {
+        int iOverview = 0;
         int iSrcOverview = -1;  // -1 means the source bands.
+        int nSrcWidth = 0;
+        int nSrcHeight = 0;
+        int nDstWidth = 0;
+        int nDstHeight = 0;
+        double dfXRatioDstToSrc = 0;
+        double dfYRatioDstToSrc = 0;
+        int nOvrFactor = 1;
+        int nDstChunkXSize = 0;
+        int nDstChunkYSize = 0;
+        int nFullResXChunk = 0;
+        int nFullResYChunk = 0;
+        int nFullResXChunkQueried = 0;
+        int nFullResYChunkQueried = 0;
+
+        // Next destination line to process
+        int nDstYOff = 0;
+        // Number of destination lines written to the overview bands
+        int nDstLinesWritten = 0;
+        int nPendingJobs = 0;
+        bool bFinished = false;
+
+        std::vector<void*> apaChunk{};
+        std::vector<GByte*> apabyChunkNoDataMask{};
+    };
+
+    std::vector<OvrLevel> aoLevels(nOverviews);
+    for( int iOverview = 0; iOverview < nOverviews; ++iOverview )
+    {
+        OvrLevel& oLevel = aoLevels[iOverview];
+        oLevel.iOverview = iOverview;
+        oLevel.apaChunk.resize(nBands);
+        oLevel.apabyChunkNoDataMask.resize(nBands);
 
         int nDstChunkXSize = 0;
         int nDstChunkYSize = 0;
@@ -5037,7 +5296,7 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand* const* papoSrcBand
         {
             nSrcWidth = papapoOverviewBands[0][iOverview - 1]->GetXSize();
             nSrcHeight = papapoOverviewBands[0][iOverview - 1]->GetYSize();
-            iSrcOverview = iOverview - 1;
+            oLevel.iSrcOverview = iOverview - 1;
         }
 
         const double dfXRatioDstToSrc =
@@ -5080,348 +5339,525 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand* const* papoSrcBand
         const int nFullResXChunkQueried =
             nFullResXChunk + 2 * nKernelRadius * nOvrFactor;
 
-        // Structure describing a resampling job
-        struct OvrJob
-        {
-            // Buffers to free when job is finished
-            std::unique_ptr<PointerHolder> oSrcMaskBufferHolder{};
-            std::unique_ptr<PointerHolder> oSrcBufferHolder{};
-            std::unique_ptr<PointerHolder> oDstBufferHolder{};
-
-            // Input parameters of pfnResampleFn
-            GDALResampleFunction pfnResampleFn = nullptr;
-            double dfXRatioDstToSrc{};
-            double dfYRatioDstToSrc{};
-            GDALDataType eWrkDataType = GDT_Unknown;
-            const void * pChunk = nullptr;
-            const GByte * pabyChunkNodataMask = nullptr;
-            int nChunkXOff = 0;
-            int nChunkXSize = 0;
-            int nChunkYOff = 0;
-            int nChunkYSize = 0;
-            int nDstXOff = 0;
-            int nDstXOff2 = 0;
-            int nDstYOff = 0;
-            int nDstYOff2 = 0;
-            GDALRasterBand* poOverview = nullptr;
-            const char * pszResampling = nullptr;
-            int bHasNoData = 0;
-            float fNoDataValue = 0.0f;
-            GDALDataType eSrcDataType = GDT_Unknown;
-            bool bPropagateNoData = false;
-
-            // Output values of resampling function
-            CPLErr eErr = CE_Failure;
-            void* pDstBuffer = nullptr;
-            GDALDataType eDstBufferDataType = GDT_Unknown;
-
-            // Synchronization
-            bool                    bFinished = false;
-            std::mutex              mutex{};
-            std::condition_variable cv{};
-        };
-
-        // Thread function to resample
-        const auto JobResampleFunc = [](void* pData)
-        {
-            OvrJob* poJob = static_cast<OvrJob*>(pData);
+        oLevel.nSrcWidth = nSrcWidth;
+        oLevel.nSrcHeight = nSrcHeight;
+        oLevel.nDstWidth = nDstWidth;
+        oLevel.nDstHeight = nDstHeight;
+        oLevel.dfXRatioDstToSrc = dfXRatioDstToSrc;
+        oLevel.dfYRatioDstToSrc = dfYRatioDstToSrc;
+        oLevel.nOvrFactor = nOvrFactor;
+        oLevel.nDstChunkXSize = nDstChunkXSize;
+        oLevel.nDstChunkYSize = nDstChunkYSize;
+        oLevel.nFullResXChunk = nFullResXChunk;
+        oLevel.nFullResYChunk = nFullResYChunk;
+        oLevel.nFullResXChunkQueried = nFullResXChunkQueried;
+        oLevel.nFullResYChunkQueried = nFullResYChunkQueried;
+    }
 
-            poJob->eErr = poJob->pfnResampleFn(
-                poJob->dfXRatioDstToSrc,
-                poJob->dfYRatioDstToSrc,
-                0.0, 0.0,
-                poJob->eWrkDataType,
-                poJob->pChunk,
-                poJob->pabyChunkNodataMask,
-                poJob->nChunkXOff,
-                poJob->nChunkXSize,
-                poJob->nChunkYOff,
-                poJob->nChunkYSize,
-                poJob->nDstXOff,
-                poJob->nDstXOff2,
-                poJob->nDstYOff,
-                poJob->nDstYOff2,
-                poJob->poOverview,
-                &(poJob->pDstBuffer),
-                &(poJob->eDstBufferDataType),
-                poJob->pszResampling,
-                poJob->bHasNoData,
-                poJob->fNoDataValue,
-                nullptr,
-                poJob->eSrcDataType,
-                poJob->bPropagateNoData);
+    // When several threads are available, the computation of an overview
+    // level that is computed from the previous one starts as soon as the
+    // lines it needs have been written, instead of waiting for the previous
+    // level to be completed, so that worker threads do not starve at the
+    // end of each level. Those lines are read back from the block cache of
+    // the overview bands, which only gives the same result as in serial mode
+    // if the overviews are not compressed with a lossy method: levels are
+    // not pipelined otherwise.
+    bool bPipelineLevels = poJobQueue != nullptr && nOverviews > 1;
+    for( int iOverview = 0;
+         bPipelineLevels && iOverview + 1 < nOverviews; ++iOverview )
+    {
+        if( !GDALOvrBandIsLossless(papapoOverviewBands[0][iOverview]) )
+            bPipelineLevels = false;
+    }
 
-            poJob->oDstBufferHolder.reset(new PointerHolder(poJob->pDstBuffer));
+    // Structure describing a resampling job
+    struct OvrJob
+    {
+        // Buffers to free when job is finished
+        std::unique_ptr<PointerHolder> oSrcMaskBufferHolder{};
+        std::unique_ptr<PointerHolder> oSrcBufferHolder{};
+        std::unique_ptr<PointerHolder> oDstBufferHolder{};
 
-            {
-                std::lock_guard<std::mutex> guard(poJob->mutex);
-                poJob->bFinished = true;
-                poJob->cv.notify_one();
-            }
-        };
+        // Input parameters of pfnResampleFn
+        GDALResampleFunction pfnResampleFn = nullptr;
+        double dfXRatioDstToSrc{};
+        double dfYRatioDstToSrc{};
+        GDALDataType eWrkDataType = GDT_Unknown;
+        const void * pChunk = nullptr;
+        const GByte * pabyChunkNodataMask = nullptr;
+        int nChunkXOff = 0;
+        int nChunkXSize = 0;
+        int nChunkYOff = 0;
+        int nChunkYSize = 0;
+        int nDstXOff = 0;
+        int nDstXOff2 = 0;
+        int nDstYOff = 0;
+        int nDstYOff2 = 0;
+        GDALRasterBand* poOverview = nullptr;
+        const char * pszResampling = nullptr;
+        int bHasNoData = 0;
+        float fNoDataValue = 0.0f;
+        GDALDataType eSrcDataType = GDT_Unknown;
+        bool bPropagateNoData = false;
+
+        // Overview level of the job, and whether it is the last one of a
+        // line of chunks.
+        OvrLevel* poLevel = nullptr;
+        bool bLastOfChunkLine = false;
+
+        // Output values of resampling function
+        CPLErr eErr = CE_Failure;
+        void* pDstBuffer = nullptr;
+        GDALDataType eDstBufferDataType = GDT_Unknown;
+
+        // Synchronization
+        bool                    bFinished = false;
+        std::mutex              mutex{};
+        std::condition_variable cv{};
+    };
+
+    // Thread function to resample
+    const auto JobResampleFunc = [](void* pData)
+    {
+        OvrJob* poJob = static_cast<OvrJob*>(pData);
+
+        poJob->eErr = poJob->pfnResampleFn(
+            poJob->dfXRatioDstToSrc,
+            poJob->dfYRatioDstToSrc,
+            0.0, 0.0,
+            poJob->eWrkDataType,
+            poJob->pChunk,
+            poJob->pabyChunkNodataMask,
+            poJob->nChunkXOff,
+            poJob->nChunkXSize,
+            poJob->nChunkYOff,
+            poJob->nChunkYSize,
+            poJob->nDstXOff,
+            poJob->nDstXOff2,
+            poJob->nDstYOff,
+            poJob->nDstYOff2,
+            poJob->poOverview,
+            &(poJob->pDstBuffer),
+            &(poJob->eDstBufferDataType),
+            poJob->pszResampling,
+            poJob->bHasNoData,
+            poJob->fNoDataValue,
+            nullptr,
+            poJob->eSrcDataType,
+            poJob->bPropagateNoData);
+
+        poJob->oDstBufferHolder.reset(new PointerHolder(poJob->pDstBuffer));
 
-        // Function to write resample data to target band
-        const auto WriteJobData = [](const OvrJob* poJob)
         {
-            return poJob->poOverview->RasterIO(
-                                GF_Write,
-                                poJob->nDstXOff,
-                                poJob->nDstYOff,
-                                poJob->nDstXOff2 - poJob->nDstXOff,
-                                poJob->nDstYOff2 - poJob->nDstYOff,
-                                poJob->pDstBuffer,
-                                poJob->nDstXOff2 - poJob->nDstXOff,
-                                poJob->nDstYOff2 - poJob->nDstYOff,
-                                poJob->eDstBufferDataType,
-                                0, 0, nullptr );
-        };
-
-        // Wait for completion of oldest job and serialize it
-        const auto WaitAndFinalizeOldestJob = [WriteJobData](
-                            std::list<std::unique_ptr<OvrJob>>& jobList)
+            std::lock_guard<std::mutex> guard(poJob->mutex);
+            poJob->bFinished = true;
+            poJob->cv.notify_one();
+        }
+    };
+
+    // Function to write resample data to target band, and record how many
+    // lines of the level have been written.
+    const auto WriteJobData = [](OvrJob* poJob)
+    {
+        CPLErr l_eErr = poJob->poOverview->RasterIO(
+                            GF_Write,
+                            poJob->nDstXOff,
+                            poJob->nDstYOff,
+                            poJob->nDstXOff2 - poJob->nDstXOff,
+                            poJob->nDstYOff2 - poJob->nDstYOff,
+                            poJob->pDstBuffer,
+                            poJob->nDstXOff2 - poJob->nDstXOff,
+                            poJob->nDstYOff2 - poJob->nDstYOff,
+                            poJob->eDstBufferDataType,
+                            0, 0, nullptr );
+
+        OvrLevel* poLevel = poJob->poLevel;
+        poLevel->nPendingJobs--;
+        if( poJob->bLastOfChunkLine && l_eErr == CE_None )
+            poLevel->nDstLinesWritten = poJob->nDstYOff2;
+        return l_eErr;
+    };
+
+    // Wait for completion of oldest job and serialize it
+    const auto WaitAndFinalizeOldestJob = [WriteJobData](
+                        std::list<std::unique_ptr<OvrJob>>& jobList)
+    {
+        auto poOldestJob = jobList.front().get();
         {
-            auto poOldestJob = jobList.front().get();
-            {
-                std::unique_lock<std::mutex> oGuard(poOldestJob->mutex);
-                while( !poOldestJob->bFinished )
-                {
-                    poOldestJob->cv.wait(oGuard);
-                }
-            }
-            CPLErr l_eErr = poOldestJob->eErr;
-            if( l_eErr == CE_None )
+            std::unique_lock<std::mutex> oGuard(poOldestJob->mutex);
+            while( !poOldestJob->bFinished )
             {
-                l_eErr = WriteJobData(poOldestJob);
+                poOldestJob->cv.wait(oGuard);
             }
+        }
+        CPLErr l_eErr = poOldestJob->eErr;
+        if( l_eErr == CE_None )
+        {
+            l_eErr = WriteJobData(poOldestJob);
+        }
 
-            jobList.pop_front();
-            return l_eErr;
-        };
+        jobList.pop_front();
+        return l_eErr;
+    };
 
-        // Queue of jobs
-        std::list<std::unique_ptr<OvrJob>> jobList;
+    // Queue of jobs, of all levels.
+    std::list<std::unique_ptr<OvrJob>> jobList;
 
-        std::vector<void*> apaChunk(nBands);
-        std::vector<GByte*> apabyChunkNoDataMask(nBands);
+    // Computes the source lines needed for a line of chunks
+    const auto GetChunkLineSrcWindow = [nKernelRadius](
+        const OvrLevel& oLevel, int nDstYOff, int& nDstYCount,
+        int& nYCount, int& nChunkYOffQueried, int& nChunkYSizeQueried)
+    {
+        if( nDstYOff + oLevel.nDstChunkYSize <= oLevel.nDstHeight )
+            nDstYCount = oLevel.nDstChunkYSize;
+        else
+            nDstYCount = oLevel.nDstHeight - nDstYOff;
 
-        int nDstYOff = 0;
+        int nChunkYOff =
+            static_cast<int>(nDstYOff * oLevel.dfYRatioDstToSrc);
+        int nChunkYOff2 =
+            static_cast<int>(
+                ceil((nDstYOff + nDstYCount) * oLevel.dfYRatioDstToSrc) );
+        if( nChunkYOff2 > oLevel.nSrcHeight ||
+            nDstYOff + nDstYCount == oLevel.nDstHeight)
+            nChunkYOff2 = oLevel.nSrcHeight;
+        nYCount = nChunkYOff2 - nChunkYOff;
+        CPLAssert(nYCount <= oLevel.nFullResYChunk);
+
+        nChunkYOffQueried = nChunkYOff - nKernelRadius * oLevel.nOvrFactor;
+        nChunkYSizeQueried = nYCount + 2 * nKernelRadius * oLevel.nOvrFactor;
+        if( nChunkYOffQueried < 0 )
+        {
+            nChunkYSizeQueried += nChunkYOffQueried;
+            nChunkYOffQueried = 0;
+        }
+        if( nChunkYSizeQueried + nChunkYOffQueried > oLevel.nSrcHeight )
+            nChunkYSizeQueried = oLevel.nSrcHeight - nChunkYOffQueried;
+        CPLAssert(nChunkYSizeQueried <= oLevel.nFullResYChunkQueried);
+    };
+
+    // Whether the next line of chunks of a level can be computed, that is
+    // if the source lines it needs are available.
+    const auto CanProcessChunkLine = [&aoLevels, &GetChunkLineSrcWindow](
+                                                        const OvrLevel& oLevel)
+    {
+        if( oLevel.nDstYOff >= oLevel.nDstHeight )
+            return false;
+        if( oLevel.iSrcOverview < 0 )
+            return true;
+        const OvrLevel& oSrcLevel = aoLevels[oLevel.iSrcOverview];
+        if( oSrcLevel.bFinished )
+            return true;
+        int nDstYCount = 0;
+        int nYCount = 0;
+        int nChunkYOffQueried = 0;
+        int nChunkYSizeQueried = 0;
+        GetChunkLineSrcWindow(oLevel, oLevel.nDstYOff, nDstYCount, nYCount,
+                              nChunkYOffQueried, nChunkYSizeQueried);
+        return oSrcLevel.nDstLinesWritten >=
+                    nChunkYOffQueried + nChunkYSizeQueried;
+    };
+
+    // Second pass to do the real job.
+    double dfCurPixelCount = 0;
+    CPLErr eErr = CE_None;
+
+    // Process the next line of chunks of a level.
+    const auto ProcessChunkLine = [&](OvrLevel& oLevel)
+    {
+        const int iOverview = oLevel.iOverview;
+        const int iSrcOverview = oLevel.iSrcOverview;
+        const int nSrcWidth = oLevel.nSrcWidth;
+        const int nDstWidth = oLevel.nDstWidth;
+        const int nDstChunkXSize = oLevel.nDstChunkXSize;
+        const double dfXRatioDstToSrc = oLevel.dfXRatioDstToSrc;
+        const int nOvrFactor = oLevel.nOvrFactor;
+        const int nFullResXChunkQueried = oLevel.nFullResXChunkQueried;
+        const int nFullResYChunkQueried = oLevel.nFullResYChunkQueried;
+        std::vector<void*>& apaChunk = oLevel.apaChunk;
+        std::vector<GByte*>& apabyChunkNoDataMask =
+            oLevel.apabyChunkNoDataMask;
+
+        const int nDstYOff = oLevel.nDstYOff;
+        int nDstYCount = 0;
+        int nYCount = 0;
+        int nChunkYOffQueried = 0;
+        int nChunkYSizeQueried = 0;
+        GetChunkLineSrcWindow(oLevel, nDstYOff, nDstYCount, nYCount,
+                              nChunkYOffQueried, nChunkYSizeQueried);
+        oLevel.nDstYOff += nDstYCount;
+
+        if( !pfnProgress( dfCurPixelCount / dfTotalPixelCount,
+                          nullptr, pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+
+        int nDstXOff = 0;
         // Iterate on destination overview, block by block.
-        for( nDstYOff = 0;
-             nDstYOff < nDstHeight && eErr == CE_None;
-             nDstYOff += nDstChunkYSize )
+        for( nDstXOff = 0;
+             nDstXOff < nDstWidth && eErr == CE_None;
+             nDstXOff += nDstChunkXSize )
         {
-            int nDstYCount;
-            if( nDstYOff + nDstChunkYSize <= nDstHeight )
-                nDstYCount = nDstChunkYSize;
+            int nDstXCount = 0;
+            if( nDstXOff + nDstChunkXSize <= nDstWidth )
+                nDstXCount = nDstChunkXSize;
             else
-                nDstYCount = nDstHeight - nDstYOff;
+                nDstXCount = nDstWidth - nDstXOff;
 
-            int nChunkYOff =
-                static_cast<int>(nDstYOff * dfYRatioDstToSrc);
-            int nChunkYOff2 =
+            int nChunkXOff =
+                static_cast<int>(nDstXOff * dfXRatioDstToSrc);
+            int nChunkXOff2 =
                 static_cast<int>(
-                    ceil((nDstYOff + nDstYCount) * dfYRatioDstToSrc) );
-            if( nChunkYOff2 > nSrcHeight || nDstYOff + nDstYCount == nDstHeight)
-                nChunkYOff2 = nSrcHeight;
-            int nYCount = nChunkYOff2 - nChunkYOff;
-            CPLAssert(nYCount <= nFullResYChunk);
-
-            int nChunkYOffQueried = nChunkYOff - nKernelRadius * nOvrFactor;
-            int nChunkYSizeQueried = nYCount + 2 * nKernelRadius * nOvrFactor;
-            if( nChunkYOffQueried < 0 )
-            {
-                nChunkYSizeQueried += nChunkYOffQueried;
-                nChunkYOffQueried = 0;
-            }
-            if( nChunkYSizeQueried + nChunkYOffQueried > nSrcHeight )
-                nChunkYSizeQueried = nSrcHeight - nChunkYOffQueried;
-            CPLAssert(nChunkYSizeQueried <= nFullResYChunkQueried);
-
-            if( !pfnProgress( dfCurPixelCount / dfTotalPixelCount,
-                              nullptr, pProgressData ) )
+                    ceil((nDstXOff + nDstXCount) * dfXRatioDstToSrc) );
+            if( nChunkXOff2 > nSrcWidth ||
+                nDstXOff + nDstXCount == nDstWidth )
+                nChunkXOff2 = nSrcWidth;
+            const int nXCount = nChunkXOff2 - nChunkXOff;
+            CPLAssert(nXCount <= oLevel.nFullResXChunk);
+
+            int nChunkXOffQueried = nChunkXOff - nKernelRadius * nOvrFactor;
+            int nChunkXSizeQueried =
+                nXCount + 2 * nKernelRadius * nOvrFactor;
+            if( nChunkXOffQueried < 0 )
             {
-                CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-                eErr = CE_Failure;
+                nChunkXSizeQueried += nChunkXOffQueried;
+                nChunkXOffQueried = 0;
             }
-
-            int nDstXOff = 0;
-            // Iterate on destination overview, block by block.
-            for( nDstXOff = 0;
-                 nDstXOff < nDstWidth && eErr == CE_None;
-                 nDstXOff += nDstChunkXSize )
-            {
-                int nDstXCount = 0;
-                if( nDstXOff + nDstChunkXSize <= nDstWidth )
-                    nDstXCount = nDstChunkXSize;
-                else
-                    nDstXCount = nDstWidth - nDstXOff;
-
-                int nChunkXOff =
-                    static_cast<int>(nDstXOff * dfXRatioDstToSrc);
-                int nChunkXOff2 =
-                    static_cast<int>(
-                        ceil((nDstXOff + nDstXCount) * dfXRatioDstToSrc) );
-                if( nChunkXOff2 > nSrcWidth ||
-                    nDstXOff + nDstXCount == nDstWidth )
-                    nChunkXOff2 = nSrcWidth;
-                const int nXCount = nChunkXOff2 - nChunkXOff;
-                CPLAssert(nXCount <= nFullResXChunk);
-
-                int nChunkXOffQueried = nChunkXOff - nKernelRadius * nOvrFactor;
-                int nChunkXSizeQueried =
-                    nXCount + 2 * nKernelRadius * nOvrFactor;
-                if( nChunkXOffQueried < 0 )
-                {
-                    nChunkXSizeQueried += nChunkXOffQueried;
-                    nChunkXOffQueried = 0;
-                }
-                if( nChunkXSizeQueried + nChunkXOffQueried > nSrcWidth )
-                    nChunkXSizeQueried = nSrcWidth - nChunkXOffQueried;
-                CPLAssert(nChunkXSizeQueried <= nFullResXChunkQueried);
+            if( nChunkXSizeQueried + nChunkXOffQueried > nSrcWidth )
+                nChunkXSizeQueried = nSrcWidth - nChunkXOffQueried;
+            CPLAssert(nChunkXSizeQueried <= nFullResXChunkQueried);
 #if DEBUG_VERBOSE
-                CPLDebug(
-                    "GDAL",
-                    "Reading (%dx%d -> %dx%d) for output (%dx%d -> %dx%d)",
-                    nChunkXOffQueried, nChunkYOffQueried, nChunkXSizeQueried, nChunkYSizeQueried,
-                    nDstXOff, nDstYOff, nDstXCount, nDstYCount );
+            CPLDebug(
+                "GDAL",
+                "Reading (%dx%d -> %dx%d) for output (%dx%d -> %dx%d)",
+                nChunkXOffQueried, nChunkYOffQueried, nChunkXSizeQueried, nChunkYSizeQueried,
+                nDstXOff, nDstYOff, nDstXCount, nDstYCount );
 #endif
 
-                // Avoid accumulating too many tasks and exhaust RAM
+            // Avoid accumulating too many tasks and exhaust RAM
 
-                // Try to complete already finished jobs
-                while( eErr == CE_None && !jobList.empty() )
+            // Try to complete already finished jobs
+            while( eErr == CE_None && !jobList.empty() )
+            {
+                auto poOldestJob = jobList.front().get();
                 {
-                    auto poOldestJob = jobList.front().get();
+                    std::lock_guard<std::mutex> oGuard(poOldestJob->mutex);
+                    if( !poOldestJob->bFinished )
                     {
-                        std::lock_guard<std::mutex> oGuard(poOldestJob->mutex);
-                        if( !poOldestJob->bFinished )
-                        {
-                            break;
-                        }
+                        break;
                     }
-                    eErr = poOldestJob->eErr;
-                    if( eErr == CE_None )
-                    {
-                        eErr = WriteJobData(poOldestJob);
-                    }
-
-                    jobList.pop_front();
                 }
-
-                // And in case we have saturated the number of threads,
-                // wait for completion of tasks to go below the threshold.
-                while( eErr == CE_None &&
-                       jobList.size() >= static_cast<size_t>(nThreads) )
+                eErr = poOldestJob->eErr;
+                if( eErr == CE_None )
                 {
-                    eErr = WaitAndFinalizeOldestJob(jobList);
+                    eErr = WriteJobData(poOldestJob);
                 }
 
-                // (Re)allocate buffers if needed
-                for( int iBand = 0; iBand < nBands; ++iBand )
+                jobList.pop_front();
+            }
+
+            // And in case we have saturated the number of threads,
+            // wait for completion of tasks to go below the threshold.
+            while( eErr == CE_None &&
+                   jobList.size() >= static_cast<size_t>(nThreads) )
+            {
+                eErr = WaitAndFinalizeOldestJob(jobList);
+            }
+
+            // (Re)allocate buffers if needed
+            for( int iBand = 0; iBand < nBands; ++iBand )
+            {
+                if( apaChunk[iBand] == nullptr )
                 {
+                    apaChunk[iBand] = VSI_MALLOC3_VERBOSE(
+                        nFullResXChunkQueried,
+                        nFullResYChunkQueried,
+                        GDALGetDataTypeSizeBytes(eWrkDataType) );
                     if( apaChunk[iBand] == nullptr )
                     {
-                        apaChunk[iBand] = VSI_MALLOC3_VERBOSE(
-                            nFullResXChunkQueried,
-                            nFullResYChunkQueried,
-                            GDALGetDataTypeSizeBytes(eWrkDataType) );
-                        if( apaChunk[iBand] == nullptr )
-                        {
-                            eErr = CE_Failure;
-                        }
+                        eErr = CE_Failure;
                     }
-                    if( bUseNoDataMask && apabyChunkNoDataMask[iBand] == nullptr  )
+                }
+                if( bUseNoDataMask && apabyChunkNoDataMask[iBand] == nullptr  )
+                {
+                    apabyChunkNoDataMask[iBand] = static_cast<GByte *>(
+                        VSI_MALLOC2_VERBOSE( nFullResXChunkQueried,
+                                            nFullResYChunkQueried ) );
+                    if( apabyChunkNoDataMask[iBand] == nullptr )
                     {
-                        apabyChunkNoDataMask[iBand] = static_cast<GByte *>(
-                            VSI_MALLOC2_VERBOSE( nFullResXChunkQueried,
-                                                nFullResYChunkQueried ) );
-                        if( apabyChunkNoDataMask[iBand] == nullptr )
-                        {
-                            eErr = CE_Failure;
-                        }
+                        eErr = CE_Failure;
                     }
                 }
+            }
 
-                // Read the source buffers for all the bands.
-                for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+            // Read the source buffers for all the bands.
+            for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+            {
+                GDALRasterBand* poSrcBand = nullptr;
+                if( iSrcOverview == -1 )
+                    poSrcBand = papoSrcBands[iBand];
+                else
+                    poSrcBand = papapoOverviewBands[iBand][iSrcOverview];
+                eErr = poSrcBand->RasterIO(
+                    GF_Read,
+                    nChunkXOffQueried, nChunkYOffQueried,
+                    nChunkXSizeQueried, nChunkYSizeQueried,
+                    apaChunk[iBand],
+                    nChunkXSizeQueried, nChunkYSizeQueried,
+                    eWrkDataType, 0, 0, nullptr );
+
+                if( bUseNoDataMask && eErr == CE_None )
                 {
-                    GDALRasterBand* poSrcBand = nullptr;
-                    if( iSrcOverview == -1 )
-                        poSrcBand = papoSrcBands[iBand];
-                    else
-                        poSrcBand = papapoOverviewBands[iBand][iSrcOverview];
-                    eErr = poSrcBand->RasterIO(
+                    auto poMaskBand = poSrcBand->IsMaskBand() ? poSrcBand : poSrcBand->GetMaskBand();
+                    eErr = poMaskBand->RasterIO(
                         GF_Read,
                         nChunkXOffQueried, nChunkYOffQueried,
                         nChunkXSizeQueried, nChunkYSizeQueried,
-                        apaChunk[iBand],
+                        apabyChunkNoDataMask[iBand],
                         nChunkXSizeQueried, nChunkYSizeQueried,
-                        eWrkDataType, 0, 0, nullptr );
-
-                    if( bUseNoDataMask && eErr == CE_None )
-                    {
-                        auto poMaskBand = poSrcBand->IsMaskBand() ? poSrcBand : poSrcBand->GetMaskBand();
-                        eErr = poMaskBand->RasterIO(
-                            GF_Read,
-                            nChunkXOffQueried, nChunkYOffQueried,
-                            nChunkXSizeQueried, nChunkYSizeQueried,
-                            apabyChunkNoDataMask[iBand],
-                            nChunkXSizeQueried, nChunkYSizeQueried,
-                            GDT_Byte, 0, 0, nullptr );
-                    }
+                        GDT_Byte, 0, 0, nullptr );
                 }
+            }
 
-                // Compute the resulting overview block.
-                for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+            // Compute the resulting overview block.
+            for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+            {
+                auto poJob = std::unique_ptr<OvrJob>(new OvrJob());
+                poJob->pfnResampleFn = pfnResampleFn;
+                poJob->dfXRatioDstToSrc = dfXRatioDstToSrc;
+                poJob->dfYRatioDstToSrc = oLevel.dfYRatioDstToSrc;
+                poJob->eWrkDataType = eWrkDataType;
+                poJob->pChunk = apaChunk[iBand];
+                poJob->pabyChunkNodataMask = apabyChunkNoDataMask[iBand];
+                poJob->nChunkXOff = nChunkXOffQueried;
+                poJob->nChunkXSize = nChunkXSizeQueried;
+                poJob->nChunkYOff = nChunkYOffQueried;
+                poJob->nChunkYSize = nChunkYSizeQueried;
+                poJob->nDstXOff = nDstXOff;
+                poJob->nDstXOff2 = nDstXOff + nDstXCount;
+                poJob->nDstYOff = nDstYOff;
+                poJob->nDstYOff2 = nDstYOff + nDstYCount;
+                poJob->poOverview = papapoOverviewBands[iBand][iOverview];
+                poJob->pszResampling = pszResampling;
+                poJob->bHasNoData = pabHasNoData[iBand];
+                poJob->fNoDataValue = pafNoDataValue[iBand];
+                poJob->eSrcDataType = eDataType;
+                poJob->bPropagateNoData = bPropagateNoData;
+                poJob->poLevel = &oLevel;
+                poJob->bLastOfChunkLine =
+                    nDstXOff + nDstXCount == nDstWidth && iBand == nBands - 1;
+                oLevel.nPendingJobs++;
+
+                if( poJobQueue )
                 {
-                    auto poJob = std::unique_ptr<OvrJob>(new OvrJob());
-                    poJob->pfnResampleFn = pfnResampleFn;
-                    poJob->dfXRatioDstToSrc = dfXRatioDstToSrc;
-                    poJob->dfYRatioDstToSrc = dfYRatioDstToSrc;
-                    poJob->eWrkDataType = eWrkDataType;
-                    poJob->pChunk = apaChunk[iBand];
-                    poJob->pabyChunkNodataMask = apabyChunkNoDataMask[iBand];
-                    poJob->nChunkXOff = nChunkXOffQueried;
-                    poJob->nChunkXSize = nChunkXSizeQueried;
-                    poJob->nChunkYOff = nChunkYOffQueried;
-                    poJob->nChunkYSize = nChunkYSizeQueried;
-                    poJob->nDstXOff = nDstXOff;
-                    poJob->nDstXOff2 = nDstXOff + nDstXCount;
-                    poJob->nDstYOff = nDstYOff;
-                    poJob->nDstYOff2 = nDstYOff + nDstYCount;
-                    poJob->poOverview = papapoOverviewBands[iBand][iOverview];
-                    poJob->pszResampling = pszResampling;
-                    poJob->bHasNoData = pabHasNoData[iBand];
-                    poJob->fNoDataValue = pafNoDataValue[iBand];
-                    poJob->eSrcDataType = eDataType;
-                    poJob->bPropagateNoData = bPropagateNoData;
-
-                    if( poJobQueue )
-                    {
-                        poJob->oSrcMaskBufferHolder.reset(
-                            new PointerHolder(apabyChunkNoDataMask[iBand]));
-                        apabyChunkNoDataMask[iBand] = nullptr;
+                    poJob->oSrcMaskBufferHolder.reset(
+                        new PointerHolder(apabyChunkNoDataMask[iBand]));
+                    apabyChunkNoDataMask[iBand] = nullptr;
 
-                        poJob->oSrcBufferHolder.reset(
-                            new PointerHolder(apaChunk[iBand]));
-                        apaChunk[iBand] = nullptr;
+                    poJob->oSrcBufferHolder.reset(
+                        new PointerHolder(apaChunk[iBand]));
+                    apaChunk[iBand] = nullptr;
 
-                        poJobQueue->SubmitJob(JobResampleFunc, poJob.get());
-                        jobList.emplace_back(std::move(poJob));
-                    }
-                    else
+                    poJobQueue->SubmitJob(JobResampleFunc, poJob.get());
+                    jobList.emplace_back(std::move(poJob));
+                }
+                else
+                {
+                    JobResampleFunc(poJob.get());
+                    eErr = poJob->eErr;
+                    if( eErr == CE_None )
                     {
-                        JobResampleFunc(poJob.get());
-                        eErr = poJob->eErr;
-                        if( eErr == CE_None )
-                        {
-                            eErr = WriteJobData(poJob.get());
-                        }
+                        eErr = WriteJobData(poJob.get());
                     }
                 }
             }
+        }
+
+        dfCurPixelCount += static_cast<double>(nYCount) * nSrcWidth;
+    };
+
+    // Flush the data of a completed level to overviews.
+    const auto FinishLevel = [nBands, papapoOverviewBands](OvrLevel& oLevel)
+    {
+        for( int iBand = 0; iBand < nBands; ++iBand )
+        {
+            CPLFree(oLevel.apaChunk[iBand]);
+            oLevel.apaChunk[iBand] = nullptr;
+            papapoOverviewBands[iBand][oLevel.iOverview]->FlushCache(false);
+
+            CPLFree(oLevel.apabyChunkNoDataMask[iBand]);
+            oLevel.apabyChunkNoDataMask[iBand] = nullptr;
+        }
+        oLevel.bFinished = true;
+    };
+
+    if( !bPipelineLevels )
+    {
+        for( int iOverview = 0;
+             iOverview < nOverviews && eErr == CE_None;
+             ++iOverview )
+        {
+            OvrLevel& oLevel = aoLevels[iOverview];
+            while( oLevel.nDstYOff < oLevel.nDstHeight && eErr == CE_None )
+                ProcessChunkLine(oLevel);
+
+            // Wait for all pending jobs to complete
+            while( !jobList.empty() )
+            {
+                const auto l_eErr = WaitAndFinalizeOldestJob(jobList);
+                if( l_eErr != CE_None && eErr == CE_None )
+                    eErr = l_eErr;
+            }
+
+            FinishLevel(oLevel);
+        }
+    }
+    else
+    {
+        int nFinishedLevels = 0;
+        while( nFinishedLevels < nOverviews && eErr == CE_None )
+        {
+            // Complete levels whose all jobs have been written, in order.
+            OvrLevel& oFirstLevel = aoLevels[nFinishedLevels];
+            if( oFirstLevel.nDstYOff >= oFirstLevel.nDstHeight &&
+                oFirstLevel.nPendingJobs == 0 )
+            {
+                FinishLevel(oFirstLevel);
+                nFinishedLevels++;
+                continue;
+            }
+
+            // Favor the deepest level that can progress, to keep the memory
+            // usage of the block cache low.
+            OvrLevel* poLevel = nullptr;
+            for( int iOverview = nOverviews - 1;
+                 iOverview >= nFinishedLevels; --iOverview )
+            {
+                if( CanProcessChunkLine(aoLevels[iOverview]) )
+                {
+                    poLevel = &aoLevels[iOverview];
+                    break;
+                }
+            }
 
-            dfCurPixelCount += static_cast<double>(nYCount) * nSrcWidth;
+            if( poLevel )
+            {
+                ProcessChunkLine(*poLevel);
+            }
+            else if( !jobList.empty() )
+            {
+                eErr = WaitAndFinalizeOldestJob(jobList);
+            }
+            else
+            {
+                // Should not happen
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "GDALRegenerateOverviewsMultiBand(): "
+                         "no level can progress");
+                eErr = CE_Failure;
+            }
         }
 
         // Wait for all pending jobs to complete
@@ -5432,13 +5868,10 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand* const* papoSrcBand
                 eErr = l_eErr;
         }
 
-        // Flush the data to overviews.
-        for( int iBand = 0; iBand < nBands; ++iBand )
+        for( auto& oLevel: aoLevels )
         {
-            CPLFree(apaChunk[iBand]);
-            papapoOverviewBands[iBand][iOverview]->FlushCache(false);
-
-            CPLFree(apabyChunkNoDataMask[iBand]);
+            if( !oLevel.bFinished )
+                FinishLevel(oLevel);
         }
     }
 
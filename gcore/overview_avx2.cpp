@@ -0,0 +1,336 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  AVX2 convolution kernels for overview computation
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
+
+#include "overview_avx2.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
+// Note: multiplications and additions are deliberately not fused, so that
+// results are as close as possible to the ones of the SSE2 and scalar code
+// paths, and because the build only checks for AVX2 support.
+
+namespace
+{
+
+/************************************************************************/
+/*                             Load4Float()                             */
+/************************************************************************/
+
+inline __m256d Load4Float(const float* p)
+{
+    return _mm256_cvtps_pd(_mm_loadu_ps(p));
+}
+
+/************************************************************************/
+/*                             Load4Mask()                              */
+/************************************************************************/
+
+inline __m256d Load4Mask(const GByte* p)
+{
+    int nVal;
+    memcpy(&nVal, p, sizeof(nVal));
+    return _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(nVal)));
+}
+
+/************************************************************************/
+/*                             HorizSum()                               */
+/************************************************************************/
+
+inline double HorizSum(__m256d v)
+{
+    const __m128d v2 = _mm_add_pd(_mm256_castpd256_pd128(v),
+                                  _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(v2, _mm_unpackhi_pd(v2, v2)));
+}
+
+/************************************************************************/
+/*                           HorizSum4Vec()                             */
+/************************************************************************/
+
+// Returns [sum(v0), sum(v1), sum(v2), sum(v3)]
+inline __m256d HorizSum4Vec(__m256d v0, __m256d v1, __m256d v2, __m256d v3)
+{
+    // [v0_0+v0_1, v1_0+v1_1, v0_2+v0_3, v1_2+v1_3]
+    const __m256d v01 = _mm256_hadd_pd(v0, v1);
+    // [v2_0+v2_1, v3_0+v3_1, v2_2+v2_3, v3_2+v3_3]
+    const __m256d v23 = _mm256_hadd_pd(v2, v3);
+    const __m256d vLow = _mm256_permute2f128_pd(v01, v23, 0x20);
+    const __m256d vHigh = _mm256_permute2f128_pd(v01, v23, 0x31);
+    return _mm256_add_pd(vLow, vHigh);
+}
+
+/************************************************************************/
+/*                      GetMaxConsecutiveValid()                        */
+/************************************************************************/
+
+inline int GetMaxConsecutiveValid(const GByte* pabyMask, int nCount)
+{
+    int nConsecutiveValid = 0;
+    int nMaxConsecutiveValid = 0;
+    for( int k = 0; k < nCount; k++ )
+    {
+        if( pabyMask[k] )
+            nConsecutiveValid ++;
+        else if( nConsecutiveValid )
+        {
+            nMaxConsecutiveValid = std::max(nMaxConsecutiveValid,
+                                            nConsecutiveValid);
+            nConsecutiveValid = 0;
+        }
+    }
+    return std::max(nMaxConsecutiveValid, nConsecutiveValid);
+}
+
+} // namespace
+
+/************************************************************************/
+/*              GDALResampleConvolutionHorizontalFloat32_AVX2()         */
+/************************************************************************/
+
+void GDALResampleConvolutionHorizontalFloat32_AVX2(
+    const float* pChunk, size_t nChunkLineStride, int nLines,
+    const double* padfWeights, int nSrcPixelCount,
+    double* padfDst, size_t nDstLineStride )
+{
+    int iLine = 0;
+    for( ; iLine + 3 < nLines; iLine += 4 )
+    {
+        const float* const pLine0 = pChunk + iLine * nChunkLineStride;
+        const float* const pLine1 = pLine0 + nChunkLineStride;
+        const float* const pLine2 = pLine1 + nChunkLineStride;
+        const float* const pLine3 = pLine2 + nChunkLineStride;
+        __m256d v_acc0 = _mm256_setzero_pd();
+        __m256d v_acc1 = _mm256_setzero_pd();
+        __m256d v_acc2 = _mm256_setzero_pd();
+        __m256d v_acc3 = _mm256_setzero_pd();
+        int i = 0;
+        for( ; i + 3 < nSrcPixelCount; i += 4 )
+        {
+            const __m256d v_weight = _mm256_loadu_pd(padfWeights + i);
+            v_acc0 = _mm256_add_pd(v_acc0,
+                        _mm256_mul_pd(Load4Float(pLine0 + i), v_weight));
+            v_acc1 = _mm256_add_pd(v_acc1,
+                        _mm256_mul_pd(Load4Float(pLine1 + i), v_weight));
+            v_acc2 = _mm256_add_pd(v_acc2,
+                        _mm256_mul_pd(Load4Float(pLine2 + i), v_weight));
+            v_acc3 = _mm256_add_pd(v_acc3,
+                        _mm256_mul_pd(Load4Float(pLine3 + i), v_weight));
+        }
+        double adfRes[4];
+        _mm256_storeu_pd(adfRes, HorizSum4Vec(v_acc0, v_acc1, v_acc2, v_acc3));
+        for( ; i < nSrcPixelCount; ++i )
+        {
+            adfRes[0] += pLine0[i] * padfWeights[i];
+            adfRes[1] += pLine1[i] * padfWeights[i];
+            adfRes[2] += pLine2[i] * padfWeights[i];
+            adfRes[3] += pLine3[i] * padfWeights[i];
+        }
+        padfDst[iLine * nDstLineStride] = adfRes[0];
+        padfDst[(iLine + 1) * nDstLineStride] = adfRes[1];
+        padfDst[(iLine + 2) * nDstLineStride] = adfRes[2];
+        padfDst[(iLine + 3) * nDstLineStride] = adfRes[3];
+    }
+    for( ; iLine < nLines; ++iLine )
+    {
+        const float* const pLine = pChunk + iLine * nChunkLineStride;
+        __m256d v_acc = _mm256_setzero_pd();
+        int i = 0;
+        for( ; i + 3 < nSrcPixelCount; i += 4 )
+        {
+            v_acc = _mm256_add_pd(v_acc,
+                        _mm256_mul_pd(Load4Float(pLine + i),
+                                      _mm256_loadu_pd(padfWeights + i)));
+        }
+        double dfVal = HorizSum(v_acc);
+        for( ; i < nSrcPixelCount; ++i )
+            dfVal += pLine[i] * padfWeights[i];
+        padfDst[iLine * nDstLineStride] = dfVal;
+    }
+}
+
+/************************************************************************/
+/*          GDALResampleConvolutionHorizontalWithMaskFloat32_AVX2()     */
+/************************************************************************/
+
+void GDALResampleConvolutionHorizontalWithMaskFloat32_AVX2(
+    const float* pChunk, const GByte* pabyMask,
+    size_t nChunkLineStride, int nLines,
+    const double* padfWeights, int nSrcPixelCount,
+    bool bKernelWithNegativeWeights,
+    double* padfDst, GByte* pabyDstMask, size_t nDstLineStride )
+{
+    for( int iLine = 0; iLine < nLines; ++iLine )
+    {
+        const float* const pLine = pChunk + iLine * nChunkLineStride;
+        const GByte* const pabyLineMask = pabyMask + iLine * nChunkLineStride;
+        const size_t nDstOffset = iLine * nDstLineStride;
+
+        if( bKernelWithNegativeWeights &&
+            GetMaxConsecutiveValid(pabyLineMask, nSrcPixelCount) <
+                                                        nSrcPixelCount / 2 )
+        {
+            padfDst[nDstOffset] = 0.0;
+            pabyDstMask[nDstOffset] = 0;
+            continue;
+        }
+
+        __m256d v_acc = _mm256_setzero_pd();
+        __m256d v_accWeight = _mm256_setzero_pd();
+        int i = 0;
+        for( ; i + 3 < nSrcPixelCount; i += 4 )
+        {
+            const __m256d v_weight =
+                _mm256_mul_pd(_mm256_loadu_pd(padfWeights + i),
+                              Load4Mask(pabyLineMask + i));
+            v_acc = _mm256_add_pd(v_acc,
+                        _mm256_mul_pd(Load4Float(pLine + i), v_weight));
+            v_accWeight = _mm256_add_pd(v_accWeight, v_weight);
+        }
+        double dfVal = HorizSum(v_acc);
+        double dfWeightSum = HorizSum(v_accWeight);
+        for( ; i < nSrcPixelCount; ++i )
+        {
+            const double dfWeight = padfWeights[i] * pabyLineMask[i];
+            dfVal += pLine[i] * dfWeight;
+            dfWeightSum += dfWeight;
+        }
+
+        if( dfWeightSum > 0.0 )
+        {
+            padfDst[nDstOffset] = dfVal / dfWeightSum;
+            pabyDstMask[nDstOffset] = 1;
+        }
+        else
+        {
+            padfDst[nDstOffset] = 0.0;
+            pabyDstMask[nDstOffset] = 0;
+        }
+    }
+}
+
+/************************************************************************/
+/*             GDALResampleConvolutionVertical_16cols_AVX2()            */
+/************************************************************************/
+
+void GDALResampleConvolutionVertical_16cols_AVX2(
+    const double* padfSrc, size_t nStride,
+    const double* padfWeights, int nSrcLineCount, float* afDest )
+{
+    __m256d v_acc0 = _mm256_setzero_pd();
+    __m256d v_acc1 = _mm256_setzero_pd();
+    __m256d v_acc2 = _mm256_setzero_pd();
+    __m256d v_acc3 = _mm256_setzero_pd();
+    const double* pSrc = padfSrc;
+    for( int i = 0; i < nSrcLineCount; ++i, pSrc += nStride )
+    {
+        const __m256d w = _mm256_broadcast_sd(padfWeights + i);
+        v_acc0 = _mm256_add_pd(v_acc0,
+                    _mm256_mul_pd(_mm256_loadu_pd(pSrc + 0), w));
+        v_acc1 = _mm256_add_pd(v_acc1,
+                    _mm256_mul_pd(_mm256_loadu_pd(pSrc + 4), w));
+        v_acc2 = _mm256_add_pd(v_acc2,
+                    _mm256_mul_pd(_mm256_loadu_pd(pSrc + 8), w));
+        v_acc3 = _mm256_add_pd(v_acc3,
+                    _mm256_mul_pd(_mm256_loadu_pd(pSrc + 12), w));
+    }
+    _mm_storeu_ps(afDest, _mm256_cvtpd_ps(v_acc0));
+    _mm_storeu_ps(afDest + 4, _mm256_cvtpd_ps(v_acc1));
+    _mm_storeu_ps(afDest + 8, _mm256_cvtpd_ps(v_acc2));
+    _mm_storeu_ps(afDest + 12, _mm256_cvtpd_ps(v_acc3));
+}
+
+/************************************************************************/
+/*          GDALResampleConvolutionVerticalWithMask_8cols_AVX2()        */
+/************************************************************************/
+
+void GDALResampleConvolutionVerticalWithMask_8cols_AVX2(
+    const double* padfSrc, const GByte* pabyMask, size_t nStride,
+    const double* padfWeights, int nSrcLineCount,
+    bool bKernelWithNegativeWeights,
+    double* adfVal, double* adfWeightSum )
+{
+    __m256d v_acc0 = _mm256_setzero_pd();
+    __m256d v_acc1 = _mm256_setzero_pd();
+    __m256d v_accWeight0 = _mm256_setzero_pd();
+    __m256d v_accWeight1 = _mm256_setzero_pd();
+    // Per column count of consecutive valid values, and its maximum
+    __m256i v_consecutiveValid = _mm256_setzero_si256();
+    __m256i v_maxConsecutiveValid = _mm256_setzero_si256();
+    const __m256i v_one = _mm256_set1_epi32(1);
+    const double* pSrc = padfSrc;
+    const GByte* pabySrcMask = pabyMask;
+    for( int i = 0; i < nSrcLineCount;
+         ++i, pSrc += nStride, pabySrcMask += nStride )
+    {
+        const __m256i v_mask = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pabySrcMask)));
+        if( bKernelWithNegativeWeights )
+        {
+            // mask is 0 or 1: reset the counter to 0 on invalid values
+            v_consecutiveValid = _mm256_and_si256(
+                _mm256_add_epi32(v_consecutiveValid, v_one),
+                _mm256_sub_epi32(_mm256_setzero_si256(), v_mask));
+            v_maxConsecutiveValid = _mm256_max_epi32(v_maxConsecutiveValid,
+                                                     v_consecutiveValid);
+        }
+        const __m256d w = _mm256_broadcast_sd(padfWeights + i);
+        const __m256d v_weight0 = _mm256_mul_pd(w,
+            _mm256_cvtepi32_pd(_mm256_castsi256_si128(v_mask)));
+        const __m256d v_weight1 = _mm256_mul_pd(w,
+            _mm256_cvtepi32_pd(_mm256_extracti128_si256(v_mask, 1)));
+        v_acc0 = _mm256_add_pd(v_acc0,
+                    _mm256_mul_pd(_mm256_loadu_pd(pSrc + 0), v_weight0));
+        v_acc1 = _mm256_add_pd(v_acc1,
+                    _mm256_mul_pd(_mm256_loadu_pd(pSrc + 4), v_weight1));
+        v_accWeight0 = _mm256_add_pd(v_accWeight0, v_weight0);
+        v_accWeight1 = _mm256_add_pd(v_accWeight1, v_weight1);
+    }
+    _mm256_storeu_pd(adfVal, v_acc0);
+    _mm256_storeu_pd(adfVal + 4, v_acc1);
+    _mm256_storeu_pd(adfWeightSum, v_accWeight0);
+    _mm256_storeu_pd(adfWeightSum + 4, v_accWeight1);
+    if( bKernelWithNegativeWeights )
+    {
+        int anMaxConsecutiveValid[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(anMaxConsecutiveValid),
+                            v_maxConsecutiveValid);
+        for( int k = 0; k < 8; ++k )
+        {
+            if( anMaxConsecutiveValid[k] < nSrcLineCount / 2 )
+                adfWeightSum[k] = 0.0;
+        }
+    }
+}
+
+#endif
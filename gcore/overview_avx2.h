@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  AVX2 convolution kernels for overview computation
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef OVERVIEW_AVX2_H_INCLUDED
+#define OVERVIEW_AVX2_H_INCLUDED
+
+#include "cpl_port.h"
+
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
+
+#include <cstddef>
+
+// Horizontal pass of GDALResampleChunk32R_ConvolutionT<float>() for one
+// target pixel: convolves nSrcPixelCount values of each of the nLines lines
+// of pChunk (nChunkLineStride values apart), and stores the results in
+// padfDst, nDstLineStride values apart.
+void GDALResampleConvolutionHorizontalFloat32_AVX2(
+    const float* pChunk, size_t nChunkLineStride, int nLines,
+    const double* padfWeights, int nSrcPixelCount,
+    double* padfDst, size_t nDstLineStride );
+
+// Same as above, taking into account the validity mask of the source
+// pixels (one byte per pixel, with the same layout as pChunk). The
+// convolved values are normalized by the sum of the weights of valid pixels,
+// and the validity mask of the target ones is set in pabyDstMask.
+void GDALResampleConvolutionHorizontalWithMaskFloat32_AVX2(
+    const float* pChunk, const GByte* pabyMask,
+    size_t nChunkLineStride, int nLines,
+    const double* padfWeights, int nSrcPixelCount,
+    bool bKernelWithNegativeWeights,
+    double* padfDst, GByte* pabyDstMask, size_t nDstLineStride );
+
+// Vertical pass of GDALResampleChunk32R_ConvolutionT() for 16 consecutive
+// target columns of the horizontally filtered buffer.
+void GDALResampleConvolutionVertical_16cols_AVX2(
+    const double* padfSrc, size_t nStride,
+    const double* padfWeights, int nSrcLineCount, float* afDest );
+
+// Vertical pass for 8 consecutive target columns, taking into account the
+// validity mask of the source values. adfVal[] receives the non-normalized
+// values, and adfWeightSum[] the sum of the weights of the valid values, or
+// 0 if the target value must be considered as invalid.
+void GDALResampleConvolutionVerticalWithMask_8cols_AVX2(
+    const double* padfSrc, const GByte* pabyMask, size_t nStride,
+    const double* padfWeights, int nSrcLineCount,
+    bool bKernelWithNegativeWeights,
+    double* adfVal, double* adfWeightSum );
+
+#endif
+
+#endif /* OVERVIEW_AVX2_H_INCLUDED */
@@ -40,21 +40,31 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_cpu_features.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 #include "gdal_vrt.h"
 #include "gdalwarper.h"
 #include "memdataset.h"
 #include "vrtdataset.h"
+#include "rasterio_avx2.h"
 
 
 static void GDALFastCopyByte( const GByte * CPL_RESTRICT pSrcData,
@@ -197,6 +207,157 @@ no_reload_block:
     return true;
 }
 
+/************************************************************************/
+/*                      TryDirectBlockRasterIO()                        */
+/*                                                                      */
+/*      Non-resampled reads that are larger than the block cache do     */
+/*      not benefit from caching their blocks, which would only evict   */
+/*      everything else. In that case, blocks that are not already      */
+/*      cached are decoded with IReadBlock() without going through      */
+/*      GDALRasterBlock: directly in the user buffer when a whole       */
+/*      block is requested and the buffer lines are contiguous and one  */
+/*      block wide, or otherwise in a temporary block buffer from which */
+/*      the requested part is copied with the requested pixel and line  */
+/*      spacing.                                                        */
+/*      By default (GDAL_RASTERIO_BYPASS_CACHE=AUTO), this is only done */
+/*      for bands of drivers that have opted in, by setting             */
+/*      m_bBypassCacheForLargeReads. It can be forced or disabled for   */
+/*      all drivers with GDAL_RASTERIO_BYPASS_CACHE=YES/NO.             */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+CPLErr GDALRasterBand::TryDirectBlockRasterIO( int nXOff, int nYOff,
+                                               int nXSize, int nYSize,
+                                               void * pData,
+                                               GDALDataType eBufType,
+                                               GSpacing nPixelSpace,
+                                               GSpacing nLineSpace,
+                                               GDALRasterIOExtraArg* psExtraArg,
+                                               int* pbTried )
+{
+    *pbTried = FALSE;
+
+    const int nBandDataSize = GDALGetDataTypeSizeBytes( eDataType );
+    const char* pszBypass =
+        CPLGetConfigOption("GDAL_RASTERIO_BYPASS_CACHE", "AUTO");
+    if( EQUAL(pszBypass, "AUTO") )
+    {
+        if( !m_bBypassCacheForLargeReads ||
+            static_cast<GIntBig>(nXSize) * nYSize * nBandDataSize <=
+                GDALGetCacheMax64() )
+            return CE_None;
+    }
+    else if( !CPLTestBool(pszBypass) )
+    {
+        return CE_None;
+    }
+
+    const GPtrDiff_t nBlockBytes =
+        static_cast<GPtrDiff_t>(nBlockXSize) * nBlockYSize * nBandDataSize;
+    GByte* pabyTmpBlock = nullptr;
+
+    const int nXBlockStart = nXOff / nBlockXSize;
+    const int nXBlockEnd = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nYBlockStart = nYOff / nBlockYSize;
+    const int nYBlockEnd = (nYOff + nYSize - 1) / nBlockYSize;
+
+    CPLErr eErr = CE_None;
+    for( int nYBlock = nYBlockStart;
+         nYBlock <= nYBlockEnd && eErr == CE_None; nYBlock++ )
+    {
+        const int nBlockYOff = nYBlock * nBlockYSize;
+        const int nYStart = std::max(nYOff, nBlockYOff);
+        const int nYEnd = std::min(nYOff + nYSize, nBlockYOff + nBlockYSize);
+
+        for( int nXBlock = nXBlockStart; nXBlock <= nXBlockEnd; nXBlock++ )
+        {
+            const int nBlockXOff = nXBlock * nBlockXSize;
+            const int nXStart = std::max(nXOff, nBlockXOff);
+            const int nXEnd = std::min(nXOff + nXSize, nBlockXOff + nBlockXSize);
+            GByte* pabyDst = static_cast<GByte*>(pData) +
+                             (nYStart - nYOff) * nLineSpace +
+                             (nXStart - nXOff) * nPixelSpace;
+
+            const GByte* pabyBlock = nullptr;
+            GDALRasterBlock* poBlock = TryGetLockedBlockRef(nXBlock, nYBlock);
+            if( poBlock != nullptr )
+            {
+                pabyBlock = static_cast<const GByte*>(poBlock->GetDataRef());
+            }
+            else
+            {
+                // Decode directly in the user buffer if the block is entirely
+                // requested and the buffer has the block layout. Strided
+                // destinations go through the temporary block buffer.
+                const bool bDirect =
+                    eBufType == eDataType &&
+                    nPixelSpace == nBandDataSize &&
+                    nLineSpace == nPixelSpace * nBlockXSize &&
+                    nXStart == nBlockXOff && nXEnd == nBlockXOff + nBlockXSize &&
+                    nYStart == nBlockYOff && nYEnd == nBlockYOff + nBlockYSize;
+                if( !bDirect && pabyTmpBlock == nullptr )
+                {
+                    pabyTmpBlock = static_cast<GByte*>(
+                        VSI_MALLOC_VERBOSE(static_cast<size_t>(nBlockBytes)));
+                    if( pabyTmpBlock == nullptr )
+                    {
+                        eErr = CE_Failure;
+                        break;
+                    }
+                }
+
+                const GUInt32 nErrorCounter = CPLGetErrorCounter();
+                const bool bCallLeaveReadWrite =
+                    CPL_TO_BOOL(EnterReadWrite(GF_Read));
+                eErr = IReadBlock(nXBlock, nYBlock,
+                                  bDirect ? pabyDst : pabyTmpBlock);
+                if( bCallLeaveReadWrite )
+                    LeaveReadWrite();
+                if( eErr != CE_None )
+                {
+                    ReportError( CE_Failure, CPLE_AppDefined,
+                        "IReadBlock failed at X offset %d, Y offset %d%s",
+                        nXBlock, nYBlock,
+                        (nErrorCounter != CPLGetErrorCounter()) ?
+                            CPLSPrintf(": %s", CPLGetLastErrorMsg()) : "");
+                    break;
+                }
+                if( bDirect )
+                    continue;
+                pabyBlock = pabyTmpBlock;
+            }
+
+            for( int iY = nYStart; iY < nYEnd; iY++ )
+            {
+                GDALCopyWords64(
+                    pabyBlock +
+                        (static_cast<GPtrDiff_t>(iY - nBlockYOff) * nBlockXSize +
+                         (nXStart - nBlockXOff)) * nBandDataSize,
+                    eDataType, nBandDataSize,
+                    pabyDst + (iY - nYStart) * nLineSpace,
+                    eBufType, static_cast<int>(nPixelSpace),
+                    nXEnd - nXStart );
+            }
+
+            if( poBlock )
+                poBlock->DropLock();
+        }
+
+        if( eErr == CE_None && psExtraArg->pfnProgress != nullptr &&
+            !psExtraArg->pfnProgress(
+                1.0 * (nYEnd - nYOff) / nYSize, "",
+                psExtraArg->pProgressData) )
+        {
+            eErr = CE_Failure;
+        }
+    }
+
+    VSIFree(pabyTmpBlock);
+    *pbTried = TRUE;
+    return eErr;
+}
+//! @endcond
+
 /************************************************************************/
 /*                             IRasterIO()                              */
 /*                                                                      */
@@ -240,6 +401,25 @@ CPLErr GDALRasterBand::IRasterIO( GDALRWFlag eRWFlag,
              nXSize == psExtraArg->dfXSize &&
              nYSize == psExtraArg->dfYSize));
 
+/* ==================================================================== */
+/*      Large reads are done without going through the block cache.     */
+/* ==================================================================== */
+    if( eRWFlag == GF_Read
+        && nBufXSize == nXSize
+        && nBufYSize == nYSize
+        && bUseIntegerRequestCoords
+        && !bForceCachedIO )
+    {
+        int bTried = FALSE;
+        const CPLErr eErr =
+            TryDirectBlockRasterIO( nXOff, nYOff, nXSize, nYSize,
+                                    pData, eBufType,
+                                    nPixelSpace, nLineSpace,
+                                    psExtraArg, &bTried );
+        if( bTried )
+            return eErr;
+    }
+
 /* ==================================================================== */
 /*      A common case is the data requested with the destination        */
 /*      is packed, and the block width is the raster width.             */
@@ -1007,6 +1187,213 @@ static int GDALRasterIOTransformer( void *pTransformerArg,
     return TRUE;
 }
 
+/************************************************************************/
+/*                    GDALRasterIOResampledTargetBand                   */
+/************************************************************************/
+
+namespace {
+
+// Band describing the target buffer of RasterIOResampled() to the resampling
+// functions of overview.cpp, which only query its dimensions, data type and
+// NBITS metadata item. The resampled chunks are directly copied into the
+// target buffer, so it does not need to be wrapped in a MEM dataset.
+class GDALRasterIOResampledTargetBand final: public GDALRasterBand
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALRasterIOResampledTargetBand)
+
+  protected:
+    CPLErr IReadBlock( int, int, void * ) override
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "GDALRasterIOResampledTargetBand::IReadBlock() "
+                 "not supported");
+        return CE_Failure;
+    }
+
+  public:
+    GDALRasterIOResampledTargetBand( int nXSize, int nYSize,
+                                     GDALDataType eDT,
+                                     const char* pszNBITS )
+    {
+        nRasterXSize = nXSize;
+        nRasterYSize = nYSize;
+        eDataType = eDT;
+        nBlockXSize = nXSize;
+        nBlockYSize = 1;
+        if( pszNBITS )
+            SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
+    }
+};
+
+/************************************************************************/
+/*                         CopyResampledChunk()                         */
+/************************************************************************/
+
+// Copies a nXCount x nYCount chunk of values into the target buffer. If
+// eIntermDataType is not GDT_Unknown, values are first converted to it, so
+// that they are clamped and rounded as if they had been written into a band
+// of that data type, and then read from it.
+void CopyResampledChunk( const void* pSrc, GDALDataType eSrcDataType,
+                         int nSrcPixelSpace, GPtrDiff_t nSrcLineSpace,
+                         GDALDataType eIntermDataType,
+                         void* pDst, GDALDataType eDstDataType,
+                         GSpacing nPixelSpace, GSpacing nLineSpace,
+                         int nXCount, int nYCount )
+{
+    const int nIntermDataTypeSize =
+        GDALGetDataTypeSizeBytes(eIntermDataType);
+    std::vector<GByte> abyLine(
+        static_cast<size_t>(nXCount) * nIntermDataTypeSize);
+    for( int j = 0; j < nYCount; j++ )
+    {
+        const GByte* pabySrcLine =
+            static_cast<const GByte*>(pSrc) + j * nSrcLineSpace;
+        GByte* pabyDstLine = static_cast<GByte*>(pDst) + j * nLineSpace;
+        if( eIntermDataType != GDT_Unknown )
+        {
+            GDALCopyWords64( pabySrcLine, eSrcDataType, nSrcPixelSpace,
+                             abyLine.data(), eIntermDataType,
+                             nIntermDataTypeSize, nXCount );
+            GDALCopyWords64( abyLine.data(), eIntermDataType,
+                             nIntermDataTypeSize,
+                             pabyDstLine, eDstDataType,
+                             static_cast<int>(nPixelSpace), nXCount );
+        }
+        else
+        {
+            GDALCopyWords64( pabySrcLine, eSrcDataType, nSrcPixelSpace,
+                             pabyDstLine, eDstDataType,
+                             static_cast<int>(nPixelSpace), nXCount );
+        }
+    }
+}
+
+/************************************************************************/
+/*                      GDALRasterIOResampledJobs                       */
+/************************************************************************/
+
+// Runs the resampling of the chunks of RasterIOResampled(). Source chunks
+// are always read by the calling thread, as drivers are generally not
+// thread-safe, but if the GDAL_NUM_THREADS configuration option is set to
+// ALL_CPUS or a value greater than one, they are resampled and copied into
+// the target buffer by jobs of the global thread pool while the next ones
+// are read. The number of pending jobs, and thus of chunks in memory, is
+// limited to the number of threads. Errors emitted by the jobs are collected
+// and re-emitted in the calling thread by Submit() and WaitCompletion().
+class GDALRasterIOResampledJobs
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALRasterIOResampledJobs)
+
+    struct Job
+    {
+        GDALRasterIOResampledJobs* poJobs = nullptr;
+        std::function<CPLErr()> oTask{};
+    };
+
+    std::unique_ptr<CPLJobQueue> m_poQueue{};
+    int m_nMaxPendingJobs = 1;
+    std::mutex m_oMutex{};
+    CPLErr m_eErr = CE_None;
+    std::vector<CPLErrorHandlerAccumulatorStruct> m_aoErrors{};
+
+    void SetError( CPLErr eErr,
+                   std::vector<CPLErrorHandlerAccumulatorStruct>& aoErrors )
+    {
+        if( eErr != CE_None || !aoErrors.empty() )
+        {
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            if( eErr != CE_None )
+                m_eErr = eErr;
+            m_aoErrors.insert(m_aoErrors.end(),
+                              std::make_move_iterator(aoErrors.begin()),
+                              std::make_move_iterator(aoErrors.end()));
+        }
+    }
+
+    static void Run( void* pData )
+    {
+        Job* psJob = static_cast<Job*>(pData);
+        std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors;
+        CPLInstallErrorHandlerAccumulator(aoErrors);
+        const CPLErr eErr = psJob->oTask();
+        CPLUninstallErrorHandlerAccumulator();
+        psJob->poJobs->SetError(eErr, aoErrors);
+        delete psJob;
+    }
+
+    // Re-emits the errors of the tasks run so far, and returns their error.
+    // Must be called from the calling thread.
+    CPLErr EmitErrors()
+    {
+        std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors;
+        CPLErr eErr;
+        {
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            std::swap(aoErrors, m_aoErrors);
+            eErr = m_eErr;
+        }
+        for( const auto& oError : aoErrors )
+        {
+            CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+        return eErr;
+    }
+
+  public:
+    explicit GDALRasterIOResampledJobs( int nTotalJobs )
+    {
+        if( nTotalJobs > 1 )
+        {
+            const int nThreads = GDALGetNumThreads(128);
+            CPLWorkerThreadPool* poThreadPool =
+                nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
+            if( poThreadPool )
+            {
+                m_poQueue = poThreadPool->CreateJobQueue();
+                m_nMaxPendingJobs = nThreads;
+            }
+        }
+    }
+
+    ~GDALRasterIOResampledJobs()
+    {
+        WaitCompletion();
+    }
+
+    // Whether tasks run in worker threads, in which case each of them must
+    // own its source buffers.
+    bool IsMultiThreaded() const { return m_poQueue != nullptr; }
+
+    // Runs or queues oTask, and returns the error of the tasks run so far.
+    CPLErr Submit( std::function<CPLErr()>&& oTask )
+    {
+        Job* psJob = new Job();
+        psJob->poJobs = this;
+        psJob->oTask = std::move(oTask);
+        if( m_poQueue )
+        {
+            m_poQueue->WaitCompletion(m_nMaxPendingJobs - 1);
+            if( !m_poQueue->SubmitJob(Run, psJob) )
+                Run(psJob);
+        }
+        else
+        {
+            Run(psJob);
+        }
+        return EmitErrors();
+    }
+
+    // Waits for all tasks to be run, and returns their error.
+    CPLErr WaitCompletion()
+    {
+        if( m_poQueue )
+            m_poQueue->WaitCompletion();
+        return EmitErrors();
+    }
+};
+
+} // namespace
+
 /************************************************************************/
 /*                          RasterIOResampled()                         */
 /************************************************************************/
@@ -1064,46 +1451,47 @@ CPLErr GDALRasterBand::RasterIOResampled(
         nDestYOffVirtual = static_cast<int>(dfDestYOff + 0.5);
     }
 
-    // Create a MEM dataset that wraps the output buffer.
-    GDALDataset* poMEMDS;
-    void* pTempBuffer = nullptr;
-    GSpacing nPSMem = nPixelSpace;
-    GSpacing nLSMem = nLineSpace;
-    void* pDataMem = pData;
-    GDALDataType eDTMem = eBufType;
-    if( eBufType != eDataType )
-    {
-        nPSMem = GDALGetDataTypeSizeBytes(eDataType);
-        nLSMem = nPSMem * nBufXSize;
-        pTempBuffer = VSI_MALLOC2_VERBOSE( nBufYSize, static_cast<size_t>(nLSMem) );
-        if( pTempBuffer == nullptr )
-            return CE_Failure;
-        pDataMem = pTempBuffer;
-        eDTMem = eDataType;
-    }
-
-    poMEMDS = MEMDataset::Create( "", nDestXOffVirtual + nBufXSize,
-                                  nDestYOffVirtual + nBufYSize, 0,
-                                  eDTMem, nullptr );
-    GByte* pabyData = static_cast<GByte*>(pDataMem)
-                        - nPSMem * nDestXOffVirtual
-                        - nLSMem * nDestYOffVirtual;
-    GDALRasterBandH hMEMBand = MEMCreateRasterBandEx( poMEMDS, 1, pabyData,
-                                                      eDTMem,
-                                                      nPSMem, nLSMem,
-                                                      false );
-    poMEMDS->SetBand(1, GDALRasterBand::FromHandle(hMEMBand));
-
-    const char* pszNBITS = GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
-    if( pszNBITS )
-        reinterpret_cast<GDALRasterBand *>(hMEMBand)->
-            SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
-
     CPLErr eErr = CE_None;
 
     // Do the resampling.
     if( bUseWarp )
     {
+        // Create a MEM dataset that wraps the output buffer.
+        GDALDataset* poMEMDS;
+        void* pTempBuffer = nullptr;
+        GSpacing nPSMem = nPixelSpace;
+        GSpacing nLSMem = nLineSpace;
+        void* pDataMem = pData;
+        GDALDataType eDTMem = eBufType;
+        if( eBufType != eDataType )
+        {
+            nPSMem = GDALGetDataTypeSizeBytes(eDataType);
+            nLSMem = nPSMem * nBufXSize;
+            pTempBuffer = VSI_MALLOC2_VERBOSE( nBufYSize,
+                                               static_cast<size_t>(nLSMem) );
+            if( pTempBuffer == nullptr )
+                return CE_Failure;
+            pDataMem = pTempBuffer;
+            eDTMem = eDataType;
+        }
+
+        poMEMDS = MEMDataset::Create( "", nDestXOffVirtual + nBufXSize,
+                                      nDestYOffVirtual + nBufYSize, 0,
+                                      eDTMem, nullptr );
+        GByte* pabyData = static_cast<GByte*>(pDataMem)
+                            - nPSMem * nDestXOffVirtual
+                            - nLSMem * nDestYOffVirtual;
+        GDALRasterBandH hMEMBand = MEMCreateRasterBandEx( poMEMDS, 1, pabyData,
+                                                          eDTMem,
+                                                          nPSMem, nLSMem,
+                                                          false );
+        poMEMDS->SetBand(1, GDALRasterBand::FromHandle(hMEMBand));
+
+        const char* pszNBITS = GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+        if( pszNBITS )
+            reinterpret_cast<GDALRasterBand *>(hMEMBand)->
+                SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
+
         int bHasNoData = FALSE;
         double dfNoDataValue = GetNoDataValue(&bHasNoData) ;
 
@@ -1211,10 +1599,25 @@ CPLErr GDALRasterBand::RasterIOResampled(
 
         if( hVRTDS )
             GDALClose(hVRTDS);
+
+        if( eBufType != eDataType )
+        {
+            CPL_IGNORE_RET_VAL(poMEMDS->GetRasterBand(1)->RasterIO(GF_Read,
+                              nDestXOffVirtual, nDestYOffVirtual,
+                              nBufXSize, nBufYSize,
+                              pData,
+                              nBufXSize, nBufYSize,
+                              eBufType,
+                              nPixelSpace, nLineSpace,
+                              nullptr));
+        }
+        GDALClose(poMEMDS);
+        VSIFree(pTempBuffer);
     }
     else
     {
         const char* pszResampling =
+            (psExtraArg->eResampleAlg == GRIORA_NearestNeighbour) ? "NEAREST" :
             (psExtraArg->eResampleAlg == GRIORA_Bilinear) ? "BILINEAR" :
             (psExtraArg->eResampleAlg == GRIORA_Cubic) ? "CUBIC" :
             (psExtraArg->eResampleAlg == GRIORA_CubicSpline) ? "CUBICSPLINE" :
@@ -1279,34 +1682,29 @@ CPLErr GDALRasterBand::RasterIOResampled(
         if( nFullResYSizeQueried > nRasterYSize )
             nFullResYSizeQueried = nRasterYSize;
 
-        void * pChunk =
-            VSI_MALLOC3_VERBOSE( GDALGetDataTypeSizeBytes(eWrkDataType),
-                                 nFullResXSizeQueried, nFullResYSizeQueried );
-        GByte * pabyChunkNoDataMask = nullptr;
-
         GDALRasterBand* poMaskBand = GetMaskBand();
         int l_nMaskFlags = GetMaskFlags();
 
         bool bUseNoDataMask = ((l_nMaskFlags & GMF_ALL_VALID) == 0);
-        if (bUseNoDataMask)
-        {
-            pabyChunkNoDataMask = static_cast<GByte *>(
-                VSI_MALLOC2_VERBOSE( nFullResXSizeQueried,
-                                     nFullResYSizeQueried ) );
-        }
-        if( pChunk == nullptr || (bUseNoDataMask && pabyChunkNoDataMask == nullptr) )
-        {
-            GDALClose(poMEMDS);
-            CPLFree(pChunk);
-            CPLFree(pabyChunkNoDataMask);
-            VSIFree(pTempBuffer);
-            return CE_Failure;
-        }
+
+        // Values are converted to the band data type before being converted
+        // to the buffer data type.
+        const GDALDataType eIntermDataType =
+            (eBufType != eDataType) ? eDataType : GDT_Unknown;
+
+        GDALRasterIOResampledTargetBand oTargetBand(
+            nDestXOffVirtual + nBufXSize, nDestYOffVirtual + nBufYSize,
+            eDataType, GetMetadataItem("NBITS", "IMAGE_STRUCTURE"));
+        GDALColorTable* poColorTable = GetColorTable();
 
         int nTotalBlocks = ((nBufXSize + nDstBlockXSize - 1) / nDstBlockXSize) *
                            ((nBufYSize + nDstBlockYSize - 1) / nDstBlockYSize);
         int nBlocksDone = 0;
 
+        GDALRasterIOResampledJobs oJobs(nTotalBlocks);
+        std::shared_ptr<void> oChunk;
+        std::shared_ptr<GByte> oChunkNoDataMask;
+
         int nDstYOff;
         for( nDstYOff = 0; nDstYOff < nBufYSize && eErr == CE_None;
             nDstYOff += nDstBlockYSize )
@@ -1372,11 +1770,36 @@ CPLErr GDALRasterBand::RasterIOResampled(
                     nChunkXSizeQueried = nRasterXSize - nChunkXOffQueried;
                 CPLAssert(nChunkXSizeQueried <= nFullResXSizeQueried);
 
+                // Pending jobs own the source buffers they use, so new ones
+                // must be allocated in multithreaded mode.
+                if( !oChunk || oJobs.IsMultiThreaded() )
+                {
+                    oChunk.reset(
+                        VSI_MALLOC3_VERBOSE(
+                            GDALGetDataTypeSizeBytes(eWrkDataType),
+                            nFullResXSizeQueried, nFullResYSizeQueried ),
+                        VSIFree );
+                    if( bUseNoDataMask )
+                    {
+                        oChunkNoDataMask.reset(
+                            static_cast<GByte *>(
+                                VSI_MALLOC2_VERBOSE( nFullResXSizeQueried,
+                                                     nFullResYSizeQueried ) ),
+                            VSIFree );
+                    }
+                    if( !oChunk || (bUseNoDataMask && !oChunkNoDataMask) )
+                    {
+                        eErr = CE_Failure;
+                        break;
+                    }
+                }
+                GByte* const pabyChunkNoDataMask = oChunkNoDataMask.get();
+
                 // Read the source buffers.
                 eErr = RasterIO( GF_Read,
                                 nChunkXOffQueried, nChunkYOffQueried,
                                 nChunkXSizeQueried, nChunkYSizeQueried,
-                                pChunk,
+                                oChunk.get(),
                                 nChunkXSizeQueried, nChunkYSizeQueried,
                                 eWrkDataType, 0, 0, nullptr );
 
@@ -1407,16 +1830,14 @@ CPLErr GDALRasterBand::RasterIOResampled(
                     {
                         if( bVal == 0 )
                         {
-                            for(int j=0;j<nDstYCount;j++)
-                            {
-                                GDALCopyWords(
-                                    &fNoDataValue, GDT_Float32, 0,
-                                    static_cast<GByte*>(pDataMem) +
-                                    nLSMem * (j + nDstYOff) +
-                                    nDstXOff * nPSMem,
-                                    eDTMem, static_cast<int>(nPSMem),
-                                    nDstXCount);
-                            }
+                            CopyResampledChunk(
+                                &fNoDataValue, GDT_Float32, 0, 0,
+                                eIntermDataType,
+                                static_cast<GByte*>(pData) +
+                                    nLineSpace * nDstYOff +
+                                    nPixelSpace * nDstXOff,
+                                eBufType, nPixelSpace, nLineSpace,
+                                nDstXCount, nDstYCount );
                             bSkipResample = true;
                         }
                         else
@@ -1428,53 +1849,73 @@ CPLErr GDALRasterBand::RasterIOResampled(
 
                 if( !bSkipResample && eErr == CE_None )
                 {
-                    const bool bPropagateNoData = false;
-                    void* pDstBuffer = nullptr;
-                    GDALDataType eDstBufferDataType = GDT_Unknown;
-                    GDALRasterBand* poMEMBand = GDALRasterBand::FromHandle(hMEMBand);
-                    eErr = pfnResampleFunc(
-                        dfXRatioDstToSrc,
-                        dfYRatioDstToSrc,
-                        dfXOff - nXOff, /* == 0 if bHasXOffVirtual */
-                        dfYOff - nYOff, /* == 0 if bHasYOffVirtual */
-                        eWrkDataType,
-                        pChunk,
-                        bNoDataMaskFullyOpaque ? nullptr : pabyChunkNoDataMask,
-                        nChunkXOffQueried - (bHasXOffVirtual ? 0 : nXOff),
-                        nChunkXSizeQueried,
-                        nChunkYOffQueried - (bHasYOffVirtual ? 0 : nYOff),
-                        nChunkYSizeQueried,
-                        nDstXOff + nDestXOffVirtual,
-                        nDstXOff + nDestXOffVirtual + nDstXCount,
-                        nDstYOff + nDestYOffVirtual,
-                        nDstYOff + nDestYOffVirtual + nDstYCount,
-                        poMEMBand,
-                        &pDstBuffer,
-                        &eDstBufferDataType,
-                        pszResampling,
-                        bHasNoData, fNoDataValue,
-                        GetColorTable(),
-                        eDataType,
-                        bPropagateNoData);
-                    if( eErr == CE_None )
+                    const std::shared_ptr<void> oJobChunk = oChunk;
+                    const std::shared_ptr<GByte> oJobChunkNoDataMask =
+                        bNoDataMaskFullyOpaque ? nullptr : oChunkNoDataMask;
+                    GDALRasterBand* const poTargetBand = &oTargetBand;
+                    GByte* const pabyDst = static_cast<GByte*>(pData) +
+                                           nLineSpace * nDstYOff +
+                                           nPixelSpace * nDstXOff;
+                    const double dfSrcXDelta = dfXOff - nXOff;  // == 0 if bHasXOffVirtual
+                    const double dfSrcYDelta = dfYOff - nYOff;  // == 0 if bHasYOffVirtual
+                    const int nChunkXOffRel =
+                        nChunkXOffQueried - (bHasXOffVirtual ? 0 : nXOff);
+                    const int nChunkYOffRel =
+                        nChunkYOffQueried - (bHasYOffVirtual ? 0 : nYOff);
+                    const int nDstXOffVirtual = nDstXOff + nDestXOffVirtual;
+                    const int nDstYOffVirtual = nDstYOff + nDestYOffVirtual;
+                    const GDALDataType eSrcDataType = eDataType;
+                    eErr = oJobs.Submit([=]()
                     {
-                        eErr = poMEMBand->RasterIO(
-                            GF_Write,
-                            nDstXOff + nDestXOffVirtual,
-                            nDstYOff + nDestYOffVirtual,
-                            nDstXCount,
-                            nDstYCount,
-                            pDstBuffer,
-                            nDstXCount,
-                            nDstYCount,
-                            eDstBufferDataType,
-                            0, 0, nullptr );
-                    }
-                    CPLFree(pDstBuffer);
+                        const bool bPropagateNoData = false;
+                        void* pDstBuffer = nullptr;
+                        GDALDataType eDstBufferDataType = GDT_Unknown;
+                        CPLErr l_eErr = pfnResampleFunc(
+                            dfXRatioDstToSrc,
+                            dfYRatioDstToSrc,
+                            dfSrcXDelta,
+                            dfSrcYDelta,
+                            eWrkDataType,
+                            oJobChunk.get(),
+                            oJobChunkNoDataMask.get(),
+                            nChunkXOffRel,
+                            nChunkXSizeQueried,
+                            nChunkYOffRel,
+                            nChunkYSizeQueried,
+                            nDstXOffVirtual,
+                            nDstXOffVirtual + nDstXCount,
+                            nDstYOffVirtual,
+                            nDstYOffVirtual + nDstYCount,
+                            poTargetBand,
+                            &pDstBuffer,
+                            &eDstBufferDataType,
+                            pszResampling,
+                            bHasNoData, fNoDataValue,
+                            poColorTable,
+                            eSrcDataType,
+                            bPropagateNoData);
+                        if( l_eErr == CE_None )
+                        {
+                            const int nDstBufferDataTypeSize =
+                                GDALGetDataTypeSizeBytes(eDstBufferDataType);
+                            CopyResampledChunk(
+                                pDstBuffer, eDstBufferDataType,
+                                nDstBufferDataTypeSize,
+                                static_cast<GPtrDiff_t>(nDstBufferDataTypeSize) *
+                                    nDstXCount,
+                                eDstBufferDataType != eSrcDataType ?
+                                    eIntermDataType : GDT_Unknown,
+                                pabyDst, eBufType, nPixelSpace, nLineSpace,
+                                nDstXCount, nDstYCount );
+                        }
+                        CPLFree(pDstBuffer);
+                        return l_eErr;
+                    });
                 }
 
                 nBlocksDone ++;
                 if( eErr == CE_None && psExtraArg->pfnProgress != nullptr &&
+                    nBlocksDone < nTotalBlocks &&
                     !psExtraArg->pfnProgress(
                         1.0 * nBlocksDone / nTotalBlocks, "",
                         psExtraArg->pProgressData) )
@@ -1484,23 +1925,15 @@ CPLErr GDALRasterBand::RasterIOResampled(
             }
         }
 
-        CPLFree(pChunk);
-        CPLFree(pabyChunkNoDataMask);
-    }
-
-    if( eBufType != eDataType )
-    {
-        CPL_IGNORE_RET_VAL(poMEMDS->GetRasterBand(1)->RasterIO(GF_Read,
-                          nDestXOffVirtual, nDestYOffVirtual,
-                          nBufXSize, nBufYSize,
-                          pData,
-                          nBufXSize, nBufYSize,
-                          eBufType,
-                          nPixelSpace, nLineSpace,
-                          nullptr));
+        const CPLErr eJobsErr = oJobs.WaitCompletion();
+        if( eErr == CE_None )
+            eErr = eJobsErr;
+        if( eErr == CE_None && psExtraArg->pfnProgress != nullptr &&
+            !psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData) )
+        {
+            eErr = CE_Failure;
+        }
     }
-    GDALClose(poMEMDS);
-    VSIFree(pTempBuffer);
 
     return eErr;
 }
@@ -1520,13 +1953,6 @@ CPLErr GDALDataset::RasterIOResampled(
     GDALRasterIOExtraArg* psExtraArg )
 
 {
-#if 0
-    // Determine if we use warping resampling or overview resampling
-    bool bUseWarp = false;
-    if( GDALDataTypeIsComplex( eDataType ) )
-        bUseWarp = true;
-#endif
-
     double dfXOff = nXOff;
     double dfYOff = nYOff;
     double dfXSize = nXSize;
@@ -1566,409 +1992,296 @@ CPLErr GDALDataset::RasterIOResampled(
         nDestYOffVirtual = static_cast<int>(dfDestYOff + 0.5);
     }
 
-    // Create a MEM dataset that wraps the output buffer.
-    GDALDataset* poMEMDS = MEMDataset::Create( "", nDestXOffVirtual + nBufXSize,
-                                               nDestYOffVirtual + nBufYSize, 0,
-                                               eBufType, nullptr );
-    GDALRasterBand** papoDstBands =
-        static_cast<GDALRasterBand **>(
-            CPLMalloc( nBandCount * sizeof(GDALRasterBand*)) );
-    for(int i=0;i<nBandCount;i++)
-    {
-        char szBuffer[32] = { '\0' };
-        int nRet = CPLPrintPointer(
-            szBuffer,
-            static_cast<GByte*>(pData) - nPixelSpace * nDestXOffVirtual
-            - nLineSpace * nDestYOffVirtual + nBandSpace * i, sizeof(szBuffer));
-        szBuffer[nRet] = 0;
+    CPLErr eErr = CE_None;
 
-        char szBuffer0[64] = { '\0' };
-        snprintf( szBuffer0, sizeof(szBuffer0),
-                  "DATAPOINTER=%s", szBuffer );
+    const char* pszResampling =
+        (psExtraArg->eResampleAlg == GRIORA_NearestNeighbour) ? "NEAREST" :
+        (psExtraArg->eResampleAlg == GRIORA_Bilinear) ? "BILINEAR" :
+        (psExtraArg->eResampleAlg == GRIORA_Cubic) ? "CUBIC" :
+        (psExtraArg->eResampleAlg == GRIORA_CubicSpline) ? "CUBICSPLINE" :
+        (psExtraArg->eResampleAlg == GRIORA_Lanczos) ? "LANCZOS" :
+        (psExtraArg->eResampleAlg == GRIORA_Average) ? "AVERAGE" :
+        (psExtraArg->eResampleAlg == GRIORA_RMS) ? "RMS" :
+        (psExtraArg->eResampleAlg == GRIORA_Mode) ? "MODE" :
+        (psExtraArg->eResampleAlg == GRIORA_Gauss) ? "GAUSS" : "UNKNOWN";
+
+    GDALRasterBand* poFirstSrcBand = GetRasterBand(panBandMap[0]);
+    GDALDataType eDataType = poFirstSrcBand->GetRasterDataType();
+    int nBlockXSize, nBlockYSize;
+    poFirstSrcBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+
+    int nKernelRadius;
+    GDALResampleFunction pfnResampleFunc =
+                    GDALGetResampleFunction(pszResampling, &nKernelRadius);
+    CPLAssert(pfnResampleFunc);
+    GDALDataType eWrkDataType =
+        GDALGetOvrWorkDataType(pszResampling, eDataType);
+
+    int nDstBlockXSize = nBufXSize;
+    int nDstBlockYSize = nBufYSize;
+    int nFullResXChunk, nFullResYChunk;
+    while( true )
+    {
+        nFullResXChunk =
+            3 + static_cast<int>(nDstBlockXSize * dfXRatioDstToSrc);
+        nFullResYChunk =
+            3 + static_cast<int>(nDstBlockYSize * dfYRatioDstToSrc);
+        if( nFullResXChunk > nRasterXSize )
+            nFullResXChunk = nRasterXSize;
+        if( nFullResYChunk > nRasterYSize )
+            nFullResYChunk = nRasterYSize;
+        if( (nDstBlockXSize == 1 && nDstBlockYSize == 1) ||
+            (static_cast<GIntBig>(nFullResXChunk) * nFullResYChunk <= 1024 * 1024) )
+            break;
+        // When operating on the full width of a raster whose block width is
+        // the raster width, prefer doing chunks in height.
+        if( nFullResXChunk >= nXSize && nXSize == nBlockXSize &&
+            nDstBlockYSize > 1 )
+            nDstBlockYSize /= 2;
+        /* Otherwise cut the maximal dimension */
+        else if( nDstBlockXSize > 1 &&
+                 (nFullResXChunk > nFullResYChunk || nDstBlockYSize == 1) )
+            nDstBlockXSize /= 2;
+        else
+            nDstBlockYSize /= 2;
+    }
 
-        char szBuffer1[64] = { '\0' };
-        snprintf( szBuffer1, sizeof(szBuffer1),
-                  "PIXELOFFSET=" CPL_FRMT_GIB,
-                  static_cast<GIntBig>(nPixelSpace) );
+    int nOvrFactor = std::max( static_cast<int>(0.5 + dfXRatioDstToSrc),
+                               static_cast<int>(0.5 + dfYRatioDstToSrc) );
+    if( nOvrFactor == 0 ) nOvrFactor = 1;
+    int nFullResXSizeQueried = nFullResXChunk + 2 * nKernelRadius * nOvrFactor;
+    int nFullResYSizeQueried = nFullResYChunk + 2 * nKernelRadius * nOvrFactor;
 
-        char szBuffer2[64] = { '\0' };
-        snprintf( szBuffer2, sizeof(szBuffer2),
-                  "LINEOFFSET=" CPL_FRMT_GIB,
-                  static_cast<GIntBig>(nLineSpace) );
+    if( nFullResXSizeQueried > nRasterXSize )
+        nFullResXSizeQueried = nRasterXSize;
+    if( nFullResYSizeQueried > nRasterYSize )
+        nFullResYSizeQueried = nRasterYSize;
 
-        char* apszOptions[4] = { szBuffer0, szBuffer1, szBuffer2, nullptr };
+    GDALRasterBand* poMaskBand = poFirstSrcBand->GetMaskBand();
+    int nMaskFlags = poFirstSrcBand->GetMaskFlags();
 
-        poMEMDS->AddBand(eBufType, apszOptions);
+    bool bUseNoDataMask = ((nMaskFlags & GMF_ALL_VALID) == 0);
 
+    // Describe the target buffer of each band to the resampling functions.
+    std::vector<std::unique_ptr<GDALRasterIOResampledTargetBand>>
+        apoTargetBands;
+    for( int i = 0; i < nBandCount; i++ )
+    {
         GDALRasterBand* poSrcBand = GetRasterBand(panBandMap[i]);
-        papoDstBands[i] = poMEMDS->GetRasterBand(i+1);
-        const char* pszNBITS = poSrcBand->GetMetadataItem( "NBITS",
-                                                           "IMAGE_STRUCTURE" );
-        if( pszNBITS )
-            poMEMDS->GetRasterBand(i+1)->SetMetadataItem( "NBITS", pszNBITS,
-                                                          "IMAGE_STRUCTURE" );
+        apoTargetBands.emplace_back(
+            new GDALRasterIOResampledTargetBand(
+                nDestXOffVirtual + nBufXSize, nDestYOffVirtual + nBufYSize,
+                eBufType,
+                poSrcBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE")));
     }
 
-    CPLErr eErr = CE_None;
-
-    // TODO(schwehr): Why disabled?  Why not just delete?
-    // Looks like this code was initially added as disable by copying
-    // from RasterIO here:
-    // https://trac.osgeo.org/gdal/changeset/29572
-#if 0
-    // Do the resampling.
-    if( bUseWarp )
-    {
-        VRTDatasetH hVRTDS = nullptr;
-        GDALRasterBandH hVRTBand = nullptr;
-        if( GetDataset() == nullptr )
-        {
-            /* Create VRT dataset that wraps the whole dataset */
-            hVRTDS = VRTCreate(nRasterXSize, nRasterYSize);
-            VRTAddBand( hVRTDS, eDataType, nullptr );
-            hVRTBand = GDALGetRasterBand(hVRTDS, 1);
-            VRTAddSimpleSource( (VRTSourcedRasterBandH)hVRTBand,
-                                (GDALRasterBandH)this,
-                                0, 0,
-                                nRasterXSize, nRasterYSize,
-                                0, 0,
-                                nRasterXSize, nRasterYSize,
-                                nullptr, VRT_NODATA_UNSET );
-
-            /* Add a mask band if needed */
-            if( GetMaskFlags() != GMF_ALL_VALID )
-            {
-                ((GDALDataset*)hVRTDS)->CreateMaskBand(0);
-                VRTSourcedRasterBand* poVRTMaskBand =
-                    (VRTSourcedRasterBand*)(((GDALRasterBand*)hVRTBand)->GetMaskBand());
-                poVRTMaskBand->
-                    AddMaskBandSource( this,
-                                    0, 0,
-                                    nRasterXSize, nRasterYSize,
-                                    0, 0,
-                                    nRasterXSize, nRasterYSize);
-            }
-        }
-
-        GDALWarpOptions* psWarpOptions = GDALCreateWarpOptions();
-        psWarpOptions->eResampleAlg = (GDALResampleAlg)psExtraArg->eResampleAlg;
-        psWarpOptions->hSrcDS = (GDALDatasetH) (hVRTDS ? hVRTDS : GetDataset());
-        psWarpOptions->hDstDS = (GDALDatasetH) poMEMDS;
-        psWarpOptions->nBandCount = 1;
-        int nSrcBandNumber = (hVRTDS ? 1 : nBand);
-        int nDstBandNumber = 1;
-        psWarpOptions->panSrcBands = &nSrcBandNumber;
-        psWarpOptions->panDstBands = &nDstBandNumber;
-        psWarpOptions->pfnProgress = psExtraArg->pfnProgress ?
-                    psExtraArg->pfnProgress : GDALDummyProgress;
-        psWarpOptions->pProgressArg = psExtraArg->pProgressData;
-        psWarpOptions->pfnTransformer = GDALRasterIOTransformer;
-        GDALRasterIOTransformerStruct sTransformer;
-        sTransformer.dfXOff = bHasXOffVirtual ? 0 : dfXOff;
-        sTransformer.dfYOff = bHasYOffVirtual ? 0 : dfYOff;
-        sTransformer.dfXRatioDstToSrc = dfXRatioDstToSrc;
-        sTransformer.dfYRatioDstToSrc = dfYRatioDstToSrc;
-        psWarpOptions->pTransformerArg = &sTransformer;
+    int nTotalBlocks = ((nBufXSize + nDstBlockXSize - 1) / nDstBlockXSize) *
+                       ((nBufYSize + nDstBlockYSize - 1) / nDstBlockYSize);
+    int nBlocksDone = 0;
 
-        GDALWarpOperationH hWarpOperation = GDALCreateWarpOperation(psWarpOptions);
-        eErr = GDALChunkAndWarpImage( hWarpOperation,
-                                      nDestXOffVirtual, nDestYOffVirtual,
-                                      nBufXSize, nBufYSize );
-        GDALDestroyWarpOperation( hWarpOperation );
-
-        psWarpOptions->panSrcBands = nullptr;
-        psWarpOptions->panDstBands = nullptr;
-        GDALDestroyWarpOptions( psWarpOptions );
+    GDALRasterIOResampledJobs oJobs(nTotalBlocks);
+    std::shared_ptr<void> oChunk;
+    std::shared_ptr<GByte> oChunkNoDataMask;
 
-        if( hVRTDS )
-            GDALClose(hVRTDS);
-    }
-    else
-#endif
+    int nDstYOff;
+    for( nDstYOff = 0; nDstYOff < nBufYSize && eErr == CE_None;
+        nDstYOff += nDstBlockYSize )
     {
-        const char* pszResampling =
-            (psExtraArg->eResampleAlg == GRIORA_Bilinear) ? "BILINEAR" :
-            (psExtraArg->eResampleAlg == GRIORA_Cubic) ? "CUBIC" :
-            (psExtraArg->eResampleAlg == GRIORA_CubicSpline) ? "CUBICSPLINE" :
-            (psExtraArg->eResampleAlg == GRIORA_Lanczos) ? "LANCZOS" :
-            (psExtraArg->eResampleAlg == GRIORA_Average) ? "AVERAGE" :
-            (psExtraArg->eResampleAlg == GRIORA_RMS) ? "RMS" :
-            (psExtraArg->eResampleAlg == GRIORA_Mode) ? "MODE" :
-            (psExtraArg->eResampleAlg == GRIORA_Gauss) ? "GAUSS" : "UNKNOWN";
-
-        GDALRasterBand* poFirstSrcBand = GetRasterBand(panBandMap[0]);
-        GDALDataType eDataType = poFirstSrcBand->GetRasterDataType();
-        int nBlockXSize, nBlockYSize;
-        poFirstSrcBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
-
-        int nKernelRadius;
-        GDALResampleFunction pfnResampleFunc =
-                        GDALGetResampleFunction(pszResampling, &nKernelRadius);
-        CPLAssert(pfnResampleFunc);
-#ifdef GDAL_ENABLE_RESAMPLING_MULTIBAND
-        GDALResampleFunctionMultiBands pfnResampleFuncMultiBands =
-                        GDALGetResampleFunctionMultiBands(pszResampling, &nKernelRadius);
-#endif
-        GDALDataType eWrkDataType =
-            GDALGetOvrWorkDataType(pszResampling, eDataType);
-
-        int nDstBlockXSize = nBufXSize;
-        int nDstBlockYSize = nBufYSize;
-        int nFullResXChunk, nFullResYChunk;
-        while( true )
-        {
-            nFullResXChunk =
-                3 + static_cast<int>(nDstBlockXSize * dfXRatioDstToSrc);
-            nFullResYChunk =
-                3 + static_cast<int>(nDstBlockYSize * dfYRatioDstToSrc);
-            if( nFullResXChunk > nRasterXSize )
-                nFullResXChunk = nRasterXSize;
-            if( nFullResYChunk > nRasterYSize )
-                nFullResYChunk = nRasterYSize;
-            if( (nDstBlockXSize == 1 && nDstBlockYSize == 1) ||
-                (static_cast<GIntBig>(nFullResXChunk) * nFullResYChunk <= 1024 * 1024) )
-                break;
-            // When operating on the full width of a raster whose block width is
-            // the raster width, prefer doing chunks in height.
-            if( nFullResXChunk >= nXSize && nXSize == nBlockXSize &&
-                nDstBlockYSize > 1 )
-                nDstBlockYSize /= 2;
-            /* Otherwise cut the maximal dimension */
-            else if( nDstBlockXSize > 1 &&
-                     (nFullResXChunk > nFullResYChunk || nDstBlockYSize == 1) )
-                nDstBlockXSize /= 2;
-            else
-                nDstBlockYSize /= 2;
-        }
-
-        int nOvrFactor = std::max( static_cast<int>(0.5 + dfXRatioDstToSrc),
-                                   static_cast<int>(0.5 + dfYRatioDstToSrc) );
-        if( nOvrFactor == 0 ) nOvrFactor = 1;
-        int nFullResXSizeQueried = nFullResXChunk + 2 * nKernelRadius * nOvrFactor;
-        int nFullResYSizeQueried = nFullResYChunk + 2 * nKernelRadius * nOvrFactor;
-
-        if( nFullResXSizeQueried > nRasterXSize )
-            nFullResXSizeQueried = nRasterXSize;
-        if( nFullResYSizeQueried > nRasterYSize )
-            nFullResYSizeQueried = nRasterYSize;
-
-        void * pChunk =
-            VSI_MALLOC3_VERBOSE(
-                GDALGetDataTypeSizeBytes(eWrkDataType) * nBandCount,
-                nFullResXSizeQueried, nFullResYSizeQueried );
-        GByte * pabyChunkNoDataMask = nullptr;
-
-        GDALRasterBand* poMaskBand = poFirstSrcBand->GetMaskBand();
-        int nMaskFlags = poFirstSrcBand->GetMaskFlags();
-
-        bool bUseNoDataMask = ((nMaskFlags & GMF_ALL_VALID) == 0);
-        if (bUseNoDataMask)
-        {
-            pabyChunkNoDataMask = static_cast<GByte *>(
-                VSI_MALLOC2_VERBOSE( nFullResXSizeQueried, nFullResYSizeQueried ));
-        }
-        if( pChunk == nullptr || (bUseNoDataMask && pabyChunkNoDataMask == nullptr) )
+        int nDstYCount;
+        if  (nDstYOff + nDstBlockYSize <= nBufYSize)
+            nDstYCount = nDstBlockYSize;
+        else
+            nDstYCount = nBufYSize - nDstYOff;
+
+        int nChunkYOff =
+            nYOff + static_cast<int>(nDstYOff * dfYRatioDstToSrc);
+        int nChunkYOff2 =
+            nYOff + 1 +
+            static_cast<int>(
+                ceil((nDstYOff + nDstYCount) * dfYRatioDstToSrc) );
+        if( nChunkYOff2 > nRasterYSize )
+            nChunkYOff2 = nRasterYSize;
+        int nYCount = nChunkYOff2 - nChunkYOff;
+        CPLAssert(nYCount <= nFullResYChunk);
+
+        int nChunkYOffQueried = nChunkYOff - nKernelRadius * nOvrFactor;
+        int nChunkYSizeQueried = nYCount + 2 * nKernelRadius * nOvrFactor;
+        if( nChunkYOffQueried < 0 )
         {
-            GDALClose(poMEMDS);
-            CPLFree(pChunk);
-            CPLFree(pabyChunkNoDataMask);
-            CPLFree(papoDstBands);
-            return CE_Failure;
+            nChunkYSizeQueried += nChunkYOffQueried;
+            nChunkYOffQueried = 0;
         }
+        if( nChunkYSizeQueried + nChunkYOffQueried > nRasterYSize )
+            nChunkYSizeQueried = nRasterYSize - nChunkYOffQueried;
+        CPLAssert(nChunkYSizeQueried <= nFullResYSizeQueried);
 
-        int nTotalBlocks = ((nBufXSize + nDstBlockXSize - 1) / nDstBlockXSize) *
-                           ((nBufYSize + nDstBlockYSize - 1) / nDstBlockYSize);
-        int nBlocksDone = 0;
-
-        int nDstYOff;
-        for( nDstYOff = 0; nDstYOff < nBufYSize && eErr == CE_None;
-            nDstYOff += nDstBlockYSize )
+        int nDstXOff;
+        for( nDstXOff = 0; nDstXOff < nBufXSize && eErr == CE_None;
+            nDstXOff += nDstBlockXSize )
         {
-            int nDstYCount;
-            if  (nDstYOff + nDstBlockYSize <= nBufYSize)
-                nDstYCount = nDstBlockYSize;
+            int nDstXCount;
+            if  (nDstXOff + nDstBlockXSize <= nBufXSize)
+                nDstXCount = nDstBlockXSize;
             else
-                nDstYCount = nBufYSize - nDstYOff;
-
-            int nChunkYOff =
-                nYOff + static_cast<int>(nDstYOff * dfYRatioDstToSrc);
-            int nChunkYOff2 =
-                nYOff + 1 +
-                static_cast<int>(
-                    ceil((nDstYOff + nDstYCount) * dfYRatioDstToSrc) );
-            if( nChunkYOff2 > nRasterYSize )
-                nChunkYOff2 = nRasterYSize;
-            int nYCount = nChunkYOff2 - nChunkYOff;
-            CPLAssert(nYCount <= nFullResYChunk);
-
-            int nChunkYOffQueried = nChunkYOff - nKernelRadius * nOvrFactor;
-            int nChunkYSizeQueried = nYCount + 2 * nKernelRadius * nOvrFactor;
-            if( nChunkYOffQueried < 0 )
+                nDstXCount = nBufXSize - nDstXOff;
+
+            int nChunkXOff =
+                nXOff + static_cast<int>(nDstXOff * dfXRatioDstToSrc);
+            int nChunkXOff2 =
+                nXOff + 1 + static_cast<int>(
+                    ceil((nDstXOff + nDstXCount) * dfXRatioDstToSrc) );
+            if( nChunkXOff2 > nRasterXSize )
+                nChunkXOff2 = nRasterXSize;
+            int nXCount = nChunkXOff2 - nChunkXOff;
+            CPLAssert(nXCount <= nFullResXChunk);
+
+            int nChunkXOffQueried = nChunkXOff - nKernelRadius * nOvrFactor;
+            int nChunkXSizeQueried = nXCount + 2 * nKernelRadius * nOvrFactor;
+            if( nChunkXOffQueried < 0 )
             {
-                nChunkYSizeQueried += nChunkYOffQueried;
-                nChunkYOffQueried = 0;
+                nChunkXSizeQueried += nChunkXOffQueried;
+                nChunkXOffQueried = 0;
             }
-            if( nChunkYSizeQueried + nChunkYOffQueried > nRasterYSize )
-                nChunkYSizeQueried = nRasterYSize - nChunkYOffQueried;
-            CPLAssert(nChunkYSizeQueried <= nFullResYSizeQueried);
+            if( nChunkXSizeQueried + nChunkXOffQueried > nRasterXSize )
+                nChunkXSizeQueried = nRasterXSize - nChunkXOffQueried;
+            CPLAssert(nChunkXSizeQueried <= nFullResXSizeQueried);
 
-            int nDstXOff;
-            for( nDstXOff = 0; nDstXOff < nBufXSize && eErr == CE_None;
-                nDstXOff += nDstBlockXSize )
+            // Pending jobs own the source buffers they use, so new ones
+            // must be allocated in multithreaded mode.
+            if( !oChunk || oJobs.IsMultiThreaded() )
             {
-                int nDstXCount;
-                if  (nDstXOff + nDstBlockXSize <= nBufXSize)
-                    nDstXCount = nDstBlockXSize;
-                else
-                    nDstXCount = nBufXSize - nDstXOff;
-
-                int nChunkXOff =
-                    nXOff + static_cast<int>(nDstXOff * dfXRatioDstToSrc);
-                int nChunkXOff2 =
-                    nXOff + 1 + static_cast<int>(
-                        ceil((nDstXOff + nDstXCount) * dfXRatioDstToSrc) );
-                if( nChunkXOff2 > nRasterXSize )
-                    nChunkXOff2 = nRasterXSize;
-                int nXCount = nChunkXOff2 - nChunkXOff;
-                CPLAssert(nXCount <= nFullResXChunk);
-
-                int nChunkXOffQueried = nChunkXOff - nKernelRadius * nOvrFactor;
-                int nChunkXSizeQueried = nXCount + 2 * nKernelRadius * nOvrFactor;
-                if( nChunkXOffQueried < 0 )
+                oChunk.reset(
+                    VSI_MALLOC3_VERBOSE(
+                        GDALGetDataTypeSizeBytes(eWrkDataType) * nBandCount,
+                        nFullResXSizeQueried, nFullResYSizeQueried ),
+                    VSIFree );
+                if( bUseNoDataMask )
                 {
-                    nChunkXSizeQueried += nChunkXOffQueried;
-                    nChunkXOffQueried = 0;
+                    oChunkNoDataMask.reset(
+                        static_cast<GByte *>(
+                            VSI_MALLOC2_VERBOSE( nFullResXSizeQueried,
+                                                 nFullResYSizeQueried ) ),
+                        VSIFree );
                 }
-                if( nChunkXSizeQueried + nChunkXOffQueried > nRasterXSize )
-                    nChunkXSizeQueried = nRasterXSize - nChunkXOffQueried;
-                CPLAssert(nChunkXSizeQueried <= nFullResXSizeQueried);
-
-                bool bSkipResample = false;
-                bool bNoDataMaskFullyOpaque = false;
-                if (eErr == CE_None && bUseNoDataMask)
+                if( !oChunk || (bUseNoDataMask && !oChunkNoDataMask) )
                 {
-                    eErr = poMaskBand->RasterIO( GF_Read,
-                                                 nChunkXOffQueried,
-                                                 nChunkYOffQueried,
-                                                 nChunkXSizeQueried,
-                                                 nChunkYSizeQueried,
-                                                 pabyChunkNoDataMask,
-                                                 nChunkXSizeQueried,
-                                                 nChunkYSizeQueried,
-                                                 GDT_Byte, 0, 0, nullptr );
+                    eErr = CE_Failure;
+                    break;
+                }
+            }
+            GByte* const pabyChunkNoDataMask = oChunkNoDataMask.get();
 
-                    /* Optimizations if mask if fully opaque or transparent */
-                    const int nPixels = nChunkXSizeQueried * nChunkYSizeQueried;
-                    const GByte bVal = pabyChunkNoDataMask[0];
-                    int i = 1;  // Used after for.
-                    for( ; i < nPixels; i++ )
-                    {
-                        if( pabyChunkNoDataMask[i] != bVal )
-                            break;
-                    }
-                    if( i == nPixels )
+            bool bSkipResample = false;
+            bool bNoDataMaskFullyOpaque = false;
+            if (eErr == CE_None && bUseNoDataMask)
+            {
+                eErr = poMaskBand->RasterIO( GF_Read,
+                                             nChunkXOffQueried,
+                                             nChunkYOffQueried,
+                                             nChunkXSizeQueried,
+                                             nChunkYSizeQueried,
+                                             pabyChunkNoDataMask,
+                                             nChunkXSizeQueried,
+                                             nChunkYSizeQueried,
+                                             GDT_Byte, 0, 0, nullptr );
+
+                /* Optimizations if mask if fully opaque or transparent */
+                const int nPixels = nChunkXSizeQueried * nChunkYSizeQueried;
+                const GByte bVal = pabyChunkNoDataMask[0];
+                int i = 1;  // Used after for.
+                for( ; i < nPixels; i++ )
+                {
+                    if( pabyChunkNoDataMask[i] != bVal )
+                        break;
+                }
+                if( i == nPixels )
+                {
+                    if( bVal == 0 )
                     {
-                        if( bVal == 0 )
-                        {
-                            float fNoDataValue = 0.0f;
-                            for( int iBand = 0; iBand < nBandCount; iBand++ )
-                            {
-                                for( int j = 0; j < nDstYCount; j++ )
-                                {
-                                    GDALCopyWords(
-                                        &fNoDataValue, GDT_Float32, 0,
-                                        static_cast<GByte *>(pData) +
-                                        iBand * nBandSpace +
-                                        nLineSpace * (j + nDstYOff) +
-                                        nDstXOff * nPixelSpace,
-                                        eBufType,
-                                        static_cast<int>(nPixelSpace),
-                                        nDstXCount);
-                                }
-                            }
-                            bSkipResample = true;
-                        }
-                        else
+                        float fNoDataValue = 0.0f;
+                        for( int iBand = 0; iBand < nBandCount; iBand++ )
                         {
-                            bNoDataMaskFullyOpaque = true;
+                            CopyResampledChunk(
+                                &fNoDataValue, GDT_Float32, 0, 0,
+                                GDT_Unknown,
+                                static_cast<GByte *>(pData) +
+                                    iBand * nBandSpace +
+                                    nLineSpace * nDstYOff +
+                                    nDstXOff * nPixelSpace,
+                                eBufType, nPixelSpace, nLineSpace,
+                                nDstXCount, nDstYCount );
                         }
+                        bSkipResample = true;
+                    }
+                    else
+                    {
+                        bNoDataMaskFullyOpaque = true;
                     }
                 }
+            }
 
-                if( !bSkipResample && eErr == CE_None )
-                {
-                    /* Read the source buffers */
-                    eErr = RasterIO( GF_Read,
-                                     nChunkXOffQueried, nChunkYOffQueried,
-                                     nChunkXSizeQueried, nChunkYSizeQueried,
-                                     pChunk,
-                                     nChunkXSizeQueried, nChunkYSizeQueried,
-                                     eWrkDataType,
-                                     nBandCount, panBandMap,
-                                     0, 0, 0, nullptr );
-                }
+            if( !bSkipResample && eErr == CE_None )
+            {
+                /* Read the source buffers */
+                eErr = RasterIO( GF_Read,
+                                 nChunkXOffQueried, nChunkYOffQueried,
+                                 nChunkXSizeQueried, nChunkYSizeQueried,
+                                 oChunk.get(),
+                                 nChunkXSizeQueried, nChunkYSizeQueried,
+                                 eWrkDataType,
+                                 nBandCount, panBandMap,
+                                 0, 0, 0, nullptr );
+            }
 
-#ifdef GDAL_ENABLE_RESAMPLING_MULTIBAND
-                if( pfnResampleFuncMultiBands &&
-                    !bSkipResample &&
-                    eErr == CE_None )
-                {
-                    eErr = pfnResampleFuncMultiBands(
-                        dfXRatioDstToSrc,
-                        dfYRatioDstToSrc,
-                        dfXOff - nXOff, /* == 0 if bHasXOffVirtual */
-                        dfYOff - nYOff, /* == 0 if bHasYOffVirtual */
-                        eWrkDataType,
-                        (GByte*)pChunk,
-                        nBandCount,
-                        bNoDataMaskFullyOpaque ? nullptr : pabyChunkNoDataMask,
-                        nChunkXOffQueried - (bHasXOffVirtual ? 0 : nXOff),
-                        nChunkXSizeQueried,
-                        nChunkYOffQueried - (bHasYOffVirtual ? 0 : nYOff),
-                        nChunkYSizeQueried,
-                        nDstXOff + nDestXOffVirtual,
-                        nDstXOff + nDestXOffVirtual + nDstXCount,
-                        nDstYOff + nDestYOffVirtual,
-                        nDstYOff + nDestYOffVirtual + nDstYCount,
-                        papoDstBands,
-                        pszResampling,
-                        FALSE /*bHasNoData*/,
-                        0.f /* fNoDataValue */,
-                        nullptr /* color table*/,
-                        eDataType );
-                }
-                else
-#endif
+            if( !bSkipResample && eErr == CE_None )
+            {
+                const std::shared_ptr<void> oJobChunk = oChunk;
+                const std::shared_ptr<GByte> oJobChunkNoDataMask =
+                    bNoDataMaskFullyOpaque ? nullptr : oChunkNoDataMask;
+                const std::vector<std::unique_ptr<
+                    GDALRasterIOResampledTargetBand>>* papoTargetBands =
+                        &apoTargetBands;
+                GByte* const pabyDst = static_cast<GByte*>(pData) +
+                                       nLineSpace * nDstYOff +
+                                       nPixelSpace * nDstXOff;
+                const double dfSrcXDelta = dfXOff - nXOff;  // == 0 if bHasXOffVirtual
+                const double dfSrcYDelta = dfYOff - nYOff;  // == 0 if bHasYOffVirtual
+                const int nChunkXOffRel =
+                    nChunkXOffQueried - (bHasXOffVirtual ? 0 : nXOff);
+                const int nChunkYOffRel =
+                    nChunkYOffQueried - (bHasYOffVirtual ? 0 : nYOff);
+                const int nDstXOffVirtual = nDstXOff + nDestXOffVirtual;
+                const int nDstYOffVirtual = nDstYOff + nDestYOffVirtual;
+                eErr = oJobs.Submit([=]()
                 {
-                    size_t nChunkBandOffset =
+                    const size_t nChunkBandOffset =
                         static_cast<size_t>(nChunkXSizeQueried) *
                         nChunkYSizeQueried *
                         GDALGetDataTypeSizeBytes(eWrkDataType);
-                    for( int i = 0;
-                         i < nBandCount && !bSkipResample && eErr == CE_None;
-                         i++ )
+                    CPLErr l_eErr = CE_None;
+                    for( int i = 0; i < nBandCount && l_eErr == CE_None; i++ )
                     {
                         const bool bPropagateNoData = false;
                         void* pDstBuffer = nullptr;
                         GDALDataType eDstBufferDataType = GDT_Unknown;
-                        GDALRasterBand* poMEMBand = poMEMDS->GetRasterBand(i+1);
-                        eErr = pfnResampleFunc(
+                        l_eErr = pfnResampleFunc(
                             dfXRatioDstToSrc,
                             dfYRatioDstToSrc,
-                            dfXOff - nXOff, /* == 0 if bHasXOffVirtual */
-                            dfYOff - nYOff, /* == 0 if bHasYOffVirtual */
+                            dfSrcXDelta,
+                            dfSrcYDelta,
                             eWrkDataType,
-                            reinterpret_cast<GByte*>(pChunk) + i * nChunkBandOffset,
-                            bNoDataMaskFullyOpaque ? nullptr : pabyChunkNoDataMask,
-                            nChunkXOffQueried - (bHasXOffVirtual ? 0 : nXOff),
+                            static_cast<GByte*>(oJobChunk.get()) +
+                                i * nChunkBandOffset,
+                            oJobChunkNoDataMask.get(),
+                            nChunkXOffRel,
                             nChunkXSizeQueried,
-                            nChunkYOffQueried - (bHasYOffVirtual ? 0 : nYOff),
+                            nChunkYOffRel,
                             nChunkYSizeQueried,
-                            nDstXOff + nDestXOffVirtual,
-                            nDstXOff + nDestXOffVirtual + nDstXCount,
-                            nDstYOff + nDestYOffVirtual,
-                            nDstYOff + nDestYOffVirtual + nDstYCount,
-                            poMEMBand,
+                            nDstXOffVirtual,
+                            nDstXOffVirtual + nDstXCount,
+                            nDstYOffVirtual,
+                            nDstYOffVirtual + nDstYCount,
+                            (*papoTargetBands)[i].get(),
                             &pDstBuffer,
                             &eDstBufferDataType,
                             pszResampling,
@@ -1977,41 +2290,46 @@ CPLErr GDALDataset::RasterIOResampled(
                             nullptr /* color table*/,
                             eDataType,
                             bPropagateNoData );
-                        if( eErr == CE_None )
+                        if( l_eErr == CE_None )
                         {
-                            eErr = poMEMBand->RasterIO(
-                                GF_Write,
-                                nDstXOff + nDestXOffVirtual,
-                                nDstYOff + nDestYOffVirtual,
-                                nDstXCount,
-                                nDstYCount,
-                                pDstBuffer,
-                                nDstXCount,
-                                nDstYCount,
-                                eDstBufferDataType,
-                                0, 0, nullptr );
+                            const int nDstBufferDataTypeSize =
+                                GDALGetDataTypeSizeBytes(eDstBufferDataType);
+                            CopyResampledChunk(
+                                pDstBuffer, eDstBufferDataType,
+                                nDstBufferDataTypeSize,
+                                static_cast<GPtrDiff_t>(nDstBufferDataTypeSize) *
+                                    nDstXCount,
+                                GDT_Unknown,
+                                pabyDst + i * nBandSpace,
+                                eBufType, nPixelSpace, nLineSpace,
+                                nDstXCount, nDstYCount );
                         }
                         CPLFree(pDstBuffer);
                     }
-                }
+                    return l_eErr;
+                });
+            }
 
-                nBlocksDone ++;
-                if( eErr == CE_None && psExtraArg->pfnProgress != nullptr &&
-                    !psExtraArg->pfnProgress(
-                        1.0 * nBlocksDone / nTotalBlocks, "",
-                        psExtraArg->pProgressData) )
-                {
-                    eErr = CE_Failure;
-                }
+            nBlocksDone ++;
+            if( eErr == CE_None && psExtraArg->pfnProgress != nullptr &&
+                nBlocksDone < nTotalBlocks &&
+                !psExtraArg->pfnProgress(
+                    1.0 * nBlocksDone / nTotalBlocks, "",
+                    psExtraArg->pProgressData) )
+            {
+                eErr = CE_Failure;
             }
         }
-
-        CPLFree(pChunk);
-        CPLFree(pabyChunkNoDataMask);
     }
 
-    CPLFree(papoDstBands);
-    GDALClose(poMEMDS);
+    const CPLErr eJobsErr = oJobs.WaitCompletion();
+    if( eErr == CE_None )
+        eErr = eJobsErr;
+    if( eErr == CE_None && psExtraArg->pfnProgress != nullptr &&
+        !psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData) )
+    {
+        eErr = CE_Failure;
+    }
 
     return eErr;
 }
@@ -3495,6 +3813,18 @@ GDALCopyWords64( const void * CPL_RESTRICT pSrcData,
         }
     }
 
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
+    // Packed buffers of the most common type pairs.
+    if( nSrcPixelStride == nSrcDataTypeSize &&
+        nDstPixelStride == GDALGetDataTypeSizeBytes(eDstType) &&
+        nWordCount >= 16 && CPLHaveRuntimeAVX2() &&
+        GDALCopyWordsContiguous_AVX2( pSrcData, eSrcType,
+                                      pDstData, eDstType, nWordCount ) )
+    {
+        return;
+    }
+#endif
+
     // Handle the more general case -- deals with conversion of data types
     // directly.
     switch (eSrcType)
@@ -4640,6 +4970,538 @@ static void GDALCopyWholeRasterGetSwathSize(
     *pnSwathLines = nSwathLines;
 }
 
+/************************************************************************/
+/*                    GDALCopyWholeRasterPipeline                       */
+/************************************************************************/
+
+namespace {
+
+// Pipelined implementation of GDALDatasetCopyWholeRaster(), used when the
+// GDAL_NUM_THREADS configuration option is set. Swaths are read by the
+// calling thread, converted to the target data type by jobs of the global
+// thread pool when all source bands share another data type, and written in
+// order by a dedicated writer thread, so that the reading, conversion and
+// writing of successive swaths overlap. The number of swaths in flight, and
+// thus the memory used, is bounded.
+//
+// Writing from another thread relies on the read/write mutex that
+// GDALDataset takes in update mode, as GDALRasterBlock does when flushing
+// dirty blocks from arbitrary threads, so the serial copy is used when it
+// is disabled with GDAL_ENABLE_READ_WRITE_MUTEX=NO. Errors emitted by the
+// writer thread are collected and re-emitted by the calling thread at the
+// end of Run().
+class GDALCopyWholeRasterPipeline
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALCopyWholeRasterPipeline)
+
+    struct Swath
+    {
+        GDALCopyWholeRasterPipeline* poPipeline = nullptr;
+        int     nBand = 0;  // 0 for all bands (pixel interleaved case)
+        int     iX = 0;
+        int     iY = 0;
+        int     nCols = 0;
+        int     nLines = 0;
+        GIntBig nSeq = 0;
+        void   *pSrcBuf = nullptr;  // Only used when converting.
+        void   *pDstBuf = nullptr;
+    };
+
+    GDALDataset        *m_poSrcDS;
+    GDALDataset        *m_poDstDS;
+    const GDALDataType  m_eDT;
+    GDALDataType        m_eSrcDT = GDT_Unknown;
+    const int           m_nBandsPerSwath;  // 1, or all bands if interleaved
+    const size_t        m_nSwathPixels;
+    int                 m_nMaxSwaths = 3;
+
+    std::unique_ptr<CPLJobQueue> m_poConvertQueue{};
+
+    std::mutex              m_oMutex{};
+    std::condition_variable m_oCV{};
+    std::vector<Swath*>     m_apoAllSwaths{};
+    std::vector<Swath*>     m_apoFreeSwaths{};
+    std::map<GIntBig, Swath*> m_oMapReadySwaths{};
+    GIntBig             m_nSeqSubmitted = 0;
+    GIntBig             m_nSeqWritten = 0;
+    bool                m_bReadDone = false;
+    bool                m_bAbort = false;
+    CPLErr              m_eWriteErr = CE_None;
+    std::vector<CPLErrorHandlerAccumulatorStruct> m_aoWriteErrors{};
+
+    Swath* AcquireSwath()
+    {
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        while( m_apoFreeSwaths.empty() && !m_bAbort &&
+               static_cast<int>(m_apoAllSwaths.size()) >= m_nMaxSwaths )
+        {
+            m_oCV.wait(oLock);
+        }
+        if( m_bAbort )
+            return nullptr;
+        if( !m_apoFreeSwaths.empty() )
+        {
+            Swath* psSwath = m_apoFreeSwaths.back();
+            m_apoFreeSwaths.pop_back();
+            return psSwath;
+        }
+
+        Swath* psSwath = new Swath();
+        psSwath->poPipeline = this;
+        m_apoAllSwaths.push_back(psSwath);
+        psSwath->pDstBuf = VSI_MALLOC3_VERBOSE(
+            m_nSwathPixels, m_nBandsPerSwath,
+            GDALGetDataTypeSizeBytes(m_eDT));
+        if( m_eSrcDT != GDT_Unknown )
+        {
+            psSwath->pSrcBuf = VSI_MALLOC3_VERBOSE(
+                m_nSwathPixels, m_nBandsPerSwath,
+                GDALGetDataTypeSizeBytes(m_eSrcDT));
+        }
+        if( psSwath->pDstBuf == nullptr ||
+            (m_eSrcDT != GDT_Unknown && psSwath->pSrcBuf == nullptr) )
+        {
+            m_bAbort = true;
+            m_oCV.notify_all();
+            return nullptr;
+        }
+        return psSwath;
+    }
+
+    void SetReady( Swath* psSwath )
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_oMapReadySwaths[psSwath->nSeq] = psSwath;
+        m_oCV.notify_all();
+    }
+
+    static void ConvertJob( void* pData )
+    {
+        Swath* psSwath = static_cast<Swath*>(pData);
+        GDALCopyWholeRasterPipeline* poThis = psSwath->poPipeline;
+        const int nBands = poThis->m_nBandsPerSwath;
+        GDALCopyWords64( psSwath->pSrcBuf, poThis->m_eSrcDT,
+                         GDALGetDataTypeSizeBytes(poThis->m_eSrcDT),
+                         psSwath->pDstBuf, poThis->m_eDT,
+                         GDALGetDataTypeSizeBytes(poThis->m_eDT),
+                         static_cast<GPtrDiff_t>(psSwath->nCols) *
+                             psSwath->nLines * nBands );
+        poThis->SetReady(psSwath);
+    }
+
+    static void WriterThread( void* pData )
+    {
+        auto poThis = static_cast<GDALCopyWholeRasterPipeline*>(pData);
+        CPLInstallErrorHandlerAccumulator(poThis->m_aoWriteErrors);
+        poThis->WriteSwaths();
+        CPLUninstallErrorHandlerAccumulator();
+    }
+
+    void WriteSwaths()
+    {
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        while( true )
+        {
+            auto oIter = m_oMapReadySwaths.end();
+            while( !m_bAbort &&
+                   (oIter = m_oMapReadySwaths.find(m_nSeqWritten)) ==
+                        m_oMapReadySwaths.end() &&
+                   !(m_bReadDone && m_nSeqWritten == m_nSeqSubmitted) )
+            {
+                m_oCV.wait(oLock);
+            }
+            if( m_bAbort || oIter == m_oMapReadySwaths.end() )
+                break;
+            Swath* psSwath = oIter->second;
+            m_oMapReadySwaths.erase(oIter);
+            oLock.unlock();
+
+            int nBand = psSwath->nBand;
+            const CPLErr eErr = m_poDstDS->RasterIO(
+                GF_Write,
+                psSwath->iX, psSwath->iY, psSwath->nCols, psSwath->nLines,
+                psSwath->pDstBuf, psSwath->nCols, psSwath->nLines,
+                m_eDT, nBand == 0 ? m_nBandsPerSwath : 1,
+                nBand == 0 ? nullptr : &nBand,
+                0, 0, 0, nullptr );
+
+            oLock.lock();
+            if( eErr != CE_None )
+            {
+                m_eWriteErr = eErr;
+                m_bAbort = true;
+            }
+            m_nSeqWritten ++;
+            m_apoFreeSwaths.push_back(psSwath);
+            m_oCV.notify_all();
+        }
+    }
+
+  public:
+    GDALCopyWholeRasterPipeline( GDALDataset* poSrcDS, GDALDataset* poDstDS,
+                                 GDALDataType eDT, bool bInterleave,
+                                 int nSwathCols, int nSwathLines ) :
+        m_poSrcDS(poSrcDS), m_poDstDS(poDstDS), m_eDT(eDT),
+        m_nBandsPerSwath(bInterleave ? poDstDS->GetRasterCount() : 1),
+        m_nSwathPixels(static_cast<size_t>(nSwathCols) * nSwathLines)
+    {
+    }
+
+    ~GDALCopyWholeRasterPipeline()
+    {
+        for( Swath* psSwath: m_apoAllSwaths )
+        {
+            VSIFree(psSwath->pSrcBuf);
+            VSIFree(psSwath->pDstBuf);
+            delete psSwath;
+        }
+    }
+
+    // Returns nullptr if the pipelined copy is not enabled.
+    static std::unique_ptr<GDALCopyWholeRasterPipeline> Create(
+                                GDALDataset* poSrcDS, GDALDataset* poDstDS,
+                                GDALDataType eDT, bool bInterleave,
+                                int nSwathCols, int nSwathLines,
+                                GIntBig nTotalSwaths )
+    {
+        if( nTotalSwaths < 2 )
+            return nullptr;
+        const int nThreads = GDALGetNumThreads(128);
+        if( nThreads < 2 )
+            return nullptr;
+        if( !CPLTestBool(
+                CPLGetConfigOption("GDAL_ENABLE_READ_WRITE_MUTEX", "YES")) )
+            return nullptr;
+
+        std::unique_ptr<GDALCopyWholeRasterPipeline> poPipeline(
+            new GDALCopyWholeRasterPipeline(poSrcDS, poDstDS, eDT,
+                                            bInterleave,
+                                            nSwathCols, nSwathLines));
+
+        // Convert in worker threads if all source bands have the same data
+        // type, different from the target one.
+        GDALDataType eSrcDT = poSrcDS->GetRasterBand(1)->GetRasterDataType();
+        for( int i = 2; i <= poSrcDS->GetRasterCount(); i++ )
+        {
+            if( poSrcDS->GetRasterBand(i)->GetRasterDataType() != eSrcDT )
+                eSrcDT = GDT_Unknown;
+        }
+        if( eSrcDT != GDT_Unknown && eSrcDT != eDT )
+        {
+            CPLWorkerThreadPool* poThreadPool =
+                GDALGetGlobalThreadPool(nThreads - 1);
+            if( poThreadPool )
+            {
+                poPipeline->m_eSrcDT = eSrcDT;
+                poPipeline->m_poConvertQueue = poThreadPool->CreateJobQueue();
+                poPipeline->m_nMaxSwaths = 2 + std::min(nThreads - 1, 3);
+            }
+        }
+
+        return poPipeline;
+    }
+
+    CPLErr Run( const std::vector<int>& anBands, int nSwathCols,
+                int nSwathLines, bool bCheckHoles,
+                GDALProgressFunc pfnProgress, void* pProgressData )
+    {
+        const int nXSize = m_poDstDS->GetRasterXSize();
+        const int nYSize = m_poDstDS->GetRasterYSize();
+        const GIntBig nTotalSwaths =
+            static_cast<GIntBig>(anBands.size()) *
+            DIV_ROUND_UP(nYSize, nSwathLines) *
+            DIV_ROUND_UP(nXSize, nSwathCols);
+        GIntBig nSwathsSkipped = 0;
+
+        CPLJoinableThread* hWriterThread =
+            CPLCreateJoinableThread(WriterThread, this);
+        if( hWriterThread == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "CPLCreateJoinableThread() failed in "
+                     "GDALDatasetCopyWholeRaster()");
+            return CE_Failure;
+        }
+
+        CPLErr eErr = CE_None;
+        for( const int nBand: anBands )
+        {
+            for( int iY = 0; iY < nYSize && eErr == CE_None;
+                 iY += nSwathLines )
+            {
+                const int nThisLines = std::min(nSwathLines, nYSize - iY);
+
+                for( int iX = 0; iX < nXSize && eErr == CE_None;
+                     iX += nSwathCols )
+                {
+                    const int nThisCols = std::min(nSwathCols, nXSize - iX);
+
+                    // Same hole detection as in the non pipelined case.
+                    int nStatus = GDAL_DATA_COVERAGE_STATUS_DATA;
+                    if( bCheckHoles && nBand != 0 )
+                    {
+                        nStatus = m_poSrcDS->GetRasterBand(nBand)->
+                            GetDataCoverageStatus(
+                                iX, iY, nThisCols, nThisLines,
+                                GDAL_DATA_COVERAGE_STATUS_DATA);
+                    }
+
+                    if( nStatus & GDAL_DATA_COVERAGE_STATUS_DATA )
+                    {
+                        Swath* psSwath = AcquireSwath();
+                        if( psSwath == nullptr )
+                        {
+                            eErr = CE_Failure;
+                            break;
+                        }
+                        psSwath->nBand = nBand;
+                        psSwath->iX = iX;
+                        psSwath->iY = iY;
+                        psSwath->nCols = nThisCols;
+                        psSwath->nLines = nThisLines;
+
+                        int nBandTmp = nBand;
+                        eErr = m_poSrcDS->RasterIO(
+                            GF_Read, iX, iY, nThisCols, nThisLines,
+                            m_poConvertQueue ? psSwath->pSrcBuf :
+                                               psSwath->pDstBuf,
+                            nThisCols, nThisLines,
+                            m_poConvertQueue ? m_eSrcDT : m_eDT,
+                            nBand == 0 ? m_nBandsPerSwath : 1,
+                            nBand == 0 ? nullptr : &nBandTmp,
+                            0, 0, 0, nullptr );
+
+                        if( eErr != CE_None )
+                        {
+                            std::lock_guard<std::mutex> oLock(m_oMutex);
+                            m_apoFreeSwaths.push_back(psSwath);
+                            break;
+                        }
+
+                        {
+                            std::lock_guard<std::mutex> oLock(m_oMutex);
+                            psSwath->nSeq = m_nSeqSubmitted ++;
+                        }
+                        if( m_poConvertQueue )
+                        {
+                            if( !m_poConvertQueue->SubmitJob(ConvertJob,
+                                                             psSwath) )
+                                ConvertJob(psSwath);
+                        }
+                        else
+                        {
+                            SetReady(psSwath);
+                        }
+                    }
+                    else
+                    {
+                        nSwathsSkipped ++;
+                    }
+
+                    GIntBig nSeqWritten;
+                    {
+                        std::lock_guard<std::mutex> oLock(m_oMutex);
+                        nSeqWritten = m_nSeqWritten;
+                    }
+                    if( !pfnProgress(
+                            static_cast<double>(nSeqWritten + nSwathsSkipped) /
+                                static_cast<double>(nTotalSwaths),
+                            nullptr, pProgressData ) )
+                    {
+                        eErr = CE_Failure;
+                        CPLError( CE_Failure, CPLE_UserInterrupt,
+                                  "User terminated CreateCopy()" );
+                    }
+                }
+            }
+            if( eErr != CE_None )
+                break;
+        }
+
+        {
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            m_bReadDone = true;
+            if( eErr != CE_None )
+                m_bAbort = true;
+            m_oCV.notify_all();
+        }
+        if( m_poConvertQueue )
+            m_poConvertQueue->WaitCompletion();
+        CPLJoinThread(hWriterThread);
+
+        for( const auto& oError : m_aoWriteErrors )
+        {
+            CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+        m_aoWriteErrors.clear();
+
+        if( eErr == CE_None )
+            eErr = m_eWriteErr;
+        if( eErr == CE_None &&
+            !pfnProgress( 1.0, nullptr, pProgressData ) )
+        {
+            eErr = CE_Failure;
+            CPLError( CE_Failure, CPLE_UserInterrupt,
+                      "User terminated CreateCopy()" );
+        }
+        return eErr;
+    }
+};
+
+} // namespace
+
+/************************************************************************/
+/*                     GDALCanCopyCompressedBlocks()                    */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+/** Return whether the compressed blocks of poSrcDS can be copied as they are
+ * into poDstDS, with GDALDataset::ReadCompressedData() and
+ * GDALDataset::WriteCompressedData().
+ *
+ * Drivers are expected to report no layout for a dataset being written when
+ * settings of their encoder have been explicitly requested, or when their
+ * codec is lossy, so that those settings are honoured. This can also be
+ * disabled by setting the GDAL_COPY_COMPRESSED_BLOCKS configuration option to
+ * NO, for example to force recompression with the default settings.
+ */
+bool GDALCanCopyCompressedBlocks(GDALDataset* poSrcDS, GDALDataset* poDstDS)
+{
+    if( poDstDS->GetAccess() != GA_Update ||
+        poSrcDS->GetRasterXSize() != poDstDS->GetRasterXSize() ||
+        poSrcDS->GetRasterYSize() != poDstDS->GetRasterYSize() ||
+        poSrcDS->GetRasterCount() != poDstDS->GetRasterCount() ||
+        !CPLTestBool(CPLGetConfigOption("GDAL_COPY_COMPRESSED_BLOCKS", "YES")) )
+    {
+        return false;
+    }
+
+    GDALDataset::CompressedBlockLayout sSrcLayout;
+    GDALDataset::CompressedBlockLayout sDstLayout;
+    return poSrcDS->GetCompressedBlockLayout(sSrcLayout) &&
+           poDstDS->GetCompressedBlockLayout(sDstLayout) &&
+           !sSrcLayout.osFormat.empty() &&
+           sSrcLayout.osFormat == sDstLayout.osFormat &&
+           sSrcLayout.nBlockXSize == sDstLayout.nBlockXSize &&
+           sSrcLayout.nBlockYSize == sDstLayout.nBlockYSize &&
+           sSrcLayout.nPlaneCount == sDstLayout.nPlaneCount;
+}
+//! @endcond
+
+/************************************************************************/
+/*                      GDALCopyCompressedBlocks()                      */
+/************************************************************************/
+
+// Implementation of GDALDatasetCopyWholeRaster() when
+// GDALCanCopyCompressedBlocks() returns true. Blocks missing in the source
+// are skipped if bSkipHoles is set, and otherwise copied through RasterIO(),
+// as they would be by the regular path.
+static CPLErr GDALCopyCompressedBlocks(GDALDataset* poSrcDS,
+                                       GDALDataset* poDstDS,
+                                       bool bSkipHoles,
+                                       GDALProgressFunc pfnProgress,
+                                       void *pProgressData)
+{
+    GDALDataset::CompressedBlockLayout sLayout;
+    poSrcDS->GetCompressedBlockLayout(sLayout);
+
+    // Make sure that the content of the source file is up to date
+    if( poSrcDS->GetAccess() == GA_Update )
+        poSrcDS->FlushCache(false);
+
+    const int nXBlocks =
+        DIV_ROUND_UP(poSrcDS->GetRasterXSize(), sLayout.nBlockXSize);
+    const int nYBlocks =
+        DIV_ROUND_UP(poSrcDS->GetRasterYSize(), sLayout.nBlockYSize);
+    const double dfTotalBlocks =
+        static_cast<double>(nXBlocks) * nYBlocks * sLayout.nPlaneCount;
+
+    CPLDebug("GDAL", "Copying %.0f compressed blocks from %s to %s",
+             dfTotalBlocks, poSrcDS->GetDescription(),
+             poDstDS->GetDescription());
+
+    // Bands of a plane: all of them if the data is pixel-interleaved, one
+    // otherwise.
+    const int nBandsPerPlane = sLayout.nPlaneCount == 1 ?
+                                        poSrcDS->GetRasterCount() : 1;
+    const GDALDataType eDT =
+        poDstDS->GetRasterBand(1)->GetRasterDataType();
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDT);
+    std::vector<GByte> abyHole;
+
+    std::vector<GByte> abyData;
+    double dfBlocksDone = 0;
+    for( int iPlane = 0; iPlane < sLayout.nPlaneCount; ++iPlane )
+    {
+        std::vector<int> anBandMap;
+        for( int i = 0; i < nBandsPerPlane; ++i )
+            anBandMap.push_back(sLayout.nPlaneCount == 1 ? i + 1 : iPlane + 1);
+
+        for( int iYBlock = 0; iYBlock < nYBlocks; ++iYBlock )
+        {
+            for( int iXBlock = 0; iXBlock < nXBlocks; ++iXBlock )
+            {
+                CPLErr eErr = poSrcDS->ReadCompressedData(
+                    iPlane, iXBlock, iYBlock, abyData);
+                if( eErr == CE_None && !abyData.empty() )
+                {
+                    eErr = poDstDS->WriteCompressedData(
+                        iPlane, iXBlock, iYBlock,
+                        abyData.data(), abyData.size());
+                }
+                else if( eErr == CE_None && !bSkipHoles )
+                {
+                    const int nXOff = iXBlock * sLayout.nBlockXSize;
+                    const int nYOff = iYBlock * sLayout.nBlockYSize;
+                    const int nXSize = std::min(sLayout.nBlockXSize,
+                        poSrcDS->GetRasterXSize() - nXOff);
+                    const int nYSize = std::min(sLayout.nBlockYSize,
+                        poSrcDS->GetRasterYSize() - nYOff);
+                    try
+                    {
+                        abyHole.resize(static_cast<size_t>(nXSize) * nYSize *
+                                       nBandsPerPlane * nDTSize);
+                    }
+                    catch( const std::exception& )
+                    {
+                        CPLError( CE_Failure, CPLE_OutOfMemory,
+                                  "Out of memory in GDALCopyCompressedBlocks()" );
+                        return CE_Failure;
+                    }
+                    eErr = poSrcDS->RasterIO( GF_Read, nXOff, nYOff,
+                                              nXSize, nYSize,
+                                              abyHole.data(), nXSize, nYSize,
+                                              eDT, nBandsPerPlane,
+                                              anBandMap.data(), 0, 0, 0,
+                                              nullptr );
+                    if( eErr == CE_None )
+                    {
+                        eErr = poDstDS->RasterIO( GF_Write, nXOff, nYOff,
+                                                  nXSize, nYSize,
+                                                  abyHole.data(),
+                                                  nXSize, nYSize,
+                                                  eDT, nBandsPerPlane,
+                                                  anBandMap.data(), 0, 0, 0,
+                                                  nullptr );
+                    }
+                }
+                if( eErr != CE_None )
+                    return eErr;
+
+                dfBlocksDone += 1;
+                if( !pfnProgress(dfBlocksDone / dfTotalBlocks,
+                                 nullptr, pProgressData) )
+                {
+                    CPLError( CE_Failure, CPLE_UserInterrupt,
+                              "User terminated CreateCopy()" );
+                    return CE_Failure;
+                }
+            }
+        }
+    }
+    return CE_None;
+}
+
 /************************************************************************/
 /*                     GDALDatasetCopyWholeRaster()                     */
 /************************************************************************/
@@ -4668,6 +5530,17 @@ static void GDALCopyWholeRasterGetSwathSize(
  * </ul>
  * More options may be supported in the future.
  *
+ * Starting with GDAL 3.7, if both datasets report the same
+ * GDALDataset::GetCompressedBlockLayout(), blocks are copied in their
+ * compressed form, without being decoded and re-encoded. This can be disabled
+ * by setting the GDAL_COPY_COMPRESSED_BLOCKS configuration option to NO.
+ *
+ * Starting with GDAL 3.7, if the GDAL_NUM_THREADS configuration option is set
+ * to ALL_CPUS or a value greater than one, reading, data type conversion and
+ * writing of successive swaths are done concurrently: swaths are read by the
+ * calling thread and written by a dedicated thread, with a bounded number of
+ * swaths in flight.
+ *
  * @param hSrcDS the source dataset
  * @param hDstDS the destination dataset
  * @param papszOptions transfer hints in "StringList" Name=Value format.
@@ -4725,6 +5598,18 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
     if( nBandCount == 0 )
         return CE_None;
 
+/* -------------------------------------------------------------------- */
+/*      Copy compressed blocks as they are if the source and target     */
+/*      datasets use the same encoding and block layout.                */
+/* -------------------------------------------------------------------- */
+    if( GDALCanCopyCompressedBlocks(poSrcDS, poDstDS) )
+    {
+        const bool bSkipHoles = CPLTestBool(CSLFetchNameValueDef(
+                                        papszOptions, "SKIP_HOLES", "NO" ));
+        return GDALCopyCompressedBlocks(poSrcDS, poDstDS, bSkipHoles,
+                                        pfnProgress, pProgressData);
+    }
+
     GDALRasterBand *poSrcPrototypeBand = poSrcDS->GetRasterBand(1);
     GDALRasterBand *poDstPrototypeBand = poDstDS->GetRasterBand(1);
     GDALDataType eDT = poDstPrototypeBand->GetRasterDataType();
@@ -4781,15 +5666,29 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
     if( bInterleave)
         nPixelSize *= nBandCount;
 
-    void *pSwathBuf = VSI_MALLOC3_VERBOSE(nSwathCols, nSwathLines, nPixelSize );
-    if( pSwathBuf == nullptr )
+    const GIntBig nTotalSwaths =
+        static_cast<GIntBig>(bInterleave ? 1 : nBandCount) *
+        DIV_ROUND_UP(nYSize, nSwathLines) *
+        DIV_ROUND_UP(nXSize, nSwathCols);
+    auto poPipeline = GDALCopyWholeRasterPipeline::Create(
+        poSrcDS, poDstDS, eDT, bInterleave, nSwathCols, nSwathLines,
+        nTotalSwaths);
+
+    void *pSwathBuf = nullptr;
+    if( poPipeline == nullptr )
     {
-        return CE_Failure;
+        pSwathBuf = VSI_MALLOC3_VERBOSE(nSwathCols, nSwathLines, nPixelSize );
+        if( pSwathBuf == nullptr )
+        {
+            return CE_Failure;
+        }
     }
 
     CPLDebug( "GDAL",
-              "GDALDatasetCopyWholeRaster(): %d*%d swaths, bInterleave=%d",
-              nSwathCols, nSwathLines, static_cast<int>(bInterleave) );
+              "GDALDatasetCopyWholeRaster(): %d*%d swaths, bInterleave=%d, "
+              "pipelined=%d",
+              nSwathCols, nSwathLines, static_cast<int>(bInterleave),
+              static_cast<int>(poPipeline != nullptr) );
 
     // Advise the source raster that we are going to read it completely
     // Note: this might already have been done by GDALCreateCopy() in the
@@ -4804,7 +5703,20 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
     const bool bCheckHoles = CPLTestBool( CSLFetchNameValueDef(
                                         papszOptions, "SKIP_HOLES", "NO" ) );
 
-    if( !bInterleave )
+    if( poPipeline )
+    {
+        std::vector<int> anBands;
+        if( bInterleave )
+            anBands.push_back(0);
+        else
+        {
+            for( int iBand = 0; iBand < nBandCount; iBand++ )
+                anBands.push_back(iBand + 1);
+        }
+        eErr = poPipeline->Run( anBands, nSwathCols, nSwathLines,
+                                bCheckHoles, pfnProgress, pProgressData );
+    }
+    else if( !bInterleave )
     {
         GDALRasterIOExtraArg sExtraArg;
         INIT_RASTERIO_EXTRA_ARG(sExtraArg);
@@ -0,0 +1,463 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  AVX2 specializations
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
+
+#include "rasterio_avx2.h"
+
+#include <immintrin.h>
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Note: gdal_priv_templates.hpp is deliberately not included, as its
+// GDALCopy8Words() specializations depend on __AVX2__ and must not be
+// instantiated with different definitions in this compilation unit.
+// The scalar conversions below must give the same results as GDALCopyWord().
+
+namespace
+{
+
+/************************************************************************/
+/*                          Scalar conversions                          */
+/************************************************************************/
+
+template<class Tin, class Tout> inline Tout ConvertToInt(Tin nValue,
+                                                         std::true_type)
+{
+    const int64_t nVal = static_cast<int64_t>(nValue);
+    constexpr int64_t nMin =
+        static_cast<int64_t>(std::numeric_limits<Tout>::min());
+    constexpr int64_t nMax =
+        static_cast<int64_t>(std::numeric_limits<Tout>::max());
+    return static_cast<Tout>(nVal < nMin ? nMin : nVal > nMax ? nMax : nVal);
+}
+
+template<class Tin, class Tout> inline Tout ConvertToInt(Tin fValue,
+                                                         std::false_type)
+{
+    if( fValue != fValue )
+        return 0;
+    constexpr Tin fMin = static_cast<Tin>(std::numeric_limits<Tout>::min());
+    constexpr Tin fMax = static_cast<Tin>(std::numeric_limits<Tout>::max());
+    if( std::numeric_limits<Tout>::is_signed )
+        fValue = fValue >= 0 ? fValue + static_cast<Tin>(0.5) :
+                               fValue - static_cast<Tin>(0.5);
+    else
+        fValue += static_cast<Tin>(0.5);
+    return static_cast<Tout>(fValue > fMax ? fMax :
+                             fValue < fMin ? fMin : fValue);
+}
+
+inline float ConvertDoubleToFloat(double dfValue)
+{
+    if( dfValue > std::numeric_limits<float>::max() )
+        return std::numeric_limits<float>::infinity();
+    if( dfValue < -std::numeric_limits<float>::max() )
+        return -std::numeric_limits<float>::infinity();
+    return static_cast<float>(dfValue);
+}
+
+/************************************************************************/
+/*                   Loading of 8 integers as Int32                     */
+/************************************************************************/
+
+template<class T> inline __m256i Load8AsInt32(const T* p);
+
+template<> inline __m256i Load8AsInt32(const GByte* p)
+{
+    return _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+template<> inline __m256i Load8AsInt32(const GInt16* p)
+{
+    return _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+template<> inline __m256i Load8AsInt32(const GUInt16* p)
+{
+    return _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+template<> inline __m256i Load8AsInt32(const GInt32* p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+/************************************************************************/
+/*            Storing of 16 Int32 with saturation to the type           */
+/************************************************************************/
+
+template<class T> inline void Store16FromInt32(__m256i a, __m256i b, T* p);
+
+template<> inline void Store16FromInt32(__m256i a, __m256i b, GByte* p)
+{
+    // Pack with signed saturation to Int16 (values > 32767 are still
+    // greater than 255), and then with unsigned saturation to Byte.
+    __m256i ab = _mm256_packs_epi32(a, b);
+    ab = _mm256_permute4x64_epi64(ab, 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    const __m128i xmm = _mm_packus_epi16(_mm256_castsi256_si128(ab),
+                                         _mm256_extracti128_si256(ab, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), xmm);
+}
+
+template<> inline void Store16FromInt32(__m256i a, __m256i b, GInt16* p)
+{
+    __m256i ab = _mm256_packs_epi32(a, b);
+    ab = _mm256_permute4x64_epi64(ab, 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), ab);
+}
+
+template<> inline void Store16FromInt32(__m256i a, __m256i b, GUInt16* p)
+{
+    __m256i ab = _mm256_packus_epi32(a, b);
+    ab = _mm256_permute4x64_epi64(ab, 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), ab);
+}
+
+template<> inline void Store16FromInt32(__m256i a, __m256i b, GInt32* p)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 8), b);
+}
+
+/************************************************************************/
+/*          Rounding and clamping of 8 reals to the type range          */
+/************************************************************************/
+
+template<class Tout> inline __m256i Convert8ToInt32(const float* p)
+{
+    const __m256 ymm = _mm256_loadu_ps(p);
+    const __m256 p0d5 = _mm256_set1_ps(0.5f);
+    const __m256 ymm_max =
+        _mm256_set1_ps(static_cast<float>(std::numeric_limits<Tout>::max()));
+    __m256 ymm_r;
+    if( std::numeric_limits<Tout>::is_signed )
+    {
+        // f >= 0 ? f + 0.5f : f - 0.5f, and NaN to 0
+        const __m256 mask_pos = _mm256_cmp_ps(ymm, _mm256_setzero_ps(),
+                                              _CMP_GE_OQ);
+        ymm_r = _mm256_add_ps(ymm, _mm256_blendv_ps(_mm256_set1_ps(-0.5f),
+                                                    p0d5, mask_pos));
+        ymm_r = _mm256_and_ps(ymm_r, _mm256_cmp_ps(ymm, ymm, _CMP_ORD_Q));
+        const __m256 ymm_min = _mm256_set1_ps(
+            static_cast<float>(std::numeric_limits<Tout>::min()));
+        ymm_r = _mm256_min_ps(_mm256_max_ps(ymm_r, ymm_min), ymm_max);
+    }
+    else
+    {
+        // NaN is mapped to 0.5 by _mm256_max_ps(NaN, 0.5)
+        ymm_r = _mm256_add_ps(ymm, p0d5);
+        ymm_r = _mm256_min_ps(_mm256_max_ps(ymm_r, p0d5), ymm_max);
+    }
+    return _mm256_cvttps_epi32(ymm_r);
+}
+
+template<class Tout> inline __m128i Convert4ToInt32(const double* p)
+{
+    const __m256d ymm = _mm256_loadu_pd(p);
+    const __m256d p0d5 = _mm256_set1_pd(0.5);
+    const __m256d ymm_max =
+        _mm256_set1_pd(static_cast<double>(std::numeric_limits<Tout>::max()));
+    __m256d ymm_r;
+    if( std::numeric_limits<Tout>::is_signed )
+    {
+        const __m256d mask_pos = _mm256_cmp_pd(ymm, _mm256_setzero_pd(),
+                                               _CMP_GE_OQ);
+        ymm_r = _mm256_add_pd(ymm, _mm256_blendv_pd(_mm256_set1_pd(-0.5),
+                                                    p0d5, mask_pos));
+        ymm_r = _mm256_and_pd(ymm_r, _mm256_cmp_pd(ymm, ymm, _CMP_ORD_Q));
+        const __m256d ymm_min = _mm256_set1_pd(
+            static_cast<double>(std::numeric_limits<Tout>::min()));
+        ymm_r = _mm256_min_pd(_mm256_max_pd(ymm_r, ymm_min), ymm_max);
+    }
+    else
+    {
+        ymm_r = _mm256_add_pd(ymm, p0d5);
+        ymm_r = _mm256_min_pd(_mm256_max_pd(ymm_r, p0d5), ymm_max);
+    }
+    return _mm256_cvttpd_epi32(ymm_r);
+}
+
+template<class Tout> inline __m256i Convert8ToInt32(const double* p)
+{
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(Convert4ToInt32<Tout>(p)),
+        Convert4ToInt32<Tout>(p + 4), 1);
+}
+
+// Integer inputs are saturated when stored.
+template<class Tout, class Tin> inline __m256i Convert8ToInt32(const Tin* p)
+{
+    return Load8AsInt32(p);
+}
+
+/************************************************************************/
+/*                              Kernels                                 */
+/************************************************************************/
+
+// Integer to integer, and real to integer
+template<class Tin, class Tout> void CopyToInt(const Tin* CPL_RESTRICT pSrc,
+                                               Tout* CPL_RESTRICT pDst,
+                                               GPtrDiff_t nWordCount)
+{
+    GPtrDiff_t n = 0;
+    for( ; n + 16 <= nWordCount; n += 16 )
+    {
+        Store16FromInt32(Convert8ToInt32<Tout>(pSrc + n),
+                         Convert8ToInt32<Tout>(pSrc + n + 8), pDst + n);
+    }
+    for( ; n < nWordCount; ++n )
+    {
+        pDst[n] = ConvertToInt<Tin, Tout>(
+            pSrc[n],
+            std::integral_constant<bool, std::numeric_limits<Tin>::is_integer>());
+    }
+}
+
+template<class Tin> void CopyIntToFloat(const Tin* CPL_RESTRICT pSrc,
+                                        float* CPL_RESTRICT pDst,
+                                        GPtrDiff_t nWordCount)
+{
+    GPtrDiff_t n = 0;
+    for( ; n + 8 <= nWordCount; n += 8 )
+    {
+        _mm256_storeu_ps(pDst + n, _mm256_cvtepi32_ps(Load8AsInt32(pSrc + n)));
+    }
+    for( ; n < nWordCount; ++n )
+    {
+        pDst[n] = static_cast<float>(pSrc[n]);
+    }
+}
+
+template<class Tin> void CopyIntToDouble(const Tin* CPL_RESTRICT pSrc,
+                                         double* CPL_RESTRICT pDst,
+                                         GPtrDiff_t nWordCount)
+{
+    GPtrDiff_t n = 0;
+    for( ; n + 8 <= nWordCount; n += 8 )
+    {
+        const __m256i ymm = Load8AsInt32(pSrc + n);
+        _mm256_storeu_pd(pDst + n,
+                         _mm256_cvtepi32_pd(_mm256_castsi256_si128(ymm)));
+        _mm256_storeu_pd(pDst + n + 4,
+                         _mm256_cvtepi32_pd(_mm256_extracti128_si256(ymm, 1)));
+    }
+    for( ; n < nWordCount; ++n )
+    {
+        pDst[n] = static_cast<double>(pSrc[n]);
+    }
+}
+
+void CopyFloatToDouble(const float* CPL_RESTRICT pSrc,
+                       double* CPL_RESTRICT pDst,
+                       GPtrDiff_t nWordCount)
+{
+    GPtrDiff_t n = 0;
+    for( ; n + 8 <= nWordCount; n += 8 )
+    {
+        _mm256_storeu_pd(pDst + n, _mm256_cvtps_pd(_mm_loadu_ps(pSrc + n)));
+        _mm256_storeu_pd(pDst + n + 4,
+                         _mm256_cvtps_pd(_mm_loadu_ps(pSrc + n + 4)));
+    }
+    for( ; n < nWordCount; ++n )
+    {
+        pDst[n] = pSrc[n];
+    }
+}
+
+void CopyDoubleToFloat(const double* CPL_RESTRICT pSrc,
+                       float* CPL_RESTRICT pDst,
+                       GPtrDiff_t nWordCount)
+{
+    const __m256d ymm_posmax = _mm256_set1_pd(std::numeric_limits<float>::max());
+    const __m256d ymm_negmax = _mm256_set1_pd(-std::numeric_limits<float>::max());
+    const __m128 xmm_posinf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    const __m128 xmm_neginf = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    GPtrDiff_t n = 0;
+    for( ; n + 4 <= nWordCount; n += 4 )
+    {
+        const __m256d ymm = _mm256_loadu_pd(pSrc + n);
+        // Values out of the float range are mapped to infinity, rather than
+        // being rounded to +/- FLT_MAX when close to it.
+        const __m128 mask_pos = _mm256_cvtpd_ps(
+            _mm256_cmp_pd(ymm, ymm_posmax, _CMP_GT_OQ));
+        const __m128 mask_neg = _mm256_cvtpd_ps(
+            _mm256_cmp_pd(ymm, ymm_negmax, _CMP_LT_OQ));
+        __m128 xmm = _mm256_cvtpd_ps(ymm);
+        xmm = _mm_blendv_ps(xmm, xmm_posinf, mask_pos);
+        xmm = _mm_blendv_ps(xmm, xmm_neginf, mask_neg);
+        _mm_storeu_ps(pDst + n, xmm);
+    }
+    for( ; n < nWordCount; ++n )
+    {
+        pDst[n] = ConvertDoubleToFloat(pSrc[n]);
+    }
+}
+
+/************************************************************************/
+/*                            Dispatching                               */
+/************************************************************************/
+
+template<class Tin> bool CopyFromIntType(const Tin* pSrc, void* pDstData,
+                                         GDALDataType eDstType,
+                                         GPtrDiff_t nWordCount)
+{
+    switch( eDstType )
+    {
+        case GDT_Byte:
+            CopyToInt(pSrc, static_cast<GByte*>(pDstData), nWordCount);
+            return true;
+        case GDT_Int16:
+            CopyToInt(pSrc, static_cast<GInt16*>(pDstData), nWordCount);
+            return true;
+        case GDT_UInt16:
+            CopyToInt(pSrc, static_cast<GUInt16*>(pDstData), nWordCount);
+            return true;
+        case GDT_Float32:
+            CopyIntToFloat(pSrc, static_cast<float*>(pDstData), nWordCount);
+            return true;
+        case GDT_Float64:
+            CopyIntToDouble(pSrc, static_cast<double*>(pDstData), nWordCount);
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                   GDALCopyWordsContiguous_AVX2()                     */
+/************************************************************************/
+
+// Converts nWordCount packed words, with the same results as GDALCopyWords().
+// Returns false if the type pair is not handled here.
+bool GDALCopyWordsContiguous_AVX2( const void* CPL_RESTRICT pSrcData,
+                                   GDALDataType eSrcType,
+                                   void* CPL_RESTRICT pDstData,
+                                   GDALDataType eDstType,
+                                   GPtrDiff_t nWordCount )
+{
+    switch( eSrcType )
+    {
+        case GDT_Byte:
+            // Byte to Int16/UInt16 is already handled with SSE2
+            if( eDstType == GDT_Float32 || eDstType == GDT_Float64 )
+                return CopyFromIntType(static_cast<const GByte*>(pSrcData),
+                                       pDstData, eDstType, nWordCount);
+            break;
+
+        case GDT_Int16:
+            if( eDstType == GDT_Int32 )
+            {
+                CopyToInt(static_cast<const GInt16*>(pSrcData),
+                          static_cast<GInt32*>(pDstData), nWordCount);
+                return true;
+            }
+            return CopyFromIntType(static_cast<const GInt16*>(pSrcData),
+                                   pDstData, eDstType, nWordCount);
+
+        case GDT_UInt16:
+            if( eDstType == GDT_Int32 )
+            {
+                CopyToInt(static_cast<const GUInt16*>(pSrcData),
+                          static_cast<GInt32*>(pDstData), nWordCount);
+                return true;
+            }
+            return CopyFromIntType(static_cast<const GUInt16*>(pSrcData),
+                                   pDstData, eDstType, nWordCount);
+
+        case GDT_Int32:
+            return CopyFromIntType(static_cast<const GInt32*>(pSrcData),
+                                   pDstData, eDstType, nWordCount);
+
+        case GDT_Float32:
+        {
+            const float* pSrc = static_cast<const float*>(pSrcData);
+            switch( eDstType )
+            {
+                case GDT_Byte:
+                    CopyToInt(pSrc, static_cast<GByte*>(pDstData), nWordCount);
+                    return true;
+                case GDT_Int16:
+                    CopyToInt(pSrc, static_cast<GInt16*>(pDstData), nWordCount);
+                    return true;
+                case GDT_UInt16:
+                    CopyToInt(pSrc, static_cast<GUInt16*>(pDstData), nWordCount);
+                    return true;
+                case GDT_Float64:
+                    CopyFloatToDouble(pSrc, static_cast<double*>(pDstData),
+                                      nWordCount);
+                    return true;
+                default:
+                    break;
+            }
+            break;
+        }
+
+        case GDT_Float64:
+        {
+            const double* pSrc = static_cast<const double*>(pSrcData);
+            switch( eDstType )
+            {
+                case GDT_Byte:
+                    CopyToInt(pSrc, static_cast<GByte*>(pDstData), nWordCount);
+                    return true;
+                case GDT_Int16:
+                    CopyToInt(pSrc, static_cast<GInt16*>(pDstData), nWordCount);
+                    return true;
+                case GDT_UInt16:
+                    CopyToInt(pSrc, static_cast<GUInt16*>(pDstData), nWordCount);
+                    return true;
+                case GDT_Int32:
+                    CopyToInt(pSrc, static_cast<GInt32*>(pDstData), nWordCount);
+                    return true;
+                case GDT_Float32:
+                    CopyDoubleToFloat(pSrc, static_cast<float*>(pDstData),
+                                      nWordCount);
+                    return true;
+                default:
+                    break;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+    return false;
+}
+
+#endif
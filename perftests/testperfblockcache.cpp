@@ -0,0 +1,193 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Test performance of the block cache eviction policies on a
+ *           workload mixing accesses to a hot set of blocks with full scans.
+ * Author:   Even Rouault, <even dot rouault at spatialys.com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2023, Even Rouault <even dot rouault at spatialys.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+// Usage: testperfblockcache [--config GDAL_BLOCK_CACHE_POLICY LRU|2Q]
+//                           [-cachemax <MB>] [-hot <blocks>] [-scan <blocks>]
+//                           [-rounds <n>] [-readcost <microseconds>]
+//
+// Each round reads all blocks of a "scan" dataset once (like gdalinfo -stats
+// or gdal_translate would do), interleaved with random reads of a small set
+// of "hot" blocks of another dataset (like a tile server would do).
+// The number of hot block reads that had to go to the "driver" is reported.
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal_priv.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+constexpr int BLOCK_SIZE = 256;
+
+class CountingRasterBand final : public GDALRasterBand
+{
+  public:
+    int nReads = 0;
+    int nReadCostMicroSec = 0;
+
+    CountingRasterBand( GDALDataset* poDSIn, int nBlocksPerRowIn,
+                        int nBlocksPerColumnIn )
+    {
+        poDS = poDSIn;
+        nBand = 1;
+        eDataType = GDT_Byte;
+        nBlockXSize = BLOCK_SIZE;
+        nBlockYSize = BLOCK_SIZE;
+        nRasterXSize = BLOCK_SIZE * nBlocksPerRowIn;
+        nRasterYSize = BLOCK_SIZE * nBlocksPerColumnIn;
+    }
+
+    CPLErr IReadBlock( int nXBlockOff, int nYBlockOff, void* pData ) override
+    {
+        ++nReads;
+        memset(pData, (nXBlockOff + nYBlockOff) & 0xFF,
+               BLOCK_SIZE * BLOCK_SIZE);
+        if( nReadCostMicroSec > 0 )
+            CPLSleep(nReadCostMicroSec * 1e-6);
+        return CE_None;
+    }
+};
+
+class CountingDataset final : public GDALDataset
+{
+  public:
+    CountingDataset( int nBlocksPerRowIn, int nBlocksPerColumnIn )
+    {
+        nRasterXSize = BLOCK_SIZE * nBlocksPerRowIn;
+        nRasterYSize = BLOCK_SIZE * nBlocksPerColumnIn;
+        SetBand(1, new CountingRasterBand(this, nBlocksPerRowIn,
+                                          nBlocksPerColumnIn));
+    }
+
+    CountingRasterBand* GetCountingBand()
+    {
+        return cpl::down_cast<CountingRasterBand*>(GetRasterBand(1));
+    }
+};
+
+static bool ReadBlock( GDALRasterBand* poBand, int nXBlock, int nYBlock )
+{
+    GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(nXBlock, nYBlock);
+    if( poBlock == nullptr )
+        return false;
+    poBlock->DropLock();
+    return true;
+}
+
+int main( int argc, char* argv[] )
+{
+    argc = GDALGeneralCmdLineProcessor(argc, &argv, 0);
+    if( argc < 1 )
+        exit(-argc);
+
+    int nCacheMaxMB = 16;
+    int nHotBlocks = 100;
+    int nScanBlocksPerRow = 40;
+    int nRounds = 10;
+    int nReadCostMicroSec = 0;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-cachemax") && i + 1 < argc )
+            nCacheMaxMB = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-hot") && i + 1 < argc )
+            nHotBlocks = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-scan") && i + 1 < argc )
+            nScanBlocksPerRow = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-rounds") && i + 1 < argc )
+            nRounds = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-readcost") && i + 1 < argc )
+            nReadCostMicroSec = atoi(argv[++i]);
+        else
+        {
+            printf("Usage: testperfblockcache [-cachemax <MB>] "
+                   "[-hot <blocks>] [-scan <blocks_per_row>] "
+                   "[-rounds <n>] [-readcost <microseconds>]\n");
+            CSLDestroy(argv);
+            return 1;
+        }
+    }
+
+    GDALSetCacheMax64(static_cast<GIntBig>(nCacheMaxMB) * 1024 * 1024);
+
+    auto poHotDS = new CountingDataset(nHotBlocks, 1);
+    auto poScanDS = new CountingDataset(nScanBlocksPerRow, nScanBlocksPerRow);
+    CountingRasterBand* poHotBand = poHotDS->GetCountingBand();
+    CountingRasterBand* poScanBand = poScanDS->GetCountingBand();
+    poHotBand->nReadCostMicroSec = nReadCostMicroSec;
+    poScanBand->nReadCostMicroSec = nReadCostMicroSec;
+
+    std::mt19937 oGenerator(0);
+    std::uniform_int_distribution<int> oHotDistribution(0, nHotBlocks - 1);
+
+    printf("GDAL_BLOCK_CACHE_POLICY = %s\n",
+           CPLGetConfigOption("GDAL_BLOCK_CACHE_POLICY", "LRU"));
+    printf("Cache: %d MB, hot set: %d blocks, scan: %d blocks/round\n",
+           nCacheMaxMB, nHotBlocks, nScanBlocksPerRow * nScanBlocksPerRow);
+
+    const auto start = std::chrono::steady_clock::now();
+    int nHotAccesses = 0;
+    for( int iRound = 0; iRound < nRounds; ++iRound )
+    {
+        const int nHotReadsBefore = poHotBand->nReads;
+        for( int iY = 0; iY < nScanBlocksPerRow; ++iY )
+        {
+            for( int iX = 0; iX < nScanBlocksPerRow; ++iX )
+            {
+                if( !ReadBlock(poScanBand, iX, iY) ||
+                    !ReadBlock(poHotBand, oHotDistribution(oGenerator), 0) )
+                {
+                    fprintf(stderr, "Failure\n");
+                    delete poHotDS;
+                    delete poScanDS;
+                    CSLDestroy(argv);
+                    return 1;
+                }
+                ++nHotAccesses;
+            }
+        }
+        printf("Round %d: %d hot block misses\n", iRound,
+               poHotBand->nReads - nHotReadsBefore);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    printf("Hot set hit ratio: %.1f %%\n",
+           100.0 * (nHotAccesses - poHotBand->nReads) / nHotAccesses);
+    printf("Elapsed: %.3f s\n",
+           std::chrono::duration<double>(end - start).count());
+
+    delete poHotDS;
+    delete poScanDS;
+    CSLDestroy(argv);
+    GDALDestroyDriverManager();
+    return 0;
+}
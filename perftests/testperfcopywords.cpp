@@ -114,5 +114,42 @@ int main(int /* argc */, char* /* argv */ [])
     }
     CPLSetConfigOption("GDAL_USE_SSSE3", nullptr);
 
+    // Packed conversions between common data types, which have AVX2 kernels.
+    // GDAL_USE_AVX2=NO is only honoured in DEBUG builds.
+    const GDALDataType aeCommonTypes[] = { GDT_Byte, GDT_Int16, GDT_UInt16,
+                                           GDT_Int32, GDT_Float32,
+                                           GDT_Float64 };
+    for(int k=0;k<2;k++)
+    {
+        if( k == 1 )
+        {
+            printf("Disabling AVX2\n");
+            CPLSetConfigOption("GDAL_USE_AVX2", "NO");
+        }
+
+        for( const GDALDataType eInType: aeCommonTypes )
+        {
+            for( const GDALDataType eOutType: aeCommonTypes )
+            {
+                if( eInType == eOutType )
+                    continue;
+
+                start = clock();
+                for(i=0;i<10000;i++)
+                    GDALCopyWords(in, eInType,
+                                  GDALGetDataTypeSizeBytes(eInType),
+                                  out, eOutType,
+                                  GDALGetDataTypeSizeBytes(eOutType),
+                                  256 * 256);
+                end = clock();
+                printf("%s -> %s (packed, x10000) : %.2f s\n",
+                       GDALGetDataTypeName(eInType),
+                       GDALGetDataTypeName(eOutType),
+                       (end - start) * 1.0 / CLOCKS_PER_SEC);
+            }
+        }
+    }
+    CPLSetConfigOption("GDAL_USE_AVX2", nullptr);
+
     return 0;
 }
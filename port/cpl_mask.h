@@ -38,6 +38,11 @@
 
 #include <cstring>
 
+#if (defined(__x86_64) || defined(_M_X64)) && !defined(USE_SSE2_EMULATION)
+#include <emmintrin.h>
+#define CPL_MASK_USE_SSE2
+#endif
+
 /**
  * Allocates a buffer to store a given number of bits
  *
@@ -131,6 +136,95 @@ void CPLMaskMerge(GUInt32* mask1, GUInt32* mask2, std::size_t n) {
     }
 }
 
+/**
+ * Set a mask to false wherever a second mask is false
+ *
+ * @param mask1 destination mask
+ * @param mask2 source mask
+ * @param n number of bits in masks (must be same)
+ */
+inline
+void CPLMaskIntersect(GUInt32* mask1, const GUInt32* mask2, std::size_t n) {
+    std::size_t nIter = (n + 31) / 32;
+    for (std::size_t i = 0; i < nIter; i++) {
+        mask1[i] &= mask2[i];
+    }
+}
+
+/**
+ * Clear the bits of a mask wherever a byte mask (one byte per bit) is zero
+ *
+ * @param mask bit mask
+ * @param pabyByteMask byte mask, of at least n bytes
+ * @param n number of bits in mask
+ * @return `true` if no bit was cleared
+ */
+inline
+bool CPLMaskClearFromBytes(GUInt32* mask, const GByte* pabyByteMask,
+                           std::size_t n) {
+    GUInt32 nCleared = 0;
+    std::size_t i = 0;
+#ifdef CPL_MASK_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 32 <= n; i += 32) {
+        const __m128i lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pabyByteMask + i));
+        const __m128i hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pabyByteMask + i + 16));
+        const GUInt32 nZeros =
+            static_cast<GUInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, zero))) |
+            (static_cast<GUInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, zero))) << 16);
+        mask[i >> 5] &= ~nZeros;
+        nCleared |= nZeros;
+    }
+#endif
+    for (; i < n; i++) {
+        if (pabyByteMask[i] == 0) {
+            CPLMaskClear(mask, i);
+            nCleared = 1;
+        }
+    }
+    return nCleared == 0;
+}
+
+/**
+ * Expand a bit mask to a byte mask (255 for set bits, 0 for cleared bits)
+ *
+ * @param mask bit mask
+ * @param pabyByteMask destination byte mask, of at least n bytes
+ * @param n number of bits in mask
+ */
+inline
+void CPLMaskExpandToBytes(const GUInt32* mask, GByte* pabyByteMask,
+                          std::size_t n) {
+    std::size_t i = 0;
+#ifdef CPL_MASK_USE_SSE2
+    // Byte j of a 16-byte lane tests bit (j % 8) of the byte it was
+    // broadcast from.
+    const __m128i bitSelect = _mm_set_epi8(
+        static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    for (; i + 32 <= n; i += 32) {
+        const GUInt32 nWord = mask[i >> 5];
+        for (int iHalf = 0; iHalf < 2; iHalf++) {
+            // Broadcast byte 0 to bytes 0-7 and byte 1 to bytes 8-15.
+            __m128i v = _mm_cvtsi32_si128(
+                static_cast<int>((nWord >> (16 * iHalf)) & 0xffff));
+            v = _mm_unpacklo_epi8(v, v);
+            v = _mm_unpacklo_epi16(v, v);
+            v = _mm_unpacklo_epi32(v, v);
+            v = _mm_cmpeq_epi8(_mm_and_si128(v, bitSelect), bitSelect);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(pabyByteMask + i + 16 * iHalf), v);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        pabyByteMask[i] =
+            (mask[i >> 5] & (0x01U << (i & 0x1f))) ? 255 : 0;
+    }
+}
+
 #endif // __cplusplus
 
 #endif // CPL_MASK_H
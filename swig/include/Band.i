@@ -283,6 +283,20 @@ public:
   }
 %clear (CPLErr);
 
+#if defined(SWIGPYTHON)
+%apply (IF_ERROR_RETURN_NONE) { (CPLErr) };
+%feature ("kwargs") ComputeQuantiles;
+  CPLErr ComputeQuantiles( bool approx_ok,
+                           int nQuantiles, const double* padfProbabilities,
+                           double* padfQuantiles,
+                           GDALProgressFunc callback = NULL, void* callback_data=NULL){
+    return GDALComputeRasterQuantiles( self, approx_ok, nQuantiles,
+                                       padfProbabilities, padfQuantiles,
+                                       callback, callback_data );
+  }
+%clear (CPLErr);
+#endif
+
   CPLErr SetStatistics( double min, double max, double mean, double stddev ) {
     return GDALSetRasterStatistics( self, min, max, mean, stddev );
   }
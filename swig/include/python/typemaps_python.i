@@ -1720,6 +1720,65 @@ OBJECT_LIST_INPUT(GDALDatasetShadow);
   }
 }
 
+/* ***************************************************************************
+ *                       ComputeQuantiles()
+ * The caller passes a sequence of probabilities, and gets back a list of
+ * the corresponding quantiles.
+ */
+
+%typemap(in, numinputs=1) (int nQuantiles, const double* padfProbabilities, double* padfQuantiles)
+{
+  /* %typemap(in) int nQuantiles, const double* padfProbabilities, double* padfQuantiles */
+  if ( !PySequence_Check($input) ) {
+    PyErr_SetString(PyExc_TypeError, "not a sequence");
+    SWIG_fail;
+  }
+  Py_ssize_t size = PySequence_Size($input);
+  if( size != (int)size || size > (Py_ssize_t)(INT_MAX / sizeof(double)) ) {
+    PyErr_SetString(PyExc_TypeError, "too big sequence");
+    SWIG_fail;
+  }
+  $1 = (int)size;
+  $2 = (double*) VSICalloc(size ? size : 1, sizeof(double));
+  $3 = (double*) VSICalloc(size ? size : 1, sizeof(double));
+  if( $2 == NULL || $3 == NULL ) {
+    PyErr_SetString( PyExc_RuntimeError, "Cannot allocate quantiles" );
+    SWIG_fail;
+  }
+  for( int i = 0; i<$1; i++ ) {
+    PyObject *o = PySequence_GetItem($input,i);
+    if ( !PyArg_Parse(o,"d",&$2[i]) ) {
+      PyErr_SetString(PyExc_TypeError, "not a number");
+      Py_DECREF(o);
+      SWIG_fail;
+    }
+    Py_DECREF(o);
+  }
+}
+
+%typemap(freearg) (int nQuantiles, const double* padfProbabilities, double* padfQuantiles)
+{
+  /* %typemap(freearg) (int nQuantiles, const double* padfProbabilities, double* padfQuantiles) */
+  VSIFree( (void*) $2 );
+  VSIFree( $3 );
+}
+
+%typemap(argout) (int nQuantiles, const double* padfProbabilities, double* padfQuantiles)
+{
+  /* %typemap(argout) (int nQuantiles, const double* padfProbabilities, double* padfQuantiles) */
+  Py_DECREF( $result );
+  if ( result != CE_None ) {
+    $result = Py_None;
+    Py_INCREF( $result );
+  }
+  else {
+    $result = PyList_New( $1 );
+    for ( int i = 0; i < $1; ++i ) {
+      PyList_SetItem( $result, i, PyFloat_FromDouble( $3[i] ) );
+    }
+  }
+}
+
 /* ***************************************************************************
  *                       GetDefaultHistogram()
  */